@@ -18,13 +18,16 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <cstring>
 #include <map>
+#include <optional>
 #include <string>
 #include <variant>
 #include <cassert>
+#include <type_traits>
 #include <tcb/span.hpp>
 #include "exceptions.h"
 
@@ -95,11 +98,40 @@ inline uint32_t read_u32_le(tcb::span<const uint8_t> in, size_t offset) {
         (static_cast<uint32_t>(in[offset + 3]) << 24);
 }
 
+// Host byte order. Parquet PLAIN values are little-endian, so on little-endian hosts they already have the
+// native layout and can be copied as-is.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+inline constexpr bool kHostIsLittleEndian = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
+#elif defined(_WIN32)
+inline constexpr bool kHostIsLittleEndian = true;
+#else
+inline constexpr bool kHostIsLittleEndian = false;
+#endif
+
+// Types supported by the templated and bulk little-endian functions below.
+template <class T>
+inline constexpr bool is_le_value_type_v =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+inline uint32_t byte_swap(uint32_t v) {
+    return ((v & 0x000000FFu) << 24) | ((v & 0x0000FF00u) << 8) |
+           ((v & 0x00FF0000u) >> 8)  | ((v & 0xFF000000u) >> 24);
+}
+
+inline uint64_t byte_swap(uint64_t v) {
+    return (static_cast<uint64_t>(byte_swap(static_cast<uint32_t>(v))) << 32) |
+           byte_swap(static_cast<uint32_t>(v >> 32));
+}
+
 // Utility functions for reading and writing with templated types.
 
 template <class T>
 inline T read_le(const uint8_t* p) {
-    if constexpr (std::is_same_v<T, int32_t>) {
+    if constexpr (kHostIsLittleEndian && is_le_value_type_v<T>) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
         const uint32_t v =
             (static_cast<uint32_t>(p[0])      ) |
             (static_cast<uint32_t>(p[1]) <<  8) |
@@ -146,7 +178,9 @@ inline T read_le(const uint8_t* p) {
 
 template <class T>
 inline void write_le(const T& value, uint8_t* p) {
-    if constexpr (std::is_same_v<T, int32_t>) {
+    if constexpr (kHostIsLittleEndian && is_le_value_type_v<T>) {
+        std::memcpy(p, &value, sizeof(T));
+    } else if constexpr (std::is_same_v<T, int32_t>) {
         const uint32_t v = static_cast<uint32_t>(value);
         p[0] = static_cast<uint8_t>( v        & 0xFF);
         p[1] = static_cast<uint8_t>((v >>  8) & 0xFF);
@@ -185,6 +219,53 @@ inline void write_le(const T& value, uint8_t* p) {
     }
 }
 
+// Bulk little-endian conversion between packed bytes and native arrays, e.g. a page of PLAIN INT32 values.
+// On little-endian hosts this is a single memcpy. Elsewhere each value is byte-swapped in a branch-free loop
+// that compilers vectorize.
+template <class T>
+inline void read_le_array(tcb::span<const uint8_t> in, tcb::span<T> out) {
+    static_assert(is_le_value_type_v<T>, "read_le_array: unsupported type");
+    if (in.size() != out.size() * sizeof(T)) {
+        throw InvalidInputException("read_le_array: input size does not match the number of values");
+    }
+    if (in.empty()) {
+        return;
+    }
+    if constexpr (kHostIsLittleEndian) {
+        std::memcpy(out.data(), in.data(), in.size());
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+        for (size_t i = 0; i < out.size(); ++i) {
+            Bits bits;
+            std::memcpy(&bits, in.data() + i * sizeof(T), sizeof(T));
+            bits = byte_swap(bits);
+            std::memcpy(&out[i], &bits, sizeof(T));
+        }
+    }
+}
+
+template <class T>
+inline void write_le_array(tcb::span<const T> in, tcb::span<uint8_t> out) {
+    static_assert(is_le_value_type_v<T>, "write_le_array: unsupported type");
+    if (out.size() != in.size() * sizeof(T)) {
+        throw InvalidInputException("write_le_array: output size does not match the number of values");
+    }
+    if (in.empty()) {
+        return;
+    }
+    if constexpr (kHostIsLittleEndian) {
+        std::memcpy(out.data(), in.data(), out.size());
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+        for (size_t i = 0; i < in.size(); ++i) {
+            Bits bits;
+            std::memcpy(&bits, &in[i], sizeof(T));
+            bits = byte_swap(bits);
+            std::memcpy(out.data() + i * sizeof(T), &bits, sizeof(T));
+        }
+    }
+}
+
 // Utility functions for little-endian number reading and writing UINT32 values.
 //
 // Since UINT32 functions are called heavily in tight loops and hot execution paths to read/write sizes,
@@ -301,6 +382,37 @@ inline std::vector<uint8_t> JoinWithLengthPrefix(const std::vector<uint8_t>& lea
     return result;
 }
 
+/**
+ * Same as JoinWithLengthPrefix, writing into a caller-provided buffer.
+ *
+ * @param leading The first part of the bytes
+ * @param trailing The second part of the bytes
+ * @param out Output buffer of at least kSizePrefixBytes + leading.size() + trailing.size() bytes
+ * @return Number of bytes written to out
+ * @throws InvalidInputException if out is too small or leading size exceeds 2^32 - 1
+ */
+inline size_t JoinWithLengthPrefixInto(
+    tcb::span<const uint8_t> leading, tcb::span<const uint8_t> trailing, tcb::span<uint8_t> out) {
+    if (leading.size() > std::numeric_limits<uint32_t>::max()) {
+        throw InvalidInputException("Leading bytes size exceeds maximum representable value");
+    }
+    const size_t total_size = kSizePrefixBytes + leading.size() + trailing.size();
+    if (out.size() < total_size) {
+        throw InvalidInputException("Output buffer too small for length-prefixed data: " +
+                                    std::to_string(total_size) + " bytes required, " +
+                                    std::to_string(out.size()) + " bytes provided");
+    }
+
+    write_u32_le(out.data(), static_cast<uint32_t>(leading.size()));
+    if (!leading.empty()) {
+        std::memcpy(out.data() + kSizePrefixBytes, leading.data(), leading.size());
+    }
+    if (!trailing.empty()) {
+        std::memcpy(out.data() + kSizePrefixBytes + leading.size(), trailing.data(), trailing.size());
+    }
+    return total_size;
+}
+
 /**
  * Parse a self-contained byte span that was created with JoinWithLengthPrefix.
  * Extracts leading and trailing span views based on the embedded length prefix.
@@ -342,6 +454,138 @@ inline SpansPair SplitWithLengthPrefix(tcb::span<const uint8_t> bytes) {
         std::vector<uint8_t>(spans.trailing.begin(), spans.trailing.end())};
 }
 
+// Segmented (scatter/gather) input bytes.
+//
+// Non-owning view of bytes held in several segments, like an iovec array: e.g. a page received in network
+// chunks, or the level and value bytes of a page kept in separate caller buffers. Consumers walk the segments
+// directly and only gather the ranges they need as one span (and only when those straddle a segment boundary),
+// instead of concatenating the whole input first.
+//
+// The segment array and the segment bytes must outlive the view. A single span converts implicitly, without
+// allocating.
+class SegmentedBytes {
+public:
+    SegmentedBytes() = default;
+
+    SegmentedBytes(tcb::span<const uint8_t> bytes)
+        : single_segment_(bytes), is_single_(true), contiguous_(bytes), is_contiguous_(true), size_(bytes.size()) {}
+
+    explicit SegmentedBytes(tcb::span<const tcb::span<const uint8_t>> segments) : segments_(segments) {
+        size_t num_non_empty = 0;
+        for (const auto& segment : segments_) {
+            size_ += segment.size();
+            if (!segment.empty()) {
+                contiguous_ = segment;
+                ++num_non_empty;
+            }
+        }
+        is_contiguous_ = (num_non_empty <= 1);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    size_t GetNumSegments() const { return is_single_ ? 1 : segments_.size(); }
+    tcb::span<const uint8_t> GetSegment(size_t index) const { return is_single_ ? single_segment_ : segments_[index]; }
+
+    // Whether all bytes are in a single segment (empty segments aside). AsContiguous then views them as one span.
+    bool IsContiguous() const { return is_contiguous_; }
+    tcb::span<const uint8_t> AsContiguous() const {
+        if (!is_contiguous_) {
+            throw InvalidInputException("SegmentedBytes: bytes are not contiguous");
+        }
+        return contiguous_;
+    }
+
+    // Calls visitor(tcb::span<const uint8_t> segment) for every non-empty segment, in order.
+    template <class Visitor>
+    void ForEachSegment(Visitor&& visitor) const {
+        for (size_t i = 0; i < GetNumSegments(); ++i) {
+            if (!GetSegment(i).empty()) {
+                visitor(GetSegment(i));
+            }
+        }
+    }
+
+    // Copies out.size() bytes starting at offset into out.
+    void CopyTo(size_t offset, tcb::span<uint8_t> out) const {
+        CheckRange(offset, out.size());
+        size_t copied = 0;
+        size_t segment_start = 0;
+        for (size_t i = 0; i < GetNumSegments() && copied < out.size(); ++i) {
+            const auto segment = GetSegment(i);
+            const size_t segment_end = segment_start + segment.size();
+            const size_t position = offset + copied;
+            if (position < segment_end) {
+                const size_t in_segment = position - segment_start;
+                const size_t length = std::min(segment.size() - in_segment, out.size() - copied);
+                std::memcpy(out.data() + copied, segment.data() + in_segment, length);
+                copied += length;
+            }
+            segment_start = segment_end;
+        }
+    }
+
+    uint32_t ReadU32LE(size_t offset) const {
+        uint8_t bytes[sizeof(uint32_t)];
+        CopyTo(offset, tcb::span<uint8_t>(bytes, sizeof(bytes)));
+        return read_u32_le(bytes);
+    }
+
+    // Whether bytes [offset, offset + size) lie within a single segment, so they can be viewed in place.
+    bool IsWithinOneSegment(size_t offset, size_t size) const {
+        return size == 0 || FindSegmentView(offset, size).has_value();
+    }
+
+    // Bytes [offset, offset + size) as one span: a view into the segment holding them when they do not straddle a
+    // segment boundary, otherwise a copy gathered into scratch.
+    tcb::span<const uint8_t> GetContiguous(size_t offset, size_t size, std::vector<uint8_t>& scratch) const {
+        CheckRange(offset, size);
+        if (size == 0) {
+            return {};
+        }
+        if (auto view = FindSegmentView(offset, size)) {
+            return *view;
+        }
+        scratch.resize(size);
+        CopyTo(offset, scratch);
+        return scratch;
+    }
+
+private:
+    std::optional<tcb::span<const uint8_t>> FindSegmentView(size_t offset, size_t size) const {
+        CheckRange(offset, size);
+        size_t segment_start = 0;
+        for (size_t i = 0; i < GetNumSegments(); ++i) {
+            const auto segment = GetSegment(i);
+            if (offset < segment_start + segment.size()) {
+                const size_t in_segment = offset - segment_start;
+                if (size <= segment.size() - in_segment) {
+                    return segment.subspan(in_segment, size);
+                }
+                return std::nullopt;
+            }
+            segment_start += segment.size();
+        }
+        return std::nullopt;
+    }
+
+    void CheckRange(size_t offset, size_t size) const {
+        if (offset > size_ || size > size_ - offset) {
+            throw InvalidInputException(
+                "SegmentedBytes: range [" + std::to_string(offset) + ", " + std::to_string(offset) + " + " +
+                std::to_string(size) + ") exceeds size " + std::to_string(size_));
+        }
+    }
+
+    tcb::span<const tcb::span<const uint8_t>> segments_;
+    tcb::span<const uint8_t> single_segment_;
+    bool is_single_ = false;
+    tcb::span<const uint8_t> contiguous_;
+    bool is_contiguous_ = true;
+    size_t size_ = 0;
+};
+
 // Utility functions for creating an AttributesMap
 
 // Common alias for converted encoding attributes used across modules.
@@ -166,6 +166,19 @@ TEST(BytesUtils, JoinWithLengthPrefix_BothEmpty) {
     EXPECT_EQ(0x00, result[3]);
 }
 
+TEST(BytesUtils, JoinWithLengthPrefixInto_MatchesJoinWithLengthPrefix) {
+    std::vector<uint8_t> leading = {0x01, 0x02, 0x03};
+    std::vector<uint8_t> trailing = {0x04, 0x05};
+    auto expected = JoinWithLengthPrefix(leading, trailing);
+
+    std::vector<uint8_t> out(expected.size());
+    EXPECT_EQ(JoinWithLengthPrefixInto(leading, trailing, out), expected.size());
+    EXPECT_EQ(out, expected);
+
+    std::vector<uint8_t> too_small(expected.size() - 1);
+    EXPECT_THROW(JoinWithLengthPrefixInto(leading, trailing, too_small), InvalidInputException);
+}
+
 TEST(BytesUtils, SplitWithLengthPrefix_Normal) {
     std::vector<uint8_t> leading = {0x01, 0x02, 0x03};
     std::vector<uint8_t> trailing = {0x04, 0x05, 0x06};
@@ -485,3 +498,97 @@ TEST(BytesUtils, WriteReadLeDouble_OffsetRoundTrip_VerifiesBytesAndGuards) {
     }
     EXPECT_DOUBLE_EQ(decoded, kOriginal);
 }
+
+TEST(BytesUtils, ByteSwap_ReversesBytes) {
+    EXPECT_EQ(byte_swap(uint32_t{0x12345678u}), 0x78563412u);
+    EXPECT_EQ(byte_swap(uint64_t{0x0102030405060708ull}), 0x0807060504030201ull);
+}
+
+TEST(BytesUtils, ReadLeArrayWriteLeArray_MatchPerValueFunctions) {
+    const std::vector<int32_t> int32_values = {0, 1, -1, 0x12345678, -2147483000};
+    std::vector<uint8_t> int32_bytes(int32_values.size() * sizeof(int32_t));
+    write_le_array<int32_t>(int32_values, int32_bytes);
+    for (size_t i = 0; i < int32_values.size(); ++i) {
+        EXPECT_EQ(read_le<int32_t>(int32_bytes.data() + i * sizeof(int32_t)), int32_values[i]);
+    }
+    EXPECT_EQ(int32_bytes[12], 0x78);
+    EXPECT_EQ(int32_bytes[15], 0x12);
+    std::vector<int32_t> int32_decoded(int32_values.size());
+    read_le_array<int32_t>(int32_bytes, int32_decoded);
+    EXPECT_EQ(int32_decoded, int32_values);
+
+    // Values read from an unaligned offset.
+    const std::vector<double> double_values = {0.0, -3.141592653589793, 1e300};
+    std::vector<uint8_t> double_bytes(1 + double_values.size() * sizeof(double));
+    for (size_t i = 0; i < double_values.size(); ++i) {
+        write_le<double>(double_values[i], double_bytes.data() + 1 + i * sizeof(double));
+    }
+    std::vector<double> double_decoded(double_values.size());
+    read_le_array<double>(tcb::span<const uint8_t>(double_bytes).subspan(1), double_decoded);
+    EXPECT_EQ(double_decoded, double_values);
+}
+
+TEST(BytesUtils, ReadLeArrayWriteLeArray_SizeMismatch_Throws) {
+    std::vector<uint8_t> bytes(7);
+    std::vector<int64_t> values(1);
+    EXPECT_THROW(read_le_array<int64_t>(bytes, values), InvalidInputException);
+    EXPECT_THROW(write_le_array<int64_t>(values, bytes), InvalidInputException);
+
+    std::vector<float> no_values;
+    read_le_array<float>(tcb::span<const uint8_t>(), no_values);
+    write_le_array<float>(no_values, tcb::span<uint8_t>());
+}
+
+TEST(BytesUtils, SegmentedBytes_ReadsAcrossSegments) {
+    const std::vector<uint8_t> first = {0x01, 0x02, 0x03};
+    const std::vector<uint8_t> second = {0x04, 0x05, 0x06, 0x07, 0x08};
+    const std::vector<tcb::span<const uint8_t>> segments = {first, {}, second};
+    const SegmentedBytes bytes(segments);
+    EXPECT_EQ(bytes.size(), 8u);
+    EXPECT_FALSE(bytes.IsContiguous());
+    EXPECT_THROW(bytes.AsContiguous(), InvalidInputException);
+
+    std::vector<uint8_t> copied(4);
+    bytes.CopyTo(1, copied);
+    EXPECT_EQ(copied, (std::vector<uint8_t>{0x02, 0x03, 0x04, 0x05}));
+    EXPECT_EQ(bytes.ReadU32LE(2), 0x06050403u);
+
+    // Ranges within one segment are viewed in place, straddling ranges are gathered into scratch.
+    std::vector<uint8_t> scratch;
+    EXPECT_TRUE(bytes.IsWithinOneSegment(3, 5));
+    EXPECT_EQ(bytes.GetContiguous(3, 5, scratch).data(), second.data());
+    EXPECT_TRUE(scratch.empty());
+    EXPECT_FALSE(bytes.IsWithinOneSegment(2, 2));
+    auto gathered = bytes.GetContiguous(2, 2, scratch);
+    EXPECT_EQ(gathered.data(), scratch.data());
+    EXPECT_EQ(scratch, (std::vector<uint8_t>{0x03, 0x04}));
+
+    std::vector<uint8_t> visited;
+    size_t num_visited = 0;
+    bytes.ForEachSegment([&](tcb::span<const uint8_t> segment) {
+        visited.insert(visited.end(), segment.begin(), segment.end());
+        ++num_visited;
+    });
+    EXPECT_EQ(num_visited, 2u);
+    EXPECT_EQ(visited, (std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}));
+
+    EXPECT_THROW(bytes.ReadU32LE(5), InvalidInputException);
+    EXPECT_THROW(bytes.CopyTo(8, tcb::span<uint8_t>(copied.data(), 1)), InvalidInputException);
+}
+
+TEST(BytesUtils, SegmentedBytes_SingleNonEmptySegmentIsContiguous) {
+    const std::vector<uint8_t> data = {0x0A, 0x0B};
+    const SegmentedBytes from_span = tcb::span<const uint8_t>(data);
+    EXPECT_TRUE(from_span.IsContiguous());
+    EXPECT_EQ(from_span.AsContiguous().data(), data.data());
+
+    const std::vector<tcb::span<const uint8_t>> segments = {{}, data, {}};
+    const SegmentedBytes from_segments(segments);
+    EXPECT_TRUE(from_segments.IsContiguous());
+    EXPECT_EQ(from_segments.AsContiguous().data(), data.data());
+    EXPECT_EQ(from_segments.AsContiguous().size(), 2u);
+
+    const SegmentedBytes empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.IsContiguous());
+}
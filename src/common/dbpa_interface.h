@@ -48,6 +48,8 @@ namespace dbps::external {
  * - Read operations are not destructive. Multiple calls return the same data
  * - Destructor must dispose of internal memory (either by delegation or cleanup)
  * - Library users must check size() to ensure the actual size of the returned payload.
+ * - Results may reference caller-owned memory (e.g. agents writing into a caller-provided buffer). The caller must
+ *   then keep that memory alive while using the result.
  * - Exceptions on init(): init() may throw DBPSException for initialization errors (e.g., invalid parameters, server connection failures)
  * - Exceptions on Encrypt() and Decrypt(): Encrypt/Decrypt do not throw exceptions. Errors reported via success() flag and error methods.
  */
@@ -17,6 +17,10 @@
 
 #include "dbpa_local.h"
 #include "../processing/encryption_sequencer.h"
+#include "../processing/encryptors/basic_xor_encryptor.h"
+#include "../processing/encryption_mode_policy.h"
+#include "../processing/buffer_pool.h"
+#include "exceptions.h"
 #include "enum_utils.h"
 #include "dbpa_utils.h"
 #include <iostream>
@@ -33,6 +37,13 @@ LocalEncryptionResult::LocalEncryptionResult(std::vector<uint8_t> ciphertext, co
       encryption_metadata_(encryption_metadata) {
 }
 
+LocalEncryptionResult::LocalEncryptionResult(span<const uint8_t> caller_owned_ciphertext, const std::map<std::string, std::string>& encryption_metadata)
+    : caller_owned_ciphertext_(caller_owned_ciphertext),
+      is_caller_owned_(true),
+      success_(true),
+      encryption_metadata_(encryption_metadata) {
+}
+
 LocalEncryptionResult::LocalEncryptionResult(const std::string& error_stage, const std::string& error_message)
     : success_(false), error_message_(error_stage + ": " + error_message) {
     error_fields_["error_stage"] = error_stage;
@@ -43,6 +54,9 @@ span<const uint8_t> LocalEncryptionResult::ciphertext() const {
     if (!success_) {
         return span<const uint8_t>();
     }
+    if (is_caller_owned_) {
+        return caller_owned_ciphertext_;
+    }
     return span<const uint8_t>(ciphertext_.data(), ciphertext_.size());
 }
 
@@ -50,6 +64,9 @@ std::size_t LocalEncryptionResult::size() const {
     if (!success_) {
         return 0;
     }
+    if (is_caller_owned_) {
+        return caller_owned_ciphertext_.size();
+    }
     return ciphertext_.size();
 }
 
@@ -75,6 +92,10 @@ LocalDecryptionResult::LocalDecryptionResult(std::vector<uint8_t> plaintext)
     : plaintext_(std::move(plaintext)), success_(true) {
 }
 
+LocalDecryptionResult::LocalDecryptionResult(span<const uint8_t> caller_owned_plaintext)
+    : caller_owned_plaintext_(caller_owned_plaintext), is_caller_owned_(true), success_(true) {
+}
+
 LocalDecryptionResult::LocalDecryptionResult(const std::string& error_stage, const std::string& error_message)
     : success_(false), error_message_(error_stage + ": " + error_message) {
     error_fields_["error_stage"] = error_stage;
@@ -85,6 +106,9 @@ span<const uint8_t> LocalDecryptionResult::plaintext() const {
     if (!success_) {
         return span<const uint8_t>();
     }
+    if (is_caller_owned_) {
+        return caller_owned_plaintext_;
+    }
     return span<const uint8_t>(plaintext_.data(), plaintext_.size());
 }
 
@@ -92,6 +116,9 @@ std::size_t LocalDecryptionResult::size() const {
     if (!success_) {
         return 0;
     }
+    if (is_caller_owned_) {
+        return caller_owned_plaintext_.size();
+    }
     return plaintext_.size();
 }
 
@@ -107,6 +134,78 @@ const std::map<std::string, std::string>& LocalDecryptionResult::error_fields()
     return error_fields_;
 }
 
+namespace {
+    constexpr char kParallelThresholdConfigKey[] = "value_encryption_parallel_threshold_bytes";
+    constexpr char kStreamingChunkSizeConfigKey[] = "streaming_chunk_size_bytes";
+    constexpr char kDictionaryIndexPassthroughConfigKey[] = "dictionary_index_passthrough";
+    constexpr char kInsecureDictionaryIndexChecksumConfigKey[] = "insecure_dictionary_index_checksum";
+    constexpr char kBufferPoolMaxCachedBytesConfigKey[] = "buffer_pool_max_cached_bytes";
+    constexpr char kTrustedCiphertextConfigKey[] = "trusted_ciphertext";
+    constexpr char kValueDedupConfigKey[] = "value_dedup";
+    constexpr char kColumnarValueListsConfigKey[] = "columnar_value_lists";
+}
+
+// LocalBatchResult implementation
+
+LocalBatchResult::LocalBatchResult(
+    std::vector<uint8_t> arena,
+    std::vector<size_t> page_offsets,
+    std::vector<std::map<std::string, std::string>> page_encryption_metadata)
+    : arena_(std::move(arena)),
+      page_offsets_(std::move(page_offsets)),
+      page_encryption_metadata_(std::move(page_encryption_metadata)),
+      success_(true) {
+}
+
+LocalBatchResult::LocalBatchResult(const std::string& error_stage, const std::string& error_message)
+    : success_(false), error_message_(error_stage + ": " + error_message) {
+    error_fields_["error_stage"] = error_stage;
+    error_fields_["error_detail"] = error_message;
+}
+
+bool LocalBatchResult::success() const {
+    return success_;
+}
+
+std::size_t LocalBatchResult::num_pages() const {
+    if (!success_ || page_offsets_.empty()) {
+        return 0;
+    }
+    return page_offsets_.size() - 1;
+}
+
+span<const uint8_t> LocalBatchResult::page(std::size_t page_index) const {
+    if (page_index >= num_pages()) {
+        return span<const uint8_t>();
+    }
+    return span<const uint8_t>(
+        arena_.data() + page_offsets_[page_index],
+        page_offsets_[page_index + 1] - page_offsets_[page_index]);
+}
+
+const std::map<std::string, std::string>& LocalBatchResult::page_encryption_metadata(std::size_t page_index) const {
+    static const std::map<std::string, std::string> kEmptyMetadata;
+    if (page_index >= page_encryption_metadata_.size()) {
+        return kEmptyMetadata;
+    }
+    return page_encryption_metadata_[page_index];
+}
+
+span<const uint8_t> LocalBatchResult::arena() const {
+    if (!success_) {
+        return span<const uint8_t>();
+    }
+    return span<const uint8_t>(arena_.data(), arena_.size());
+}
+
+const std::string& LocalBatchResult::error_message() const {
+    return error_message_;
+}
+
+const std::map<std::string, std::string>& LocalBatchResult::error_fields() const {
+    return error_fields_;
+}
+
 // LocalDataBatchProtectionAgent implementation
 
 void LocalDataBatchProtectionAgent::init(
@@ -152,6 +251,144 @@ void LocalDataBatchProtectionAgent::init(
         user_id_ = *user_id_opt;
         std::cerr << "INFO: LocalDataBatchProtectionAgent::init() - user_id extracted: [" << user_id_ << "]" << std::endl;
 
+        // Optional size settings from configuration_map, in bytes.
+        auto read_size_config = [this](const char* key, size_t default_value) -> size_t {
+            auto it = configuration_map_.find(key);
+            if (it == configuration_map_.end()) {
+                return default_value;
+            }
+            try {
+                return static_cast<size_t>(std::stoull(it->second));
+            } catch (const std::exception&) {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid " << key
+                          << ": [" << it->second << "]" << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " + std::string(key);
+                throw DBPSException("Invalid " + std::string(key) + ": " + it->second);
+            }
+        };
+
+        // Threshold for intra-page parallel value encryption (optional, defaults to the encryptor's).
+        const size_t parallel_threshold_bytes =
+            read_size_config(kParallelThresholdConfigKey, BasicXorEncryptor::kDefaultParallelThresholdBytes);
+
+        // Chunk size of the streaming mode (optional, disabled by default).
+        const size_t streaming_chunk_size = read_size_config(kStreamingChunkSizeConfigKey, 0);
+
+        // Per-thread bytes kept by the pool of intermediate page buffers (optional, disabled by default).
+        const size_t buffer_pool_max_cached_bytes = read_size_config(kBufferPoolMaxCachedBytesConfigKey, 0);
+        std::shared_ptr<dbps::processing::BufferPool> buffer_pool;
+        if (buffer_pool_max_cached_bytes > 0) {
+            dbps::processing::BufferPoolOptions pool_options;
+            pool_options.max_cached_bytes_per_shard = buffer_pool_max_cached_bytes;
+            buffer_pool = std::make_shared<dbps::processing::BufferPool>(pool_options);
+        }
+
+        // Dictionary index passthrough (optional, disabled by default).
+        bool dictionary_index_passthrough = false;
+        auto passthrough_it = configuration_map_.find(kDictionaryIndexPassthroughConfigKey);
+        if (passthrough_it != configuration_map_.end()) {
+            if (passthrough_it->second != "true" && passthrough_it->second != "false") {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid "
+                          << kDictionaryIndexPassthroughConfigKey << ": [" << passthrough_it->second << "]" << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " + std::string(kDictionaryIndexPassthroughConfigKey);
+                throw DBPSException("Invalid " + std::string(kDictionaryIndexPassthroughConfigKey) + ": " +
+                                    passthrough_it->second);
+            }
+            dictionary_index_passthrough = (passthrough_it->second == "true");
+        }
+
+        // Checksum-tagged passthrough pages of the XOR encryptor (optional, rejected by default).
+        bool insecure_dictionary_index_checksum = false;
+        auto insecure_checksum_it = configuration_map_.find(kInsecureDictionaryIndexChecksumConfigKey);
+        if (insecure_checksum_it != configuration_map_.end()) {
+            if (insecure_checksum_it->second != "true" && insecure_checksum_it->second != "false") {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid "
+                          << kInsecureDictionaryIndexChecksumConfigKey << ": [" << insecure_checksum_it->second << "]"
+                          << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " +
+                               std::string(kInsecureDictionaryIndexChecksumConfigKey);
+                throw DBPSException("Invalid " + std::string(kInsecureDictionaryIndexChecksumConfigKey) + ": " +
+                                    insecure_checksum_it->second);
+            }
+            insecure_dictionary_index_checksum = (insecure_checksum_it->second == "true");
+        }
+
+        // Trusted ciphertext (optional, disabled by default).
+        bool trusted_ciphertext = false;
+        auto trusted_it = configuration_map_.find(kTrustedCiphertextConfigKey);
+        if (trusted_it != configuration_map_.end()) {
+            if (trusted_it->second != "true" && trusted_it->second != "false") {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid "
+                          << kTrustedCiphertextConfigKey << ": [" << trusted_it->second << "]" << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " + std::string(kTrustedCiphertextConfigKey);
+                throw DBPSException("Invalid " + std::string(kTrustedCiphertextConfigKey) + ": " + trusted_it->second);
+            }
+            trusted_ciphertext = (trusted_it->second == "true");
+        }
+
+        // Value deduplication of per-value pages (optional, disabled by default).
+        dbps::processing::ValueDedupOptions value_dedup;
+        auto dedup_it = configuration_map_.find(kValueDedupConfigKey);
+        if (dedup_it != configuration_map_.end()) {
+            auto dedup_mode = dbps::processing::ValueDedupModeFromString(dedup_it->second);
+            if (!dedup_mode.has_value()) {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid "
+                          << kValueDedupConfigKey << ": [" << dedup_it->second << "]" << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " + std::string(kValueDedupConfigKey);
+                throw DBPSException("Invalid " + std::string(kValueDedupConfigKey) + ": " + dedup_it->second);
+            }
+            value_dedup.mode = dedup_mode.value();
+        }
+
+        // Columnar value lists of ciphertext format v0.02 (optional, disabled by default).
+        bool columnar_value_lists = false;
+        auto columnar_it = configuration_map_.find(kColumnarValueListsConfigKey);
+        if (columnar_it != configuration_map_.end()) {
+            if (columnar_it->second != "true" && columnar_it->second != "false") {
+                std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid "
+                          << kColumnarValueListsConfigKey << ": [" << columnar_it->second << "]" << std::endl;
+                initialized_ = "Agent not properly initialized - invalid " + std::string(kColumnarValueListsConfigKey);
+                throw DBPSException("Invalid " + std::string(kColumnarValueListsConfigKey) + ": " + columnar_it->second);
+            }
+            columnar_value_lists = (columnar_it->second == "true");
+        }
+
+        // Per-block vs per-value selection policy (optional, defaults to per-value whenever supported).
+        std::shared_ptr<const EncryptionModePolicy> mode_policy;
+        try {
+            mode_policy = EncryptionModePolicy::FromConfiguration(configuration_map_);
+        } catch (const InvalidInputException& e) {
+            std::cerr << "ERROR: LocalDataBatchProtectionAgent::init() - Invalid encryption mode policy: "
+                      << e.what() << std::endl;
+            initialized_ = "Agent not properly initialized - invalid encryption mode policy";
+            throw DBPSException("Invalid encryption mode policy: " + std::string(e.what()));
+        }
+
+        // Build the column context once. Column-level validation errors are kept in the context
+        // and reported on each Encrypt/Decrypt call.
+        ColumnEncryptionOptions column_options;
+        column_options.streaming_chunk_size = streaming_chunk_size;
+        column_options.mode_policy = mode_policy;
+        column_options.dictionary_index_passthrough = dictionary_index_passthrough;
+        column_options.insecure_dictionary_index_checksum = insecure_dictionary_index_checksum;
+        column_options.buffer_pool = buffer_pool;
+        column_options.trusted_ciphertext = trusted_ciphertext;
+        column_options.value_dedup = value_dedup;
+        column_options.columnar_value_lists = columnar_value_lists;
+        column_context_ = std::make_shared<const ColumnEncryptionContext>(
+            column_name_,
+            datatype_,
+            datatype_length_,
+            compression_type_,
+            compression_type_,
+            column_key_id_,
+            user_id_,
+            app_context_,
+            std::make_unique<BasicXorEncryptor>(
+                column_key_id_, column_name_, user_id_, app_context_, datatype_, parallel_threshold_bytes),
+            std::move(column_options)
+        );
+
     } catch (const DBPSException& e) {
         // Re-throw DBPSException as-is
         throw;
@@ -186,18 +423,11 @@ std::unique_ptr<EncryptionResult> LocalDataBatchProtectionAgent::Encrypt(
         return std::make_unique<LocalEncryptionResult>("parameter_validation", "page_encoding not found or invalid in encoding_attributes");
     }
     
-    // Create the DataBatchEncryptionSequencer
+    // Create the DataBatchEncryptionSequencer on top of the column context built on init()
     DataBatchEncryptionSequencer sequencer(
-        column_name_,
-        datatype_,
-        datatype_length_,
-        compression_type_,
+        column_context_,
         encoding_opt.value(),
-        encoding_attributes,
-        compression_type_,
-        column_key_id_,
-        user_id_,
-        app_context_,
+        std::move(encoding_attributes),
         {}  // encryption_metadata, which is empty for the Encryption call.
     );
     
@@ -234,18 +464,11 @@ std::unique_ptr<DecryptionResult> LocalDataBatchProtectionAgent::Decrypt(
         return std::make_unique<LocalDecryptionResult>("parameter_validation", "page_encoding not found or invalid in encoding_attributes");
     }
     
-    // Create the DataBatchEncryptionSequencer
+    // Create the DataBatchEncryptionSequencer on top of the column context built on init()
     DataBatchEncryptionSequencer sequencer(
-        column_name_,
-        datatype_,
-        datatype_length_,
-        compression_type_,
+        column_context_,
         encoding_opt.value(),
-        encoding_attributes,
-        compression_type_,
-        column_key_id_,
-        user_id_,
-        app_context_,
+        std::move(encoding_attributes),
         column_encryption_metadata_.value_or(std::map<std::string, std::string>{})
     );
     
@@ -261,3 +484,215 @@ std::unique_ptr<DecryptionResult> LocalDataBatchProtectionAgent::Decrypt(
     return std::make_unique<LocalDecryptionResult>(std::move(sequencer.decrypted_result_));
 }
 
+namespace {
+    // Allocator over a fixed caller-provided span. Requests larger than the span return it as-is,
+    // and the sequencer reports the size mismatch.
+    OutputBufferAllocator MakeSpanAllocator(span<uint8_t> output) {
+        return [output](std::size_t) { return output; };
+    }
+}
+
+std::unique_ptr<EncryptionResult> LocalDataBatchProtectionAgent::EncryptInto(
+    span<const uint8_t> plaintext,
+    std::map<std::string, std::string> encoding_attributes,
+    span<uint8_t> output) {
+    return EncryptInto(plaintext, std::move(encoding_attributes), MakeSpanAllocator(output));
+}
+
+std::unique_ptr<EncryptionResult> LocalDataBatchProtectionAgent::EncryptInto(
+    span<const uint8_t> plaintext,
+    std::map<std::string, std::string> encoding_attributes,
+    const OutputBufferAllocator& allocate_output) {
+
+    if (!initialized_.has_value()) {
+        return std::make_unique<LocalEncryptionResult>("initialization", "Agent not initialized - init() was not called");
+    }
+
+    if (!initialized_->empty()) {
+        return std::make_unique<LocalEncryptionResult>("initialization", *initialized_);
+    }
+
+    auto encoding_opt = dbps::external::ExtractPageEncoding(encoding_attributes);
+    if (!encoding_opt.has_value()) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::EncryptInto() - page_encoding not found or invalid in encoding_attributes." << std::endl;
+        return std::make_unique<LocalEncryptionResult>("parameter_validation", "page_encoding not found or invalid in encoding_attributes");
+    }
+
+    DataBatchEncryptionSequencer sequencer(
+        column_context_,
+        encoding_opt.value(),
+        std::move(encoding_attributes),
+        {}  // encryption_metadata, which is empty for the Encryption call.
+    );
+
+    // Remember the allocated span, so the result can reference the bytes written into it.
+    span<uint8_t> allocated_output;
+    bool encrypt_result = sequencer.DecodeAndEncryptInto(plaintext, [&](std::size_t max_size) {
+        allocated_output = allocate_output(max_size);
+        return allocated_output;
+    });
+    if (!encrypt_result) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::EncryptInto() - Encryption failed: "
+                  << sequencer.error_stage_ << " - " << sequencer.error_message_ << std::endl;
+        return std::make_unique<LocalEncryptionResult>(sequencer.error_stage_, sequencer.error_message_);
+    }
+
+    return std::make_unique<LocalEncryptionResult>(
+        span<const uint8_t>(allocated_output.data(), sequencer.output_size_), sequencer.encryption_metadata_);
+}
+
+std::unique_ptr<DecryptionResult> LocalDataBatchProtectionAgent::DecryptInto(
+    span<const uint8_t> ciphertext,
+    std::map<std::string, std::string> encoding_attributes,
+    span<uint8_t> output) {
+    return DecryptInto(ciphertext, std::move(encoding_attributes), MakeSpanAllocator(output));
+}
+
+std::unique_ptr<DecryptionResult> LocalDataBatchProtectionAgent::DecryptInto(
+    span<const uint8_t> ciphertext,
+    std::map<std::string, std::string> encoding_attributes,
+    const OutputBufferAllocator& allocate_output) {
+
+    if (!initialized_.has_value()) {
+        return std::make_unique<LocalDecryptionResult>("initialization", "Agent not initialized - init() was not called");
+    }
+
+    if (!initialized_->empty()) {
+        return std::make_unique<LocalDecryptionResult>("initialization", *initialized_);
+    }
+
+    auto encoding_opt = dbps::external::ExtractPageEncoding(encoding_attributes);
+    if (!encoding_opt.has_value()) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::DecryptInto() - page_encoding not found or invalid in encoding_attributes." << std::endl;
+        return std::make_unique<LocalDecryptionResult>("parameter_validation", "page_encoding not found or invalid in encoding_attributes");
+    }
+
+    DataBatchEncryptionSequencer sequencer(
+        column_context_,
+        encoding_opt.value(),
+        std::move(encoding_attributes),
+        column_encryption_metadata_.value_or(std::map<std::string, std::string>{})
+    );
+
+    // Remember the allocated span, so the result can reference the bytes written into it.
+    span<uint8_t> allocated_output;
+    bool decrypt_result = sequencer.DecryptAndEncodeInto(ciphertext, [&](std::size_t max_size) {
+        allocated_output = allocate_output(max_size);
+        return allocated_output;
+    });
+    if (!decrypt_result) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::DecryptInto() - Decryption failed: "
+                  << sequencer.error_stage_ << " - " << sequencer.error_message_ << std::endl;
+        return std::make_unique<LocalDecryptionResult>(sequencer.error_stage_, sequencer.error_message_);
+    }
+
+    return std::make_unique<LocalDecryptionResult>(
+        span<const uint8_t>(allocated_output.data(), sequencer.output_size_));
+}
+
+std::optional<std::size_t> LocalDataBatchProtectionAgent::MaxCiphertextSize(
+    std::size_t plaintext_size,
+    const std::map<std::string, std::string>& encoding_attributes) const {
+
+    if (!initialized_.has_value() || !initialized_->empty()) {
+        return std::nullopt;
+    }
+
+    auto encoding_opt = dbps::external::ExtractPageEncoding(encoding_attributes);
+    if (!encoding_opt.has_value()) {
+        return std::nullopt;
+    }
+
+    DataBatchEncryptionSequencer sequencer(column_context_, encoding_opt.value(), encoding_attributes, {});
+    return sequencer.GetMaxCiphertextSize(plaintext_size);
+}
+
+// Builds the sequencer batch pages, resolving page_encoding for each page.
+// Returns the index of the first page with a missing or invalid page_encoding, if any.
+static std::optional<size_t> BuildSequencerBatchPages(
+    std::vector<LocalBatchPage>& pages,
+    std::vector<SequencerBatchPage>& sequencer_pages) {
+    sequencer_pages.clear();
+    sequencer_pages.reserve(pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto encoding_opt = dbps::external::ExtractPageEncoding(pages[i].encoding_attributes);
+        if (!encoding_opt.has_value()) {
+            return i;
+        }
+        sequencer_pages.push_back(SequencerBatchPage{
+            pages[i].payload, encoding_opt.value(), std::move(pages[i].encoding_attributes),
+            std::move(pages[i].encryption_metadata)});
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<LocalBatchResult> LocalDataBatchProtectionAgent::EncryptBatch(std::vector<LocalBatchPage> pages) {
+
+    if (!initialized_.has_value()) {
+        return std::make_unique<LocalBatchResult>("initialization", "Agent not initialized - init() was not called");
+    }
+
+    if (!initialized_->empty()) {
+        return std::make_unique<LocalBatchResult>("initialization", *initialized_);
+    }
+
+    std::vector<SequencerBatchPage> sequencer_pages;
+    auto invalid_page = BuildSequencerBatchPages(pages, sequencer_pages);
+    if (invalid_page.has_value()) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::EncryptBatch() - page_encoding not found or invalid in encoding_attributes." << std::endl;
+        return std::make_unique<LocalBatchResult>("parameter_validation",
+            "page " + std::to_string(invalid_page.value()) + ": page_encoding not found or invalid in encoding_attributes");
+    }
+
+    // A single sequencer processes all pages on top of the column context built on init()
+    DataBatchEncryptionSequencer sequencer(
+        column_context_,
+        {}  // encryption_metadata, which is empty for the Encryption call.
+    );
+
+    if (!sequencer.DecodeAndEncryptBatch(sequencer_pages)) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::EncryptBatch() - Encryption failed: "
+                  << sequencer.error_stage_ << " - " << sequencer.error_message_ << std::endl;
+        return std::make_unique<LocalBatchResult>(sequencer.error_stage_, sequencer.error_message_);
+    }
+
+    return std::make_unique<LocalBatchResult>(
+        std::move(sequencer.batch_result_.arena),
+        std::move(sequencer.batch_result_.page_offsets),
+        std::move(sequencer.batch_result_.page_encryption_metadata));
+}
+
+std::unique_ptr<LocalBatchResult> LocalDataBatchProtectionAgent::DecryptBatch(std::vector<LocalBatchPage> pages) {
+
+    if (!initialized_.has_value()) {
+        return std::make_unique<LocalBatchResult>("initialization", "Agent not initialized - init() was not called");
+    }
+
+    if (!initialized_->empty()) {
+        return std::make_unique<LocalBatchResult>("initialization", *initialized_);
+    }
+
+    std::vector<SequencerBatchPage> sequencer_pages;
+    auto invalid_page = BuildSequencerBatchPages(pages, sequencer_pages);
+    if (invalid_page.has_value()) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::DecryptBatch() - page_encoding not found or invalid in encoding_attributes." << std::endl;
+        return std::make_unique<LocalBatchResult>("parameter_validation",
+            "page " + std::to_string(invalid_page.value()) + ": page_encoding not found or invalid in encoding_attributes");
+    }
+
+    // A single sequencer processes all pages on top of the column context built on init()
+    DataBatchEncryptionSequencer sequencer(
+        column_context_,
+        column_encryption_metadata_.value_or(std::map<std::string, std::string>{})
+    );
+
+    if (!sequencer.DecryptAndEncodeBatch(sequencer_pages)) {
+        std::cerr << "ERROR: LocalDataBatchProtectionAgent::DecryptBatch() - Decryption failed: "
+                  << sequencer.error_stage_ << " - " << sequencer.error_message_ << std::endl;
+        return std::make_unique<LocalBatchResult>(sequencer.error_stage_, sequencer.error_message_);
+    }
+
+    return std::make_unique<LocalBatchResult>(
+        std::move(sequencer.batch_result_.arena),
+        std::move(sequencer.batch_result_.page_offsets));
+}
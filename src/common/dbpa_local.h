@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,16 +33,30 @@
 #define DBPS_EXPORT
 #endif
 
+// Per-column context shared by all pages, defined in processing/column_encryption_context.h
+class ColumnEncryptionContext;
+
 namespace dbps::external {
 
+/**
+ * Allocator of caller-owned output memory for the LocalDataBatchProtectionAgent *Into methods.
+ * Called at most once per call with an upper bound of the output size; must return a writable span of
+ * at least max_size bytes. The actual output size is reported by the result size().
+ */
+using OutputBufferAllocator = std::function<span<uint8_t>(std::size_t max_size)>;
+
 /**
  * Implementation of EncryptionResult for local calls that wraps DataBatchEncryptionSequencer results
  * Provides the required interface for encryption results from direct sequencer calls
+ * The ciphertext is either owned by the result, or references caller-owned memory (EncryptInto).
  */
 class DBPS_EXPORT LocalEncryptionResult : public EncryptionResult {
 public:
     // Constructor for successful encryption
     LocalEncryptionResult(std::vector<uint8_t> ciphertext, const std::map<std::string, std::string>& encryption_metadata = {});
+
+    // Constructor for successful encryption into caller-owned memory. The caller must keep it alive.
+    LocalEncryptionResult(span<const uint8_t> caller_owned_ciphertext, const std::map<std::string, std::string>& encryption_metadata);
     
     // Constructor for failed encryption
     LocalEncryptionResult(const std::string& error_stage, const std::string& error_message);
@@ -58,6 +73,8 @@ public:
 
 private:
     std::vector<uint8_t> ciphertext_;
+    span<const uint8_t> caller_owned_ciphertext_;
+    bool is_caller_owned_ = false;
     bool success_;
     std::map<std::string, std::string> encryption_metadata_;
     std::string error_message_;
@@ -67,11 +84,15 @@ private:
 /**
  * Implementation of DecryptionResult for local calls that wraps DataBatchEncryptionSequencer results
  * Provides the required interface for decryption results from direct sequencer calls
+ * The plaintext is either owned by the result, or references caller-owned memory (DecryptInto).
  */
 class DBPS_EXPORT LocalDecryptionResult : public DecryptionResult {
 public:
     // Constructor for successful decryption
     LocalDecryptionResult(std::vector<uint8_t> plaintext);
+
+    // Constructor for successful decryption into caller-owned memory. The caller must keep it alive.
+    LocalDecryptionResult(span<const uint8_t> caller_owned_plaintext);
     
     // Constructor for failed decryption
     LocalDecryptionResult(const std::string& error_stage, const std::string& error_message);
@@ -87,6 +108,55 @@ public:
 
 private:
     std::vector<uint8_t> plaintext_;
+    span<const uint8_t> caller_owned_plaintext_;
+    bool is_caller_owned_ = false;
+    bool success_;
+    std::string error_message_;
+    std::map<std::string, std::string> error_fields_;
+};
+
+/**
+ * Input page for the LocalDataBatchProtectionAgent batch methods.
+ * The payload is a non-owning view; the caller must keep it alive during the batch call.
+ */
+struct DBPS_EXPORT LocalBatchPage {
+    span<const uint8_t> payload;
+    std::map<std::string, std::string> encoding_attributes;
+    // DecryptBatch only: the page's entry from page_encryption_metadata. Empty uses the metadata given on init().
+    std::map<std::string, std::string> encryption_metadata;
+};
+
+/**
+ * Result of the LocalDataBatchProtectionAgent batch methods.
+ * All page outputs are stored in one contiguous buffer, and page(i) returns the view of page i.
+ * page_encryption_metadata(i) is only populated by EncryptBatch.
+ */
+class DBPS_EXPORT LocalBatchResult {
+public:
+    // Constructor for successful batch
+    LocalBatchResult(
+        std::vector<uint8_t> arena,
+        std::vector<size_t> page_offsets,
+        std::vector<std::map<std::string, std::string>> page_encryption_metadata = {});
+
+    // Constructor for failed batch
+    LocalBatchResult(const std::string& error_stage, const std::string& error_message);
+
+    bool success() const;
+    std::size_t num_pages() const;
+    span<const uint8_t> page(std::size_t page_index) const;
+    const std::map<std::string, std::string>& page_encryption_metadata(std::size_t page_index) const;
+
+    // The contiguous buffer holding all page outputs back-to-back.
+    span<const uint8_t> arena() const;
+
+    const std::string& error_message() const;
+    const std::map<std::string, std::string>& error_fields() const;
+
+private:
+    std::vector<uint8_t> arena_;
+    std::vector<size_t> page_offsets_;
+    std::vector<std::map<std::string, std::string>> page_encryption_metadata_;
     bool success_;
     std::string error_message_;
     std::map<std::string, std::string> error_fields_;
@@ -95,6 +165,31 @@ private:
 /**
  * Implementation of DataBatchProtectionAgentInterface for local calls
  * Calls DataBatchEncryptionSequencer directly without any network communication
+ * The column context (parameters, validation and encryptor) is built once on init() and reused by every page.
+ *
+ * Optional configuration_map keys:
+ * - "value_encryption_parallel_threshold_bytes": minimum size of a page's values for per-value
+ *   encryption/decryption to run in parallel on the shared thread pool (0 disables it).
+ * - "streaming_chunk_size_bytes": enables the bounded-memory streaming mode, processing every page in chunks
+ *   of at most this many bytes (0, the default, disables it). Decryption follows the encryption metadata.
+ * - "encryption_mode_policy", "encryption_mode_max_page_latency_us", "encryption_mode_cost_model_file":
+ *   per-block vs per-value selection policy of the pages (see EncryptionModePolicy::FromConfiguration).
+ * - "dictionary_index_passthrough": "true" to leave the data pages of dictionary-encoded chunks unencrypted
+ *   behind a tag, keeping the encryption cost on the dictionary page ("false" by default). The XOR encryptor of
+ *   this agent has no block tags, so it also requires "insecure_dictionary_index_checksum".
+ * - "insecure_dictionary_index_checksum": "true", for staging only, to tag and check passthrough pages with a
+ *   checksum that detects accidental corruption but gives no tamper protection ("false" by default). Needed on
+ *   both the encrypting and the decrypting agent.
+ * - "buffer_pool_max_cached_bytes": enables recycling of the intermediate page buffers, keeping up to this many
+ *   bytes per thread for reuse (0, the default, disables it).
+ * - "trusted_ciphertext": "true" when the ciphertexts decrypted by this agent were produced by the same
+ *   deployment and their integrity is protected separately. Per-value decryption then skips the structural
+ *   validation meant for untrusted input ("false" by default).
+ * - "value_dedup": "scatter" or "dictionary" to encrypt each distinct value of low-cardinality per-value pages
+ *   once (see ValueDedupMode), "off" by default.
+ * - "columnar_value_lists": "true" to encrypt the values of variable-size types with packed value sizes and one
+ *   payload region (ciphertext format v0.02) instead of per-value records ("false" by default). Readers of format
+ *   v0.01 cannot decrypt such ciphertext.
  */
 class DBPS_EXPORT LocalDataBatchProtectionAgent : public DataBatchProtectionAgentInterface {
 public:
@@ -119,6 +214,51 @@ public:
     std::unique_ptr<DecryptionResult> Decrypt(
         span<const uint8_t> ciphertext,
         std::map<std::string, std::string> encoding_attributes) override;
+
+    /*
+     * Variants of Encrypt/Decrypt that write the output into caller-owned memory, e.g. a page buffer of the
+     * Parquet writer/reader. The returned result references that memory and its size() is the actual output size.
+     * - The span variants fail with error stage "output_allocation" if the span is smaller than the size
+     *   requested by the pipeline (see MaxCiphertextSize to size it for encryption).
+     * - The allocator variants request the memory once the output bound is known.
+     */
+    std::unique_ptr<EncryptionResult> EncryptInto(
+        span<const uint8_t> plaintext,
+        std::map<std::string, std::string> encoding_attributes,
+        span<uint8_t> output);
+
+    std::unique_ptr<EncryptionResult> EncryptInto(
+        span<const uint8_t> plaintext,
+        std::map<std::string, std::string> encoding_attributes,
+        const OutputBufferAllocator& allocate_output);
+
+    std::unique_ptr<DecryptionResult> DecryptInto(
+        span<const uint8_t> ciphertext,
+        std::map<std::string, std::string> encoding_attributes,
+        span<uint8_t> output);
+
+    std::unique_ptr<DecryptionResult> DecryptInto(
+        span<const uint8_t> ciphertext,
+        std::map<std::string, std::string> encoding_attributes,
+        const OutputBufferAllocator& allocate_output);
+
+    /*
+     * Upper bound of the ciphertext size of Encrypt/EncryptInto for a plaintext page of plaintext_size bytes.
+     * Returns std::nullopt if the agent is not initialized, the attributes are invalid, or the bound depends
+     * on the payload itself (pages encrypted per-value with a compressed payload).
+     */
+    std::optional<std::size_t> MaxCiphertextSize(
+        std::size_t plaintext_size,
+        const std::map<std::string, std::string>& encoding_attributes) const;
+
+    /*
+     * Batch variants of Encrypt/Decrypt for many pages of the same column.
+     * All pages are processed in one call and returned in a single contiguous buffer with per-page views.
+     * The batch fails as a whole if any page fails; the error message names the failed page index.
+     */
+    std::unique_ptr<LocalBatchResult> EncryptBatch(std::vector<LocalBatchPage> pages);
+
+    std::unique_ptr<LocalBatchResult> DecryptBatch(std::vector<LocalBatchPage> pages);
     
     ~LocalDataBatchProtectionAgent() override = default;
 
@@ -127,6 +267,9 @@ protected:
     // std::nullopt = not initialized, "error message" = failed, "" = success
     std::optional<std::string> initialized_;
     std::string user_id_;
+
+    // Column-level context built once on init() and shared by every Encrypt/Decrypt call.
+    std::shared_ptr<const ColumnEncryptionContext> column_context_;
 };
 
 } // namespace dbps::external
@@ -151,6 +151,52 @@ TEST_F(LocalDataBatchProtectionAgentTest, RoundTripEncryptDecrypt) {
     EXPECT_EQ(original_data, decrypted_data);
 }
 
+// Test that one initialized agent serves many pages of the same column
+TEST_F(LocalDataBatchProtectionAgentTest, MultiplePagesWithSameAgent) {
+    LocalDataBatchProtectionAgent encrypt_agent;
+    std::string app_context = R"({"user_id": "test_user"})";
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+    for (const std::string value : {"page_one", "page_two", "page_three"}) {
+        std::vector<uint8_t> original_data = BuildByteArrayValueBytesForTesting(value);
+        auto encrypt_result = encrypt_agent.Encrypt(original_data, encoding_attributes);
+        ASSERT_NE(encrypt_result, nullptr);
+        ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+
+        LocalDataBatchProtectionAgent decrypt_agent;
+        EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                           Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                           encrypt_result->encryption_metadata()));
+        auto ciphertext_span = encrypt_result->ciphertext();
+        std::vector<uint8_t> ciphertext(ciphertext_span.begin(), ciphertext_span.end());
+        auto decrypt_result = decrypt_agent.Decrypt(ciphertext, encoding_attributes);
+        ASSERT_NE(decrypt_result, nullptr);
+        ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+
+        auto plaintext_span = decrypt_result->plaintext();
+        EXPECT_EQ(std::vector<uint8_t>(plaintext_span.begin(), plaintext_span.end()), original_data);
+    }
+}
+
+// Test column-level validation errors are reported on each call
+TEST_F(LocalDataBatchProtectionAgentTest, EmptyKeyIdReportedOnEncrypt) {
+    LocalDataBatchProtectionAgent agent;
+    std::string app_context = R"({"user_id": "test_user"})";
+    EXPECT_NO_THROW(agent.init("test_column", {}, app_context, "",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::vector<uint8_t> test_data = BuildByteArrayValueBytesForTesting("test_ABC");
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+    for (int page = 0; page < 2; ++page) {
+        auto result = agent.Encrypt(test_data, encoding_attributes);
+        ASSERT_NE(result, nullptr);
+        EXPECT_FALSE(result->success());
+        EXPECT_TRUE(result->error_message().find("key_id") != std::string::npos);
+    }
+}
+
 // Test encryption without initialization
 TEST_F(LocalDataBatchProtectionAgentTest, EncryptWithoutInit) {
     LocalDataBatchProtectionAgent agent;
@@ -211,6 +257,451 @@ TEST_F(LocalDataBatchProtectionAgentTest, MissingPageEncoding) {
     EXPECT_TRUE(result->error_message().find("page_encoding") != std::string::npos);
 }
 
+// Test batch encryption and decryption of several pages with one call each
+TEST_F(LocalDataBatchProtectionAgentTest, BatchRoundTrip) {
+    LocalDataBatchProtectionAgent encrypt_agent;
+    std::string app_context = R"({"user_id": "test_user"})";
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+    std::vector<std::vector<uint8_t>> original_pages = {
+        BuildByteArrayValueBytesForTesting("page_one"),
+        BuildByteArrayValueBytesForTesting("page_two"),
+        BuildByteArrayValueBytesForTesting("page_three")};
+    std::vector<LocalBatchPage> plaintext_pages;
+    for (const auto& page : original_pages) {
+        plaintext_pages.push_back({page, encoding_attributes});
+    }
+
+    auto encrypt_result = encrypt_agent.EncryptBatch(plaintext_pages);
+    ASSERT_NE(encrypt_result, nullptr);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    ASSERT_EQ(encrypt_result->num_pages(), original_pages.size());
+
+    // Each batch page matches the result of the single-page call.
+    std::vector<LocalBatchPage> ciphertext_pages;
+    for (size_t i = 0; i < original_pages.size(); ++i) {
+        auto single_result = encrypt_agent.Encrypt(original_pages[i], encoding_attributes);
+        ASSERT_TRUE(single_result->success());
+        auto single_ciphertext = single_result->ciphertext();
+        auto batch_ciphertext = encrypt_result->page(i);
+        EXPECT_EQ(std::vector<uint8_t>(batch_ciphertext.begin(), batch_ciphertext.end()),
+                  std::vector<uint8_t>(single_ciphertext.begin(), single_ciphertext.end()));
+        EXPECT_EQ(encrypt_result->page_encryption_metadata(i), single_result->encryption_metadata());
+        ciphertext_pages.push_back({batch_ciphertext, encoding_attributes});
+    }
+
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->page_encryption_metadata(0)));
+    auto decrypt_result = decrypt_agent.DecryptBatch(ciphertext_pages);
+    ASSERT_NE(decrypt_result, nullptr);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    ASSERT_EQ(decrypt_result->num_pages(), original_pages.size());
+    for (size_t i = 0; i < original_pages.size(); ++i) {
+        auto plaintext = decrypt_result->page(i);
+        EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_pages[i]);
+    }
+}
+
+// Test batch decryption uses each page's own encryption metadata
+TEST_F(LocalDataBatchProtectionAgentTest, BatchDecryptWithPerPageMetadata) {
+    LocalDataBatchProtectionAgent encrypt_agent;
+    std::string app_context = R"({"user_id": "test_user"})";
+    const std::map<std::string, std::string> columnar_config = {{"columnar_value_lists", "true"}};
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", columnar_config, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    // A dictionary page holds a columnar value list (v0.02), the index page is encrypted per block (v0.01).
+    std::vector<std::vector<uint8_t>> original_pages = {
+        BuildByteArrayValueBytesForTesting("dictionary_value"),
+        {0x02, 0x06, 0x01, 0x03, 0x02, 0x00}};
+    std::vector<std::map<std::string, std::string>> page_attributes = {
+        {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}},
+        {{"page_encoding", "RLE_DICTIONARY"}, {"page_type", "DATA_PAGE_V1"}, {"data_page_num_values", "6"},
+         {"data_page_max_definition_level", "0"}, {"data_page_max_repetition_level", "0"},
+         {"page_v1_definition_level_encoding", "RLE"}, {"page_v1_repetition_level_encoding", "RLE"}}};
+    std::vector<LocalBatchPage> plaintext_pages;
+    for (size_t i = 0; i < original_pages.size(); ++i) {
+        plaintext_pages.push_back({original_pages[i], page_attributes[i]});
+    }
+    auto encrypt_result = encrypt_agent.EncryptBatch(plaintext_pages);
+    ASSERT_NE(encrypt_result, nullptr);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    EXPECT_EQ(encrypt_result->page_encryption_metadata(0).at("dbps_agent_version"), "v0.02");
+    EXPECT_EQ(encrypt_result->page_encryption_metadata(1).at("dbps_agent_version"), "v0.01");
+
+    std::vector<LocalBatchPage> ciphertext_pages;
+    for (size_t i = 0; i < original_pages.size(); ++i) {
+        ciphertext_pages.push_back(
+            {encrypt_result->page(i), page_attributes[i], encrypt_result->page_encryption_metadata(i)});
+    }
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", columnar_config, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->page_encryption_metadata(1)));
+    auto decrypt_result = decrypt_agent.DecryptBatch(ciphertext_pages);
+    ASSERT_NE(decrypt_result, nullptr);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    ASSERT_EQ(decrypt_result->num_pages(), original_pages.size());
+    for (size_t i = 0; i < original_pages.size(); ++i) {
+        auto plaintext = decrypt_result->page(i);
+        EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_pages[i]);
+    }
+}
+
+// Test batch errors name the failed page
+TEST_F(LocalDataBatchProtectionAgentTest, BatchMissingPageEncoding) {
+    LocalDataBatchProtectionAgent agent;
+    std::string app_context = R"({"user_id": "test_user"})";
+    EXPECT_NO_THROW(agent.init("test_column", {}, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::vector<uint8_t> test_data = BuildByteArrayValueBytesForTesting("test_ABC");
+    std::vector<LocalBatchPage> pages = {
+        {test_data, {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}}},
+        {test_data, {{"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}}}};
+    auto result = agent.EncryptBatch(pages);
+
+    ASSERT_NE(result, nullptr);
+    EXPECT_FALSE(result->success());
+    EXPECT_EQ(result->num_pages(), 0u);
+    EXPECT_TRUE(result->error_message().find("page 1") != std::string::npos);
+    EXPECT_TRUE(result->error_message().find("page_encoding") != std::string::npos);
+}
+
+// Test batch calls without initialization
+TEST_F(LocalDataBatchProtectionAgentTest, BatchWithoutInit) {
+    LocalDataBatchProtectionAgent agent;
+
+    std::vector<uint8_t> test_data = {1, 2, 3, 4};
+    std::vector<LocalBatchPage> pages = {
+        {test_data, {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}}}};
+    auto encrypt_result = agent.EncryptBatch(pages);
+    ASSERT_NE(encrypt_result, nullptr);
+    EXPECT_FALSE(encrypt_result->success());
+    EXPECT_TRUE(encrypt_result->error_message().find("init() was not called") != std::string::npos);
+
+    auto decrypt_result = agent.DecryptBatch(pages);
+    ASSERT_NE(decrypt_result, nullptr);
+    EXPECT_FALSE(decrypt_result->success());
+    EXPECT_TRUE(decrypt_result->error_message().find("init() was not called") != std::string::npos);
+}
+
+// Test the parallel threshold configuration key is honored and validated
+TEST_F(LocalDataBatchProtectionAgentTest, ParallelThresholdConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::vector<RawValueBytes> elements;
+    for (int i = 0; i < 200; ++i) {
+        std::string value = "value_" + std::to_string(i);
+        elements.emplace_back(value.begin(), value.end());
+    }
+    std::vector<uint8_t> original_data = CombineRawBytesIntoValueBytesForTesting(
+        elements, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "200"}};
+
+    // Threshold of 1 byte runs every per-value page in parallel; "0" disables it.
+    std::vector<std::vector<uint8_t>> ciphertexts;
+    for (const std::string threshold : {"1", "0"}) {
+        LocalDataBatchProtectionAgent agent;
+        EXPECT_NO_THROW(agent.init("test_column", {{"value_encryption_parallel_threshold_bytes", threshold}}, app_context, "test_key",
+                                   Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+        auto encrypt_result = agent.Encrypt(original_data, encoding_attributes);
+        ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+        auto ciphertext = encrypt_result->ciphertext();
+        ciphertexts.emplace_back(ciphertext.begin(), ciphertext.end());
+    }
+    EXPECT_EQ(ciphertexts[0], ciphertexts[1]);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"value_encryption_parallel_threshold_bytes", "abc"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+// Test streaming_chunk_size_bytes enables the chunked streaming mode for every page of the column
+TEST_F(LocalDataBatchProtectionAgentTest, StreamingChunkSizeConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::vector<uint8_t> original_data = CombineRawBytesIntoValueBytesForTesting(
+        {{'s', 't', 'r', 'e', 'a', 'm'}, {'e', 'd'}, {'v', 'a', 'l', 'u', 'e', 's'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "3"}};
+
+    LocalDataBatchProtectionAgent agent;
+    EXPECT_NO_THROW(agent.init("test_column", {{"streaming_chunk_size_bytes", "8"}}, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto encrypt_result = agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    auto encryption_metadata = encrypt_result->encryption_metadata();
+    ASSERT_TRUE(encryption_metadata.has_value());
+    EXPECT_EQ(encryption_metadata->at("encrypt_framing"), "chunked");
+
+    // Decryption follows the encryption metadata, whatever the agent configuration.
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, encryption_metadata));
+    auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"streaming_chunk_size_bytes", "abc"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+// Test dictionary index passthrough configuration
+TEST_F(LocalDataBatchProtectionAgentTest, DictionaryIndexPassthroughConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::vector<uint8_t> index_page = {0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    std::map<std::string, std::string> encoding_attributes = {
+        {"page_encoding", "RLE_DICTIONARY"}, {"page_type", "DATA_PAGE_V1"}, {"data_page_num_values", "6"},
+        {"data_page_max_definition_level", "0"}, {"data_page_max_repetition_level", "0"},
+        {"page_v1_definition_level_encoding", "RLE"}, {"page_v1_repetition_level_encoding", "RLE"}};
+
+    // The XOR encryptor of the agent has no block tags, so passthrough pages need the insecure checksum opt-in.
+    LocalDataBatchProtectionAgent rejected_agent;
+    EXPECT_NO_THROW(rejected_agent.init("test_column", {{"dictionary_index_passthrough", "true"}}, app_context,
+                                        "test_key", Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                        std::nullopt));
+    EXPECT_FALSE(rejected_agent.Encrypt(index_page, encoding_attributes)->success());
+
+    const std::map<std::string, std::string> insecure_checksum = {{"insecure_dictionary_index_checksum", "true"}};
+    std::map<std::string, std::string> passthrough_configuration = insecure_checksum;
+    passthrough_configuration["dictionary_index_passthrough"] = "true";
+    LocalDataBatchProtectionAgent agent;
+    EXPECT_NO_THROW(agent.init("test_column", passthrough_configuration, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto encrypt_result = agent.Encrypt(index_page, encoding_attributes);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    auto encryption_metadata = encrypt_result->encryption_metadata();
+    ASSERT_TRUE(encryption_metadata.has_value());
+    EXPECT_EQ(encryption_metadata->at("encrypt_mode_data_page"), "dictionary_index_passthrough");
+
+    LocalDataBatchProtectionAgent checking_agent;
+    EXPECT_NO_THROW(checking_agent.init("test_column", {}, app_context, "test_key",
+                                        Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, encryption_metadata));
+    EXPECT_FALSE(checking_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes)->success());
+
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", insecure_checksum, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, encryption_metadata));
+    auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), index_page);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"dictionary_index_passthrough", "yes"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+    EXPECT_THROW(invalid_agent.init("test_column", {{"insecure_dictionary_index_checksum", "yes"}}, app_context,
+                                    "test_key", Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                    std::nullopt), DBPSException);
+}
+
+// Test buffer pool configuration
+TEST_F(LocalDataBatchProtectionAgentTest, BufferPoolConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+
+    LocalDataBatchProtectionAgent agent;
+    EXPECT_NO_THROW(agent.init("test_column", {{"buffer_pool_max_cached_bytes", "1048576"}}, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    for (const std::string value : {"first pooled page", "second pooled page"}) {
+        std::vector<uint8_t> original_data = BuildByteArrayValueBytesForTesting(value);
+        auto encrypt_result = agent.Encrypt(original_data, encoding_attributes);
+        ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+
+        LocalDataBatchProtectionAgent decrypt_agent;
+        EXPECT_NO_THROW(decrypt_agent.init("test_column", {{"buffer_pool_max_cached_bytes", "1048576"}}, app_context,
+                                           "test_key", Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                           encrypt_result->encryption_metadata()));
+        auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+        ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+        auto plaintext = decrypt_result->plaintext();
+        EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+    }
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"buffer_pool_max_cached_bytes", "lots"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+// Test trusted ciphertext configuration
+TEST_F(LocalDataBatchProtectionAgentTest, TrustedCiphertextConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+    std::vector<uint8_t> original_data = BuildByteArrayValueBytesForTesting("trusted page");
+
+    LocalDataBatchProtectionAgent encrypt_agent;
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto encrypt_result = encrypt_agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {{"trusted_ciphertext", "true"}}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->encryption_metadata()));
+    auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"trusted_ciphertext", "1"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+TEST_F(LocalDataBatchProtectionAgentTest, ValueDedupConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "200"}};
+    std::vector<uint8_t> original_data;
+    for (int i = 0; i < 200; ++i) {
+        auto value = BuildByteArrayValueBytesForTesting(i % 3 == 0 ? "rejected" : "accepted");
+        original_data.insert(original_data.end(), value.begin(), value.end());
+    }
+
+    LocalDataBatchProtectionAgent encrypt_agent;
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", {{"value_dedup", "dictionary"}}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto encrypt_result = encrypt_agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    EXPECT_LT(encrypt_result->size(), original_data.size());
+
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->encryption_metadata()));
+    auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"value_dedup", "on"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+TEST_F(LocalDataBatchProtectionAgentTest, ColumnarValueListsConfiguration) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "200"}};
+    std::vector<uint8_t> original_data;
+    for (int i = 0; i < 200; ++i) {
+        auto value = BuildByteArrayValueBytesForTesting("value_" + std::to_string(i));
+        original_data.insert(original_data.end(), value.begin(), value.end());
+    }
+
+    LocalDataBatchProtectionAgent row_agent;
+    EXPECT_NO_THROW(row_agent.init("test_column", {}, app_context, "test_key",
+                                   Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto row_result = row_agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(row_result->success()) << row_result->error_message();
+
+    LocalDataBatchProtectionAgent encrypt_agent;
+    EXPECT_NO_THROW(encrypt_agent.init("test_column", {{"columnar_value_lists", "true"}}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+    auto encrypt_result = encrypt_agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    EXPECT_LT(encrypt_result->size(), row_result->size());
+
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->encryption_metadata()));
+    auto decrypt_result = decrypt_agent.Decrypt(encrypt_result->ciphertext(), encoding_attributes);
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+
+    LocalDataBatchProtectionAgent invalid_agent;
+    EXPECT_THROW(invalid_agent.init("test_column", {{"columnar_value_lists", "yes"}}, app_context, "test_key",
+                                    Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt), DBPSException);
+}
+
+// Test EncryptInto/DecryptInto write into caller-owned memory and reference it from the result
+TEST_F(LocalDataBatchProtectionAgentTest, EncryptDecryptIntoCallerBuffer) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    LocalDataBatchProtectionAgent agent;
+    EXPECT_NO_THROW(agent.init("test_column", {}, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::vector<uint8_t> original_data = BuildByteArrayValueBytesForTesting("caller_buffer");
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+
+    auto max_ciphertext_size = agent.MaxCiphertextSize(original_data.size(), encoding_attributes);
+    ASSERT_TRUE(max_ciphertext_size.has_value());
+
+    std::vector<uint8_t> page_buffer(max_ciphertext_size.value());
+    auto encrypt_result = agent.EncryptInto(original_data, encoding_attributes, span<uint8_t>(page_buffer));
+    ASSERT_TRUE(encrypt_result->success()) << encrypt_result->error_message();
+    EXPECT_EQ(encrypt_result->ciphertext().data(), page_buffer.data());
+    EXPECT_LE(encrypt_result->size(), max_ciphertext_size.value());
+
+    // Same ciphertext and metadata as the owning Encrypt call.
+    auto owned_result = agent.Encrypt(original_data, encoding_attributes);
+    ASSERT_TRUE(owned_result->success());
+    auto owned_ciphertext = owned_result->ciphertext();
+    auto into_ciphertext = encrypt_result->ciphertext();
+    EXPECT_EQ(std::vector<uint8_t>(into_ciphertext.begin(), into_ciphertext.end()),
+              std::vector<uint8_t>(owned_ciphertext.begin(), owned_ciphertext.end()));
+    EXPECT_EQ(encrypt_result->encryption_metadata(), owned_result->encryption_metadata());
+
+    // Decrypt through the allocator variant.
+    LocalDataBatchProtectionAgent decrypt_agent;
+    EXPECT_NO_THROW(decrypt_agent.init("test_column", {}, app_context, "test_key",
+                                       Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+                                       encrypt_result->encryption_metadata()));
+    std::vector<uint8_t> plaintext_buffer;
+    auto decrypt_result = decrypt_agent.DecryptInto(
+        encrypt_result->ciphertext(), encoding_attributes, [&](std::size_t max_size) {
+            plaintext_buffer.resize(max_size);
+            return span<uint8_t>(plaintext_buffer);
+        });
+    ASSERT_TRUE(decrypt_result->success()) << decrypt_result->error_message();
+    EXPECT_EQ(decrypt_result->plaintext().data(), plaintext_buffer.data());
+    auto plaintext = decrypt_result->plaintext();
+    EXPECT_EQ(std::vector<uint8_t>(plaintext.begin(), plaintext.end()), original_data);
+}
+
+// Test EncryptInto reports a caller buffer that is too small
+TEST_F(LocalDataBatchProtectionAgentTest, EncryptIntoBufferTooSmall) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    LocalDataBatchProtectionAgent agent;
+    EXPECT_NO_THROW(agent.init("test_column", {}, app_context, "test_key",
+                               Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, std::nullopt));
+
+    std::vector<uint8_t> original_data = BuildByteArrayValueBytesForTesting("too_small");
+    std::map<std::string, std::string> encoding_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+
+    std::vector<uint8_t> page_buffer(4);
+    auto result = agent.EncryptInto(original_data, encoding_attributes, span<uint8_t>(page_buffer));
+    EXPECT_FALSE(result->success());
+    EXPECT_EQ(result->error_fields().at("error_stage"), "output_allocation");
+    EXPECT_EQ(result->size(), 0u);
+}
+
+// Test MaxCiphertextSize is only available when the bound does not depend on the payload
+TEST_F(LocalDataBatchProtectionAgentTest, MaxCiphertextSizeBounds) {
+    std::string app_context = R"({"user_id": "test_user"})";
+    std::map<std::string, std::string> plain_attributes = {{"page_encoding", "PLAIN"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+    std::map<std::string, std::string> dictionary_attributes = {{"page_encoding", "RLE_DICTIONARY"}, {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+
+    LocalDataBatchProtectionAgent not_initialized_agent;
+    EXPECT_FALSE(not_initialized_agent.MaxCiphertextSize(100, plain_attributes).has_value());
+
+    LocalDataBatchProtectionAgent snappy_agent;
+    EXPECT_NO_THROW(snappy_agent.init("test_column", {}, app_context, "test_key",
+                                      Type::INT32, std::nullopt, CompressionCodec::SNAPPY, std::nullopt));
+
+    // Per-block pages are bounded by the block encryptor: XOR is length-preserving.
+    EXPECT_EQ(snappy_agent.MaxCiphertextSize(100, dictionary_attributes), std::optional<std::size_t>(100));
+    // Per-value pages with a compressed payload depend on the decompressed size.
+    EXPECT_FALSE(snappy_agent.MaxCiphertextSize(100, plain_attributes).has_value());
+    // Missing page_encoding
+    EXPECT_FALSE(snappy_agent.MaxCiphertextSize(100, {{"page_type", "DICTIONARY_PAGE"}}).has_value());
+}
+
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
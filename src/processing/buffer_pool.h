@@ -0,0 +1,269 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dbps::processing {
+
+struct BufferPoolOptions {
+    // Number of recycling pools. Threads are spread round-robin over them on first use, so with at least as
+    // many pools as threads every thread recycles into its own pool. 0 uses the hardware concurrency.
+    size_t num_shards = 0;
+
+    // Bounds of the memory kept for reuse by each pool. Released buffers beyond them are freed.
+    size_t max_cached_buffers_per_shard = 16;
+    size_t max_cached_bytes_per_shard = size_t{64} << 20;
+};
+
+// Counters of a BufferPool, accumulated since its construction.
+struct BufferPoolStats {
+    // Buffers handed out by Acquire/AcquireUninitialized, and their total capacity.
+    uint64_t acquisitions = 0;
+    uint64_t bytes_served = 0;
+
+    // Acquisitions that could not reuse a cached buffer and went to the heap, and the bytes they allocated.
+    uint64_t heap_allocations = 0;
+    uint64_t heap_bytes_allocated = 0;
+
+    // Buffers handed back by Release, and those freed instead of cached because a pool was full.
+    uint64_t releases = 0;
+    uint64_t discarded_releases = 0;
+
+    // Capacity currently cached for reuse across all pools.
+    uint64_t cached_bytes = 0;
+};
+
+// -----------------------------------------------------------------------------
+// BufferPool
+//
+// Recycles the byte vectors of the page pipeline (ByteBuffer write buffers, decompression outputs, per-value
+// ciphertexts) so steady-state pages reuse warm memory instead of going through malloc/free and fresh page
+// faults for every page.
+//
+// Buffers are plain std::vector<uint8_t>, so pooled buffers flow through the existing APIs unchanged: a
+// buffer acquired from the pool can be moved anywhere, and any vector can be released into the pool.
+// Each thread recycles into its own pool (see BufferPoolOptions::num_shards), so the pool lock is uncontended
+// in practice. Acquire picks the smallest cached buffer that is large enough.
+//
+// Like std::pmr::get_default_resource, each thread has a current default pool, installed with ScopedDefault.
+// AcquireBuffer/AcquireUninitializedBuffer/ReleaseBuffer use it and fall back to the heap when there is none,
+// so components such as encryptors draw from the pool of the sequencer calling them without an explicit
+// parameter.
+// -----------------------------------------------------------------------------
+class BufferPool {
+public:
+    explicit BufferPool(BufferPoolOptions options = {})
+        : options_(options),
+          shards_(options.num_shards > 0 ? options.num_shards
+                                         : std::max<size_t>(1, std::thread::hardware_concurrency())) {}
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Returns an empty buffer with a capacity of at least min_capacity.
+    std::vector<uint8_t> Acquire(size_t min_capacity) {
+        auto buffer = Take(min_capacity);
+        buffer.clear();
+        buffer.reserve(min_capacity);
+        return buffer;
+    }
+
+    /**
+     * Returns a buffer of exactly `size` bytes whose contents are unspecified. Only the bytes that were never
+     * used before are zero-filled, so recycled memory is not cleared again.
+     * Recycled bytes may hold data of earlier pages (including plaintext), so this is only for buffers that
+     * are fully overwritten before they are read or handed out.
+     */
+    std::vector<uint8_t> AcquireUninitialized(size_t size) {
+        auto buffer = Take(size);
+        buffer.resize(size);
+        return buffer;
+    }
+
+    // Hands a buffer back for reuse. Its size is kept (see AcquireUninitialized). Buffers that are not cached
+    // are freed.
+    void Release(std::vector<uint8_t> buffer) {
+        const size_t capacity = buffer.capacity();
+        if (capacity == 0) {
+            return;
+        }
+        releases_.fetch_add(1, std::memory_order_relaxed);
+        if (capacity > options_.max_cached_bytes_per_shard || options_.max_cached_buffers_per_shard == 0) {
+            discarded_releases_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // The evicted buffers (or the released one, if the pool is full of larger buffers) are freed
+        // after the lock is released.
+        std::vector<std::vector<uint8_t>> to_free;
+        auto& shard = GetThreadShard();
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            while (shard.buffers.size() >= options_.max_cached_buffers_per_shard ||
+                   shard.cached_bytes + capacity > options_.max_cached_bytes_per_shard) {
+                // Evict the smallest cached buffer, as long as it is smaller than the released one.
+                auto smallest = std::min_element(shard.buffers.begin(), shard.buffers.end(),
+                    [](const auto& a, const auto& b) { return a.capacity() < b.capacity(); });
+                if (smallest == shard.buffers.end() || smallest->capacity() >= capacity) {
+                    break;
+                }
+                shard.cached_bytes -= smallest->capacity();
+                cached_bytes_.fetch_sub(smallest->capacity(), std::memory_order_relaxed);
+                to_free.push_back(std::move(*smallest));
+                *smallest = std::move(shard.buffers.back());
+                shard.buffers.pop_back();
+            }
+            if (shard.buffers.size() < options_.max_cached_buffers_per_shard &&
+                shard.cached_bytes + capacity <= options_.max_cached_bytes_per_shard) {
+                shard.cached_bytes += capacity;
+                cached_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+                shard.buffers.push_back(std::move(buffer));
+                return;
+            }
+        }
+        discarded_releases_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    BufferPoolStats GetStats() const {
+        BufferPoolStats stats;
+        stats.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+        stats.bytes_served = bytes_served_.load(std::memory_order_relaxed);
+        stats.heap_allocations = heap_allocations_.load(std::memory_order_relaxed);
+        stats.heap_bytes_allocated = heap_bytes_allocated_.load(std::memory_order_relaxed);
+        stats.releases = releases_.load(std::memory_order_relaxed);
+        stats.discarded_releases = discarded_releases_.load(std::memory_order_relaxed);
+        stats.cached_bytes = cached_bytes_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Default pool of the calling thread, or nullptr if none is installed.
+    static BufferPool* GetDefault() { return CurrentDefault(); }
+
+    // Installs a default pool on the calling thread for the lifetime of the scope, restoring the previous one
+    // afterwards. A null pool keeps the current default.
+    class ScopedDefault {
+    public:
+        explicit ScopedDefault(BufferPool* pool) : previous_(CurrentDefault()) {
+            if (pool != nullptr) {
+                CurrentDefault() = pool;
+            }
+        }
+        ~ScopedDefault() { CurrentDefault() = previous_; }
+
+        ScopedDefault(const ScopedDefault&) = delete;
+        ScopedDefault& operator=(const ScopedDefault&) = delete;
+
+    private:
+        BufferPool* previous_;
+    };
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::vector<std::vector<uint8_t>> buffers;
+        size_t cached_bytes = 0;
+    };
+
+    static BufferPool*& CurrentDefault() {
+        static thread_local BufferPool* current = nullptr;
+        return current;
+    }
+
+    // Threads get consecutive slots on first use, which spreads them evenly over the shards of every pool.
+    Shard& GetThreadShard() {
+        static std::atomic<size_t> next_thread_slot{0};
+        static thread_local const size_t thread_slot = next_thread_slot.fetch_add(1, std::memory_order_relaxed);
+        return shards_[thread_slot % shards_.size()];
+    }
+
+    // Takes the smallest cached buffer with a capacity of at least min_capacity, or a new empty buffer.
+    std::vector<uint8_t> Take(size_t min_capacity) {
+        std::vector<uint8_t> buffer;
+        auto& shard = GetThreadShard();
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto best = shard.buffers.end();
+            for (auto it = shard.buffers.begin(); it != shard.buffers.end(); ++it) {
+                if (it->capacity() >= min_capacity && (best == shard.buffers.end() || it->capacity() < best->capacity())) {
+                    best = it;
+                }
+            }
+            if (best != shard.buffers.end()) {
+                buffer = std::move(*best);
+                *best = std::move(shard.buffers.back());
+                shard.buffers.pop_back();
+                shard.cached_bytes -= buffer.capacity();
+                cached_bytes_.fetch_sub(buffer.capacity(), std::memory_order_relaxed);
+            }
+        }
+        if (buffer.capacity() < min_capacity) {
+            heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+            heap_bytes_allocated_.fetch_add(min_capacity, std::memory_order_relaxed);
+            buffer.reserve(min_capacity);
+        }
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        bytes_served_.fetch_add(buffer.capacity(), std::memory_order_relaxed);
+        return buffer;
+    }
+
+    const BufferPoolOptions options_;
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> acquisitions_{0};
+    std::atomic<uint64_t> bytes_served_{0};
+    std::atomic<uint64_t> heap_allocations_{0};
+    std::atomic<uint64_t> heap_bytes_allocated_{0};
+    std::atomic<uint64_t> releases_{0};
+    std::atomic<uint64_t> discarded_releases_{0};
+    std::atomic<uint64_t> cached_bytes_{0};
+};
+
+// Acquire/AcquireUninitialized/Release on the default pool of the calling thread, or on the heap without one.
+
+inline std::vector<uint8_t> AcquireBuffer(size_t min_capacity) {
+    if (auto* pool = BufferPool::GetDefault()) {
+        return pool->Acquire(min_capacity);
+    }
+    std::vector<uint8_t> buffer;
+    buffer.reserve(min_capacity);
+    return buffer;
+}
+
+inline std::vector<uint8_t> AcquireUninitializedBuffer(size_t size) {
+    if (auto* pool = BufferPool::GetDefault()) {
+        return pool->AcquireUninitialized(size);
+    }
+    return std::vector<uint8_t>(size);
+}
+
+inline void ReleaseBuffer(std::vector<uint8_t> buffer) {
+    if (auto* pool = BufferPool::GetDefault()) {
+        pool->Release(std::move(buffer));
+    }
+}
+
+} // namespace dbps::processing
@@ -0,0 +1,227 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "buffer_pool.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "typed_buffer.h"
+#include "typed_buffer_values.h"
+
+using namespace dbps::processing;
+
+namespace {
+    BufferPoolOptions SingleShardOptions() {
+        BufferPoolOptions options;
+        options.num_shards = 1;
+        return options;
+    }
+}
+
+TEST(BufferPoolTest, AcquireAllocatesFromHeapWhenEmpty) {
+    BufferPool pool(SingleShardOptions());
+    auto buffer = pool.Acquire(100);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_GE(buffer.capacity(), 100u);
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.acquisitions, 1u);
+    EXPECT_EQ(stats.heap_allocations, 1u);
+    EXPECT_EQ(stats.heap_bytes_allocated, 100u);
+    EXPECT_GE(stats.bytes_served, 100u);
+}
+
+TEST(BufferPoolTest, ReleasedBufferIsReused) {
+    BufferPool pool(SingleShardOptions());
+    auto buffer = pool.Acquire(256);
+    const uint8_t* data = buffer.data();
+    pool.Release(std::move(buffer));
+    EXPECT_EQ(pool.GetStats().cached_bytes, 256u);
+
+    auto reused = pool.Acquire(200);
+    EXPECT_EQ(reused.data(), data);
+    EXPECT_TRUE(reused.empty());
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_EQ(stats.heap_allocations, 1u);
+    EXPECT_EQ(stats.releases, 1u);
+    EXPECT_EQ(stats.cached_bytes, 0u);
+}
+
+TEST(BufferPoolTest, AcquirePicksSmallestLargeEnoughBuffer) {
+    BufferPool pool(SingleShardOptions());
+    auto small = pool.Acquire(64);
+    auto medium = pool.Acquire(512);
+    auto large = pool.Acquire(4096);
+    const uint8_t* medium_data = medium.data();
+    pool.Release(std::move(large));
+    pool.Release(std::move(small));
+    pool.Release(std::move(medium));
+
+    auto buffer = pool.Acquire(300);
+    EXPECT_EQ(buffer.data(), medium_data);
+
+    // Nothing cached is large enough: a new buffer comes from the heap.
+    auto larger = pool.Acquire(8192);
+    EXPECT_EQ(pool.GetStats().heap_allocations, 4u);
+}
+
+TEST(BufferPoolTest, AcquireUninitializedKeepsRecycledBytes) {
+    BufferPool pool(SingleShardOptions());
+    auto buffer = pool.AcquireUninitialized(8);
+    ASSERT_EQ(buffer.size(), 8u);
+    for (auto& byte : buffer) {
+        byte = 0xAB;
+    }
+    pool.Release(std::move(buffer));
+
+    // The recycled bytes are not cleared, and only the bytes never used before are zero-filled.
+    buffer = pool.AcquireUninitialized(4);
+    ASSERT_EQ(buffer.size(), 4u);
+    EXPECT_EQ(buffer[0], 0xAB);
+    EXPECT_EQ(buffer[3], 0xAB);
+}
+
+TEST(BufferPoolTest, ReleaseRespectsLimits) {
+    BufferPoolOptions options = SingleShardOptions();
+    options.max_cached_buffers_per_shard = 2;
+    options.max_cached_bytes_per_shard = 1000;
+    BufferPool pool(options);
+
+    // Larger than the whole pool: freed.
+    std::vector<uint8_t> huge;
+    huge.reserve(2000);
+    pool.Release(std::move(huge));
+    EXPECT_EQ(pool.GetStats().discarded_releases, 1u);
+    EXPECT_EQ(pool.GetStats().cached_bytes, 0u);
+
+    std::vector<uint8_t> a, b, c;
+    a.reserve(100);
+    b.reserve(200);
+    c.reserve(300);
+    pool.Release(std::move(a));
+    pool.Release(std::move(b));
+
+    // The pool is full: the smallest cached buffer is evicted for a larger one.
+    pool.Release(std::move(c));
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.cached_bytes, 500u);
+    EXPECT_EQ(stats.discarded_releases, 1u);
+
+    // A buffer smaller than every cached one is freed instead.
+    std::vector<uint8_t> d;
+    d.reserve(50);
+    pool.Release(std::move(d));
+    stats = pool.GetStats();
+    EXPECT_EQ(stats.cached_bytes, 500u);
+    EXPECT_EQ(stats.discarded_releases, 2u);
+    EXPECT_EQ(stats.releases, 5u);
+
+    // Empty buffers are ignored.
+    pool.Release(std::vector<uint8_t>());
+    EXPECT_EQ(pool.GetStats().releases, 5u);
+}
+
+TEST(BufferPoolTest, ThreadsRecycleIntoTheirOwnShard) {
+    BufferPoolOptions options;
+    options.num_shards = 64;
+    BufferPool pool(options);
+
+    auto buffer = pool.Acquire(128);
+    pool.Release(std::move(buffer));
+
+    // Another thread does not see the buffer cached by this one.
+    std::thread([&pool] {
+        auto other = pool.Acquire(128);
+        pool.Release(std::move(other));
+    }).join();
+    EXPECT_EQ(pool.GetStats().heap_allocations, 2u);
+
+    auto reused = pool.Acquire(128);
+    EXPECT_EQ(pool.GetStats().heap_allocations, 2u);
+}
+
+TEST(BufferPoolTest, ScopedDefaultInstallsAndRestoresPool) {
+    EXPECT_EQ(BufferPool::GetDefault(), nullptr);
+    BufferPool outer(SingleShardOptions());
+    BufferPool inner(SingleShardOptions());
+    {
+        BufferPool::ScopedDefault use_outer(&outer);
+        EXPECT_EQ(BufferPool::GetDefault(), &outer);
+        {
+            BufferPool::ScopedDefault use_inner(&inner);
+            EXPECT_EQ(BufferPool::GetDefault(), &inner);
+        }
+        {
+            // A null pool keeps the current default.
+            BufferPool::ScopedDefault use_none(nullptr);
+            EXPECT_EQ(BufferPool::GetDefault(), &outer);
+        }
+        EXPECT_EQ(BufferPool::GetDefault(), &outer);
+    }
+    EXPECT_EQ(BufferPool::GetDefault(), nullptr);
+}
+
+TEST(BufferPoolTest, FreeFunctionsUseDefaultPool) {
+    // Without a default pool, buffers come from the heap and released buffers are freed.
+    auto heap_buffer = AcquireUninitializedBuffer(16);
+    EXPECT_EQ(heap_buffer.size(), 16u);
+    ReleaseBuffer(std::move(heap_buffer));
+
+    BufferPool pool(SingleShardOptions());
+    BufferPool::ScopedDefault use_pool(&pool);
+    auto buffer = AcquireBuffer(32);
+    ReleaseBuffer(std::move(buffer));
+    auto reused = AcquireUninitializedBuffer(24);
+    EXPECT_EQ(reused.size(), 24u);
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_EQ(stats.heap_allocations, 1u);
+    EXPECT_EQ(stats.releases, 1u);
+}
+
+TEST(BufferPoolTest, ByteBufferWriteBuffersComeFromDefaultPool) {
+    BufferPool pool(SingleShardOptions());
+    BufferPool::ScopedDefault use_pool(&pool);
+
+    std::vector<uint8_t> first;
+    {
+        TypedBufferI32 buffer(4);
+        for (size_t i = 0; i < 4; ++i) {
+            buffer.SetElement(i, static_cast<int32_t>(i));
+        }
+        first = buffer.FinalizeAndTakeBuffer();
+    }
+    const uint8_t* first_data = first.data();
+    ReleaseBuffer(std::move(first));
+
+    // The next write buffer reuses the released memory as-is: every slot is written before it is taken.
+    TypedBufferI32 buffer(4);
+    for (size_t i = 0; i < 4; ++i) {
+        buffer.SetElement(3 - i, static_cast<int32_t>(7 + i));
+    }
+    auto second = buffer.FinalizeAndTakeBuffer();
+    EXPECT_EQ(second.data(), first_data);
+    EXPECT_EQ(second, std::vector<uint8_t>({10, 0, 0, 0, 9, 0, 0, 0, 8, 0, 0, 0, 7, 0, 0, 0}));
+    EXPECT_EQ(pool.GetStats().heap_allocations, 1u);
+}
@@ -0,0 +1,214 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <tcb/span.hpp>
+
+#include "buffer_pool.h"
+#include "bytes_utils.h"
+#include "exceptions.h"
+#include "typed_buffer_values.h"
+
+namespace dbps::processing {
+
+// -----------------------------------------------------------------------------
+// ByteArrayOffsetsBuffer
+//
+// Variable-size elements in an Arrow-style layout: a single data region holding all element bytes
+// back-to-back, plus num_elements + 1 offsets into it. Element i is data[offsets[i], offsets[i + 1]).
+//
+// ByteBuffer<RawBytesVariableSizedCodec> interleaves a [u32 size] prefix with every element, so element
+// bytes can only be visited one span at a time. Here they form one contiguous range, which a transform
+// (e.g. a vectorized encryption kernel) can process in a single call, using the offsets only where element
+// boundaries matter.
+//
+// Conversions to and from Parquet PLAIN BYTE_ARRAY value bytes ([u32 size][element] records) take a single
+// pass. Offsets are 32-bit, like the PLAIN size prefixes, so the data region is limited to 4 GiB.
+//
+// The columnar value lists of ciphertext format v0.02 are built from this layout (see
+// DBPSEncryptor::EncryptColumnarValuesInto): the data region becomes their payload region in one kernel call.
+// The converted data region comes from the buffer pool; Release() hands it back once the buffer is consumed.
+// -----------------------------------------------------------------------------
+
+class ByteArrayOffsetsBuffer {
+public:
+    // Empty buffer.
+    ByteArrayOffsetsBuffer() : offsets_(1, 0) {}
+
+    // Takes ownership of an offsets array and data region.
+    // Offsets must start at 0, be non-decreasing and end at data.size().
+    ByteArrayOffsetsBuffer(std::vector<uint32_t> offsets, std::vector<uint8_t> data)
+        : offsets_(std::move(offsets)), data_(std::move(data)) {
+        if (offsets_.empty() || offsets_.front() != 0 || offsets_.back() != data_.size()) {
+            throw InvalidInputException("Malformed offsets buffer: offsets must start at 0 and end at the data size");
+        }
+        for (size_t i = 1; i < offsets_.size(); ++i) {
+            if (offsets_[i] < offsets_[i - 1]) {
+                throw InvalidInputException("Malformed offsets buffer: offsets must be non-decreasing");
+            }
+        }
+    }
+
+    // Converts PLAIN BYTE_ARRAY value bytes in one pass, validating bounds and the element count.
+    static ByteArrayOffsetsBuffer FromPlainValueBytes(tcb::span<const uint8_t> value_bytes, size_t num_elements);
+
+    // Converts a read-only variable-size buffer, whose records are PLAIN BYTE_ARRAY value bytes.
+    static ByteArrayOffsetsBuffer FromTypedBuffer(const TypedBufferRawBytesVariableSized& buffer);
+
+    // Getters
+    size_t GetNumElements() const { return offsets_.size() - 1; }
+    size_t GetDataSize() const { return data_.size(); }
+    tcb::span<const uint8_t> GetData() const { return data_; }
+    tcb::span<uint8_t> GetMutableData() { return data_; }
+    tcb::span<const uint32_t> GetOffsets() const { return offsets_; }
+
+    tcb::span<const uint8_t> GetElement(size_t position) const {
+        if (position >= GetNumElements()) {
+            throw InvalidInputException(
+                "Element index out of bounds during GetElement: index=" + std::to_string(position) +
+                " size=" + std::to_string(GetNumElements()));
+        }
+        return tcb::span<const uint8_t>(data_).subspan(offsets_[position], offsets_[position + 1] - offsets_[position]);
+    }
+
+    // Size of the PLAIN value bytes of the buffer.
+    size_t GetPlainValueBytesSize() const { return GetNumElements() * kSizePrefixBytes + data_.size(); }
+
+    // Writes the PLAIN value bytes into out, which must hold at least GetPlainValueBytesSize() bytes.
+    // Returns the number of bytes written.
+    size_t WritePlainValueBytesInto(tcb::span<uint8_t> out) const;
+
+    std::vector<uint8_t> ToPlainValueBytes() const {
+        std::vector<uint8_t> value_bytes(GetPlainValueBytesSize());
+        WritePlainValueBytesInto(value_bytes);
+        return value_bytes;
+    }
+
+    // Returns the data region to the buffer pool. The buffer is empty afterwards.
+    void Release() {
+        ReleaseBuffer(std::move(data_));
+        data_ = std::vector<uint8_t>();
+        offsets_.assign(1, 0);
+    }
+
+private:
+    std::vector<uint32_t> offsets_;
+    std::vector<uint8_t> data_;
+};
+
+inline ByteArrayOffsetsBuffer ByteArrayOffsetsBuffer::FromPlainValueBytes(
+    tcb::span<const uint8_t> value_bytes, size_t num_elements) {
+    // With valid input, the data size is known upfront: everything but the size prefixes.
+    if (num_elements > value_bytes.size() / kSizePrefixBytes) {
+        throw InvalidInputException("Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+    }
+    const size_t data_size = value_bytes.size() - num_elements * kSizePrefixBytes;
+    if (data_size > std::numeric_limits<uint32_t>::max()) {
+        throw InvalidInputException("ByteArrayOffsetsBuffer: data region exceeds 32-bit offsets");
+    }
+
+    ByteArrayOffsetsBuffer buffer;
+    buffer.offsets_.resize(num_elements + 1);
+    buffer.data_ = AcquireUninitializedBuffer(data_size);
+    const uint8_t* src = value_bytes.data();
+    const size_t end = value_bytes.size();
+    uint32_t* offsets = buffer.offsets_.data();
+    uint8_t* data = buffer.data_.data();
+
+    // Single pass: every record is bounds checked against the input and its bytes appended to the data region.
+    // Since the data region is sized from num_elements, a record that would overflow it means a count mismatch.
+    size_t cursor = 0;
+    size_t data_offset = 0;
+    for (size_t i = 0; i < num_elements; ++i) {
+        if (end - cursor < kSizePrefixBytes) {
+            throw InvalidInputException("Malformed variable-size buffer: truncated length prefix");
+        }
+        const size_t element_size = read_u32_le(src + cursor);
+        cursor += kSizePrefixBytes;
+        if (end - cursor < element_size || data_size - data_offset < element_size) {
+            throw InvalidInputException("Malformed variable-size buffer: truncated element payload");
+        }
+        offsets[i] = static_cast<uint32_t>(data_offset);
+        if (element_size > 0) {
+            std::memcpy(data + data_offset, src + cursor, element_size);
+        }
+        cursor += element_size;
+        data_offset += element_size;
+    }
+    if (cursor != end) {
+        throw InvalidInputException("Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+    }
+    offsets[num_elements] = static_cast<uint32_t>(data_offset);
+    return buffer;
+}
+
+inline ByteArrayOffsetsBuffer ByteArrayOffsetsBuffer::FromTypedBuffer(const TypedBufferRawBytesVariableSized& buffer) {
+    const size_t num_elements = buffer.GetNumElements();
+    const size_t data_size = buffer.GetRecordsSize() - num_elements * kSizePrefixBytes;
+    if (data_size > std::numeric_limits<uint32_t>::max()) {
+        throw InvalidInputException("ByteArrayOffsetsBuffer: data region exceeds 32-bit offsets");
+    }
+
+    ByteArrayOffsetsBuffer result;
+    result.offsets_.resize(num_elements + 1);
+    result.data_ = AcquireUninitializedBuffer(data_size);
+    uint32_t* offsets = result.offsets_.data();
+    uint8_t* data = result.data_.data();
+    size_t data_offset = 0;
+    buffer.ForEachBatch([&](size_t first_position, tcb::span<const tcb::span<const uint8_t>> batch) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            offsets[first_position + i] = static_cast<uint32_t>(data_offset);
+            if (!batch[i].empty()) {
+                std::memcpy(data + data_offset, batch[i].data(), batch[i].size());
+            }
+            data_offset += batch[i].size();
+        }
+    });
+    offsets[num_elements] = static_cast<uint32_t>(data_offset);
+    return result;
+}
+
+inline size_t ByteArrayOffsetsBuffer::WritePlainValueBytesInto(tcb::span<uint8_t> out) const {
+    const size_t plain_size = GetPlainValueBytesSize();
+    if (out.size() < plain_size) {
+        throw InvalidInputException("WritePlainValueBytesInto: output buffer is smaller than the value bytes");
+    }
+    uint8_t* dst = out.data();
+    const uint8_t* data = data_.data();
+    const size_t num_elements = GetNumElements();
+    for (size_t i = 0; i < num_elements; ++i) {
+        const uint32_t element_size = offsets_[i + 1] - offsets_[i];
+        write_u32_le(dst, element_size);
+        dst += kSizePrefixBytes;
+        if (element_size > 0) {
+            std::memcpy(dst, data + offsets_[i], element_size);
+        }
+        dst += element_size;
+    }
+    return plain_size;
+}
+
+} // namespace dbps::processing
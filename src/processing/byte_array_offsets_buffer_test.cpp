@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "byte_array_offsets_buffer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bytes_utils.h"
+#include "exceptions.h"
+
+using dbps::processing::ByteArrayOffsetsBuffer;
+using dbps::processing::TypedBufferRawBytesVariableSized;
+
+namespace {
+    std::vector<uint8_t> MakePlainValueBytes(const std::vector<std::string>& values) {
+        std::vector<uint8_t> value_bytes;
+        for (const auto& value : values) {
+            append_u32_le(value_bytes, static_cast<uint32_t>(value.size()));
+            value_bytes.insert(value_bytes.end(), value.begin(), value.end());
+        }
+        return value_bytes;
+    }
+}
+
+TEST(ByteArrayOffsetsBufferTest, PlainRoundTrip) {
+    const std::vector<std::string> values = {"id-1", "", "code", "a much longer value"};
+    const auto value_bytes = MakePlainValueBytes(values);
+
+    auto buffer = ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, values.size());
+    ASSERT_EQ(buffer.GetNumElements(), values.size());
+    EXPECT_EQ(buffer.GetOffsets().size(), values.size() + 1);
+    EXPECT_EQ(BytesToString(buffer.GetData()), "id-1codea much longer value");
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(BytesToString(buffer.GetElement(i)), values[i]);
+    }
+    EXPECT_THROW((void)buffer.GetElement(values.size()), InvalidInputException);
+
+    EXPECT_EQ(buffer.GetPlainValueBytesSize(), value_bytes.size());
+    EXPECT_EQ(buffer.ToPlainValueBytes(), value_bytes);
+}
+
+TEST(ByteArrayOffsetsBufferTest, ContiguousTransform) {
+    const std::vector<std::string> values = {"abc", "de", "", "f"};
+    auto buffer = ByteArrayOffsetsBuffer::FromPlainValueBytes(MakePlainValueBytes(values), values.size());
+
+    // All element bytes can be transformed as one range.
+    for (auto& byte : buffer.GetMutableData()) {
+        byte = static_cast<uint8_t>(byte - 'a' + 'A');
+    }
+    EXPECT_EQ(buffer.ToPlainValueBytes(), MakePlainValueBytes({"ABC", "DE", "", "F"}));
+}
+
+TEST(ByteArrayOffsetsBufferTest, FromTypedBufferMatchesPlainConversion) {
+    const std::vector<std::string> values = {"status=200", "", "status=404", "x"};
+    const auto value_bytes = MakePlainValueBytes(values);
+    TypedBufferRawBytesVariableSized typed_buffer{tcb::span<const uint8_t>(value_bytes), values.size()};
+
+    auto buffer = ByteArrayOffsetsBuffer::FromTypedBuffer(typed_buffer);
+    auto expected = ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, values.size());
+    EXPECT_EQ(std::vector<uint32_t>(buffer.GetOffsets().begin(), buffer.GetOffsets().end()),
+              std::vector<uint32_t>(expected.GetOffsets().begin(), expected.GetOffsets().end()));
+    EXPECT_EQ(BytesToString(buffer.GetData()), BytesToString(expected.GetData()));
+    EXPECT_EQ(buffer.ToPlainValueBytes(), value_bytes);
+
+    // Release hands the data region back and leaves an empty buffer.
+    buffer.Release();
+    EXPECT_EQ(buffer.GetNumElements(), 0u);
+    EXPECT_EQ(buffer.GetDataSize(), 0u);
+}
+
+TEST(ByteArrayOffsetsBufferTest, Empty) {
+    ByteArrayOffsetsBuffer empty_buffer;
+    EXPECT_EQ(empty_buffer.GetNumElements(), 0u);
+    EXPECT_TRUE(empty_buffer.ToPlainValueBytes().empty());
+
+    auto buffer = ByteArrayOffsetsBuffer::FromPlainValueBytes({}, 0);
+    EXPECT_EQ(buffer.GetNumElements(), 0u);
+}
+
+TEST(ByteArrayOffsetsBufferTest, MalformedInput_Throws) {
+    const auto value_bytes = MakePlainValueBytes({"one", "two", "three"});
+
+    EXPECT_THROW(ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, 2), InvalidInputException);
+    EXPECT_THROW(ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, 4), InvalidInputException);
+    EXPECT_THROW(ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, 100), InvalidInputException);
+    std::vector<uint8_t> truncated(value_bytes.begin(), value_bytes.end() - 1);
+    EXPECT_THROW(ByteArrayOffsetsBuffer::FromPlainValueBytes(truncated, 3), InvalidInputException);
+
+    EXPECT_THROW(ByteArrayOffsetsBuffer({0, 3, 2}, std::vector<uint8_t>(3)), InvalidInputException);
+    EXPECT_THROW(ByteArrayOffsetsBuffer({0, 2}, std::vector<uint8_t>(3)), InvalidInputException);
+    EXPECT_THROW(ByteArrayOffsetsBuffer({}, {}), InvalidInputException);
+
+    auto buffer = ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, 3);
+    std::vector<uint8_t> small_output(value_bytes.size() - 1);
+    EXPECT_THROW(buffer.WritePlainValueBytesInto(small_output), InvalidInputException);
+}
@@ -0,0 +1,294 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tcb/span.hpp>
+
+#include "bytes_utils.h"
+#include "exceptions.h"
+#include "typed_buffer.h"
+
+namespace dbps::processing {
+
+// -----------------------------------------------------------------------------
+// ByteBufferView
+//
+// Immutable, fully indexed read-only view over the same [prefix][elements] layout as a read-only ByteBuffer.
+//
+// ByteBuffer indexes its elements lazily and keeps its iterator state in the buffer itself, so concurrent
+// reads need PrepareForConcurrentReads first and the buffer can only be iterated once. A view is validated and
+// indexed when it is created, and never changes afterwards: all of its methods can be called from any number
+// of threads. Sequential reads go through Cursor objects, small values owned by each reader, each walking its
+// own [begin, end) range of elements. Any number of cursors can walk the same view at once.
+//
+// The view does not own the element bytes: they must outlive the view and its cursors. A view built over
+// segmented input points into the segments as well, and only owns copies of the elements that straddle a
+// segment boundary.
+// -----------------------------------------------------------------------------
+
+template <class Codec>
+class ByteBufferView {
+public:
+    using value_type = typename Codec::value_type;
+    static constexpr bool is_fixed_sized = Codec::is_fixed_sized;
+
+    // Sequential reader over a range of elements of a view.
+    class Cursor {
+    public:
+        // Reads the next element of the range. Returns false once the range is exhausted.
+        bool NextRaw(tcb::span<const uint8_t>& raw_bytes) {
+            if (position_ == end_) {
+                raw_bytes = {};
+                return false;
+            }
+            raw_bytes = view_->GetRawElementUnchecked(position_++);
+            return true;
+        }
+
+        bool Next(value_type& element) {
+            tcb::span<const uint8_t> raw_bytes;
+            if (!NextRaw(raw_bytes)) {
+                return false;
+            }
+            element = view_->codec_.Decode(raw_bytes);
+            return true;
+        }
+
+        // Position of the element the next call reads.
+        size_t GetPosition() const { return position_; }
+        size_t GetEnd() const { return end_; }
+
+    private:
+        friend class ByteBufferView;
+        Cursor(const ByteBufferView* view, size_t begin, size_t end) : view_(view), position_(begin), end_(end) {}
+
+        const ByteBufferView* view_;
+        size_t position_;
+        size_t end_;
+    };
+
+    // Validates and indexes the elements in the span, like a read-only ByteBuffer with the same arguments.
+    ByteBufferView(
+        tcb::span<const uint8_t> elements_span,
+        size_t num_elements,
+        size_t prefix_size = 0,
+        Codec codec = Codec{});
+
+    // View over the elements of a read-only buffer. The element index is reused if the buffer already built it,
+    // and taken over when the buffer is an rvalue.
+    explicit ByteBufferView(const ByteBuffer<Codec>& buffer);
+    explicit ByteBufferView(ByteBuffer<Codec>&& buffer);
+
+    // Validates and indexes elements laid out across several segments. Contiguous input is indexed in place
+    // like the span constructor; otherwise elements within one segment are viewed in place and elements that
+    // straddle a boundary are gathered into storage owned by the view.
+    ByteBufferView(
+        const SegmentedBytes& elements,
+        size_t num_elements,
+        size_t prefix_size = 0,
+        Codec codec = Codec{});
+
+    // Getters
+    size_t GetNumElements() const { return num_elements_; }
+    size_t GetElementSize() const { return element_size_; }
+
+    // Random access by position.
+    value_type GetElement(size_t position) const { return codec_.Decode(GetRawElement(position)); }
+    tcb::span<const uint8_t> GetRawElement(size_t position) const {
+        CheckPosition(position);
+        return GetRawElementUnchecked(position);
+    }
+
+    // Cursors over all elements, or over the elements in [begin, end).
+    Cursor GetCursor() const { return Cursor(this, 0, num_elements_); }
+    Cursor GetCursor(size_t begin, size_t end) const {
+        if (begin > end || end > num_elements_) {
+            throw InvalidInputException(
+                "Invalid cursor range: begin=" + std::to_string(begin) + " end=" + std::to_string(end) +
+                " size=" + std::to_string(num_elements_));
+        }
+        return Cursor(this, begin, end);
+    }
+
+private:
+    void CheckPosition(size_t position) const {
+        if (position >= num_elements_) {
+            throw InvalidInputException(
+                "Element index out of bounds during GetRawElement: index=" + std::to_string(position) +
+                " size=" + std::to_string(num_elements_));
+        }
+    }
+
+    tcb::span<const uint8_t> GetRawElementUnchecked(size_t position) const {
+        if (is_segmented_) {
+            return element_spans_[position];
+        }
+        if constexpr (is_fixed_sized) {
+            return elements_span_.subspan(prefix_size_ + position * element_size_, element_size_);
+        } else {
+            const size_t offset = offsets_[position];
+            return elements_span_.subspan(offset + kSizePrefixBytes, read_u32_le(elements_span_.data() + offset));
+        }
+    }
+
+    const tcb::span<const uint8_t> elements_span_;
+    const size_t num_elements_;
+    const size_t prefix_size_;
+    const Codec codec_;
+    const size_t element_size_;
+
+    // Offsets of the [u32 size] prefixes of variable-size elements in elements_span_.
+    std::vector<size_t> offsets_;
+
+    // Segmented input: one span per element, into its segment or into gathered_bytes_.
+    bool is_segmented_ = false;
+    std::vector<tcb::span<const uint8_t>> element_spans_;
+    std::vector<uint8_t> gathered_bytes_;
+};
+
+template <class Codec>
+inline ByteBufferView<Codec>::ByteBufferView(
+    tcb::span<const uint8_t> elements_span, size_t num_elements, size_t prefix_size, Codec codec)
+    : ByteBufferView(ByteBuffer<Codec>(elements_span, num_elements, prefix_size, std::move(codec))) {}
+
+template <class Codec>
+inline ByteBufferView<Codec>::ByteBufferView(const ByteBuffer<Codec>& buffer)
+    : elements_span_(buffer.elements_span_),
+      num_elements_(buffer.num_elements_),
+      prefix_size_(buffer.prefix_size_),
+      codec_(buffer.codec_),
+      element_size_(buffer.element_size_) {
+    buffer.PrepareForBulkReads("ByteBufferView");
+    if constexpr (!is_fixed_sized) {
+        offsets_ = buffer.offsets_;
+    }
+}
+
+template <class Codec>
+inline ByteBufferView<Codec>::ByteBufferView(ByteBuffer<Codec>&& buffer)
+    : elements_span_(buffer.elements_span_),
+      num_elements_(buffer.num_elements_),
+      prefix_size_(buffer.prefix_size_),
+      codec_(buffer.codec_),
+      element_size_(buffer.element_size_) {
+    buffer.PrepareForBulkReads("ByteBufferView");
+    if constexpr (!is_fixed_sized) {
+        offsets_ = std::move(buffer.offsets_);
+        buffer.is_initialized_from_span_ = false;
+    }
+}
+
+template <class Codec>
+inline ByteBufferView<Codec>::ByteBufferView(
+    const SegmentedBytes& elements, size_t num_elements, size_t prefix_size, Codec codec)
+    : elements_span_(elements.IsContiguous() ? elements.AsContiguous() : tcb::span<const uint8_t>()),
+      num_elements_(num_elements),
+      prefix_size_(prefix_size),
+      codec_(std::move(codec)),
+      element_size_(ByteBuffer<Codec>::InitElementSize(codec_)) {
+    if (elements.IsContiguous()) {
+        ByteBuffer<Codec> buffer(elements_span_, num_elements_, prefix_size_, codec_);
+        buffer.PrepareForBulkReads("ByteBufferView");
+        if constexpr (!is_fixed_sized) {
+            offsets_ = std::move(buffer.offsets_);
+        }
+        return;
+    }
+
+    const size_t total_size = elements.size();
+    if (total_size < prefix_size_) {
+        throw InvalidInputException("Malformed buffer: prefix_size exceeds span size");
+    }
+    if constexpr (is_fixed_sized) {
+        if ((total_size - prefix_size_) % element_size_ != 0) {
+            throw InvalidInputException("Malformed fixed-size buffer: buffer does not align with element_size");
+        }
+        if ((total_size - prefix_size_) / element_size_ != num_elements_) {
+            throw InvalidInputException("Malformed fixed-size buffer: num_elements on payload != num_elements_ expected.");
+        }
+    }
+
+    // Offsets only grow during the walk, so the segment holding the current offset is tracked incrementally.
+    size_t segment_index = 0;
+    size_t segment_start = 0;
+    const auto find_in_segment = [&](size_t offset, size_t size) -> tcb::span<const uint8_t> {
+        while (segment_index < elements.GetNumSegments() &&
+               offset >= segment_start + elements.GetSegment(segment_index).size()) {
+            segment_start += elements.GetSegment(segment_index).size();
+            ++segment_index;
+        }
+        if (segment_index == elements.GetNumSegments()) {
+            return {};
+        }
+        const auto segment = elements.GetSegment(segment_index);
+        const size_t offset_in_segment = offset - segment_start;
+        if (size > segment.size() - offset_in_segment) {
+            return {};
+        }
+        return segment.subspan(offset_in_segment, size);
+    };
+
+    // Gathered elements are recorded as (position, offset, size) first: gathered_bytes_ may reallocate while it grows.
+    std::vector<std::tuple<size_t, size_t, size_t>> gathered_elements;
+    element_spans_.resize(num_elements_);
+    size_t offset = prefix_size_;
+    for (size_t i = 0; i < num_elements_; ++i) {
+        size_t size = element_size_;
+        if constexpr (!is_fixed_sized) {
+            if (total_size - offset < kSizePrefixBytes) {
+                throw InvalidInputException(
+                    offset == total_size
+                        ? "Malformed variable-size buffer: num_elements on payload != num_elements_ expected."
+                        : "Malformed variable-size buffer: truncated length prefix");
+            }
+            const auto prefix = find_in_segment(offset, kSizePrefixBytes);
+            size = prefix.empty() ? elements.ReadU32LE(offset) : read_u32_le(prefix.data());
+            offset += kSizePrefixBytes;
+            if (total_size - offset < size) {
+                throw InvalidInputException("Malformed variable-size buffer: truncated element payload");
+            }
+        }
+        if (size > 0) {
+            element_spans_[i] = find_in_segment(offset, size);
+            if (element_spans_[i].empty()) {
+                const size_t gathered_offset = gathered_bytes_.size();
+                gathered_bytes_.resize(gathered_offset + size);
+                elements.CopyTo(offset, tcb::span<uint8_t>(gathered_bytes_.data() + gathered_offset, size));
+                gathered_elements.emplace_back(i, gathered_offset, size);
+            }
+        }
+        offset += size;
+    }
+    if (offset != total_size) {
+        throw InvalidInputException("Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+    }
+    for (const auto& [position, gathered_offset, size] : gathered_elements) {
+        element_spans_[position] = tcb::span<const uint8_t>(gathered_bytes_.data() + gathered_offset, size);
+    }
+    is_segmented_ = true;
+}
+
+} // namespace dbps::processing
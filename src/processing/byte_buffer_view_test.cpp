@@ -0,0 +1,200 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "byte_buffer_view.h"
+#include "typed_buffer_values.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bytes_utils.h"
+#include "exceptions.h"
+
+using namespace dbps::processing;
+
+namespace {
+    std::vector<uint8_t> MakePlainValueBytes(const std::vector<std::string>& values) {
+        std::vector<uint8_t> value_bytes;
+        for (const auto& value : values) {
+            append_u32_le(value_bytes, static_cast<uint32_t>(value.size()));
+            value_bytes.insert(value_bytes.end(), value.begin(), value.end());
+        }
+        return value_bytes;
+    }
+
+    std::string ToString(tcb::span<const uint8_t> bytes) {
+        return std::string(bytes.begin(), bytes.end());
+    }
+}
+
+TEST(ByteBufferViewTest, FixedSize_RandomAccessAndCursors) {
+    std::vector<uint8_t> bytes = {0xFF};
+    for (int32_t value : {10, -20, 30, -40}) {
+        append_i32_le(bytes, value);
+    }
+    const ByteBufferView<PlainValueCodec<int32_t, kI32TypeName>> view(tcb::span<const uint8_t>(bytes), 4u, 1u);
+    ASSERT_EQ(view.GetNumElements(), 4u);
+    EXPECT_EQ(view.GetElementSize(), sizeof(int32_t));
+    EXPECT_EQ(view.GetElement(3), -40);
+    EXPECT_THROW(view.GetElement(4), InvalidInputException);
+
+    // Cursors are independent: a full pass and a sub-range can be walked at the same time.
+    auto all = view.GetCursor();
+    auto middle = view.GetCursor(1, 3);
+    std::vector<int32_t> all_values;
+    std::vector<int32_t> middle_values;
+    int32_t value = 0;
+    while (all.Next(value)) {
+        all_values.push_back(value);
+        if (middle.Next(value)) {
+            middle_values.push_back(value);
+        }
+    }
+    EXPECT_EQ(all_values, (std::vector<int32_t>{10, -20, 30, -40}));
+    EXPECT_EQ(middle_values, (std::vector<int32_t>{-20, 30}));
+    EXPECT_EQ(middle.GetPosition(), 3u);
+
+    // The view can be walked again with a new cursor.
+    auto again = view.GetCursor(2, 4);
+    ASSERT_TRUE(again.Next(value));
+    EXPECT_EQ(value, 30);
+
+    EXPECT_THROW(view.GetCursor(3, 2), InvalidInputException);
+    EXPECT_THROW(view.GetCursor(0, 5), InvalidInputException);
+}
+
+TEST(ByteBufferViewTest, VariableSize_FromBuffer) {
+    const std::vector<std::string> values = {"id-1", "", "code", "a longer value"};
+    const auto value_bytes = MakePlainValueBytes(values);
+
+    // A buffer whose index was already built hands it over to the view.
+    TypedBufferRawBytesVariableSized buffer{tcb::span<const uint8_t>(value_bytes), values.size()};
+    ASSERT_EQ(ToString(buffer.GetRawElement(2)), "code");
+    const ByteBufferView<RawBytesVariableSizedCodec> view(buffer);
+    ASSERT_EQ(view.GetNumElements(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(ToString(view.GetRawElement(i)), values[i]);
+    }
+
+    // The buffer remains usable after a view was created from it.
+    EXPECT_EQ(ToString(buffer.GetRawElement(3)), "a longer value");
+
+    auto cursor = view.GetCursor(1, 4);
+    tcb::span<const uint8_t> raw_bytes;
+    std::vector<std::string> visited;
+    while (cursor.NextRaw(raw_bytes)) {
+        visited.push_back(ToString(raw_bytes));
+    }
+    EXPECT_EQ(visited, (std::vector<std::string>{"", "code", "a longer value"}));
+    EXPECT_FALSE(cursor.NextRaw(raw_bytes));
+    EXPECT_TRUE(raw_bytes.empty());
+}
+
+TEST(ByteBufferViewTest, MalformedInput_ThrowsAtConstruction) {
+    auto value_bytes = MakePlainValueBytes({"abc", "de"});
+    EXPECT_THROW(
+        (ByteBufferView<RawBytesVariableSizedCodec>(tcb::span<const uint8_t>(value_bytes), 3u)),
+        InvalidInputException);
+    value_bytes.pop_back();
+    EXPECT_THROW(
+        (ByteBufferView<RawBytesVariableSizedCodec>(tcb::span<const uint8_t>(value_bytes), 2u)),
+        InvalidInputException);
+
+    std::vector<uint8_t> fixed_bytes(7);
+    EXPECT_THROW(
+        (ByteBufferView<RawBytesFixedSizedCodec>(tcb::span<const uint8_t>(fixed_bytes), 2u, 0u, RawBytesFixedSizedCodec{4})),
+        InvalidInputException);
+
+    // Write buffers have no read-only payload to view.
+    TypedBufferRawBytesVariableSized write_buffer{2u, 0u, false};
+    EXPECT_THROW(ByteBufferView<RawBytesVariableSizedCodec>{write_buffer}, InvalidInputException);
+}
+
+TEST(ByteBufferViewTest, ConcurrentCursorsOverDisjointRanges) {
+    const size_t num_elements = 4000;
+    std::vector<std::string> values;
+    for (size_t i = 0; i < num_elements; ++i) {
+        values.push_back(std::string(i % 17, static_cast<char>('a' + i % 26)));
+    }
+    const auto value_bytes = MakePlainValueBytes(values);
+    const ByteBufferView<RawBytesVariableSizedCodec> view(tcb::span<const uint8_t>(value_bytes), num_elements);
+
+    const size_t num_threads = 4;
+    std::vector<size_t> mismatches(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            const size_t begin = t * num_elements / num_threads;
+            const size_t end = (t + 1) * num_elements / num_threads;
+            auto cursor = view.GetCursor(begin, end);
+            tcb::span<const uint8_t> raw_bytes;
+            for (size_t i = begin; cursor.NextRaw(raw_bytes); ++i) {
+                mismatches[t] += (ToString(raw_bytes) != values[i]) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches, std::vector<size_t>(num_threads, 0));
+}
+
+TEST(ByteBufferViewTest, Segmented_StraddlingElementsAreGathered) {
+    const std::vector<std::string> values = {"id-1", "", "code", "a longer value", "z"};
+    const auto value_bytes = MakePlainValueBytes(values);
+    const tcb::span<const uint8_t> all(value_bytes);
+
+    // Split inside the length prefix of "code", and inside the payload of "a longer value".
+    const std::vector<tcb::span<const uint8_t>> segments = {all.first(14), all.subspan(14, 16), all.subspan(30)};
+    const ByteBufferView<RawBytesVariableSizedCodec> view(SegmentedBytes(segments), values.size());
+    ASSERT_EQ(view.GetNumElements(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(ToString(view.GetRawElement(i)), values[i]);
+    }
+    // "id-1" lies within the first segment and is not copied.
+    EXPECT_EQ(view.GetRawElement(0).data(), value_bytes.data() + 4);
+
+    // Fixed-size elements, with a prefix and a boundary inside the second element.
+    std::vector<uint8_t> fixed_bytes = {0xFF, 0xFE};
+    for (int32_t value : {7, -8, 9}) {
+        append_i32_le(fixed_bytes, value);
+    }
+    const tcb::span<const uint8_t> fixed_all(fixed_bytes);
+    const std::vector<tcb::span<const uint8_t>> fixed_segments = {fixed_all.first(8), fixed_all.subspan(8)};
+    const ByteBufferView<PlainValueCodec<int32_t, kI32TypeName>> fixed_view(
+        SegmentedBytes(fixed_segments), 3u, 2u);
+    auto cursor = fixed_view.GetCursor();
+    std::vector<int32_t> decoded;
+    int32_t value = 0;
+    while (cursor.Next(value)) {
+        decoded.push_back(value);
+    }
+    EXPECT_EQ(decoded, (std::vector<int32_t>{7, -8, 9}));
+
+    // Count mismatches are detected as for contiguous input.
+    EXPECT_THROW(
+        (ByteBufferView<RawBytesVariableSizedCodec>(SegmentedBytes(segments), values.size() + 1)),
+        InvalidInputException);
+    EXPECT_THROW(
+        (ByteBufferView<PlainValueCodec<int32_t, kI32TypeName>>(SegmentedBytes(fixed_segments), 2u, 2u)),
+        InvalidInputException);
+}
@@ -0,0 +1,187 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "column_encryption_context.h"
+#include "encryptors/basic_xor_encryptor.h"
+
+#include <cstdint>
+#include <limits>
+
+using namespace dbps::external;
+
+// Helper function to create encryptor instance
+static std::unique_ptr<DBPSEncryptor> CreateEncryptor(
+    const std::string& key_id,
+    const std::string& column_name,
+    const std::string& user_id,
+    const std::string& application_context,
+    Type::type datatype) {
+
+    // Return a BasicXorEncryptor instance.
+    return std::make_unique<BasicXorEncryptor>(key_id, column_name, user_id, application_context, datatype);
+}
+
+// Helper function to get the encryptor instance from the cache, if any, or create it
+static std::shared_ptr<DBPSEncryptor> GetOrCreateEncryptor(
+    const std::string& key_id,
+    const std::string& column_name,
+    const std::string& user_id,
+    const std::string& application_context,
+    Type::type datatype,
+    EncryptorCache* encryptor_cache) {
+    auto create = [&]() {
+        return CreateEncryptor(key_id, column_name, user_id, application_context, datatype);
+    };
+    if (encryptor_cache == nullptr) {
+        return create();
+    }
+    return encryptor_cache->GetOrCreate({key_id, column_name, user_id, application_context, datatype}, create);
+}
+
+ColumnEncryptionContext::ColumnEncryptionContext(
+    const std::string& column_name,
+    Type::type datatype,
+    const std::optional<int>& datatype_length,
+    CompressionCodec::type compression,
+    CompressionCodec::type encrypted_compression,
+    const std::string& key_id,
+    const std::string& user_id,
+    const std::string& application_context,
+    ColumnEncryptionOptions options
+) : ColumnEncryptionContext(
+        column_name, datatype, datatype_length, compression, encrypted_compression,
+        key_id, user_id, application_context,
+        // options is copied, not moved: it is also read by the encryptor argument, initialized in any order.
+        GetOrCreateEncryptor(
+            key_id, column_name, user_id, application_context, datatype, options.encryptor_cache.get()),
+        options) {}
+
+ColumnEncryptionContext::ColumnEncryptionContext(
+    const std::string& column_name,
+    Type::type datatype,
+    const std::optional<int>& datatype_length,
+    CompressionCodec::type compression,
+    CompressionCodec::type encrypted_compression,
+    const std::string& key_id,
+    const std::string& user_id,
+    const std::string& application_context,
+    std::shared_ptr<DBPSEncryptor> encryptor,
+    ColumnEncryptionOptions options
+) : column_name_(column_name),
+    datatype_(datatype),
+    datatype_length_(datatype_length),
+    compression_(compression),
+    encrypted_compression_(encrypted_compression),
+    key_id_(key_id),
+    user_id_(user_id),
+    application_context_(application_context),
+    encryptor_(std::move(encryptor)),
+    streaming_chunk_size_(options.streaming_chunk_size),
+    mode_policy_(options.mode_policy ? std::move(options.mode_policy)
+                                     : std::make_shared<const EncryptionModePolicy>()),
+    dictionary_index_passthrough_(options.dictionary_index_passthrough),
+    insecure_dictionary_index_checksum_(options.insecure_dictionary_index_checksum),
+    buffer_pool_(std::move(options.buffer_pool)),
+    trusted_ciphertext_(options.trusted_ciphertext),
+    value_dedup_(options.value_dedup),
+    columnar_value_lists_(options.columnar_value_lists) {
+    ValidateColumnParameters();
+    BuildPerValueCapabilities();
+}
+
+bool ColumnEncryptionContext::IsPerValueEncryptionSupported(
+    CompressionCodec::type page_payload_compression, Encoding::type encoding, Type::type datatype) {
+
+    // Compression: Only UNCOMPRESSED and SNAPPY are currently supported
+    const bool is_compression_supported = (page_payload_compression == CompressionCodec::UNCOMPRESSED ||
+                                           page_payload_compression == CompressionCodec::SNAPPY);
+
+    // Encoding: Only PLAIN is currently supported
+    // RLE_DICTIONARY is not supported for per-value encryption since the values are not present in the
+    // page payload, only references to them.
+    const bool is_encoding_supported = (encoding == Encoding::PLAIN);
+
+    // Datatype: All datatypes are supported except BOOLEAN.
+    // BOOLEAN is not supported for per-value encryption and always defaults to per-block encryption.
+    const bool is_datatype_supported = (datatype != Type::BOOLEAN);
+
+    return is_compression_supported && is_encoding_supported && is_datatype_supported;
+}
+
+void ColumnEncryptionContext::BuildPerValueCapabilities() {
+    for (size_t encoding_slot = 0; encoding_slot < kNumEncodingSlots; ++encoding_slot) {
+        const auto encoding = static_cast<Encoding::type>(encoding_slot);
+        per_value_capabilities_[0][encoding_slot] =
+            IsPerValueEncryptionSupported(CompressionCodec::UNCOMPRESSED, encoding, datatype_);
+        per_value_capabilities_[1][encoding_slot] =
+            IsPerValueEncryptionSupported(compression_, encoding, datatype_);
+    }
+}
+
+bool ColumnEncryptionContext::SupportsPerValueEncryption(
+    Encoding::type encoding, bool is_page_payload_compressed) const {
+    const auto encoding_slot = static_cast<size_t>(encoding);
+    if (encoding_slot >= kNumEncodingSlots) {
+        return false;
+    }
+    return per_value_capabilities_[is_page_payload_compressed ? 1 : 0][encoding_slot];
+}
+
+void ColumnEncryptionContext::ValidateColumnParameters() {
+    // Check that key_id is not null and not empty
+    if (key_id_.empty()) {
+        error_stage_ = "validation";
+        error_message_ = "key_id cannot be null or empty";
+        return;
+    }
+
+    // Check that an encryptor is available
+    if (!encryptor_) {
+        error_stage_ = "validation";
+        error_message_ = "encryptor cannot be null";
+        return;
+    }
+
+    // Check FIXED_LEN_BYTE_ARRAY datatype_length requirement
+    if (datatype_ == Type::FIXED_LEN_BYTE_ARRAY) {
+        if (!datatype_length_.has_value()) {
+            error_stage_ = "parameter_validation";
+            error_message_ = "FIXED_LEN_BYTE_ARRAY datatype requires datatype_length parameter";
+            return;
+        }
+        if (datatype_length_.value() <= 0) {
+            error_stage_ = "parameter_validation";
+            error_message_ = "FIXED_LEN_BYTE_ARRAY datatype_length must be positive";
+            return;
+        }
+    }
+
+    // Check that chunk sizes fit in the 32-bit fields of the chunk framing
+    if (streaming_chunk_size_ > std::numeric_limits<uint32_t>::max()) {
+        error_stage_ = "parameter_validation";
+        error_message_ = "streaming_chunk_size must fit in 32 bits";
+        return;
+    }
+
+    // Passthrough pages are only authenticated by the block tag, so a forgeable checksum must be asked for
+    if (dictionary_index_passthrough_ && encryptor_->GetBlockTagLength() == 0 && !insecure_dictionary_index_checksum_) {
+        error_stage_ = "parameter_validation";
+        error_message_ = "dictionary_index_passthrough requires an encryptor with block tags "
+                         "(or insecure_dictionary_index_checksum)";
+        return;
+    }
+}
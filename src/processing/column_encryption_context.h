@@ -0,0 +1,266 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "enums.h"
+#include "buffer_pool.h"
+#include "encryption_mode_policy.h"
+#include "encryptor_cache.h"
+#include "value_dedup.h"
+#include "encryptors/dbps_encryptor.h"
+
+#ifndef DBPS_EXPORT
+#define DBPS_EXPORT
+#endif
+
+using namespace dbps::external;
+
+/**
+ * Optional column-level settings of a ColumnEncryptionContext.
+ */
+struct ColumnEncryptionOptions {
+    // Chunk size of the streaming mode, in bytes (0 disables streaming).
+    size_t streaming_chunk_size = 0;
+
+    // Policy choosing per-value or per-block encryption for pages that support both.
+    // Null uses the default policy, which always picks per-value.
+    std::shared_ptr<const EncryptionModePolicy> mode_policy;
+
+    // Opt-in: data pages holding dictionary indices (RLE_DICTIONARY/PLAIN_DICTIONARY) are not encrypted, only
+    // tagged with the encryptor's block tag, a MAC (see DBPSEncryptor::ComputeBlockTag). The values themselves
+    // stay encrypted in the dictionary page. Requires an encryptor with block tags, unless
+    // insecure_dictionary_index_checksum is set.
+    bool dictionary_index_passthrough = false;
+
+    // Opt-in, for staging with encryptors without block tags (e.g. BasicXorEncryptor) only: passthrough pages are
+    // tagged and checked with a checksum seeded with the key id. It detects accidental corruption, but anyone who
+    // can modify a page can recompute it. Without it, such pages are rejected on both encryption and decryption.
+    bool insecure_dictionary_index_checksum = false;
+
+    // Pool recycling the intermediate buffers of the page pipelines, installed as the thread's default pool
+    // while a page is processed. Null leaves them to the heap (or to the default pool already installed).
+    std::shared_ptr<dbps::processing::BufferPool> buffer_pool;
+
+    // Opt-in: the ciphertext decrypted with this column was produced by this deployment, and its integrity is
+    // protected separately. Per-value decryption then decodes value lists in a single pass, skipping the
+    // structural validation meant for untrusted input. Length overruns still fail safely.
+    bool trusted_ciphertext = false;
+
+    // Cache of encryptors shared across contexts. When set, the constructor without an encryptor takes the
+    // cached instance for the column parameters instead of creating one. Null creates a new encryptor.
+    std::shared_ptr<EncryptorCache> encryptor_cache;
+
+    // Opt-in: per-value pages encrypt each distinct value once (see ValueDedupMode). Off by default.
+    dbps::processing::ValueDedupOptions value_dedup;
+
+    // Opt-in: value lists of variable-size values are encrypted in the columnar layout of ciphertext format v0.02,
+    // when the encryptor supports it (see DBPSEncryptor::EncryptColumnarValueListInto). Readers of format v0.01
+    // reject such ciphertext. Decryption reads both formats either way.
+    bool columnar_value_lists = false;
+};
+
+/**
+ * Immutable per-column context shared by all pages of a column.
+ *
+ * Holds the column-level parameters that do not change from page to page (column name, datatype,
+ * compression, key and user context) together with a ready-to-use encryptor instance.
+ * Column-level validation runs once at construction time, so a DataBatchEncryptionSequencer built
+ * on top of this context only needs the page payload and the page encoding attributes.
+ *
+ * Validation failures are not thrown. They are captured in GetErrorStage()/GetErrorMessage() and
+ * reported by the sequencer on each page call, keeping the sequencer's error reporting contract.
+ *
+ * The context is meant to be created once (e.g. on agent init()) and shared via
+ * std::shared_ptr<const ColumnEncryptionContext> across the per-page sequencers.
+ *
+ * The context also holds the per-value capability table of the column: for every page encoding and
+ * page payload compression state, whether the page can be encrypted per-value. The table is filled
+ * once at construction, so the sequencer picks the per-value or per-block pipeline for a page with
+ * a single lookup, before touching the page payload.
+ *
+ * The capability table says which pipelines a page can use. Among those, the encryption mode policy of the
+ * column picks the one to use (see EncryptionModePolicy).
+ *
+ * When a streaming chunk size is set, every page of the column is encrypted in bounded-memory streaming
+ * mode: the page is processed in chunks of at most that many bytes, and the ciphertext records the chunk
+ * framing (see DataBatchEncryptionSequencer). A chunk size of 0 disables streaming.
+ *
+ * With dictionary index passthrough, the data pages of dictionary-encoded chunks skip encryption and only
+ * get a tag: a MAC when the encryptor has block tags, otherwise a checksum that gives no tamper protection.
+ * The dictionary page, which holds the actual values, is encrypted as usual.
+ *
+ * With an encryptor cache, contexts created per request share their encryptor instance with the other contexts
+ * of the same key, column, user, application context and datatype.
+ *
+ * With trusted ciphertext, decryption assumes well-formed input: value lists are decoded straight into the
+ * page with the encryptor's single-pass decoder, and the decrypted level bytes are not re-validated against
+ * the encoding attributes. Encryption is unaffected.
+ */
+class DBPS_EXPORT ColumnEncryptionContext {
+public:
+    // Constructor - creates the default encryptor for the column, or takes it from options.encryptor_cache.
+    ColumnEncryptionContext(
+        const std::string& column_name,
+        Type::type datatype,
+        const std::optional<int>& datatype_length,
+        CompressionCodec::type compression,
+        CompressionCodec::type encrypted_compression,
+        const std::string& key_id,
+        const std::string& user_id,
+        const std::string& application_context,
+        ColumnEncryptionOptions options = {});
+
+    // Constructor with pre-built encryptor (for dependency injection)
+    ColumnEncryptionContext(
+        const std::string& column_name,
+        Type::type datatype,
+        const std::optional<int>& datatype_length,
+        CompressionCodec::type compression,
+        CompressionCodec::type encrypted_compression,
+        const std::string& key_id,
+        const std::string& user_id,
+        const std::string& application_context,
+        std::shared_ptr<DBPSEncryptor> encryptor,
+        ColumnEncryptionOptions options = {});
+
+    // The context is shared across sequencers and is neither copyable nor movable.
+    ColumnEncryptionContext(const ColumnEncryptionContext&) = delete;
+    ColumnEncryptionContext& operator=(const ColumnEncryptionContext&) = delete;
+
+    ~ColumnEncryptionContext() = default;
+
+    // Getters for the column-level parameters.
+    const std::string& GetColumnName() const { return column_name_; }
+    Type::type GetDatatype() const { return datatype_; }
+    const std::optional<int>& GetDatatypeLength() const { return datatype_length_; }
+    CompressionCodec::type GetCompression() const { return compression_; }
+    CompressionCodec::type GetEncryptedCompression() const { return encrypted_compression_; }
+    const std::string& GetKeyId() const { return key_id_; }
+    const std::string& GetUserId() const { return user_id_; }
+    const std::string& GetApplicationContext() const { return application_context_; }
+
+    // Encryptor shared by all pages of the column (and by other contexts when it comes from a cache).
+    DBPSEncryptor& GetEncryptor() const { return *encryptor_; }
+
+    // Chunk size of the streaming mode, in bytes. 0 if streaming is disabled.
+    size_t GetStreamingChunkSize() const { return streaming_chunk_size_; }
+    bool IsStreamingEnabled() const { return streaming_chunk_size_ > 0; }
+
+    // Policy choosing the encryption mode of the pages that support per-value encryption.
+    const EncryptionModePolicy& GetEncryptionModePolicy() const { return *mode_policy_; }
+
+    // True if the dictionary index data pages are tagged instead of encrypted (see ColumnEncryptionOptions).
+    bool IsDictionaryIndexPassthroughEnabled() const { return dictionary_index_passthrough_; }
+
+    // True if passthrough pages may use the forgeable checksum of encryptors without block tags.
+    bool IsInsecureDictionaryIndexChecksumAllowed() const { return insecure_dictionary_index_checksum_; }
+
+    // Pool of the intermediate page buffers, or nullptr (see ColumnEncryptionOptions).
+    dbps::processing::BufferPool* GetBufferPool() const { return buffer_pool_.get(); }
+
+    // True if decryption skips the structural validation of untrusted input (see ColumnEncryptionOptions).
+    bool IsCiphertextTrusted() const { return trusted_ciphertext_; }
+
+    // Value deduplication settings of per-value pages (see ColumnEncryptionOptions).
+    const dbps::processing::ValueDedupOptions& GetValueDedupOptions() const { return value_dedup_; }
+
+    // True if value lists are encrypted in the columnar layout when the encryptor supports it.
+    bool IsColumnarValueListEnabled() const { return columnar_value_lists_; }
+
+    /**
+     * Returns true if a page of this column can be encrypted per-value, false if it must be encrypted per-block.
+     *
+     * @param encoding The page encoding
+     * @param is_page_payload_compressed Whether the page payload is compressed with the column compression.
+     *    False for DATA_PAGE_V2 pages with page_v2_is_compressed=false, whose value bytes are stored as-is.
+     */
+    bool SupportsPerValueEncryption(Encoding::type encoding, bool is_page_payload_compressed) const;
+
+    /**
+     * Capability rule behind the table: per-value encryption is supported for PLAIN encoding, non-BOOLEAN
+     * datatypes and payloads that are UNCOMPRESSED or SNAPPY compressed. All page types are supported.
+     * - RLE_DICTIONARY pages only hold references to the values, not the values themselves.
+     * - BOOLEAN values are bit-packed and not expanded as bytes.
+     */
+    static bool IsPerValueEncryptionSupported(
+        CompressionCodec::type page_payload_compression, Encoding::type encoding, Type::type datatype);
+
+    // Column-level validation result. Error fields are empty when the context is valid.
+    bool IsValid() const { return error_stage_.empty(); }
+    const std::string& GetErrorStage() const { return error_stage_; }
+    const std::string& GetErrorMessage() const { return error_message_; }
+
+private:
+    const std::string column_name_;
+    const Type::type datatype_;
+    const std::optional<int> datatype_length_;
+    const CompressionCodec::type compression_;
+    const CompressionCodec::type encrypted_compression_;
+    const std::string key_id_;
+    const std::string user_id_;
+    const std::string application_context_;
+
+    // Encryptor instance for performing encryption/decryption operations
+    const std::shared_ptr<DBPSEncryptor> encryptor_;
+
+    // Chunk size of the streaming mode (0 disables streaming)
+    const size_t streaming_chunk_size_;
+
+    // Encryption mode policy, never null
+    const std::shared_ptr<const EncryptionModePolicy> mode_policy_;
+
+    // Dictionary index data pages are tagged instead of encrypted
+    const bool dictionary_index_passthrough_;
+
+    // Passthrough pages of encryptors without block tags use a checksum instead of a MAC
+    const bool insecure_dictionary_index_checksum_;
+
+    // Pool of the intermediate page buffers, may be null
+    const std::shared_ptr<dbps::processing::BufferPool> buffer_pool_;
+
+    // Decryption skips the structural validation of untrusted input
+    const bool trusted_ciphertext_;
+
+    // Value deduplication settings of per-value pages
+    const dbps::processing::ValueDedupOptions value_dedup_;
+
+    // Value lists use the columnar layout of ciphertext format v0.02
+    const bool columnar_value_lists_;
+
+    // Column-level validation result, set once during construction.
+    std::string error_stage_;
+    std::string error_message_;
+
+    // Per-value capability table, indexed by [is_page_payload_compressed][encoding].
+    static constexpr size_t kNumEncodingSlots = static_cast<size_t>(Encoding::UNKNOWN) + 1;
+    std::array<std::array<bool, kNumEncodingSlots>, 2> per_value_capabilities_{};
+
+    void BuildPerValueCapabilities();
+
+    /**
+     * Validates the column-level parameters: key_id, the FIXED_LEN_BYTE_ARRAY datatype_length and the
+     * streaming chunk size (chunk sizes are framed as 32-bit values).
+     * Sets error_stage_ and error_message_ on the first failed check.
+     */
+    void ValidateColumnParameters();
+};
@@ -0,0 +1,256 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "column_encryption_context.h"
+#include "encryption_sequencer.h"
+#include "parquet_testing_utils.h"
+#include "encryptors/aes_encryptor.h"
+#include "encryptors/basic_xor_encryptor.h"
+#include "../common/enums.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace dbps::external;
+
+namespace {
+    const std::map<std::string, std::string> DICT_PAGE_ATTRIBUTES = {
+        {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}};
+
+    std::shared_ptr<const ColumnEncryptionContext> MakeContext(
+        Type::type datatype,
+        const std::optional<int>& datatype_length,
+        const std::string& key_id) {
+        return std::make_shared<const ColumnEncryptionContext>(
+            "test_column", datatype, datatype_length,
+            CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+            key_id, "test_user", "{}");
+    }
+}
+
+TEST(ColumnEncryptionContext, ValidContext_ExposesColumnParameters) {
+    auto context = MakeContext(Type::INT32, std::nullopt, "test_key");
+
+    EXPECT_TRUE(context->IsValid());
+    EXPECT_TRUE(context->GetErrorStage().empty());
+    EXPECT_EQ(context->GetColumnName(), "test_column");
+    EXPECT_EQ(context->GetDatatype(), Type::INT32);
+    EXPECT_EQ(context->GetCompression(), CompressionCodec::UNCOMPRESSED);
+    EXPECT_EQ(context->GetKeyId(), "test_key");
+    EXPECT_EQ(context->GetUserId(), "test_user");
+}
+
+TEST(ColumnEncryptionContext, EmptyKeyId_IsInvalid) {
+    auto context = MakeContext(Type::INT32, std::nullopt, "");
+
+    EXPECT_FALSE(context->IsValid());
+    EXPECT_EQ(context->GetErrorStage(), "validation");
+    EXPECT_EQ(context->GetErrorMessage(), "key_id cannot be null or empty");
+}
+
+TEST(ColumnEncryptionContext, FixedLenByteArrayLength_IsValidatedOnce) {
+    auto missing_length = MakeContext(Type::FIXED_LEN_BYTE_ARRAY, std::nullopt, "test_key");
+    EXPECT_FALSE(missing_length->IsValid());
+    EXPECT_EQ(missing_length->GetErrorStage(), "parameter_validation");
+
+    auto zero_length = MakeContext(Type::FIXED_LEN_BYTE_ARRAY, 0, "test_key");
+    EXPECT_FALSE(zero_length->IsValid());
+    EXPECT_EQ(zero_length->GetErrorStage(), "parameter_validation");
+
+    auto valid_length = MakeContext(Type::FIXED_LEN_BYTE_ARRAY, 16, "test_key");
+    EXPECT_TRUE(valid_length->IsValid());
+}
+
+TEST(ColumnEncryptionContext, NullEncryptor_IsInvalid) {
+    ColumnEncryptionContext context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", nullptr);
+
+    EXPECT_FALSE(context.IsValid());
+    EXPECT_EQ(context.GetErrorStage(), "validation");
+}
+
+TEST(ColumnEncryptionContext, DictionaryIndexPassthrough_RequiresBlockTags) {
+    ColumnEncryptionOptions options;
+    options.dictionary_index_passthrough = true;
+    ColumnEncryptionContext xor_context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", options);
+    EXPECT_FALSE(xor_context.IsValid());
+    EXPECT_EQ(xor_context.GetErrorStage(), "parameter_validation");
+
+    ColumnEncryptionContext aes_context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}",
+        std::make_unique<AesEncryptor>(
+            "test_key", "test_column", "test_user", "{}", Type::INT32, std::vector<uint8_t>(32, 0x11)),
+        options);
+    EXPECT_TRUE(aes_context.IsValid());
+
+    // The forgeable checksum of encryptors without block tags is an explicit opt-in.
+    options.insecure_dictionary_index_checksum = true;
+    ColumnEncryptionContext insecure_context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", options);
+    EXPECT_TRUE(insecure_context.IsValid());
+    EXPECT_TRUE(insecure_context.IsInsecureDictionaryIndexChecksumAllowed());
+}
+
+TEST(ColumnEncryptionContext, StreamingChunkSize_IsValidated) {
+    auto disabled = MakeContext(Type::INT32, std::nullopt, "test_key");
+    EXPECT_FALSE(disabled->IsStreamingEnabled());
+
+    ColumnEncryptionOptions options;
+    options.streaming_chunk_size = 1024;
+    ColumnEncryptionContext enabled(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", options);
+    EXPECT_TRUE(enabled.IsValid());
+    EXPECT_TRUE(enabled.IsStreamingEnabled());
+    EXPECT_EQ(enabled.GetStreamingChunkSize(), 1024u);
+
+    // Chunk sizes are framed as 32-bit values.
+    options.streaming_chunk_size = static_cast<size_t>(std::numeric_limits<uint32_t>::max()) + 1;
+    ColumnEncryptionContext oversized(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", options);
+    EXPECT_FALSE(oversized.IsValid());
+    EXPECT_EQ(oversized.GetErrorStage(), "parameter_validation");
+}
+
+TEST(ColumnEncryptionContext, PerValueCapabilities_FollowColumnParameters) {
+    auto plain_context = MakeContext(Type::INT32, std::nullopt, "test_key");
+    EXPECT_TRUE(plain_context->SupportsPerValueEncryption(Encoding::PLAIN, false));
+    EXPECT_TRUE(plain_context->SupportsPerValueEncryption(Encoding::PLAIN, true));
+    EXPECT_FALSE(plain_context->SupportsPerValueEncryption(Encoding::RLE_DICTIONARY, false));
+    EXPECT_FALSE(plain_context->SupportsPerValueEncryption(Encoding::DELTA_BINARY_PACKED, false));
+    EXPECT_FALSE(plain_context->SupportsPerValueEncryption(static_cast<Encoding::type>(-1), false));
+    EXPECT_FALSE(plain_context->SupportsPerValueEncryption(static_cast<Encoding::type>(Encoding::UNKNOWN + 1), false));
+
+    auto boolean_context = MakeContext(Type::BOOLEAN, std::nullopt, "test_key");
+    EXPECT_FALSE(boolean_context->SupportsPerValueEncryption(Encoding::PLAIN, false));
+    EXPECT_FALSE(boolean_context->SupportsPerValueEncryption(Encoding::PLAIN, true));
+
+    // Unsupported compressions only affect compressed page payloads.
+    ColumnEncryptionContext gzip_context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::GZIP, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}");
+    EXPECT_FALSE(gzip_context.SupportsPerValueEncryption(Encoding::PLAIN, true));
+    EXPECT_TRUE(gzip_context.SupportsPerValueEncryption(Encoding::PLAIN, false));
+
+    ColumnEncryptionContext snappy_context(
+        "test_column", Type::INT32, std::nullopt,
+        CompressionCodec::SNAPPY, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}");
+    EXPECT_TRUE(snappy_context.SupportsPerValueEncryption(Encoding::PLAIN, true));
+}
+
+TEST(ColumnEncryptionContext, InvalidContext_ReportedByEverySequencer) {
+    auto context = MakeContext(Type::BYTE_ARRAY, std::nullopt, "");
+    auto payload = BuildByteArrayValueBytesForTesting("Hello");
+
+    for (int page = 0; page < 2; ++page) {
+        DataBatchEncryptionSequencer sequencer(context, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, {});
+        EXPECT_FALSE(sequencer.DecodeAndEncrypt(payload));
+        EXPECT_EQ(sequencer.error_stage_, "validation");
+        EXPECT_EQ(sequencer.error_message_, "key_id cannot be null or empty");
+    }
+}
+
+TEST(ColumnEncryptionContext, SharedContext_MatchesPerPageSequencer) {
+    auto context = MakeContext(Type::BYTE_ARRAY, std::nullopt, "test_key");
+
+    const std::vector<std::vector<uint8_t>> pages = {
+        BuildByteArrayValueBytesForTesting("first page"),
+        BuildByteArrayValueBytesForTesting("second page"),
+        BuildByteArrayValueBytesForTesting("third page")};
+
+    for (const auto& page : pages) {
+        // Sequencer built on the shared context.
+        DataBatchEncryptionSequencer shared_sequencer(context, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, {});
+        ASSERT_TRUE(shared_sequencer.DecodeAndEncrypt(page)) << shared_sequencer.error_message_;
+
+        // Sequencer built with the full parameter list for the same page.
+        DataBatchEncryptionSequencer full_sequencer(
+            "test_column", Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED, Encoding::PLAIN,
+            DICT_PAGE_ATTRIBUTES, CompressionCodec::UNCOMPRESSED, "test_key", "test_user", "{}", {});
+        ASSERT_TRUE(full_sequencer.DecodeAndEncrypt(page)) << full_sequencer.error_message_;
+
+        EXPECT_EQ(shared_sequencer.encrypted_result_, full_sequencer.encrypted_result_);
+        EXPECT_EQ(shared_sequencer.encryption_metadata_, full_sequencer.encryption_metadata_);
+
+        // Decrypt with the same shared context.
+        DataBatchEncryptionSequencer decrypt_sequencer(
+            context, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, shared_sequencer.encryption_metadata_);
+        ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(shared_sequencer.encrypted_result_))
+            << decrypt_sequencer.error_message_;
+        EXPECT_EQ(decrypt_sequencer.decrypted_result_, page);
+    }
+}
+
+TEST(ColumnEncryptionContext, NullContext_FailsValidation) {
+    DataBatchEncryptionSequencer sequencer(nullptr, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, {});
+    auto payload = BuildByteArrayValueBytesForTesting("Hello");
+
+    EXPECT_FALSE(sequencer.DecodeAndEncrypt(payload));
+    EXPECT_EQ(sequencer.error_stage_, "validation");
+}
+
+TEST(ColumnEncryptionContext, EncryptorCache_SharesEncryptorAcrossContexts) {
+    auto cache = std::make_shared<EncryptorCache>();
+    ColumnEncryptionOptions options;
+    options.encryptor_cache = cache;
+    auto make_context = [&](const std::string& key_id, Type::type datatype) {
+        return std::make_shared<const ColumnEncryptionContext>(
+            "col", datatype, std::nullopt, CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+            key_id, "user", "{}", options);
+    };
+
+    auto context1 = make_context("key1", Type::INT32);
+    auto context2 = make_context("key1", Type::INT32);
+    auto other_key = make_context("key2", Type::INT32);
+    auto other_datatype = make_context("key1", Type::INT64);
+    EXPECT_EQ(&context1->GetEncryptor(), &context2->GetEncryptor());
+    EXPECT_NE(&context1->GetEncryptor(), &other_key->GetEncryptor());
+    EXPECT_NE(&context1->GetEncryptor(), &other_datatype->GetEncryptor());
+
+    auto stats = cache->GetStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.size, 3u);
+
+    // Pages encrypted through a cached encryptor still round-trip in a context without a cache.
+    DataBatchEncryptionSequencer encrypt_sequencer(context2, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(std::vector<uint8_t>{1, 2, 3, 4}));
+    auto uncached = std::make_shared<const ColumnEncryptionContext>(
+        "col", Type::INT32, std::nullopt, CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "key1", "user", "{}");
+    DataBatchEncryptionSequencer decrypt_sequencer(
+        uncached, Encoding::PLAIN, DICT_PAGE_ATTRIBUTES, encrypt_sequencer.encryption_metadata_);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, (std::vector<uint8_t>{1, 2, 3, 4}));
+}
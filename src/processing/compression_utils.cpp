@@ -16,6 +16,8 @@
 // under the License.
 
 #include "compression_utils.h"
+#include "buffer_pool.h"
+#include <cstring>
 #include <snappy.h>
 
 using namespace dbps::external;
@@ -50,22 +52,26 @@ std::vector<uint8_t> Compress(tcb::span<const uint8_t> bytes, CompressionCodec::
         "Unsupported compression codec: " + std::string(to_string(compression)));
 }
 
+// The decompressed buffers are fully overwritten, so they are taken uninitialized from the thread's BufferPool.
 std::vector<uint8_t> Decompress(tcb::span<const uint8_t> bytes, CompressionCodec::type compression) {
     if (compression == CompressionCodec::UNCOMPRESSED) {
-        return std::vector<uint8_t>(bytes.begin(), bytes.end());
+        auto out_buffer = dbps::processing::AcquireUninitializedBuffer(bytes.size());
+        if (!bytes.empty()) {
+            std::memcpy(out_buffer.data(), bytes.data(), bytes.size());
+        }
+        return out_buffer;
     }
     
     if (compression == CompressionCodec::SNAPPY) {
         if (bytes.empty()) {
             return std::vector<uint8_t>();
         }
-        std::vector<uint8_t> out_buffer;
         size_t uncompressed_size = 0;
         if (!snappy::GetUncompressedLength(
                 reinterpret_cast<const char*>(bytes.data()), bytes.size(), &uncompressed_size)) {
             throw InvalidInputException("Failed to decompress data: invalid or corrupt Snappy-compressed input");
         }
-        out_buffer.resize(uncompressed_size);
+        auto out_buffer = dbps::processing::AcquireUninitializedBuffer(uncompressed_size);
         if (!snappy::RawUncompress(
                 reinterpret_cast<const char*>(bytes.data()),
                 bytes.size(),
@@ -81,4 +87,99 @@ std::vector<uint8_t> Decompress(tcb::span<const uint8_t> bytes, CompressionCodec
         "Unsupported compression codec: " + std::string(to_string(compression)));
 }
 
+size_t MaxCompressedSize(size_t uncompressed_size, CompressionCodec::type compression) {
+    if (compression == CompressionCodec::UNCOMPRESSED) {
+        return uncompressed_size;
+    }
+
+    if (compression == CompressionCodec::SNAPPY) {
+        // Empty inputs compress to an empty output, same as Compress.
+        return uncompressed_size == 0 ? 0 : snappy::MaxCompressedLength(uncompressed_size);
+    }
+
+    throw DBPSUnsupportedException(
+        "Unsupported compression codec: " + std::string(to_string(compression)));
+}
+
+namespace {
+    void CheckOutputSize(tcb::span<uint8_t> out, size_t required_size) {
+        if (out.size() < required_size) {
+            throw InvalidInputException(
+                "Compression output buffer too small: " + std::to_string(required_size) +
+                " bytes required, " + std::to_string(out.size()) + " bytes provided");
+        }
+    }
+}
+
+size_t CompressConcatenatedInto(
+    tcb::span<const uint8_t> leading, tcb::span<const uint8_t> trailing, CompressionCodec::type compression,
+    tcb::span<uint8_t> out) {
+    const size_t total_size = leading.size() + trailing.size();
+    CheckOutputSize(out, MaxCompressedSize(total_size, compression));
+
+    if (compression == CompressionCodec::UNCOMPRESSED) {
+        if (!leading.empty()) {
+            std::memcpy(out.data(), leading.data(), leading.size());
+        }
+        if (!trailing.empty()) {
+            std::memcpy(out.data() + leading.size(), trailing.data(), trailing.size());
+        }
+        return total_size;
+    }
+
+    // SNAPPY, the only other codec accepted by MaxCompressedSize.
+    if (total_size == 0) {
+        return 0;
+    }
+    size_t compressed_size = 0;
+    if (leading.empty() || trailing.empty()) {
+        auto bytes = leading.empty() ? trailing : leading;
+        snappy::RawCompress(
+            reinterpret_cast<const char*>(bytes.data()),
+            bytes.size(),
+            reinterpret_cast<char*>(out.data()),
+            &compressed_size);
+        return compressed_size;
+    }
+    // snappy reads the two ranges in order, as if they were one contiguous input.
+    struct iovec parts[2];
+    parts[0].iov_base = const_cast<uint8_t*>(leading.data());
+    parts[0].iov_len = leading.size();
+    parts[1].iov_base = const_cast<uint8_t*>(trailing.data());
+    parts[1].iov_len = trailing.size();
+
+    snappy::RawCompressFromIOVec(
+        parts,
+        total_size,
+        reinterpret_cast<char*>(out.data()),
+        &compressed_size);
+    return compressed_size;
+}
+
+std::vector<uint8_t> CompressConcatenated(
+    tcb::span<const uint8_t> leading, tcb::span<const uint8_t> trailing, CompressionCodec::type compression) {
+    std::vector<uint8_t> out_buffer(MaxCompressedSize(leading.size() + trailing.size(), compression));
+    out_buffer.resize(CompressConcatenatedInto(leading, trailing, compression, out_buffer));
+    return out_buffer;
+}
+
+size_t CompressWithRawPrefixInto(
+    tcb::span<const uint8_t> raw_prefix, tcb::span<const uint8_t> bytes, CompressionCodec::type compression,
+    tcb::span<uint8_t> out) {
+    CheckOutputSize(out, raw_prefix.size() + MaxCompressedSize(bytes.size(), compression));
+
+    if (!raw_prefix.empty()) {
+        std::memcpy(out.data(), raw_prefix.data(), raw_prefix.size());
+    }
+    auto compressed_out = out.subspan(raw_prefix.size());
+    return raw_prefix.size() + CompressConcatenatedInto(bytes, {}, compression, compressed_out);
+}
+
+std::vector<uint8_t> CompressWithRawPrefix(
+    tcb::span<const uint8_t> raw_prefix, tcb::span<const uint8_t> bytes, CompressionCodec::type compression) {
+    std::vector<uint8_t> out_buffer(raw_prefix.size() + MaxCompressedSize(bytes.size(), compression));
+    out_buffer.resize(CompressWithRawPrefixInto(raw_prefix, bytes, compression, out_buffer));
+    return out_buffer;
+}
+
 } // namespace dbps::compression
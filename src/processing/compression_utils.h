@@ -49,4 +49,65 @@ std::vector<uint8_t> Compress(tcb::span<const uint8_t> bytes, CompressionCodec::
  */
 std::vector<uint8_t> Decompress(tcb::span<const uint8_t> bytes, CompressionCodec::type compression);
 
+/**
+ * Upper bound of the Compress output size for an input of the given size.
+ *
+ * @param uncompressed_size The size of the bytes to compress
+ * @param compression The compression codec to use
+ * @return Maximum compressed size (uncompressed_size if UNCOMPRESSED)
+ * @throws DBPSUnsupportedException if the compression codec is not supported
+ */
+size_t MaxCompressedSize(size_t uncompressed_size, CompressionCodec::type compression);
+
+/**
+ * Compress the concatenation of two byte ranges, without materializing the concatenation.
+ * Equivalent to Compress(Join(leading, trailing), compression); the output is written in a single buffer.
+ * For SNAPPY, the compressor reads both ranges directly (scatter-gather input).
+ *
+ * @param leading The first part of the bytes to compress
+ * @param trailing The second part of the bytes to compress
+ * @param compression The compression codec to use
+ * @return Compressed bytes, or the concatenated bytes if UNCOMPRESSED
+ * @throws DBPSUnsupportedException if the compression codec is not supported
+ */
+std::vector<uint8_t> CompressConcatenated(
+    tcb::span<const uint8_t> leading, tcb::span<const uint8_t> trailing, CompressionCodec::type compression);
+
+/**
+ * Same as CompressConcatenated, writing into a caller-provided buffer.
+ *
+ * @param out Output buffer of at least MaxCompressedSize(leading.size() + trailing.size(), compression) bytes
+ * @return Number of bytes written to out
+ * @throws InvalidInputException if out is smaller than the bound
+ * @throws DBPSUnsupportedException if the compression codec is not supported
+ */
+size_t CompressConcatenatedInto(
+    tcb::span<const uint8_t> leading, tcb::span<const uint8_t> trailing, CompressionCodec::type compression,
+    tcb::span<uint8_t> out);
+
+/**
+ * Compress bytes and prepend an uncompressed prefix, written in a single buffer.
+ * Equivalent to Join(raw_prefix, Compress(bytes, compression)), without the intermediate compressed vector.
+ *
+ * @param raw_prefix Bytes copied as-is at the start of the output
+ * @param bytes The bytes to compress after the prefix
+ * @param compression The compression codec to use
+ * @return raw_prefix followed by the compressed bytes (or the original bytes if UNCOMPRESSED)
+ * @throws DBPSUnsupportedException if the compression codec is not supported
+ */
+std::vector<uint8_t> CompressWithRawPrefix(
+    tcb::span<const uint8_t> raw_prefix, tcb::span<const uint8_t> bytes, CompressionCodec::type compression);
+
+/**
+ * Same as CompressWithRawPrefix, writing into a caller-provided buffer.
+ *
+ * @param out Output buffer of at least raw_prefix.size() + MaxCompressedSize(bytes.size(), compression) bytes
+ * @return Number of bytes written to out
+ * @throws InvalidInputException if out is smaller than the bound
+ * @throws DBPSUnsupportedException if the compression codec is not supported
+ */
+size_t CompressWithRawPrefixInto(
+    tcb::span<const uint8_t> raw_prefix, tcb::span<const uint8_t> bytes, CompressionCodec::type compression,
+    tcb::span<uint8_t> out);
+
 } // namespace dbps::compression
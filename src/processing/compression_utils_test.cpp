@@ -161,3 +161,48 @@ TEST(CompressionUtils, Decompress_UnsupportedCodec_AllTypes) {
     EXPECT_THROW(Decompress(input, CompressionCodec::LZ4), DBPSUnsupportedException);
 }
 
+
+TEST(CompressionUtils, CompressConcatenated_MatchesCompressOfJoinedBytes) {
+    std::vector<uint8_t> leading = {0x01, 0x02, 0x03};
+    std::vector<uint8_t> trailing(1000, 0xAA);
+    std::vector<uint8_t> joined = leading;
+    joined.insert(joined.end(), trailing.begin(), trailing.end());
+
+    EXPECT_EQ(CompressConcatenated(leading, trailing, CompressionCodec::UNCOMPRESSED), joined);
+
+    auto compressed = CompressConcatenated(leading, trailing, CompressionCodec::SNAPPY);
+    EXPECT_EQ(compressed, Compress(joined, CompressionCodec::SNAPPY));
+    EXPECT_EQ(Decompress(compressed, CompressionCodec::SNAPPY), joined);
+}
+
+TEST(CompressionUtils, CompressConcatenated_EmptyParts) {
+    std::vector<uint8_t> empty;
+    std::vector<uint8_t> bytes = {0x10, 0x20, 0x30};
+
+    EXPECT_TRUE(CompressConcatenated(empty, empty, CompressionCodec::SNAPPY).empty());
+    EXPECT_EQ(Decompress(CompressConcatenated(empty, bytes, CompressionCodec::SNAPPY), CompressionCodec::SNAPPY), bytes);
+    EXPECT_EQ(Decompress(CompressConcatenated(bytes, empty, CompressionCodec::SNAPPY), CompressionCodec::SNAPPY), bytes);
+}
+
+TEST(CompressionUtils, CompressWithRawPrefix_MatchesPrefixJoinedWithCompressedBytes) {
+    std::vector<uint8_t> prefix = {0x01, 0x02};
+    std::vector<uint8_t> bytes(500, 0x55);
+
+    auto expected = prefix;
+    auto compressed = Compress(bytes, CompressionCodec::SNAPPY);
+    expected.insert(expected.end(), compressed.begin(), compressed.end());
+    EXPECT_EQ(CompressWithRawPrefix(prefix, bytes, CompressionCodec::SNAPPY), expected);
+
+    auto uncompressed_expected = prefix;
+    uncompressed_expected.insert(uncompressed_expected.end(), bytes.begin(), bytes.end());
+    EXPECT_EQ(CompressWithRawPrefix(prefix, bytes, CompressionCodec::UNCOMPRESSED), uncompressed_expected);
+
+    // Empty bytes compress to nothing, same as Compress.
+    EXPECT_EQ(CompressWithRawPrefix(prefix, {}, CompressionCodec::SNAPPY), prefix);
+}
+
+TEST(CompressionUtils, CompressConcatenated_UnsupportedCodec) {
+    std::vector<uint8_t> input = {0x01, 0x02, 0x03};
+    EXPECT_THROW(CompressConcatenated(input, input, CompressionCodec::GZIP), DBPSUnsupportedException);
+    EXPECT_THROW(CompressWithRawPrefix(input, input, CompressionCodec::GZIP), DBPSUnsupportedException);
+}
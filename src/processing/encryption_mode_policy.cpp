@@ -0,0 +1,312 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "encryption_mode_policy.h"
+#include "encryption_sequencer.h"
+#include "column_encryption_context.h"
+#include "enum_utils.h"
+#include "../common/bytes_utils.h"
+#include "../common/exceptions.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using namespace dbps::external;
+using namespace dbps::enum_utils;
+
+namespace {
+    constexpr int kCostModelVersion = 1;
+    constexpr const char* kModeNames[] = {"per_block", "per_value"};
+
+    constexpr const char* kPolicyConfigKey = "encryption_mode_policy";
+    constexpr const char* kMaxPageLatencyConfigKey = "encryption_mode_max_page_latency_us";
+    constexpr const char* kCostModelFileConfigKey = "encryption_mode_cost_model_file";
+
+    constexpr Type::type kAllDatatypes[] = {
+        Type::BOOLEAN, Type::INT32, Type::INT64, Type::INT96, Type::FLOAT,
+        Type::DOUBLE, Type::BYTE_ARRAY, Type::FIXED_LEN_BYTE_ARRAY};
+
+    // Synthetic values for calibration
+    constexpr int kCalibrationFixedLenByteArrayLength = 16;
+    constexpr size_t kCalibrationByteArrayValueLength = 12;
+}
+
+// EncryptionCostModel implementation
+
+EncryptionCostModel::EncryptionCostModel() {
+    // Conservative defaults: per-value pays for decoding the page and for per-value headers.
+    for (auto datatype : kAllDatatypes) {
+        SetCost(datatype, EncryptionMode::PER_BLOCK, 1000.0, 0.5);
+        SetCost(datatype, EncryptionMode::PER_VALUE, 5000.0, datatype == Type::BYTE_ARRAY ? 4.0 : 2.0);
+    }
+}
+
+size_t EncryptionCostModel::DatatypeSlot(Type::type datatype) {
+    const auto slot = static_cast<size_t>(datatype);
+    if (slot >= kNumDatatypes) {
+        throw InvalidInputException("Invalid datatype for the encryption cost model: " + std::to_string(slot));
+    }
+    return slot;
+}
+
+double EncryptionCostModel::EstimatePageCostNanos(Type::type datatype, EncryptionMode mode, size_t page_size) const {
+    const auto& cost = costs_[DatatypeSlot(datatype)][static_cast<size_t>(mode)];
+    return cost.fixed_nanos + cost.nanos_per_byte * static_cast<double>(page_size);
+}
+
+void EncryptionCostModel::SetCost(Type::type datatype, EncryptionMode mode, double fixed_nanos, double nanos_per_byte) {
+    if (!(fixed_nanos >= 0.0) || !(nanos_per_byte >= 0.0) || std::isinf(fixed_nanos) || std::isinf(nanos_per_byte)) {
+        throw InvalidInputException("Encryption costs must be finite and non-negative");
+    }
+    costs_[DatatypeSlot(datatype)][static_cast<size_t>(mode)] = Cost{fixed_nanos, nanos_per_byte};
+}
+
+std::string EncryptionCostModel::ToJson() const {
+    nlohmann::json json;
+    json["version"] = kCostModelVersion;
+    for (auto datatype : kAllDatatypes) {
+        auto& datatype_json = json["costs"][std::string(to_string(datatype))];
+        for (size_t mode = 0; mode < 2; ++mode) {
+            const auto& cost = costs_[DatatypeSlot(datatype)][mode];
+            datatype_json[kModeNames[mode]] = {{"fixed_nanos", cost.fixed_nanos}, {"nanos_per_byte", cost.nanos_per_byte}};
+        }
+    }
+    return json.dump(2);
+}
+
+EncryptionCostModel EncryptionCostModel::FromJson(const std::string& json_string) {
+    try {
+        auto json = nlohmann::json::parse(json_string);
+        if (json.value("version", 0) != kCostModelVersion) {
+            throw InvalidInputException("Unsupported encryption cost model version");
+        }
+        EncryptionCostModel model;
+        const auto& costs_json = json.at("costs");
+        for (auto datatype : kAllDatatypes) {
+            const auto& datatype_json = costs_json.at(std::string(to_string(datatype)));
+            for (size_t mode = 0; mode < 2; ++mode) {
+                const auto& cost_json = datatype_json.at(kModeNames[mode]);
+                model.SetCost(datatype, static_cast<EncryptionMode>(mode),
+                              cost_json.at("fixed_nanos").get<double>(), cost_json.at("nanos_per_byte").get<double>());
+            }
+        }
+        return model;
+    } catch (const nlohmann::json::exception& e) {
+        throw InvalidInputException("Malformed encryption cost model: " + std::string(e.what()));
+    }
+}
+
+void EncryptionCostModel::SaveToFile(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw InvalidInputException("Failed to open encryption cost model file for writing: " + path);
+    }
+    file << ToJson() << std::endl;
+    if (!file.good()) {
+        throw InvalidInputException("Failed to write encryption cost model file: " + path);
+    }
+}
+
+EncryptionCostModel EncryptionCostModel::LoadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw InvalidInputException("Failed to open encryption cost model file: " + path);
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return FromJson(contents.str());
+}
+
+// Calibration
+
+namespace {
+    struct CalibrationPage {
+        std::vector<uint8_t> payload;
+        std::map<std::string, std::string> encoding_attributes;
+    };
+
+    // Builds a PLAIN dictionary page of about page_bytes bytes for the datatype.
+    CalibrationPage BuildCalibrationPage(Type::type datatype, size_t page_bytes) {
+        size_t num_values = 0;
+        CalibrationPage page;
+        if (datatype == Type::BYTE_ARRAY) {
+            const size_t value_size = ::kSizePrefixBytes + kCalibrationByteArrayValueLength;
+            num_values = std::max<size_t>(1, page_bytes / value_size);
+            page.payload.reserve(num_values * value_size);
+            for (size_t i = 0; i < num_values; ++i) {
+                append_u32_le(page.payload, static_cast<uint32_t>(kCalibrationByteArrayValueLength));
+                for (size_t j = 0; j < kCalibrationByteArrayValueLength; ++j) {
+                    page.payload.push_back(static_cast<uint8_t>((i * 31 + j) % 251));
+                }
+            }
+        } else {
+            size_t element_size = 0;
+            switch (datatype) {
+                case Type::BOOLEAN: element_size = 1; break;  // 8 bit-packed values per byte
+                case Type::INT32: case Type::FLOAT: element_size = 4; break;
+                case Type::INT64: case Type::DOUBLE: element_size = 8; break;
+                case Type::INT96: element_size = 12; break;
+                default: element_size = kCalibrationFixedLenByteArrayLength; break;
+            }
+            const size_t num_elements = std::max<size_t>(1, page_bytes / element_size);
+            num_values = (datatype == Type::BOOLEAN) ? num_elements * 8 : num_elements;
+            page.payload.resize(num_elements * element_size);
+            for (size_t i = 0; i < page.payload.size(); ++i) {
+                page.payload[i] = static_cast<uint8_t>((i * 31) % 251);
+            }
+        }
+        page.encoding_attributes = {
+            {"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", std::to_string(num_values)}};
+        return page;
+    }
+
+    // Fastest of iterations encryptions of the page, in nanoseconds.
+    double MeasurePageCostNanos(
+        const std::shared_ptr<const ColumnEncryptionContext>& column_context,
+        const CalibrationPage& page,
+        size_t iterations) {
+        double min_nanos = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < iterations; ++i) {
+            DataBatchEncryptionSequencer sequencer(column_context, Encoding::PLAIN, page.encoding_attributes, {});
+            auto start = std::chrono::steady_clock::now();
+            bool result = sequencer.DecodeAndEncrypt(page.payload);
+            auto end = std::chrono::steady_clock::now();
+            if (!result) {
+                throw InvalidInputException("Calibration page encryption failed: " + sequencer.error_stage_ +
+                                            " - " + sequencer.error_message_);
+            }
+            min_nanos = std::min(min_nanos, std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        return min_nanos;
+    }
+}
+
+EncryptionCostModel CalibrateEncryptionCostModel(const EncryptionCostCalibrationOptions& options) {
+    if (options.iterations == 0 || options.small_page_bytes == 0 ||
+        options.large_page_bytes <= options.small_page_bytes) {
+        throw InvalidInputException(
+            "Calibration requires iterations > 0 and 0 < small_page_bytes < large_page_bytes");
+    }
+
+    EncryptionCostModel model;
+    for (auto datatype : kAllDatatypes) {
+        const auto small_page = BuildCalibrationPage(datatype, options.small_page_bytes);
+        const auto large_page = BuildCalibrationPage(datatype, options.large_page_bytes);
+        const std::optional<int> datatype_length = (datatype == Type::FIXED_LEN_BYTE_ARRAY)
+            ? std::optional<int>(kCalibrationFixedLenByteArrayLength) : std::nullopt;
+
+        for (auto mode : {EncryptionMode::PER_BLOCK, EncryptionMode::PER_VALUE}) {
+            ColumnEncryptionOptions column_options;
+            column_options.mode_policy = std::make_shared<const EncryptionModePolicy>(
+                mode == EncryptionMode::PER_BLOCK ? EncryptionModePolicy::Kind::PER_BLOCK
+                                                  : EncryptionModePolicy::Kind::PER_VALUE_WHEN_SUPPORTED);
+            auto column_context = std::make_shared<const ColumnEncryptionContext>(
+                "calibration_column", datatype, datatype_length,
+                CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+                "calibration_key", "calibration_user", "{}", column_options);
+
+            // Fit the per-page and per-byte costs from the two page sizes.
+            const double small_nanos = MeasurePageCostNanos(column_context, small_page, options.iterations);
+            const double large_nanos = MeasurePageCostNanos(column_context, large_page, options.iterations);
+            const double size_delta = static_cast<double>(large_page.payload.size() - small_page.payload.size());
+            const double nanos_per_byte = std::max(0.0, (large_nanos - small_nanos) / size_delta);
+            const double fixed_nanos =
+                std::max(0.0, small_nanos - nanos_per_byte * static_cast<double>(small_page.payload.size()));
+            model.SetCost(datatype, mode, fixed_nanos, nanos_per_byte);
+        }
+    }
+    return model;
+}
+
+// EncryptionModePolicy implementation
+
+EncryptionModePolicy::EncryptionModePolicy(Kind kind) : kind_(kind) {
+    if (kind_ == Kind::COST) {
+        throw InvalidInputException("The cost encryption mode policy requires a cost model and a latency budget");
+    }
+}
+
+EncryptionModePolicy::EncryptionModePolicy(
+    EncryptionCostModel cost_model, double max_page_latency_nanos, LoadProvider load_provider)
+    : kind_(Kind::COST),
+      cost_model_(std::move(cost_model)),
+      max_page_latency_nanos_(max_page_latency_nanos),
+      load_provider_(std::move(load_provider)) {
+    if (!(max_page_latency_nanos_ > 0.0)) {
+        throw InvalidInputException("The encryption mode latency budget must be positive");
+    }
+}
+
+std::shared_ptr<const EncryptionModePolicy> EncryptionModePolicy::FromConfiguration(
+    const std::map<std::string, std::string>& configuration, LoadProvider load_provider) {
+    auto policy_it = configuration.find(kPolicyConfigKey);
+    const std::string policy_name = (policy_it == configuration.end()) ? "per_value_when_supported" : policy_it->second;
+
+    if (policy_name == "per_value_when_supported") {
+        return std::make_shared<const EncryptionModePolicy>(Kind::PER_VALUE_WHEN_SUPPORTED);
+    }
+    if (policy_name == "per_block") {
+        return std::make_shared<const EncryptionModePolicy>(Kind::PER_BLOCK);
+    }
+    if (policy_name != "cost") {
+        throw InvalidInputException("Invalid " + std::string(kPolicyConfigKey) + ": " + policy_name);
+    }
+
+    auto latency_it = configuration.find(kMaxPageLatencyConfigKey);
+    if (latency_it == configuration.end()) {
+        throw InvalidInputException("The cost encryption mode policy requires " + std::string(kMaxPageLatencyConfigKey));
+    }
+    double max_page_latency_us = 0.0;
+    try {
+        max_page_latency_us = std::stod(latency_it->second);
+    } catch (const std::exception&) {
+        throw InvalidInputException("Invalid " + std::string(kMaxPageLatencyConfigKey) + ": " + latency_it->second);
+    }
+
+    auto cost_model_it = configuration.find(kCostModelFileConfigKey);
+    EncryptionCostModel cost_model = (cost_model_it == configuration.end())
+        ? EncryptionCostModel() : EncryptionCostModel::LoadFromFile(cost_model_it->second);
+    return std::make_shared<const EncryptionModePolicy>(
+        std::move(cost_model), max_page_latency_us * 1000.0, std::move(load_provider));
+}
+
+EncryptionMode EncryptionModePolicy::SelectMode(Type::type datatype, bool per_value_supported, size_t page_size) const {
+    if (!per_value_supported || kind_ == Kind::PER_BLOCK) {
+        return EncryptionMode::PER_BLOCK;
+    }
+    if (kind_ == Kind::PER_VALUE_WHEN_SUPPORTED) {
+        return EncryptionMode::PER_VALUE;
+    }
+
+    const double load_factor = load_provider_ ? 1.0 + std::max(0.0, load_provider_()) : 1.0;
+    const double per_value_nanos =
+        load_factor * cost_model_.EstimatePageCostNanos(datatype, EncryptionMode::PER_VALUE, page_size);
+    if (per_value_nanos <= max_page_latency_nanos_) {
+        return EncryptionMode::PER_VALUE;
+    }
+    // Over budget, per-block only wins if it is actually cheaper: a slower per-block page would miss the budget
+    // by more and give up the per-value layout for nothing.
+    const double per_block_nanos =
+        load_factor * cost_model_.EstimatePageCostNanos(datatype, EncryptionMode::PER_BLOCK, page_size);
+    return (per_block_nanos < per_value_nanos) ? EncryptionMode::PER_BLOCK : EncryptionMode::PER_VALUE;
+}
@@ -0,0 +1,171 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "enums.h"
+
+#ifndef DBPS_EXPORT
+#define DBPS_EXPORT
+#endif
+
+using namespace dbps::external;
+
+/**
+ * Encryption pipeline of a page.
+ * - PER_BLOCK encrypts the page payload as a single block.
+ * - PER_VALUE decodes the page and encrypts its values as a value list.
+ */
+enum class EncryptionMode {
+    PER_BLOCK = 0,
+    PER_VALUE = 1
+};
+
+/**
+ * Measured encryption cost of the host for each datatype and encryption mode.
+ *
+ * The cost of a page is modeled as a fixed per-page cost plus a per-byte cost of the page payload:
+ *   cost_nanos = fixed_nanos + nanos_per_byte * page_size
+ * A model is produced on the target host by CalibrateEncryptionCostModel (see the calibrate_encryption_costs
+ * command) and stored as JSON:
+ *   {"version": 1, "costs": {"INT32": {"per_block": {"fixed_nanos": 900.0, "nanos_per_byte": 0.4},
+ *                                      "per_value": {"fixed_nanos": 2500.0, "nanos_per_byte": 1.9}}, ...}}
+ */
+class DBPS_EXPORT EncryptionCostModel {
+public:
+    // Default model with conservative estimates, used when no calibrated model is configured.
+    EncryptionCostModel();
+
+    // Estimated cost of encrypting a page of page_size bytes, in nanoseconds.
+    double EstimatePageCostNanos(Type::type datatype, EncryptionMode mode, size_t page_size) const;
+
+    void SetCost(Type::type datatype, EncryptionMode mode, double fixed_nanos, double nanos_per_byte);
+
+    /**
+     * JSON serialization. FromJson requires an entry for both modes of every datatype.
+     * @throws InvalidInputException on malformed JSON or missing entries
+     */
+    std::string ToJson() const;
+    static EncryptionCostModel FromJson(const std::string& json);
+
+    /**
+     * File helpers around ToJson/FromJson.
+     * @throws InvalidInputException if the file cannot be read or written, or holds an invalid model
+     */
+    void SaveToFile(const std::string& path) const;
+    static EncryptionCostModel LoadFromFile(const std::string& path);
+
+private:
+    struct Cost {
+        double fixed_nanos = 0.0;
+        double nanos_per_byte = 0.0;
+    };
+
+    static constexpr size_t kNumDatatypes = static_cast<size_t>(Type::FIXED_LEN_BYTE_ARRAY) + 1;
+    std::array<std::array<Cost, 2>, kNumDatatypes> costs_{};
+
+    static size_t DatatypeSlot(Type::type datatype);
+};
+
+/**
+ * Options of CalibrateEncryptionCostModel.
+ * Every datatype is measured on synthetic PLAIN dictionary pages of small_page_bytes and large_page_bytes,
+ * keeping the fastest of iterations runs, and the per-page and per-byte costs are fitted from both sizes.
+ */
+struct EncryptionCostCalibrationOptions {
+    size_t small_page_bytes = 64 * 1024;
+    size_t large_page_bytes = 1024 * 1024;
+    size_t iterations = 5;
+};
+
+/**
+ * Measures the cost matrix of the host by running both encryption pipelines through
+ * DataBatchEncryptionSequencer. BOOLEAN pages only support per-block encryption, so both of its
+ * modes get the per-block cost.
+ * @throws InvalidInputException if the options are invalid
+ */
+DBPS_EXPORT EncryptionCostModel CalibrateEncryptionCostModel(const EncryptionCostCalibrationOptions& options);
+
+/**
+ * Per-column policy choosing between per-block and per-value encryption for a page.
+ *
+ * Pages that do not support per-value encryption (see ColumnEncryptionContext::SupportsPerValueEncryption)
+ * are always encrypted per-block. For the other pages:
+ * - PER_VALUE_WHEN_SUPPORTED (default) always picks per-value.
+ * - PER_BLOCK always picks per-block.
+ * - COST picks per-value while its estimated page cost stays within the latency budget. Over budget, it falls
+ *   back to per-block when the per-block estimate is lower, and keeps per-value otherwise. With a load
+ *   provider, the estimates are scaled by (1 + load), so busy servers fall back earlier.
+ *
+ * Under COST, pages of the same type may get different modes, so the sequencer records the mode of each
+ * page in its ciphertext (see IsAdaptive).
+ */
+class DBPS_EXPORT EncryptionModePolicy {
+public:
+    enum class Kind {
+        PER_VALUE_WHEN_SUPPORTED,
+        PER_BLOCK,
+        COST
+    };
+
+    // Returns the current load of the host: 0 when idle, 1 when all threads are busy, higher when overloaded.
+    using LoadProvider = std::function<double()>;
+
+    // Default policy: PER_VALUE_WHEN_SUPPORTED.
+    EncryptionModePolicy() = default;
+
+    // Static policy (PER_VALUE_WHEN_SUPPORTED or PER_BLOCK).
+    explicit EncryptionModePolicy(Kind kind);
+
+    // COST policy with a latency budget per page.
+    EncryptionModePolicy(
+        EncryptionCostModel cost_model, double max_page_latency_nanos, LoadProvider load_provider = nullptr);
+
+    /**
+     * Builds a policy from configuration keys:
+     * - "encryption_mode_policy": "per_value_when_supported" (default), "per_block" or "cost".
+     * - "encryption_mode_max_page_latency_us": per-page latency budget, required for "cost".
+     * - "encryption_mode_cost_model_file": calibrated cost model for "cost" (defaults to the built-in model).
+     * load_provider is only used by the "cost" policy.
+     * @throws InvalidInputException on invalid values
+     */
+    static std::shared_ptr<const EncryptionModePolicy> FromConfiguration(
+        const std::map<std::string, std::string>& configuration, LoadProvider load_provider = nullptr);
+
+    // Picks the encryption mode of a page of page_size bytes.
+    EncryptionMode SelectMode(Type::type datatype, bool per_value_supported, size_t page_size) const;
+
+    // True if pages of the same type may get different modes, so the mode must be recorded per page.
+    bool IsAdaptive() const { return kind_ == Kind::COST; }
+
+    Kind GetKind() const { return kind_; }
+
+private:
+    Kind kind_ = Kind::PER_VALUE_WHEN_SUPPORTED;
+    EncryptionCostModel cost_model_;
+    double max_page_latency_nanos_ = 0.0;
+    LoadProvider load_provider_;
+};
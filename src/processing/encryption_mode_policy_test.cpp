@@ -0,0 +1,160 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "encryption_mode_policy.h"
+#include "../common/enums.h"
+#include "../common/exceptions.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <map>
+#include <string>
+
+using namespace dbps::external;
+
+TEST(EncryptionCostModel, DefaultEstimates) {
+    EncryptionCostModel model;
+    // Per-value is costlier than per-block, and costs grow with the page size.
+    EXPECT_GT(model.EstimatePageCostNanos(Type::INT32, EncryptionMode::PER_VALUE, 1024),
+              model.EstimatePageCostNanos(Type::INT32, EncryptionMode::PER_BLOCK, 1024));
+    EXPECT_GT(model.EstimatePageCostNanos(Type::INT32, EncryptionMode::PER_VALUE, 2048),
+              model.EstimatePageCostNanos(Type::INT32, EncryptionMode::PER_VALUE, 1024));
+
+    model.SetCost(Type::DOUBLE, EncryptionMode::PER_VALUE, 100.0, 2.0);
+    EXPECT_DOUBLE_EQ(model.EstimatePageCostNanos(Type::DOUBLE, EncryptionMode::PER_VALUE, 50), 200.0);
+    EXPECT_THROW(model.SetCost(Type::DOUBLE, EncryptionMode::PER_VALUE, -1.0, 2.0), InvalidInputException);
+}
+
+TEST(EncryptionCostModel, JsonRoundTrip) {
+    EncryptionCostModel model;
+    model.SetCost(Type::BYTE_ARRAY, EncryptionMode::PER_BLOCK, 12.5, 0.25);
+    model.SetCost(Type::BYTE_ARRAY, EncryptionMode::PER_VALUE, 300.0, 3.5);
+
+    auto restored = EncryptionCostModel::FromJson(model.ToJson());
+    EXPECT_DOUBLE_EQ(restored.EstimatePageCostNanos(Type::BYTE_ARRAY, EncryptionMode::PER_BLOCK, 10), 15.0);
+    EXPECT_DOUBLE_EQ(restored.EstimatePageCostNanos(Type::BYTE_ARRAY, EncryptionMode::PER_VALUE, 10), 335.0);
+
+    const std::string path = ::testing::TempDir() + "encryption_mode_policy_test_model.json";
+    model.SaveToFile(path);
+    auto loaded = EncryptionCostModel::LoadFromFile(path);
+    EXPECT_DOUBLE_EQ(loaded.EstimatePageCostNanos(Type::BYTE_ARRAY, EncryptionMode::PER_VALUE, 10), 335.0);
+    std::remove(path.c_str());
+}
+
+TEST(EncryptionCostModel, InvalidJson) {
+    EXPECT_THROW(EncryptionCostModel::FromJson("not json"), InvalidInputException);
+    EXPECT_THROW(EncryptionCostModel::FromJson(R"({"version": 2, "costs": {}})"), InvalidInputException);
+    EXPECT_THROW(EncryptionCostModel::FromJson(R"({"version": 1, "costs": {}})"), InvalidInputException);
+    EXPECT_THROW(EncryptionCostModel::LoadFromFile("/nonexistent/cost_model.json"), InvalidInputException);
+}
+
+TEST(EncryptionModePolicy, StaticPolicies) {
+    EncryptionModePolicy default_policy;
+    EXPECT_FALSE(default_policy.IsAdaptive());
+    EXPECT_EQ(default_policy.SelectMode(Type::INT32, true, 1 << 20), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(default_policy.SelectMode(Type::INT32, false, 16), EncryptionMode::PER_BLOCK);
+
+    EncryptionModePolicy per_block_policy(EncryptionModePolicy::Kind::PER_BLOCK);
+    EXPECT_FALSE(per_block_policy.IsAdaptive());
+    EXPECT_EQ(per_block_policy.SelectMode(Type::INT32, true, 16), EncryptionMode::PER_BLOCK);
+
+    EXPECT_THROW(EncryptionModePolicy(EncryptionModePolicy::Kind::COST), InvalidInputException);
+}
+
+TEST(EncryptionModePolicy, CostPolicyHonorsBudgetAndLoad) {
+    EncryptionCostModel model;
+    model.SetCost(Type::INT64, EncryptionMode::PER_VALUE, 1000.0, 1.0);
+
+    // Budget of 2000ns: per-value up to 1000 bytes.
+    EncryptionModePolicy policy(model, 2000.0);
+    EXPECT_TRUE(policy.IsAdaptive());
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 1000), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 1001), EncryptionMode::PER_BLOCK);
+    EXPECT_EQ(policy.SelectMode(Type::INT64, false, 10), EncryptionMode::PER_BLOCK);
+
+    // A load of 1 doubles the estimates.
+    double load = 0.0;
+    EncryptionModePolicy load_aware_policy(model, 2000.0, [&load]() { return load; });
+    EXPECT_EQ(load_aware_policy.SelectMode(Type::INT64, true, 500), EncryptionMode::PER_VALUE);
+    load = 1.0;
+    EXPECT_EQ(load_aware_policy.SelectMode(Type::INT64, true, 500), EncryptionMode::PER_BLOCK);
+    EXPECT_EQ(load_aware_policy.SelectMode(Type::INT64, true, 0), EncryptionMode::PER_VALUE);
+
+    EXPECT_THROW(EncryptionModePolicy(model, 0.0), InvalidInputException);
+}
+
+TEST(EncryptionModePolicy, CostPolicyComparesBothModesOverBudget) {
+    EncryptionCostModel model;
+    model.SetCost(Type::INT64, EncryptionMode::PER_VALUE, 1000.0, 1.0);
+    model.SetCost(Type::INT64, EncryptionMode::PER_BLOCK, 3000.0, 0.5);
+    EncryptionModePolicy policy(model, 2000.0);
+
+    // Over budget from 1001 bytes, but per-block only gets cheaper past 4000 bytes.
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 1000), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 2000), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 4000), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(policy.SelectMode(Type::INT64, true, 4001), EncryptionMode::PER_BLOCK);
+
+    // The load scales both estimates, so it does not move the crossover.
+    EncryptionModePolicy load_aware_policy(model, 2000.0, []() { return 3.0; });
+    EXPECT_EQ(load_aware_policy.SelectMode(Type::INT64, true, 4000), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(load_aware_policy.SelectMode(Type::INT64, true, 4001), EncryptionMode::PER_BLOCK);
+}
+
+TEST(EncryptionModePolicy, FromConfiguration) {
+    EXPECT_EQ(EncryptionModePolicy::FromConfiguration({})->GetKind(),
+              EncryptionModePolicy::Kind::PER_VALUE_WHEN_SUPPORTED);
+    EXPECT_EQ(EncryptionModePolicy::FromConfiguration({{"encryption_mode_policy", "per_block"}})->GetKind(),
+              EncryptionModePolicy::Kind::PER_BLOCK);
+
+    auto cost_policy = EncryptionModePolicy::FromConfiguration(
+        {{"encryption_mode_policy", "cost"}, {"encryption_mode_max_page_latency_us", "10"}});
+    EXPECT_EQ(cost_policy->GetKind(), EncryptionModePolicy::Kind::COST);
+    // Default INT32 per-value model: 5000ns + 2ns/B, within 10us up to 2500 bytes.
+    EXPECT_EQ(cost_policy->SelectMode(Type::INT32, true, 2500), EncryptionMode::PER_VALUE);
+    EXPECT_EQ(cost_policy->SelectMode(Type::INT32, true, 2501), EncryptionMode::PER_BLOCK);
+
+    EXPECT_THROW(EncryptionModePolicy::FromConfiguration({{"encryption_mode_policy", "fastest"}}),
+                 InvalidInputException);
+    EXPECT_THROW(EncryptionModePolicy::FromConfiguration({{"encryption_mode_policy", "cost"}}),
+                 InvalidInputException);
+    EXPECT_THROW(EncryptionModePolicy::FromConfiguration(
+                     {{"encryption_mode_policy", "cost"}, {"encryption_mode_max_page_latency_us", "abc"}}),
+                 InvalidInputException);
+    EXPECT_THROW(EncryptionModePolicy::FromConfiguration(
+                     {{"encryption_mode_policy", "cost"}, {"encryption_mode_max_page_latency_us", "10"},
+                      {"encryption_mode_cost_model_file", "/nonexistent/cost_model.json"}}),
+                 InvalidInputException);
+}
+
+TEST(EncryptionModePolicy, Calibration) {
+    EncryptionCostCalibrationOptions options;
+    options.small_page_bytes = 256;
+    options.large_page_bytes = 1024;
+    options.iterations = 1;
+    auto model = CalibrateEncryptionCostModel(options);
+    for (auto datatype : {Type::BOOLEAN, Type::INT32, Type::BYTE_ARRAY, Type::FIXED_LEN_BYTE_ARRAY}) {
+        for (auto mode : {EncryptionMode::PER_BLOCK, EncryptionMode::PER_VALUE}) {
+            EXPECT_GT(model.EstimatePageCostNanos(datatype, mode, options.large_page_bytes), 0.0);
+        }
+    }
+    // The calibrated model can be persisted.
+    EXPECT_NO_THROW(EncryptionCostModel::FromJson(model.ToJson()));
+
+    options.large_page_bytes = options.small_page_bytes;
+    EXPECT_THROW(CalibrateEncryptionCostModel(options), InvalidInputException);
+}
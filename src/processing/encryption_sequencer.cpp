@@ -17,11 +17,14 @@
 
 #include "encryption_sequencer.h"
 #include "enum_utils.h"
+#include "byte_array_offsets_buffer.h"
 #include "parquet_utils.h"
 #include "../common/bytes_utils.h"
 #include "compression_utils.h"
+#include "value_dedup.h"
+#include "encryptors/encryptor_utils.h"
 #include "../common/exceptions.h"
-#include "encryptors/basic_xor_encryptor.h"
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <sstream>
@@ -33,26 +36,272 @@
 using namespace dbps::external;
 using namespace dbps::enum_utils;
 using namespace dbps::compression;
+using namespace dbps::processing;
 
 namespace {
     constexpr const char* DBPS_VERSION_KEY = "dbps_agent_version";
     constexpr const char* DBPS_VERSION = "v0.01";
+    // Ciphertext format of columns with columnar value lists: value-list ciphertexts of variable-size values may
+    // use the columnar layout (see encryptor_utils.h). Earlier readers reject it on the version check.
+    constexpr const char* DBPS_VERSION_COLUMNAR = "v0.02";
     constexpr const char* ENCRYPTION_MODE_KEY_DICTIONARY_PAGE = "encrypt_mode_dict_page";
     constexpr const char* ENCRYPTION_MODE_KEY_DATA_PAGE = "encrypt_mode_data_page";
     constexpr const char* ENCRYPTION_MODE_PER_BLOCK = "per_block";
     constexpr const char* ENCRYPTION_MODE_PER_VALUE = "per_value";
-}
+    // Mode of columns whose encryption mode policy is adaptive: the mode of each page is tagged in its ciphertext.
+    constexpr const char* ENCRYPTION_MODE_ADAPTIVE = "adaptive";
+    constexpr size_t kModeTagBytes = 1;
+    constexpr uint8_t MODE_TAG_PER_BLOCK = 0x00;
+    constexpr uint8_t MODE_TAG_PER_VALUE = 0x01;
+    // Mode of dictionary index data pages under dictionary index passthrough: [tag][payload as-is]. The tag is the
+    // encryptor's block tag (a MAC), or a u64 checksum for encryptors without block tags when the column allows
+    // it explicitly (ColumnEncryptionOptions::insecure_dictionary_index_checksum).
+    constexpr const char* ENCRYPTION_MODE_DICTIONARY_INDEX_PASSTHROUGH = "dictionary_index_passthrough";
+    constexpr size_t kIndexChecksumBytes = sizeof(uint64_t);
+    constexpr const char* ENCRYPTION_FRAMING_KEY = "encrypt_framing";
+    constexpr const char* ENCRYPTION_FRAMING_CHUNKED = "chunked";
+    // Per-value pages of columns with value deduplication in DICTIONARY mode start with a value layout tag:
+    //   regular:    [0x00][u32 level ciphertext size][level ciphertext][value-list ciphertext]
+    //   dictionary: [0x01][u32 level ciphertext size][level ciphertext]
+    //               [u32 index block ciphertext size][index block ciphertext][distinct value-list ciphertext]
+    // Whether a page is deduplicated is decided per page, so the layout is tagged in the ciphertext.
+    constexpr const char* VALUE_DEDUP_KEY = "encrypt_value_dedup";
+    constexpr const char* VALUE_DEDUP_DICTIONARY = "dictionary";
+    constexpr size_t kValueLayoutTagBytes = 1;
+    constexpr uint8_t VALUE_LAYOUT_TAG_REGULAR = 0x00;
+    constexpr uint8_t VALUE_LAYOUT_TAG_DICTIONARY = 0x01;
 
-// Helper function to create encryptor instance
-static std::unique_ptr<DBPSEncryptor> CreateEncryptor(
-    const std::string& key_id,
-    const std::string& column_name,
-    const std::string& user_id,
-    const std::string& application_context,
-    Type::type datatype) {
+    // Chunk stream layout of the streaming mode (see DataBatchEncryptionSequencer):
+    //   [u32 num_chunks][u32 plaintext_size] then per chunk [u32 chunk_plaintext_size][u32 chunk_ciphertext_size][ciphertext]
+    constexpr size_t kChunkStreamHeaderBytes = 2 * ::kSizePrefixBytes;
+    constexpr size_t kChunkFrameHeaderBytes = 2 * ::kSizePrefixBytes;
+
+    // FNV-1a checksum of a passthrough page, seeded with the key id, for encryptors without block tags.
+    // key_id is not secret, so it only detects accidental corruption and pages swapped across keys: anyone
+    // who can modify the page can recompute it.
+    uint64_t ComputeIndexPageChecksum(const std::string& key_id, tcb::span<const uint8_t> payload) {
+        constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+        constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+        uint64_t checksum = kFnvOffsetBasis;
+        for (char c : key_id) {
+            checksum = (checksum ^ static_cast<uint8_t>(c)) * kFnvPrime;
+        }
+        for (uint8_t byte : payload) {
+            checksum = (checksum ^ byte) * kFnvPrime;
+        }
+        return checksum;
+    }
+
+    // Upper bound of a chunk stream holding bytes_size bytes encrypted per-block in chunks of chunk_size.
+    std::optional<size_t> MaxBlockChunkStreamSize(DBPSEncryptor& encryptor, size_t bytes_size, size_t chunk_size) {
+        const size_t num_full_chunks = bytes_size / chunk_size;
+        const size_t last_chunk_size = bytes_size % chunk_size;
+        size_t max_size = kChunkStreamHeaderBytes;
+        if (num_full_chunks > 0) {
+            auto max_chunk = encryptor.MaxBlockCiphertextSize(chunk_size);
+            if (!max_chunk.has_value()) {
+                return std::nullopt;
+            }
+            max_size += num_full_chunks * (kChunkFrameHeaderBytes + max_chunk.value());
+        }
+        if (last_chunk_size > 0) {
+            auto max_chunk = encryptor.MaxBlockCiphertextSize(last_chunk_size);
+            if (!max_chunk.has_value()) {
+                return std::nullopt;
+            }
+            max_size += kChunkFrameHeaderBytes + max_chunk.value();
+        }
+        return max_size;
+    }
+
+    // Upper bound of a chunk stream holding the value chunks encrypted as value lists.
+    std::optional<size_t> MaxValueChunkStreamSize(DBPSEncryptor& encryptor, const std::vector<ValueBytesChunk>& chunks) {
+        size_t max_size = kChunkStreamHeaderBytes;
+        for (const auto& chunk : chunks) {
+            auto max_chunk = encryptor.MaxValueListCiphertextSize(chunk.value_bytes.size());
+            if (!max_chunk.has_value()) {
+                return std::nullopt;
+            }
+            max_size += kChunkFrameHeaderBytes + max_chunk.value();
+        }
+        return max_size;
+    }
+
+    void WriteChunkStreamHeader(tcb::span<uint8_t> out, size_t num_chunks, size_t plaintext_size) {
+        write_u32_le(out.data(), static_cast<uint32_t>(num_chunks));
+        write_u32_le(out.data() + ::kSizePrefixBytes, static_cast<uint32_t>(plaintext_size));
+    }
+
+    // Writes the frame header of a chunk whose ciphertext was written right after it.
+    void WriteChunkFrameHeader(tcb::span<uint8_t> frame, size_t plaintext_size, size_t ciphertext_size) {
+        write_u32_le(frame.data(), static_cast<uint32_t>(plaintext_size));
+        write_u32_le(frame.data() + ::kSizePrefixBytes, static_cast<uint32_t>(ciphertext_size));
+    }
+
+    // Encrypts bytes per-block in chunks of chunk_size into out, which holds at least MaxBlockChunkStreamSize bytes.
+    // Each chunk is encrypted straight into its frame. Returns the number of bytes written.
+    size_t WriteBlockChunkStream(
+        DBPSEncryptor& encryptor, tcb::span<const uint8_t> bytes, size_t chunk_size, tcb::span<uint8_t> out) {
+        const size_t num_chunks = (bytes.size() + chunk_size - 1) / chunk_size;
+        WriteChunkStreamHeader(out, num_chunks, bytes.size());
+        size_t offset = kChunkStreamHeaderBytes;
+        for (size_t chunk_offset = 0; chunk_offset < bytes.size(); chunk_offset += chunk_size) {
+            auto chunk = bytes.subspan(chunk_offset, std::min(chunk_size, bytes.size() - chunk_offset));
+            auto frame = out.subspan(offset);
+            const size_t ciphertext_size = encryptor.EncryptBlockInto(chunk, frame.subspan(kChunkFrameHeaderBytes));
+            WriteChunkFrameHeader(frame, chunk.size(), ciphertext_size);
+            offset += kChunkFrameHeaderBytes + ciphertext_size;
+        }
+        return offset;
+    }
 
-    // Return a BasicXorEncryptor instance.
-    return std::make_unique<BasicXorEncryptor>(key_id, column_name, user_id, application_context, datatype);
+    // Encrypts PLAIN BYTE_ARRAY value bytes as a columnar value list into out. The values are converted to the
+    // offsets+data layout in one pass, and the encryptor transforms its data region as one range.
+    size_t EncryptColumnarValueBytesInto(
+        DBPSEncryptor& encryptor, tcb::span<const uint8_t> value_bytes, size_t num_elements, tcb::span<uint8_t> out) {
+        auto values = ByteArrayOffsetsBuffer::FromPlainValueBytes(value_bytes, num_elements);
+        const size_t ciphertext_size = encryptor.EncryptColumnarValuesInto(values, out);
+        values.Release();
+        return ciphertext_size;
+    }
+
+    // Encrypts the value chunks as value lists into out, which holds at least MaxValueChunkStreamSize bytes.
+    // Only one chunk ciphertext is alive at a time. Returns the number of bytes written.
+    // Columnar value lists are encrypted straight into their frames.
+    size_t WriteValueChunkStream(
+        DBPSEncryptor& encryptor,
+        const std::vector<ValueBytesChunk>& chunks,
+        size_t value_bytes_size,
+        Type::type datatype,
+        const std::optional<int>& datatype_length,
+        Encoding::type encoding,
+        bool columnar,
+        tcb::span<uint8_t> out) {
+        WriteChunkStreamHeader(out, chunks.size(), value_bytes_size);
+        size_t offset = kChunkStreamHeaderBytes;
+        for (const auto& chunk : chunks) {
+            if (columnar) {
+                auto frame = out.subspan(offset);
+                const size_t ciphertext_size = EncryptColumnarValueBytesInto(
+                    encryptor, chunk.value_bytes, chunk.num_elements, frame.subspan(kChunkFrameHeaderBytes));
+                WriteChunkFrameHeader(frame, chunk.value_bytes.size(), ciphertext_size);
+                offset += kChunkFrameHeaderBytes + ciphertext_size;
+                continue;
+            }
+            auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
+                chunk.value_bytes, chunk.num_elements, datatype, datatype_length, encoding);
+            auto ciphertext = encryptor.EncryptValueList(typed_buffer);
+            auto frame = out.subspan(offset);
+            if (frame.size() < kChunkFrameHeaderBytes + ciphertext.size()) {
+                throw InvalidInputException("Value list ciphertext exceeds the encryptor size bound");
+            }
+            if (!ciphertext.empty()) {
+                std::memcpy(frame.data() + kChunkFrameHeaderBytes, ciphertext.data(), ciphertext.size());
+            }
+            WriteChunkFrameHeader(frame, chunk.value_bytes.size(), ciphertext.size());
+            offset += kChunkFrameHeaderBytes + ciphertext.size();
+            ReleaseBuffer(std::move(ciphertext));
+        }
+        return offset;
+    }
+
+    // Frame of a chunk within a chunk stream.
+    struct ChunkFrame {
+        size_t plaintext_size;
+        tcb::span<const uint8_t> ciphertext;
+    };
+
+    // Chunk stream read from a ciphertext. stream_size is the number of ciphertext bytes taken by the stream.
+    struct ChunkStream {
+        size_t plaintext_size = 0;
+        size_t stream_size = 0;
+        std::vector<ChunkFrame> frames;
+    };
+
+    // Reads and validates the chunk stream at the start of bytes. Only the frame headers are read.
+    ChunkStream ReadChunkStream(tcb::span<const uint8_t> bytes) {
+        if (bytes.size() < kChunkStreamHeaderBytes) {
+            throw InvalidInputException("Malformed chunk stream: truncated stream header");
+        }
+        const size_t num_chunks = read_u32_le(bytes.data());
+        ChunkStream stream;
+        stream.plaintext_size = read_u32_le(bytes.data() + ::kSizePrefixBytes);
+        // Every frame takes at least its header, which bounds the reservation on corrupt headers.
+        stream.frames.reserve(std::min(num_chunks, (bytes.size() - kChunkStreamHeaderBytes) / kChunkFrameHeaderBytes));
+
+        size_t offset = kChunkStreamHeaderBytes;
+        size_t total_plaintext_size = 0;
+        for (size_t i = 0; i < num_chunks; ++i) {
+            if (bytes.size() - offset < kChunkFrameHeaderBytes) {
+                throw InvalidInputException("Malformed chunk stream: truncated frame header of chunk " + std::to_string(i));
+            }
+            const size_t plaintext_size = read_u32_le(bytes.data() + offset);
+            const size_t ciphertext_size = read_u32_le(bytes.data() + offset + ::kSizePrefixBytes);
+            offset += kChunkFrameHeaderBytes;
+            if (bytes.size() - offset < ciphertext_size) {
+                throw InvalidInputException("Malformed chunk stream: truncated ciphertext of chunk " + std::to_string(i));
+            }
+            stream.frames.push_back({plaintext_size, bytes.subspan(offset, ciphertext_size)});
+            offset += ciphertext_size;
+            total_plaintext_size += plaintext_size;
+        }
+        if (total_plaintext_size != stream.plaintext_size) {
+            throw InvalidInputException("Malformed chunk stream: chunk sizes do not add up to the stream plaintext size");
+        }
+        stream.stream_size = offset;
+        return stream;
+    }
+
+    // Decrypts a per-block chunk stream into out, which holds exactly stream.plaintext_size bytes.
+    void DecryptBlockChunkStreamInto(DBPSEncryptor& encryptor, const ChunkStream& stream, tcb::span<uint8_t> out) {
+        size_t offset = 0;
+        for (const auto& frame : stream.frames) {
+            auto chunk_out = out.subspan(offset, frame.plaintext_size);
+            auto max_plaintext_size = encryptor.MaxBlockPlaintextSize(frame.ciphertext.size());
+            size_t plaintext_size = 0;
+            if (max_plaintext_size.has_value() && max_plaintext_size.value() <= chunk_out.size()) {
+                plaintext_size = encryptor.DecryptBlockInto(frame.ciphertext, chunk_out);
+            } else {
+                auto plaintext = encryptor.DecryptBlock(frame.ciphertext);
+                plaintext_size = plaintext.size();
+                if (plaintext_size == chunk_out.size() && plaintext_size > 0) {
+                    std::memcpy(chunk_out.data(), plaintext.data(), plaintext_size);
+                }
+                ReleaseBuffer(std::move(plaintext));
+            }
+            if (plaintext_size != frame.plaintext_size) {
+                throw InvalidInputException("Malformed chunk stream: decrypted chunk size does not match its frame");
+            }
+            offset += frame.plaintext_size;
+        }
+    }
+
+    // Decrypts a value list chunk stream into out, which holds exactly stream.plaintext_size bytes.
+    // Trusted chunks are decrypted in place with the encryptor's single-pass decoder.
+    void DecryptValueChunkStreamInto(
+        DBPSEncryptor& encryptor, const ChunkStream& stream, tcb::span<uint8_t> out, bool trusted) {
+        size_t offset = 0;
+        for (const auto& frame : stream.frames) {
+            if (trusted) {
+                const size_t written =
+                    encryptor.DecryptTrustedValueListInto(frame.ciphertext, out.subspan(offset, frame.plaintext_size));
+                if (written != frame.plaintext_size) {
+                    throw InvalidInputException("Malformed chunk stream: decrypted chunk size does not match its frame");
+                }
+                offset += written;
+                continue;
+            }
+            auto value_bytes = GetTypedValuesBufferAsValueBytes(encryptor.DecryptValueList(frame.ciphertext));
+            if (value_bytes.size() != frame.plaintext_size) {
+                throw InvalidInputException("Malformed chunk stream: decrypted chunk size does not match its frame");
+            }
+            if (!value_bytes.empty()) {
+                std::memcpy(out.data() + offset, value_bytes.data(), value_bytes.size());
+            }
+            offset += value_bytes.size();
+            ReleaseBuffer(std::move(value_bytes));
+        }
+    }
 }
 
 // Constructor implementation
@@ -68,18 +317,13 @@ DataBatchEncryptionSequencer::DataBatchEncryptionSequencer(
     const std::string& user_id,
     const std::string& application_context,
     const std::map<std::string, std::string>& encryption_metadata
-) : column_name_(column_name),
-    datatype_(datatype),
-    datatype_length_(datatype_length),
-    compression_(compression),
-    encoding_(encoding),
-    encoding_attributes_(encoding_attributes),
-    encrypted_compression_(encrypted_compression),
-    key_id_(key_id),
-    user_id_(user_id),
-    application_context_(application_context),
-    encryption_metadata_(encryption_metadata),
-    encryptor_(CreateEncryptor(key_id, column_name, user_id, application_context, datatype)) {}
+) : DataBatchEncryptionSequencer(
+        std::make_shared<const ColumnEncryptionContext>(
+            column_name, datatype, datatype_length, compression, encrypted_compression,
+            key_id, user_id, application_context),
+        encoding,
+        encoding_attributes,
+        encryption_metadata) {}
 
 // Constructor with pre-built encryptor
 DataBatchEncryptionSequencer::DataBatchEncryptionSequencer(
@@ -95,26 +339,73 @@ DataBatchEncryptionSequencer::DataBatchEncryptionSequencer(
     const std::string& application_context,
     const std::map<std::string, std::string>& encryption_metadata,
     std::unique_ptr<DBPSEncryptor> encryptor
-) : column_name_(column_name),
-    datatype_(datatype),
-    datatype_length_(datatype_length),
-    compression_(compression),
+) : DataBatchEncryptionSequencer(
+        std::make_shared<const ColumnEncryptionContext>(
+            column_name, datatype, datatype_length, compression, encrypted_compression,
+            key_id, user_id, application_context, std::move(encryptor)),
+        encoding,
+        encoding_attributes,
+        encryption_metadata) {}
+
+// Constructor with a shared per-column context
+DataBatchEncryptionSequencer::DataBatchEncryptionSequencer(
+    std::shared_ptr<const ColumnEncryptionContext> column_context,
+    Encoding::type encoding,
+    std::map<std::string, std::string> encoding_attributes,
+    std::map<std::string, std::string> encryption_metadata
+) : encryption_metadata_(std::move(encryption_metadata)),
+    column_context_(std::move(column_context)),
     encoding_(encoding),
-    encoding_attributes_(encoding_attributes),
-    encrypted_compression_(encrypted_compression),
-    key_id_(key_id),
-    user_id_(user_id),
-    application_context_(application_context),
-    encryption_metadata_(encryption_metadata),
-    encryptor_(std::move(encryptor)) {}
+    encoding_attributes_(std::move(encoding_attributes)) {}
+
+// Constructor for the batch methods
+DataBatchEncryptionSequencer::DataBatchEncryptionSequencer(
+    std::shared_ptr<const ColumnEncryptionContext> column_context,
+    std::map<std::string, std::string> encryption_metadata
+) : DataBatchEncryptionSequencer(
+        std::move(column_context),
+        Encoding::UNDEFINED,
+        {},
+        std::move(encryption_metadata)) {}
 
 // Top level encryption/decryption methods.
 
 bool DataBatchEncryptionSequencer::DecodeAndEncrypt(tcb::span<const uint8_t> plaintext) {
+    // Encrypt into encrypted_result_, sized to the requested bound and trimmed to the actual output.
+    // The bytes up to the output size are all written, so the buffer is taken uninitialized from the pool.
+    bool result = DecodeAndEncryptInto(plaintext, [this](size_t max_size) {
+        encrypted_result_ = AcquireUninitializedBuffer(max_size);
+        return tcb::span<uint8_t>(encrypted_result_.data(), encrypted_result_.size());
+    });
+    encrypted_result_.resize(result ? output_size_ : 0);
+    return result;
+}
+
+bool DataBatchEncryptionSequencer::DecryptAndEncode(tcb::span<const uint8_t> ciphertext) {
+    // Decrypt into decrypted_result_, sized to the requested bound and trimmed to the actual output.
+    bool result = DecryptAndEncodeInto(ciphertext, [this](size_t max_size) {
+        decrypted_result_ = AcquireUninitializedBuffer(max_size);
+        return tcb::span<uint8_t>(decrypted_result_.data(), decrypted_result_.size());
+    });
+    decrypted_result_.resize(result ? output_size_ : 0);
+    return result;
+}
+
+bool DataBatchEncryptionSequencer::DecodeAndEncryptInto(
+    tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output) {
+    return DecodeAndEncryptInto(SegmentedBytes(plaintext), allocate_output);
+}
+
+bool DataBatchEncryptionSequencer::DecodeAndEncryptInto(
+    const SegmentedBytes& plaintext, const OutputBufferAllocator& allocate_output) {
+    output_size_ = 0;
+    columnar_value_list_written_ = false;
+
     // Validate all parameters and key_id
     if (!ValidateParameters()) {
         return false;
     }
+    BufferPool::ScopedDefault scoped_buffer_pool(column_context_->GetBufferPool());
     
     // Check that plaintext is not null and not empty
     if (plaintext.empty()) {
@@ -123,83 +414,219 @@ bool DataBatchEncryptionSequencer::DecodeAndEncrypt(tcb::span<const uint8_t> pla
         return false;
     }
 
-    auto encryption_mode_key = GetEncryptionModeKey();
-    
+    // Dictionary index passthrough: the page is copied as-is behind its tag, without encryption.
+    if (IsDictionaryIndexPassthroughPage()) {
+        const size_t tag_length = GetIndexPageTagLength();
+        tcb::span<uint8_t> output;
+        if (!AllocateOutput(allocate_output, tag_length + plaintext.size(), output)) {
+            return false;
+        }
+        // The payload is copied first, so the tag reads it contiguously from the output.
+        auto payload = output.subspan(tag_length, plaintext.size());
+        plaintext.CopyTo(0, payload);
+        ComputeIndexPageTag(payload, output.first(tag_length));
+        output_size_ = tag_length + plaintext.size();
+        encryption_metadata_[GetEncryptionModeKey()] = ENCRYPTION_MODE_DICTIONARY_INDEX_PASSTHROUGH;
+        encryption_metadata_[DBPS_VERSION_KEY] = GetCiphertextVersion();
+        return true;
+    }
+
     /*
-     * Note on try-catch block:
-     * - When fully done, DecodeAndEncrypt will support per-value encryption for all cases, except for
-     *   (1) BOOLEAN datatype and (2) RLE_DICTIONARY encoding.
-     * - This try-catch block allows features to be developed incrementally until all features are
-     *   complete: Compressions, Encodings, Page types, Datatypes.
-     * - During development if a feature is not yet supported, UnsupportedExceptions are caught and the fallback to
-     *   per-block encryption is used.
-     * - Once per-value encryption for all cases is complete, the try-catch block and the call to EncryptBlock must be removed.
+     * Pipeline dispatch:
+     * - Whether the page can be encrypted per-value is looked up upfront in the per-column capability table of the
+     *   ColumnEncryptionContext (see ColumnEncryptionContext::IsPerValueEncryptionSupported), before the page payload
+     *   is touched. Unsupported pages go straight to per-block encryption, without paying for decompression and
+     *   value parsing first.
+     * - Among the supported pipelines, the column encryption mode policy picks the one to use.
+     * - Pages selected for per-value encryption must succeed on the per-value pipeline. A DBPSUnsupportedException
+     *   raised there is not expected and is propagated to the caller, same as InvalidInputException.
      */
-    try {
-        // Decompress and split plaintext into level and value bytes
-        auto [level_bytes, value_bytes, num_elements] = DecompressAndSplit(
-            plaintext, compression_, encoding_attributes_converted_);
-        
-        // Parse value bytes into typed values buffer
-        auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
-            value_bytes, num_elements, datatype_, datatype_length_, encoding_);
-        
-        // Encrypt the typed values buffer and level bytes, then join them into a single encrypted byte vector.
-        auto encrypted_value_bytes = encryptor_->EncryptValueList(typed_buffer);
-        auto encrypted_level_bytes = encryptor_->EncryptBlock(level_bytes);
-        encrypted_result_ = JoinWithLengthPrefix(encrypted_level_bytes, encrypted_value_bytes);
-
-        // Set the encryption type to per-value
-        encryption_metadata_[encryption_mode_key] = ENCRYPTION_MODE_PER_VALUE;
-        encryption_metadata_[DBPS_VERSION_KEY] = DBPS_VERSION;
-        return true;
+    const auto& mode_policy = column_context_->GetEncryptionModePolicy();
+    const bool use_per_value = mode_policy.SelectMode(
+        column_context_->GetDatatype(),
+        column_context_->SupportsPerValueEncryption(encoding_, IsPagePayloadCompressed()),
+        plaintext.size()) == EncryptionMode::PER_VALUE;
+
+    if (mode_policy.IsAdaptive()) {
+        // Pages of the same type may get different modes, so the mode is tagged in the first ciphertext byte.
+        tcb::span<uint8_t> tagged_output;
+        bool result = EncryptPageInto(plaintext, use_per_value, [&](size_t max_size) {
+            tagged_output = allocate_output(kModeTagBytes + max_size);
+            return tagged_output.subspan(std::min(kModeTagBytes, tagged_output.size()));
+        });
+        if (!result) {
+            return false;
+        }
+        tagged_output[0] = use_per_value ? MODE_TAG_PER_VALUE : MODE_TAG_PER_BLOCK;
+        output_size_ += kModeTagBytes;
+    } else if (!EncryptPageInto(plaintext, use_per_value, allocate_output)) {
+        return false;
     }
-    // Allow fallback to per-block encryption, only for explicitly unsupported conditions. See note above.
-    catch (const DBPSUnsupportedException& e) {
 
-        // Compression: Only UNCOMPRESSED and SNAPPY are currently supported
-        const bool is_compression_supported = (compression_ == CompressionCodec::UNCOMPRESSED ||
-                                               compression_ == CompressionCodec::SNAPPY);
-        
-        // Encoding: Only PLAIN is currently supported
-        // RLE_DICTIONARY is not supported for per-value encryption since the values are not present in the 
-        // `plaintext` data, only references to them.
-        const bool is_encoding_supported = (encoding_ == Encoding::PLAIN && encoding_ != Encoding::RLE_DICTIONARY);
-        
-        // Page type: All are supported (DATA_PAGE_V1, DATA_PAGE_V2, DICTIONARY_PAGE)
-        const bool is_page_supported = true;
+    const char* encryption_mode = mode_policy.IsAdaptive() ? ENCRYPTION_MODE_ADAPTIVE
+        : (use_per_value ? ENCRYPTION_MODE_PER_VALUE : ENCRYPTION_MODE_PER_BLOCK);
+    encryption_metadata_[GetEncryptionModeKey()] = encryption_mode;
+    if (column_context_->IsStreamingEnabled()) {
+        encryption_metadata_[ENCRYPTION_FRAMING_KEY] = ENCRYPTION_FRAMING_CHUNKED;
+    }
+    if (UseValueLayoutTag()) {
+        encryption_metadata_[VALUE_DEDUP_KEY] = VALUE_DEDUP_DICTIONARY;
+    }
+    encryption_metadata_[DBPS_VERSION_KEY] = GetCiphertextVersion();
+    return true;
+}
 
-        // Datatype: All datatypes are supported except BOOLEAN.
-        // BOOLEAN is not supported for per-value encryption and always defaults to per-block encryption.
-        const bool is_datatype_supported = (datatype_ != Type::BOOLEAN);
+bool DataBatchEncryptionSequencer::EncryptPageInto(
+    const SegmentedBytes& plaintext, bool use_per_value, const OutputBufferAllocator& allocate_output) {
+    // Streaming mode: same pipeline choice, processed in chunks with the chunked framing.
+    // Chunks are cut from one contiguous payload, so segmented payloads are gathered first.
+    if (column_context_->IsStreamingEnabled()) {
+        std::vector<uint8_t> gathered;
+        auto contiguous = plaintext.GetContiguous(0, plaintext.size(), gathered);
+        bool result = use_per_value ? EncryptPerValueChunkedInto(contiguous, allocate_output)
+                                    : EncryptPerBlockChunkedInto(contiguous, allocate_output);
+        ReleaseBuffer(std::move(gathered));
+        return result;
+    }
 
-        if (is_compression_supported && is_encoding_supported && is_page_supported && is_datatype_supported) {
-            // All conditions are supported, therefore an DBPSUnsupportedException exception should not have happened. 
-            // Re-throw the exception.
-            throw;
-        }
+    auto& encryptor = column_context_->GetEncryptor();
+    tcb::span<uint8_t> output;
 
-        encrypted_result_ = encryptor_->EncryptBlock(plaintext);
-        if (encrypted_result_.empty()) {
+    if (!use_per_value) {
+        // Encrypt straight into the output when the encryptor can bound the ciphertext size.
+        auto max_ciphertext_size = encryptor.MaxBlockCiphertextSize(plaintext.size());
+        if (max_ciphertext_size.has_value()) {
+            if (!AllocateOutput(allocate_output, max_ciphertext_size.value(), output)) {
+                return false;
+            }
+            output_size_ = encryptor.EncryptSegmentedBlockInto(plaintext, output);
+        } else {
+            std::vector<uint8_t> gathered;
+            auto ciphertext = encryptor.EncryptBlock(plaintext.GetContiguous(0, plaintext.size(), gathered));
+            ReleaseBuffer(std::move(gathered));
+            if (!AllocateOutput(allocate_output, ciphertext.size(), output)) {
+                return false;
+            }
+            if (!ciphertext.empty()) {
+                std::memcpy(output.data(), ciphertext.data(), ciphertext.size());
+            }
+            output_size_ = ciphertext.size();
+            ReleaseBuffer(std::move(ciphertext));
+        }
+        if (output_size_ == 0) {
             error_stage_ = "encryption";
             error_message_ = "Failed to encrypt data";
             return false;
         }
-        encryption_metadata_[encryption_mode_key] = ENCRYPTION_MODE_PER_BLOCK;
-        encryption_metadata_[DBPS_VERSION_KEY] = DBPS_VERSION;
         return true;
+    }
 
-    } catch (const InvalidInputException& e) {
-        // InvalidInputException is treated as any other exception and is re-thrown to be handled by the caller.
-        throw;
+    // Per-value pages of columns using the dictionary layout are tagged with their layout, like adaptive pages.
+    if (UseValueLayoutTag()) {
+        tcb::span<uint8_t> tagged_output;
+        bool dictionary_layout = false;
+        bool result = EncryptPerValueInto(plaintext, [&](size_t max_size) {
+            tagged_output = allocate_output(kValueLayoutTagBytes + max_size);
+            return tagged_output.subspan(std::min(kValueLayoutTagBytes, tagged_output.size()));
+        }, &dictionary_layout);
+        if (!result) {
+            return false;
+        }
+        tagged_output[0] = dictionary_layout ? VALUE_LAYOUT_TAG_DICTIONARY : VALUE_LAYOUT_TAG_REGULAR;
+        output_size_ += kValueLayoutTagBytes;
+        return true;
     }
+    return EncryptPerValueInto(plaintext, allocate_output, nullptr);
 }
 
-bool DataBatchEncryptionSequencer::DecryptAndEncode(tcb::span<const uint8_t> ciphertext) {
+bool DataBatchEncryptionSequencer::EncryptPerValueInto(
+    const SegmentedBytes& plaintext, const OutputBufferAllocator& allocate_output, bool* dictionary_layout) {
+    auto& encryptor = column_context_->GetEncryptor();
+    tcb::span<uint8_t> output;
+
+    // Decompress and split plaintext into level and value bytes.
+    // Spans point into plaintext for uncompressed payloads, or into the decompressed buffer owned by split_page.
+    auto split_page = DecompressAndSplit(
+        plaintext, column_context_->GetCompression(), encoding_attributes_converted_);
+
+    // Parse value bytes into typed values buffer
+    auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
+        split_page.value_bytes, split_page.num_elements,
+        column_context_->GetDatatype(), column_context_->GetDatatypeLength(), encoding_);
+
+    // Value deduplication (see ValueDedupOptions), for the pages where it pays off.
+    std::optional<DeduplicatedValues> deduplicated;
+    if (UseValueDedup()) {
+        deduplicated = DeduplicateValues(typed_buffer, column_context_->GetValueDedupOptions());
+    }
+    if (deduplicated.has_value()) {
+        auto distinct_values = ReinterpretValueBytesAsTypedValuesBuffer(
+            deduplicated->distinct_value_bytes, deduplicated->num_distinct,
+            column_context_->GetDatatype(), column_context_->GetDatatypeLength(), Encoding::PLAIN);
+        if (dictionary_layout == nullptr) {
+            bool result = EncryptPerValueScatteredInto(
+                split_page.level_bytes, split_page.value_bytes.size(), deduplicated->indices, distinct_values,
+                allocate_output);
+            ReleaseBuffer(std::move(split_page.decompressed_bytes));
+            return result;
+        }
+        auto result = EncryptPerValueDictionaryInto(
+            split_page.level_bytes, split_page.value_bytes.size(), *deduplicated, distinct_values, allocate_output);
+        if (result.has_value()) {
+            *dictionary_layout = true;
+            ReleaseBuffer(std::move(split_page.decompressed_bytes));
+            return result.value();
+        }
+    }
+
+    // Length-preserving encryptors write both ciphertexts straight into the output, in the joined layout:
+    // [u32 level ciphertext size][level ciphertext][value-list ciphertext].
+    if (encryptor.IsLengthPreserving()) {
+        auto max_level_size = encryptor.MaxBlockCiphertextSize(split_page.level_bytes.size());
+        auto max_value_size = encryptor.MaxValueListCiphertextSize(split_page.value_bytes.size());
+        if (max_level_size.has_value() && max_value_size.has_value()) {
+            const size_t max_size = ::kSizePrefixBytes + max_level_size.value() + max_value_size.value();
+            if (!AllocateOutput(allocate_output, max_size, output)) {
+                return false;
+            }
+            const size_t level_size = encryptor.EncryptBlockInto(
+                split_page.level_bytes, output.subspan(::kSizePrefixBytes, max_level_size.value()));
+            write_u32_le(output.data(), static_cast<uint32_t>(level_size));
+            const size_t value_size =
+                EncryptColumnValueListInto(typed_buffer, split_page.value_bytes,
+                                           output.subspan(::kSizePrefixBytes + level_size));
+            ReleaseBuffer(std::move(split_page.decompressed_bytes));
+            output_size_ = ::kSizePrefixBytes + level_size + value_size;
+            return true;
+        }
+    }
+
+    // Encrypt the typed values buffer and level bytes, then join them into the output.
+    // Intermediate buffers go back to the pool as soon as they are consumed, so later ones can reuse them.
+    auto encrypted_value_bytes = EncryptColumnValueList(typed_buffer, split_page.value_bytes);
+    auto encrypted_level_bytes = encryptor.EncryptBlock(split_page.level_bytes);
+    ReleaseBuffer(std::move(split_page.decompressed_bytes));
+    const size_t joined_size = ::kSizePrefixBytes + encrypted_level_bytes.size() + encrypted_value_bytes.size();
+    if (!AllocateOutput(allocate_output, joined_size, output)) {
+        ReleaseBuffer(std::move(encrypted_level_bytes));
+        ReleaseBuffer(std::move(encrypted_value_bytes));
+        return false;
+    }
+    output_size_ = JoinWithLengthPrefixInto(encrypted_level_bytes, encrypted_value_bytes, output);
+    ReleaseBuffer(std::move(encrypted_level_bytes));
+    ReleaseBuffer(std::move(encrypted_value_bytes));
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::DecryptAndEncodeInto(
+    tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output) {
+    output_size_ = 0;
+
     // Validate all parameters and key_id
     if (!ValidateParameters()) {
         return false;
     }
+    BufferPool::ScopedDefault scoped_buffer_pool(column_context_->GetBufferPool());
     
     // Check that ciphertext is not null and not empty
     if (ciphertext.empty()) {
@@ -215,6 +642,7 @@ bool DataBatchEncryptionSequencer::DecryptAndEncode(tcb::span<const uint8_t> cip
         error_message_ = version_error;
         return false;
     }
+    columnar_value_list_readable_ = encryption_metadata_.at(DBPS_VERSION_KEY).find(DBPS_VERSION_COLUMNAR) == 0;
     
     // Get encryption_mode from encryption_metadata
     auto encryption_mode_opt = SafeGetEncryptionMode();
@@ -223,29 +651,103 @@ bool DataBatchEncryptionSequencer::DecryptAndEncode(tcb::span<const uint8_t> cip
         error_message_ = "Failed to get encryption_mode from encryption_metadata";
         return false;
     }
-    const std::string& encryption_mode = encryption_mode_opt.value();
+    std::string encryption_mode = encryption_mode_opt.value();
+
+    // Passthrough pages are verified and copied back as-is.
+    if (encryption_mode == ENCRYPTION_MODE_DICTIONARY_INDEX_PASSTHROUGH) {
+        return DecryptDictionaryIndexPassthroughInto(ciphertext, allocate_output);
+    }
+
+    // Adaptive ciphertexts carry the mode of the page in their first byte.
+    if (encryption_mode == ENCRYPTION_MODE_ADAPTIVE) {
+        const uint8_t mode_tag = ciphertext[0];
+        if (mode_tag != MODE_TAG_PER_BLOCK && mode_tag != MODE_TAG_PER_VALUE) {
+            error_stage_ = "decrypt_encryption_mode_validation";
+            error_message_ = "Invalid encryption mode tag: " + std::to_string(mode_tag);
+            return false;
+        }
+        encryption_mode = (mode_tag == MODE_TAG_PER_VALUE) ? ENCRYPTION_MODE_PER_VALUE : ENCRYPTION_MODE_PER_BLOCK;
+        ciphertext = ciphertext.subspan(kModeTagBytes);
+        if (ciphertext.empty()) {
+            error_stage_ = "validation";
+            error_message_ = "ciphertext cannot be null or empty";
+            return false;
+        }
+    }
+
+    // Ciphertexts written in streaming mode carry their chunk framing.
+    auto is_chunked_opt = SafeGetChunkedFraming();
+    if (!is_chunked_opt.has_value()) {
+        return false;
+    }
+    if (is_chunked_opt.value()) {
+        return (encryption_mode == ENCRYPTION_MODE_PER_VALUE) ? DecryptPerValueChunkedInto(ciphertext, allocate_output)
+                                                              : DecryptPerBlockChunkedInto(ciphertext, allocate_output);
+    }
+
+    auto& encryptor = column_context_->GetEncryptor();
+    tcb::span<uint8_t> output;
     
     // Per-value encryption
     if (encryption_mode == ENCRYPTION_MODE_PER_VALUE) {
 
+        // Columns using the dictionary layout tag the layout of each per-value page.
+        auto is_layout_tagged_opt = SafeGetValueLayoutTagged();
+        if (!is_layout_tagged_opt.has_value()) {
+            return false;
+        }
+        if (is_layout_tagged_opt.value()) {
+            const uint8_t layout_tag = ciphertext[0];
+            if (layout_tag != VALUE_LAYOUT_TAG_REGULAR && layout_tag != VALUE_LAYOUT_TAG_DICTIONARY) {
+                error_stage_ = "decrypt_value_dedup_validation";
+                error_message_ = "Invalid value layout tag: " + std::to_string(layout_tag);
+                return false;
+            }
+            ciphertext = ciphertext.subspan(kValueLayoutTagBytes);
+            if (layout_tag == VALUE_LAYOUT_TAG_DICTIONARY) {
+                return DecryptPerValueDictionaryInto(ciphertext, allocate_output);
+            }
+        }
+
         // Split the joined encrypted bytes, then decrypt the level and value bytes separately.
         auto [encrypted_level_bytes, encrypted_value_bytes] = SplitWithLengthPrefix(ciphertext);
-        auto level_bytes = encryptor_->DecryptBlock(encrypted_level_bytes);
-        auto typed_buffer = encryptor_->DecryptValueList(encrypted_value_bytes);
+        if (!CheckValueListLayout(encrypted_value_bytes)) {
+            return false;
+        }
+        if (UseTrustedValueDecryption()) {
+            return DecryptPerValueTrustedInto(encrypted_level_bytes, encrypted_value_bytes, allocate_output);
+        }
+        auto level_bytes = encryptor.DecryptBlock(encrypted_level_bytes);
+        auto typed_buffer = encryptor.DecryptValueList(encrypted_value_bytes);
         
         // Convert the decrypted typed values buffer back to value bytes
         auto value_bytes = GetTypedValuesBufferAsValueBytes(std::move(typed_buffer));
         
-        // Join the decrypted level and value bytes, then compress to get plaintext
-        decrypted_result_ = CompressAndJoin(
-            level_bytes, value_bytes, compression_, encoding_attributes_converted_);
+        // Join the decrypted level and value bytes, then compress to get plaintext.
+        return CompressAndJoinPageInto(std::move(level_bytes), std::move(value_bytes), allocate_output);
     }
     
     // Per-block encryption
     else if (encryption_mode == ENCRYPTION_MODE_PER_BLOCK) {
-        // Simple XOR decryption (same operation as encryption) for per-block encryption
-        decrypted_result_ = encryptor_->DecryptBlock(ciphertext);
-        if (decrypted_result_.empty()) {
+        // Decrypt straight into the output when the encryptor can bound the plaintext size.
+        auto max_plaintext_size = encryptor.MaxBlockPlaintextSize(ciphertext.size());
+        if (max_plaintext_size.has_value()) {
+            if (!AllocateOutput(allocate_output, max_plaintext_size.value(), output)) {
+                return false;
+            }
+            output_size_ = encryptor.DecryptBlockInto(ciphertext, output);
+        } else {
+            auto plaintext = encryptor.DecryptBlock(ciphertext);
+            if (!AllocateOutput(allocate_output, plaintext.size(), output)) {
+                return false;
+            }
+            if (!plaintext.empty()) {
+                std::memcpy(output.data(), plaintext.data(), plaintext.size());
+            }
+            output_size_ = plaintext.size();
+            ReleaseBuffer(std::move(plaintext));
+        }
+        if (output_size_ == 0) {
             error_stage_ = "decryption";
             error_message_ = "Failed to decrypt data";
             return false;
@@ -255,6 +757,567 @@ bool DataBatchEncryptionSequencer::DecryptAndEncode(tcb::span<const uint8_t> cip
     return true;
 }
 
+std::optional<size_t> DataBatchEncryptionSequencer::GetMaxCiphertextSize(size_t plaintext_size) {
+    if (!ValidateParameters()) {
+        return std::nullopt;
+    }
+    if (IsDictionaryIndexPassthroughPage()) {
+        return GetIndexPageTagLength() + plaintext_size;
+    }
+
+    const auto& mode_policy = column_context_->GetEncryptionModePolicy();
+    const bool per_value_supported = column_context_->SupportsPerValueEncryption(encoding_, IsPagePayloadCompressed());
+    if (!mode_policy.IsAdaptive()) {
+        const bool use_per_value = mode_policy.SelectMode(
+            column_context_->GetDatatype(), per_value_supported, plaintext_size) == EncryptionMode::PER_VALUE;
+        return GetMaxPageCiphertextSize(plaintext_size, use_per_value);
+    }
+
+    // Adaptive policies may pick either mode (e.g. depending on load), so both are bounded.
+    auto max_size = GetMaxPageCiphertextSize(plaintext_size, false);
+    if (max_size.has_value() && per_value_supported) {
+        auto max_per_value_size = GetMaxPageCiphertextSize(plaintext_size, true);
+        max_size = max_per_value_size.has_value()
+            ? std::optional<size_t>(std::max(max_size.value(), max_per_value_size.value())) : std::nullopt;
+    }
+    if (!max_size.has_value()) {
+        return std::nullopt;
+    }
+    return kModeTagBytes + max_size.value();
+}
+
+std::optional<size_t> DataBatchEncryptionSequencer::GetMaxPageCiphertextSize(size_t plaintext_size, bool use_per_value) {
+    auto& encryptor = column_context_->GetEncryptor();
+    if (column_context_->IsStreamingEnabled()) {
+        // Per-value chunk counts depend on the value sizes, which are unknown until the payload is read.
+        if (use_per_value) {
+            return std::nullopt;
+        }
+        return MaxBlockChunkStreamSize(encryptor, plaintext_size, column_context_->GetStreamingChunkSize());
+    }
+    if (!use_per_value) {
+        return encryptor.MaxBlockCiphertextSize(plaintext_size);
+    }
+
+    // Per-value pages: the decompressed size is unknown until the payload is read.
+    if (IsPagePayloadCompressed()) {
+        return std::nullopt;
+    }
+
+    // Levels and values split the payload. The split point is unknown for DATA_PAGE_V1 (it is encoded
+    // in the payload), so each part is bounded by the whole payload size. The dictionary layout is only used
+    // when it is smaller than the value-list ciphertext, so the bound holds for it too.
+    auto max_level_bytes = encryptor.MaxBlockCiphertextSize(plaintext_size);
+    auto max_value_bytes = encryptor.MaxValueListCiphertextSize(plaintext_size);
+    if (!max_level_bytes.has_value() || !max_value_bytes.has_value()) {
+        return std::nullopt;
+    }
+    const size_t layout_tag_bytes = UseValueLayoutTag() ? kValueLayoutTagBytes : 0;
+    return layout_tag_bytes + ::kSizePrefixBytes + max_level_bytes.value() + max_value_bytes.value();
+}
+
+// Streaming mode encryption/decryption methods.
+
+bool DataBatchEncryptionSequencer::EncryptPerBlockChunkedInto(
+    tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    const size_t chunk_size = column_context_->GetStreamingChunkSize();
+
+    auto max_ciphertext_size = MaxBlockChunkStreamSize(encryptor, plaintext.size(), chunk_size);
+    if (!max_ciphertext_size.has_value()) {
+        error_stage_ = "streaming";
+        error_message_ = "Streaming mode requires an encryptor with ciphertext size bounds";
+        return false;
+    }
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, max_ciphertext_size.value(), output)) {
+        return false;
+    }
+    output_size_ = WriteBlockChunkStream(encryptor, plaintext, chunk_size, output);
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::EncryptPerValueChunkedInto(
+    tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    const size_t chunk_size = column_context_->GetStreamingChunkSize();
+
+    // Uncompressed payloads are chunked in place. Compressed payloads are decompressed once, since the
+    // page compression is applied to the whole page.
+    auto split_page = DecompressAndSplit(
+        plaintext, column_context_->GetCompression(), encoding_attributes_converted_);
+    auto value_chunks = SplitValueBytesIntoChunks(
+        split_page.value_bytes, split_page.num_elements,
+        column_context_->GetDatatype(), column_context_->GetDatatypeLength(), chunk_size);
+
+    auto max_level_stream_size = MaxBlockChunkStreamSize(encryptor, split_page.level_bytes.size(), chunk_size);
+    auto max_value_stream_size = MaxValueChunkStreamSize(encryptor, value_chunks);
+    if (!max_level_stream_size.has_value() || !max_value_stream_size.has_value()) {
+        error_stage_ = "streaming";
+        error_message_ = "Streaming mode requires an encryptor with ciphertext size bounds";
+        return false;
+    }
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, max_level_stream_size.value() + max_value_stream_size.value(), output)) {
+        return false;
+    }
+
+    // The level chunk stream is followed by the value chunk stream.
+    const size_t level_stream_size = WriteBlockChunkStream(encryptor, split_page.level_bytes, chunk_size, output);
+    const bool columnar = UseColumnarValueLists();
+    const size_t value_stream_size = WriteValueChunkStream(
+        encryptor, value_chunks, split_page.value_bytes.size(),
+        column_context_->GetDatatype(), column_context_->GetDatatypeLength(), encoding_,
+        columnar, output.subspan(level_stream_size));
+    columnar_value_list_written_ = columnar && !value_chunks.empty();
+    output_size_ = level_stream_size + value_stream_size;
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::DecryptPerBlockChunkedInto(
+    tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output) {
+    auto stream = ReadChunkStream(ciphertext);
+    if (stream.stream_size != ciphertext.size()) {
+        throw InvalidInputException("Malformed chunk stream: trailing bytes after the last chunk");
+    }
+
+    // Chunk streams record the plaintext size, so the output is allocated exactly.
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, stream.plaintext_size, output)) {
+        return false;
+    }
+    DecryptBlockChunkStreamInto(column_context_->GetEncryptor(), stream, output.first(stream.plaintext_size));
+    output_size_ = stream.plaintext_size;
+    if (output_size_ == 0) {
+        error_stage_ = "decryption";
+        error_message_ = "Failed to decrypt data";
+        return false;
+    }
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::DecryptPerValueChunkedInto(
+    tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    auto level_stream = ReadChunkStream(ciphertext);
+    auto value_stream = ReadChunkStream(ciphertext.subspan(level_stream.stream_size));
+    if (level_stream.stream_size + value_stream.stream_size != ciphertext.size()) {
+        throw InvalidInputException("Malformed chunk stream: trailing bytes after the last chunk");
+    }
+    for (const auto& frame : value_stream.frames) {
+        if (!CheckValueListLayout(frame.ciphertext)) {
+            return false;
+        }
+    }
+    const size_t level_bytes_size = level_stream.plaintext_size;
+    const size_t page_size = level_bytes_size + value_stream.plaintext_size;
+    const bool trusted = UseTrustedValueDecryption();
+    tcb::span<uint8_t> output;
+
+    // Uncompressed pages are the level bytes followed by the value bytes, so chunks are decrypted in place.
+    if (!IsPagePayloadCompressed()) {
+        if (!AllocateOutput(allocate_output, page_size, output)) {
+            return false;
+        }
+        DecryptBlockChunkStreamInto(encryptor, level_stream, output.first(level_bytes_size));
+        DecryptValueChunkStreamInto(
+            encryptor, value_stream, output.subspan(level_bytes_size, value_stream.plaintext_size), trusted);
+        output_size_ = page_size;
+        return true;
+    }
+
+    // Compressed pages are compressed as a whole, so the decrypted page is staged before compression.
+    // Both chunk streams fill it completely, so it is taken uninitialized from the pool.
+    auto decrypted_page = AcquireUninitializedBuffer(page_size);
+    tcb::span<uint8_t> decrypted_span(decrypted_page.data(), decrypted_page.size());
+    DecryptBlockChunkStreamInto(encryptor, level_stream, decrypted_span.first(level_bytes_size));
+    DecryptValueChunkStreamInto(encryptor, value_stream, decrypted_span.subspan(level_bytes_size), trusted);
+
+    tcb::span<const uint8_t> level_bytes = decrypted_span.first(level_bytes_size);
+    tcb::span<const uint8_t> value_bytes = decrypted_span.subspan(level_bytes_size);
+    const auto compression = column_context_->GetCompression();
+    const size_t max_plaintext_size = MaxCompressAndJoinSize(
+        level_bytes.size(), value_bytes.size(), compression, encoding_attributes_converted_);
+    if (!AllocateOutput(allocate_output, max_plaintext_size, output)) {
+        ReleaseBuffer(std::move(decrypted_page));
+        return false;
+    }
+    output_size_ = CompressAndJoinInto(
+        level_bytes, value_bytes, compression, encoding_attributes_converted_, output, !trusted);
+    ReleaseBuffer(std::move(decrypted_page));
+    return true;
+}
+
+// Value deduplication methods.
+
+bool DataBatchEncryptionSequencer::UseValueDedup() {
+    switch (column_context_->GetValueDedupOptions().mode) {
+        case ValueDedupMode::SCATTER: {
+            // Scattered ciphertext records must have the layout of their plaintext records, at known bounds.
+            // Columnar value lists have no records to scatter, so their values are all encrypted.
+            const auto& encryptor = column_context_->GetEncryptor();
+            return !UseColumnarValueLists() &&
+                   encryptor.IsValueEncryptionDeterministic() && encryptor.IsLengthPreserving() &&
+                   encryptor.MaxBlockCiphertextSize(0).has_value() &&
+                   encryptor.MaxValueListCiphertextSize(0).has_value();
+        }
+        case ValueDedupMode::DICTIONARY:
+            return UseValueLayoutTag();
+        default:
+            return false;
+    }
+}
+
+bool DataBatchEncryptionSequencer::UseValueLayoutTag() {
+    // Streaming pages are encrypted chunk by chunk, without deduplication.
+    return column_context_->GetValueDedupOptions().mode == ValueDedupMode::DICTIONARY &&
+           !column_context_->IsStreamingEnabled();
+}
+
+// Value-list layout methods.
+
+bool DataBatchEncryptionSequencer::UseColumnarValueLists() {
+    // Columnar value lists are written into buffers sized with the encryptor bound. Fixed-size values have no
+    // per-value framing, so their value lists keep the records layout.
+    const auto& encryptor = column_context_->GetEncryptor();
+    return column_context_->IsColumnarValueListEnabled() && column_context_->GetDatatype() == Type::BYTE_ARRAY &&
+           encryptor.SupportsColumnarValueList() && encryptor.MaxValueListCiphertextSize(0).has_value();
+}
+
+const char* DataBatchEncryptionSequencer::GetCiphertextVersion() {
+    return columnar_value_list_written_ ? DBPS_VERSION_COLUMNAR : DBPS_VERSION;
+}
+
+bool DataBatchEncryptionSequencer::CheckValueListLayout(tcb::span<const uint8_t> value_list_ciphertext) {
+    // The value-list header is not encrypted, so its layout tag is read before decryption.
+    if (columnar_value_list_readable_ || value_list_ciphertext.empty() ||
+        value_list_ciphertext[0] != kColumnarVariableSizeTag) {
+        return true;
+    }
+    error_stage_ = "decrypt_version_check";
+    error_message_ = "Columnar value list in a page of ciphertext format " + std::string(DBPS_VERSION);
+    return false;
+}
+
+std::vector<uint8_t> DataBatchEncryptionSequencer::EncryptColumnValueList(
+    const TypedValuesBuffer& typed_buffer, tcb::span<const uint8_t> value_bytes) {
+    auto& encryptor = column_context_->GetEncryptor();
+    if (!UseColumnarValueLists()) {
+        return encryptor.EncryptValueList(typed_buffer);
+    }
+    std::vector<uint8_t> ciphertext =
+        AcquireUninitializedBuffer(encryptor.MaxValueListCiphertextSize(value_bytes.size()).value());
+    ciphertext.resize(EncryptColumnValueListInto(typed_buffer, value_bytes, ciphertext));
+    return ciphertext;
+}
+
+size_t DataBatchEncryptionSequencer::EncryptColumnValueListInto(
+    const TypedValuesBuffer& typed_buffer, tcb::span<const uint8_t> value_bytes, tcb::span<uint8_t> out) {
+    auto& encryptor = column_context_->GetEncryptor();
+    if (!UseColumnarValueLists()) {
+        return encryptor.EncryptValueListInto(typed_buffer, out);
+    }
+    // Columnar value lists are only used for BYTE_ARRAY values, whose typed buffer is a view of value_bytes.
+    const size_t num_elements = std::get<TypedBufferRawBytesVariableSized>(typed_buffer).GetNumElements();
+    const size_t ciphertext_size = EncryptColumnarValueBytesInto(encryptor, value_bytes, num_elements, out);
+    columnar_value_list_written_ = true;
+    return ciphertext_size;
+}
+
+bool DataBatchEncryptionSequencer::EncryptPerValueScatteredInto(
+    tcb::span<const uint8_t> level_bytes,
+    size_t value_bytes_size,
+    tcb::span<const uint32_t> indices,
+    const TypedValuesBuffer& distinct_values,
+    const OutputBufferAllocator& allocate_output) {
+    // Same joined layout as the length-preserving pipeline, with the value list scattered from its distinct values.
+    auto& encryptor = column_context_->GetEncryptor();
+    const size_t max_level_size = encryptor.MaxBlockCiphertextSize(level_bytes.size()).value();
+    const size_t max_value_size = encryptor.MaxValueListCiphertextSize(value_bytes_size).value();
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, ::kSizePrefixBytes + max_level_size + max_value_size, output)) {
+        return false;
+    }
+    const size_t level_size =
+        encryptor.EncryptBlockInto(level_bytes, output.subspan(::kSizePrefixBytes, max_level_size));
+    write_u32_le(output.data(), static_cast<uint32_t>(level_size));
+    const size_t value_size = encryptor.EncryptDeduplicatedValueListInto(
+        distinct_values, indices, output.subspan(::kSizePrefixBytes + level_size));
+    output_size_ = ::kSizePrefixBytes + level_size + value_size;
+    return true;
+}
+
+std::optional<bool> DataBatchEncryptionSequencer::EncryptPerValueDictionaryInto(
+    tcb::span<const uint8_t> level_bytes,
+    size_t value_bytes_size,
+    const DeduplicatedValues& deduplicated,
+    const TypedValuesBuffer& distinct_values,
+    const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    const size_t index_block_size = GetIndexBlockSize(deduplicated.indices.size(), deduplicated.num_distinct);
+
+    // The dictionary layout is only kept when it is smaller than the value-list ciphertext it replaces, so that
+    // GetMaxCiphertextSize bounds both layouts. Encryptors that cannot bound their output are compared on the
+    // plaintext sizes.
+    auto max_index_size = encryptor.MaxBlockCiphertextSize(index_block_size);
+    auto max_distinct_size = encryptor.MaxValueListCiphertextSize(deduplicated.distinct_value_bytes.size());
+    auto max_value_size = encryptor.MaxValueListCiphertextSize(value_bytes_size);
+    const bool is_smaller = (max_index_size.has_value() && max_distinct_size.has_value() && max_value_size.has_value())
+        ? ::kSizePrefixBytes + max_index_size.value() + max_distinct_size.value() <= max_value_size.value()
+        : ::kSizePrefixBytes + index_block_size + deduplicated.distinct_value_bytes.size() < value_bytes_size;
+    if (!is_smaller) {
+        return std::nullopt;
+    }
+
+    auto index_block = EncodeIndexBlock(deduplicated.indices, deduplicated.num_distinct);
+    auto encrypted_index_block = encryptor.EncryptBlock(index_block);
+    ReleaseBuffer(std::move(index_block));
+    auto encrypted_distinct_values =
+        EncryptColumnValueList(distinct_values, deduplicated.distinct_value_bytes);
+    auto encrypted_level_bytes = encryptor.EncryptBlock(level_bytes);
+
+    const size_t values_size =
+        ::kSizePrefixBytes + encrypted_index_block.size() + encrypted_distinct_values.size();
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, ::kSizePrefixBytes + encrypted_level_bytes.size() + values_size, output)) {
+        ReleaseBuffer(std::move(encrypted_level_bytes));
+        ReleaseBuffer(std::move(encrypted_index_block));
+        ReleaseBuffer(std::move(encrypted_distinct_values));
+        return false;
+    }
+    write_u32_le(output.data(), static_cast<uint32_t>(encrypted_level_bytes.size()));
+    if (!encrypted_level_bytes.empty()) {
+        std::memcpy(output.data() + ::kSizePrefixBytes, encrypted_level_bytes.data(), encrypted_level_bytes.size());
+    }
+    const size_t values_offset = ::kSizePrefixBytes + encrypted_level_bytes.size();
+    output_size_ = values_offset + JoinWithLengthPrefixInto(
+        encrypted_index_block, encrypted_distinct_values, output.subspan(values_offset));
+    ReleaseBuffer(std::move(encrypted_level_bytes));
+    ReleaseBuffer(std::move(encrypted_index_block));
+    ReleaseBuffer(std::move(encrypted_distinct_values));
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::DecryptPerValueDictionaryInto(
+    tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    auto [encrypted_level_bytes, encrypted_values] = SplitWithLengthPrefix(ciphertext);
+    auto [encrypted_index_block, encrypted_distinct_values] = SplitWithLengthPrefix(encrypted_values);
+    if (!CheckValueListLayout(encrypted_distinct_values)) {
+        return false;
+    }
+
+    auto level_bytes = encryptor.DecryptBlock(encrypted_level_bytes);
+    auto index_block = encryptor.DecryptBlock(encrypted_index_block);
+    auto distinct_values = encryptor.DecryptValueList(encrypted_distinct_values);
+    const size_t num_distinct = std::visit([](const auto& buffer) { return buffer.GetNumElements(); }, distinct_values);
+    auto indices = DecodeIndexBlock(index_block, num_distinct);
+    ReleaseBuffer(std::move(index_block));
+
+    // The index block holds one index per value, so a block of another page cannot expand into this one.
+    const size_t expected_num_values = CountPageValueElements(
+        std::get<std::string>(encoding_attributes_converted_.at("page_type")), level_bytes,
+        encoding_attributes_converted_);
+    if (indices.size() != expected_num_values) {
+        error_stage_ = "decrypt_value_dedup_validation";
+        error_message_ = "Dictionary index block holds " + std::to_string(indices.size()) +
+                         " values, the page expects " + std::to_string(expected_num_values);
+        ReleaseBuffer(std::move(level_bytes));
+        return false;
+    }
+    auto value_bytes = ExpandDistinctValues(std::move(distinct_values), indices);
+    return CompressAndJoinPageInto(std::move(level_bytes), std::move(value_bytes), allocate_output);
+}
+
+std::optional<bool> DataBatchEncryptionSequencer::SafeGetValueLayoutTagged() {
+    auto it = encryption_metadata_.find(VALUE_DEDUP_KEY);
+    if (it == encryption_metadata_.end()) {
+        return false;
+    }
+    if (it->second != VALUE_DEDUP_DICTIONARY) {
+        error_stage_ = "decrypt_value_dedup_validation";
+        error_message_ = "Unsupported encryption_metadata['" + std::string(VALUE_DEDUP_KEY) + "']: " + it->second;
+        return std::nullopt;
+    }
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::CompressAndJoinPageInto(
+    std::vector<uint8_t> level_bytes, std::vector<uint8_t> value_bytes, const OutputBufferAllocator& allocate_output) {
+    // Both parts are written (or compressed) directly into the output, without a joined temporary.
+    const auto compression = column_context_->GetCompression();
+    const size_t max_plaintext_size = MaxCompressAndJoinSize(
+        level_bytes.size(), value_bytes.size(), compression, encoding_attributes_converted_);
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, max_plaintext_size, output)) {
+        ReleaseBuffer(std::move(level_bytes));
+        ReleaseBuffer(std::move(value_bytes));
+        return false;
+    }
+    output_size_ = CompressAndJoinInto(
+        level_bytes, value_bytes, compression, encoding_attributes_converted_, output);
+    ReleaseBuffer(std::move(level_bytes));
+    ReleaseBuffer(std::move(value_bytes));
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::UseTrustedValueDecryption() {
+    if (!column_context_->IsCiphertextTrusted()) {
+        return false;
+    }
+    const auto& encryptor = column_context_->GetEncryptor();
+    return encryptor.MaxBlockPlaintextSize(0).has_value() && encryptor.MaxValueListPlaintextSize(0).has_value();
+}
+
+bool DataBatchEncryptionSequencer::DecryptPerValueTrustedInto(
+    tcb::span<const uint8_t> encrypted_level_bytes,
+    tcb::span<const uint8_t> encrypted_value_bytes,
+    const OutputBufferAllocator& allocate_output) {
+    auto& encryptor = column_context_->GetEncryptor();
+    const size_t max_level_bytes_size = encryptor.MaxBlockPlaintextSize(encrypted_level_bytes.size()).value();
+    const size_t max_page_size = max_level_bytes_size +
+        encryptor.MaxValueListPlaintextSize(encrypted_value_bytes.size()).value() +
+        GetColumnarSizeExpansion(ReadHeader(encrypted_value_bytes));
+    tcb::span<uint8_t> output;
+
+    // Uncompressed pages are the level bytes followed by the value bytes, so both are decrypted in place.
+    if (!IsPagePayloadCompressed()) {
+        if (!AllocateOutput(allocate_output, max_page_size, output)) {
+            return false;
+        }
+        const size_t level_bytes_size =
+            encryptor.DecryptBlockInto(encrypted_level_bytes, output.first(max_level_bytes_size));
+        output_size_ = level_bytes_size +
+            encryptor.DecryptTrustedValueListInto(encrypted_value_bytes, output.subspan(level_bytes_size));
+        return true;
+    }
+
+    // Compressed pages are staged decrypted, then compressed without re-validating the level bytes.
+    auto decrypted_page = AcquireUninitializedBuffer(max_page_size);
+    tcb::span<uint8_t> decrypted_span(decrypted_page.data(), decrypted_page.size());
+    const size_t level_bytes_size =
+        encryptor.DecryptBlockInto(encrypted_level_bytes, decrypted_span.first(max_level_bytes_size));
+    const size_t value_bytes_size =
+        encryptor.DecryptTrustedValueListInto(encrypted_value_bytes, decrypted_span.subspan(level_bytes_size));
+
+    tcb::span<const uint8_t> level_bytes = decrypted_span.first(level_bytes_size);
+    tcb::span<const uint8_t> value_bytes = decrypted_span.subspan(level_bytes_size, value_bytes_size);
+    const auto compression = column_context_->GetCompression();
+    const size_t max_plaintext_size = MaxCompressAndJoinSize(
+        level_bytes.size(), value_bytes.size(), compression, encoding_attributes_converted_);
+    if (!AllocateOutput(allocate_output, max_plaintext_size, output)) {
+        ReleaseBuffer(std::move(decrypted_page));
+        return false;
+    }
+    output_size_ = CompressAndJoinInto(
+        level_bytes, value_bytes, compression, encoding_attributes_converted_, output, false);
+    ReleaseBuffer(std::move(decrypted_page));
+    return true;
+}
+
+// Batch encryption/decryption methods.
+
+namespace {
+    // Sizes the batch arena once from the total input size. Outputs are close to the input size for both
+    // directions, so most batches never grow it. The arena is drawn from the buffer pool, so recycled memory
+    // is not zero-filled again; every byte below the final size is written by exactly one page.
+    void InitializeBatchResult(SequencerBatchResult& batch_result, const std::vector<SequencerBatchPage>& pages) {
+        size_t total_payload_size = 0;
+        for (const auto& page : pages) {
+            total_payload_size += page.payload.size();
+        }
+        batch_result.arena = AcquireUninitializedBuffer(total_payload_size);
+        batch_result.page_offsets.clear();
+        batch_result.page_offsets.reserve(pages.size() + 1);
+        batch_result.page_offsets.push_back(0);
+        batch_result.page_encryption_metadata.clear();
+    }
+
+    // Page outputs are written straight into the arena after the last committed page. The arena is only
+    // grown (geometrically) when a page bound does not fit, and is trimmed once when the batch completes.
+    OutputBufferAllocator MakeBatchPageAllocator(SequencerBatchResult& batch_result) {
+        return [&batch_result](size_t max_size) {
+            const size_t page_offset = batch_result.page_offsets.back();
+            if (batch_result.arena.size() < page_offset + max_size) {
+                batch_result.arena.resize(std::max(page_offset + max_size, 2 * batch_result.arena.size()));
+            }
+            return tcb::span<uint8_t>(batch_result.arena.data() + page_offset, max_size);
+        };
+    }
+
+    void CommitBatchPage(SequencerBatchResult& batch_result, size_t page_output_size) {
+        batch_result.page_offsets.push_back(batch_result.page_offsets.back() + page_output_size);
+    }
+
+    void FinishBatchResult(SequencerBatchResult& batch_result) {
+        batch_result.arena.resize(batch_result.page_offsets.back());
+    }
+
+    // Drops the outputs of a failed batch, so callers never see the pages written before the failure.
+    void ClearBatchResult(SequencerBatchResult& batch_result) {
+        ReleaseBuffer(std::move(batch_result.arena));
+        batch_result = SequencerBatchResult{};
+    }
+}
+
+bool DataBatchEncryptionSequencer::DecodeAndEncryptBatch(const std::vector<SequencerBatchPage>& pages) {
+    InitializeBatchResult(batch_result_, pages);
+    batch_result_.page_encryption_metadata.reserve(pages.size());
+    auto allocate_page = MakeBatchPageAllocator(batch_result_);
+
+    try {
+        for (size_t i = 0; i < pages.size(); ++i) {
+            const auto& page = pages[i];
+
+            // The per-page sequencer shares the column context, so no validation or encryptor setup is repeated.
+            DataBatchEncryptionSequencer page_sequencer(
+                column_context_, page.encoding, page.encoding_attributes, encryption_metadata_);
+            if (!page_sequencer.DecodeAndEncryptInto(page.payload, allocate_page)) {
+                ClearBatchResult(batch_result_);
+                error_stage_ = page_sequencer.error_stage_;
+                error_message_ = "page " + std::to_string(i) + ": " + page_sequencer.error_message_;
+                return false;
+            }
+            CommitBatchPage(batch_result_, page_sequencer.output_size_);
+            batch_result_.page_encryption_metadata.push_back(std::move(page_sequencer.encryption_metadata_));
+        }
+    } catch (...) {
+        ClearBatchResult(batch_result_);
+        throw;
+    }
+    FinishBatchResult(batch_result_);
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::DecryptAndEncodeBatch(const std::vector<SequencerBatchPage>& pages) {
+    InitializeBatchResult(batch_result_, pages);
+    auto allocate_page = MakeBatchPageAllocator(batch_result_);
+
+    try {
+        for (size_t i = 0; i < pages.size(); ++i) {
+            const auto& page = pages[i];
+
+            // The per-page sequencer shares the column context, so no validation or encryptor setup is repeated.
+            // Each page is decrypted (and its version checked) with its own metadata when it has one.
+            DataBatchEncryptionSequencer page_sequencer(
+                column_context_, page.encoding, page.encoding_attributes,
+                page.encryption_metadata.empty() ? encryption_metadata_ : page.encryption_metadata);
+            if (!page_sequencer.DecryptAndEncodeInto(page.payload, allocate_page)) {
+                ClearBatchResult(batch_result_);
+                error_stage_ = page_sequencer.error_stage_;
+                error_message_ = "page " + std::to_string(i) + ": " + page_sequencer.error_message_;
+                return false;
+            }
+            CommitBatchPage(batch_result_, page_sequencer.output_size_);
+        }
+    } catch (...) {
+        ClearBatchResult(batch_result_);
+        throw;
+    }
+    FinishBatchResult(batch_result_);
+    return true;
+}
+
 // Helper methods to validate and basic parameter reading.
 
 bool DataBatchEncryptionSequencer::ConvertEncodingAttributesToValues() {
@@ -303,31 +1366,25 @@ bool DataBatchEncryptionSequencer::ConvertEncodingAttributesToValues() {
 }
 
 bool DataBatchEncryptionSequencer::ValidateParameters() {
+    // Check that the sequencer was built with a column context
+    if (!column_context_) {
+        error_stage_ = "validation";
+        error_message_ = "column context cannot be null";
+        return false;
+    }
+
     // Convert encoding attributes to typed values
     if (!ConvertEncodingAttributesToValues()) {
         return false;
     }
     
-    // Check that key_id is not null and not empty
-    if (key_id_.empty()) {
-        error_stage_ = "validation";
-        error_message_ = "key_id cannot be null or empty";
+    // Column-level checks (key_id, FIXED_LEN_BYTE_ARRAY datatype_length) run once when the
+    // column context is built. Report their result on every page call.
+    if (!column_context_->IsValid()) {
+        error_stage_ = column_context_->GetErrorStage();
+        error_message_ = column_context_->GetErrorMessage();
         return false;
     }
-
-    // Check FIXED_LEN_BYTE_ARRAY datatype_length requirement
-    if (datatype_ == Type::FIXED_LEN_BYTE_ARRAY) {
-        if (!datatype_length_.has_value()) {
-            error_stage_ = "parameter_validation";
-            error_message_ = "FIXED_LEN_BYTE_ARRAY datatype requires datatype_length parameter";
-            return false;
-        }
-        if (datatype_length_.value() <= 0) {
-            error_stage_ = "parameter_validation";
-            error_message_ = "FIXED_LEN_BYTE_ARRAY datatype_length must be positive";
-            return false;
-        }
-    }
     
     return true;
 }
@@ -337,14 +1394,112 @@ std::string DataBatchEncryptionSequencer::ValidateDecryptionVersion() {
     if (it == encryption_metadata_.end()) {
         std::cerr << "ERROR: EncryptionSequencer - encryption_metadata must contain key '" << DBPS_VERSION_KEY << "'" << std::endl;
         return "encryption_metadata must contain key '" + std::string(DBPS_VERSION_KEY) + "'";
-    } else if (it->second.find(DBPS_VERSION) != 0) {
+    } else if (it->second.find(DBPS_VERSION) != 0 && it->second.find(DBPS_VERSION_COLUMNAR) != 0) {
         std::cerr << "ERROR: EncryptionSequencer - encryption_metadata['" << DBPS_VERSION_KEY << "'] must match '" 
-                  << DBPS_VERSION << "', but got '" << it->second << "'" << std::endl;
-        return "encryption_metadata['" + std::string(DBPS_VERSION_KEY) + "'] must match '" + std::string(DBPS_VERSION) + "'";
+                  << DBPS_VERSION << "' or '" << DBPS_VERSION_COLUMNAR << "', but got '" << it->second << "'" << std::endl;
+        return "encryption_metadata['" + std::string(DBPS_VERSION_KEY) + "'] must match '" + std::string(DBPS_VERSION) +
+               "' or '" + std::string(DBPS_VERSION_COLUMNAR) + "'";
     }
     return "";
 }
 
+bool DataBatchEncryptionSequencer::IsPagePayloadCompressed() {
+    auto page_type = std::get<std::string>(encoding_attributes_converted_.at("page_type"));
+    if (page_type == "DATA_PAGE_V2") {
+        // On DATA_PAGE_V2, value bytes are compressed only if page_v2_is_compressed is set.
+        return std::get<bool>(encoding_attributes_converted_.at("page_v2_is_compressed"));
+    }
+    return column_context_->GetCompression() != CompressionCodec::UNCOMPRESSED;
+}
+
+std::optional<bool> DataBatchEncryptionSequencer::SafeGetChunkedFraming() {
+    auto it = encryption_metadata_.find(ENCRYPTION_FRAMING_KEY);
+    if (it == encryption_metadata_.end()) {
+        return false;
+    }
+    if (it->second != ENCRYPTION_FRAMING_CHUNKED) {
+        error_stage_ = "decrypt_framing_validation";
+        error_message_ = "Unsupported encryption_metadata['" + std::string(ENCRYPTION_FRAMING_KEY) + "']: " + it->second;
+        return std::nullopt;
+    }
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::AllocateOutput(
+    const OutputBufferAllocator& allocate_output, size_t required_size, tcb::span<uint8_t>& output) {
+    output = allocate_output(required_size);
+    if (output.size() < required_size) {
+        error_stage_ = "output_allocation";
+        error_message_ = "Output buffer too small: " + std::to_string(required_size) + " bytes required, " +
+                         std::to_string(output.size()) + " bytes provided";
+        return false;
+    }
+    return true;
+}
+
+bool DataBatchEncryptionSequencer::IsDictionaryIndexPassthroughPage() {
+    if (!column_context_->IsDictionaryIndexPassthroughEnabled()) {
+        return false;
+    }
+    if (encoding_ != Encoding::RLE_DICTIONARY && encoding_ != Encoding::PLAIN_DICTIONARY) {
+        return false;
+    }
+    auto page_type = std::get<std::string>(encoding_attributes_converted_.at("page_type"));
+    return page_type == "DATA_PAGE_V1" || page_type == "DATA_PAGE_V2";
+}
+
+bool DataBatchEncryptionSequencer::DecryptDictionaryIndexPassthroughInto(
+    tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output) {
+    // Pages are tagged by the writer's settings, so the reader refuses the forgeable checksum on its own.
+    if (column_context_->GetEncryptor().GetBlockTagLength() == 0 &&
+        !column_context_->IsInsecureDictionaryIndexChecksumAllowed()) {
+        error_stage_ = "decrypt_integrity_check";
+        error_message_ = "Dictionary index page needs an encryptor with block tags "
+                         "(or insecure_dictionary_index_checksum)";
+        return false;
+    }
+    const size_t tag_length = GetIndexPageTagLength();
+    if (ciphertext.size() <= tag_length) {
+        error_stage_ = "decrypt_integrity_check";
+        error_message_ = "Dictionary index page is too short to hold its tag";
+        return false;
+    }
+    auto payload = ciphertext.subspan(tag_length);
+    std::vector<uint8_t> expected_tag(tag_length);
+    ComputeIndexPageTag(payload, expected_tag);
+    // Every byte is compared, so the time taken does not reveal the length of the matching prefix.
+    uint8_t difference = 0;
+    for (size_t i = 0; i < tag_length; ++i) {
+        difference |= static_cast<uint8_t>(expected_tag[i] ^ ciphertext[i]);
+    }
+    if (difference != 0) {
+        error_stage_ = "decrypt_integrity_check";
+        error_message_ = "Dictionary index page tag mismatch";
+        return false;
+    }
+    tcb::span<uint8_t> output;
+    if (!AllocateOutput(allocate_output, payload.size(), output)) {
+        return false;
+    }
+    std::memcpy(output.data(), payload.data(), payload.size());
+    output_size_ = payload.size();
+    return true;
+}
+
+size_t DataBatchEncryptionSequencer::GetIndexPageTagLength() {
+    const size_t block_tag_length = column_context_->GetEncryptor().GetBlockTagLength();
+    return block_tag_length > 0 ? block_tag_length : kIndexChecksumBytes;
+}
+
+void DataBatchEncryptionSequencer::ComputeIndexPageTag(tcb::span<const uint8_t> payload, tcb::span<uint8_t> tag) {
+    auto& encryptor = column_context_->GetEncryptor();
+    if (encryptor.GetBlockTagLength() > 0) {
+        encryptor.ComputeBlockTag(payload, tag);
+        return;
+    }
+    write_le<int64_t>(static_cast<int64_t>(ComputeIndexPageChecksum(column_context_->GetKeyId(), payload)), tag.data());
+}
+
 const char* DataBatchEncryptionSequencer::GetEncryptionModeKey() {
     auto page_type = std::get<std::string>(encoding_attributes_converted_.at("page_type"));
     return (page_type == "DICTIONARY_PAGE") ? ENCRYPTION_MODE_KEY_DICTIONARY_PAGE : ENCRYPTION_MODE_KEY_DATA_PAGE;
@@ -357,7 +1512,8 @@ std::optional<std::string> DataBatchEncryptionSequencer::SafeGetEncryptionMode()
         return std::nullopt;
     }
     const std::string& encryption_mode = it->second;
-    if (encryption_mode != ENCRYPTION_MODE_PER_BLOCK && encryption_mode != ENCRYPTION_MODE_PER_VALUE) {
+    if (encryption_mode != ENCRYPTION_MODE_PER_BLOCK && encryption_mode != ENCRYPTION_MODE_PER_VALUE &&
+        encryption_mode != ENCRYPTION_MODE_ADAPTIVE && encryption_mode != ENCRYPTION_MODE_DICTIONARY_INDEX_PASSTHROUGH) {
         // The value for encryption mode is not valid.
         return std::nullopt;
     }
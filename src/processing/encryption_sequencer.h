@@ -31,6 +31,8 @@
 #include "parquet_utils.h"
 #include "../common/bytes_utils.h"
 #include "encryptors/dbps_encryptor.h"
+#include "column_encryption_context.h"
+#include <functional>
 #include <memory>
 
 #ifndef DBPS_EXPORT
@@ -39,6 +41,53 @@
 
 using namespace dbps::external;
 
+/**
+ * Input page for the batch methods of DataBatchEncryptionSequencer.
+ * The payload is a non-owning view; the caller must keep it alive during the batch call.
+ * encryption_metadata is the metadata of the page ciphertext, as returned in page_encryption_metadata by
+ * DecodeAndEncryptBatch. It is only read by DecryptAndEncodeBatch; when empty, the metadata the sequencer was
+ * constructed with applies.
+ */
+struct SequencerBatchPage {
+    tcb::span<const uint8_t> payload;
+    Encoding::type encoding;
+    std::map<std::string, std::string> encoding_attributes;
+    std::map<std::string, std::string> encryption_metadata;
+};
+
+/**
+ * Output of the batch methods of DataBatchEncryptionSequencer.
+ *
+ * All page outputs are stored back-to-back in a single contiguous arena.
+ * Page i occupies arena[page_offsets[i], page_offsets[i + 1]), so page_offsets has num_pages + 1 entries.
+ * page_encryption_metadata[i] holds the encryption metadata of page i (only set by DecodeAndEncryptBatch).
+ */
+struct SequencerBatchResult {
+    std::vector<uint8_t> arena;
+    std::vector<size_t> page_offsets;
+    std::vector<std::map<std::string, std::string>> page_encryption_metadata;
+
+    size_t GetNumPages() const {
+        return page_offsets.empty() ? 0 : page_offsets.size() - 1;
+    }
+
+    tcb::span<const uint8_t> GetPage(size_t page_index) const {
+        if (page_index >= GetNumPages()) {
+            throw InvalidInputException("Batch page index out of bounds: " + std::to_string(page_index));
+        }
+        return tcb::span<const uint8_t>(
+            arena.data() + page_offsets[page_index],
+            page_offsets[page_index + 1] - page_offsets[page_index]);
+    }
+};
+
+/**
+ * Allocator of caller-owned output memory for the *Into methods of DataBatchEncryptionSequencer.
+ * Called at most once per page with an upper bound of the output size; returns a writable span of at least
+ * max_size bytes (a smaller span fails the call). The output written may be shorter than max_size.
+ */
+using OutputBufferAllocator = std::function<tcb::span<uint8_t>(size_t max_size)>;
+
 /**
  * Encryption sequencer class that handles data conversion and encryption/decryption operations.
  * 
@@ -52,6 +101,43 @@ using namespace dbps::external;
  * Supports all data types, compression types, and encodings.
  * 
  * The class takes constructor parameters that were previously public attributes in JsonRequest.
+ *
+ * Column-level parameters and the encryptor live in a shared ColumnEncryptionContext. Callers that
+ * process many pages of the same column should build the context once and use the context-based
+ * constructor, so each page only carries its payload, encoding and encoding attributes.
+ *
+ * Streaming mode (ColumnEncryptionContext::IsStreamingEnabled) bounds the working memory for oversized pages.
+ * Payloads, level bytes and value bytes are encrypted in chunks of at most the streaming chunk size, and each
+ * one is written as a chunk stream:
+ *   [u32 num_chunks][u32 plaintext_size] then per chunk [u32 chunk_plaintext_size][u32 chunk_ciphertext_size][ciphertext]
+ * Per-block pages hold one chunk stream; per-value pages hold the level chunk stream followed by the value
+ * chunk stream. Value chunks hold whole values. The encryption metadata records "encrypt_framing" = "chunked",
+ * and decryption reads the chunk sizes from the ciphertext. Streaming requires an encryptor with ciphertext
+ * size bounds (see DBPSEncryptor::MaxBlockCiphertextSize).
+ *
+ * The per-block or per-value pipeline of a page is picked by the column EncryptionModePolicy among the pipelines
+ * the page supports. Adaptive policies may pick different pipelines for pages of the same type, so their pages
+ * are recorded with encryption mode "adaptive" and a leading mode tag byte (0x00 per-block, 0x01 per-value).
+ *
+ * With dictionary index passthrough enabled on the column, dictionary index data pages are not encrypted:
+ * the ciphertext is [tag][page payload as-is] and the mode is "dictionary_index_passthrough". The indices are
+ * then readable, while the dictionary values stay encrypted in the dictionary page. Encryptors with block tags
+ * (see DBPSEncryptor::ComputeBlockTag) make the tag a MAC, so modified pages fail to decrypt. Otherwise the tag
+ * is a u64 checksum seeded with the public key id, which only detects accidental corruption.
+ *
+ * With trusted ciphertext on the column (ColumnEncryptionOptions::trusted_ciphertext), per-value pages are
+ * decrypted with the encryptor's single-pass DecryptTrustedValueListInto, straight into the page when it is not
+ * compressed, and the decrypted level bytes are not re-validated against the encoding attributes.
+ *
+ * With columnar value lists on the column (ColumnEncryptionOptions::columnar_value_lists) and an encryptor that
+ * supports them, variable-size value lists are encrypted with packed value sizes and one payload region instead
+ * of [u32 size][value] records, and the metadata of those pages records dbps_agent_version "v0.02" instead of
+ * "v0.01". Pages without a columnar value list (fixed-size values, per-block and passthrough pages) keep "v0.01".
+ * Decryption accepts both versions and tells the layouts apart by the value-list header.
+ *
+ * With a BufferPool on the column (ColumnEncryptionOptions::buffer_pool), the pool is the thread's default pool
+ * during each call: intermediate buffers and encrypted_result_/decrypted_result_ are drawn from it, and the
+ * intermediate buffers are handed back to it once consumed.
  */
 class DataBatchEncryptionSequencer {
 public:
@@ -59,6 +145,12 @@ public:
     std::vector<uint8_t> encrypted_result_;
     std::vector<uint8_t> decrypted_result_;
 
+    // Result storage for the batch methods
+    SequencerBatchResult batch_result_;
+
+    // Size of the output written by the *Into methods into the caller's buffer
+    size_t output_size_ = 0;
+
     // Encryption metadata
     std::map<std::string, std::string> encryption_metadata_;
     
@@ -96,6 +188,20 @@ public:
         const std::map<std::string, std::string>& encryption_metadata,
         std::unique_ptr<DBPSEncryptor> encryptor
     );
+
+    // Constructor with a shared per-column context. Only page-level parameters are passed per call.
+    DataBatchEncryptionSequencer(
+        std::shared_ptr<const ColumnEncryptionContext> column_context,
+        Encoding::type encoding,
+        std::map<std::string, std::string> encoding_attributes,
+        std::map<std::string, std::string> encryption_metadata
+    );
+
+    // Constructor for the batch methods. Page-level parameters are passed with each page.
+    DataBatchEncryptionSequencer(
+        std::shared_ptr<const ColumnEncryptionContext> column_context,
+        std::map<std::string, std::string> encryption_metadata
+    );
     
     // Default constructor
     DataBatchEncryptionSequencer() = default;
@@ -107,24 +213,64 @@ public:
     bool DecodeAndEncrypt(tcb::span<const uint8_t> plaintext);
     bool DecryptAndEncode(tcb::span<const uint8_t> ciphertext);
 
+    /**
+     * Variants of DecodeAndEncrypt/DecryptAndEncode that write the output into caller-owned memory
+     * obtained from allocate_output, instead of encrypted_result_/decrypted_result_.
+     * On success, output_size_ holds the number of bytes written at the start of the allocated span.
+     * If the allocated span is smaller than requested, returns false with error_stage_ "output_allocation".
+     */
+    bool DecodeAndEncryptInto(tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output);
+    bool DecryptAndEncodeInto(tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Variant of DecodeAndEncryptInto for a page payload held in several segments (e.g. received in network chunks,
+     * or DATA_PAGE_V2 levels and values in separate buffers), with the same output as for the concatenated payload.
+     * Per-block pages are encrypted segment by segment, and per-value pages are split with the segmented
+     * DecompressAndSplit, so the segments are not concatenated first. Streaming and dictionary index passthrough
+     * pages are gathered into one pooled buffer.
+     */
+    bool DecodeAndEncryptInto(const SegmentedBytes& plaintext, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Returns an upper bound of the DecodeAndEncrypt output size for a page payload of plaintext_size bytes,
+     * using only the page encoding attributes. Returns std::nullopt if the bound cannot be derived without
+     * the payload (per-value pages with a compressed payload, or an encryptor without size bounds), or if
+     * the parameters are invalid (error_stage_/error_message_ are set).
+     */
+    std::optional<size_t> GetMaxCiphertextSize(size_t plaintext_size);
+
+    /**
+     * Batch processing methods for many pages of the same column.
+     *
+     * Column validation and the encryptor are shared across all pages, and all page outputs are
+     * written into batch_result_ as one contiguous arena with per-page offsets.
+     * For decryption, each page is decrypted and version-checked with its own encryption_metadata, or with the
+     * encryption_metadata_ given at construction for pages without one.
+     *
+     * Returns true if all pages succeed. On the first failed page, processing stops, batch_result_ is
+     * cleared, and error_stage_/error_message_ are set (the message is prefixed with the page index).
+     * Exceptions raised by a page propagate to the caller, same as the single-page methods, after
+     * batch_result_ is cleared.
+     */
+    bool DecodeAndEncryptBatch(const std::vector<SequencerBatchPage>& pages);
+    bool DecryptAndEncodeBatch(const std::vector<SequencerBatchPage>& pages);
+
 protected:
-    // Parameters for encryption/decryption operations
-    std::string column_name_;
-    Type::type datatype_;
-    std::optional<int> datatype_length_;
-    CompressionCodec::type compression_;
+    // Column-level parameters and encryptor, shared across all pages of the column.
+    std::shared_ptr<const ColumnEncryptionContext> column_context_;
+
+    // Page-level parameters for encryption/decryption operations
     Encoding::type encoding_;
     std::map<std::string, std::string> encoding_attributes_;
-    CompressionCodec::type encrypted_compression_;
-    std::string key_id_;
-    std::string user_id_;
-    std::string application_context_;
-    
-    // Encryptor instance for performing encryption/decryption operations
-    std::unique_ptr<DBPSEncryptor> encryptor_;
 
     // Converted encoding attributes values to corresponding types
     AttributesMap encoding_attributes_converted_;
+
+    // Whether the page being encrypted holds a columnar value list, so its metadata records the columnar version
+    bool columnar_value_list_written_ = false;
+
+    // Whether the version of the page being decrypted allows columnar value lists (format v0.02)
+    bool columnar_value_list_readable_ = false;
     
     /**
      * Converts encoding attributes string values to corresponding typed values.
@@ -136,7 +282,8 @@ protected:
     
     /**
      * Performs comprehensive validation of all parameters and key_id.
-     * Converts string parameters to enums, validates key_id, and checks supported combinations.
+     * Converts the page encoding attributes and reports the column-level validation result
+     * computed once by the ColumnEncryptionContext (key_id, FIXED_LEN_BYTE_ARRAY datatype_length).
      * Supports all data types, compression types, and encodings.
      * Returns true if all validation passes, false otherwise.
      */
@@ -153,7 +300,8 @@ protected:
     
     /**
      * Safely gets the encryption_mode value from encryption_metadata.
-     * Returns the encryption mode value ("per_block" or "per_value") if found and valid,
+     * Returns the encryption mode value ("per_block", "per_value", "adaptive" or "dictionary_index_passthrough")
+     * if found and valid,
      * otherwise returns empty string.
      */
     std::optional<std::string> SafeGetEncryptionMode();
@@ -162,5 +310,153 @@ protected:
      * Returns the encryption mode metadata key based on the page type in encoding_attributes_converted_.
      */
     const char* GetEncryptionModeKey();
+
+    /**
+     * Returns true if the page payload is compressed with the column compression, based on the page type
+     * in encoding_attributes_converted_. DATA_PAGE_V2 pages follow page_v2_is_compressed.
+     */
+    bool IsPagePayloadCompressed();
+
+    /**
+     * Encrypts the page with the given pipeline into the span obtained from allocate_output, setting output_size_.
+     * Encryption metadata is set by the caller.
+     */
+    bool EncryptPageInto(
+        const SegmentedBytes& plaintext, bool use_per_value, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Per-value pipeline of EncryptPageInto, for non-streaming pages. When dictionary_layout is not null, the
+     * page may be written in the dictionary layout of value deduplication, and *dictionary_layout tells if it was.
+     */
+    bool EncryptPerValueInto(
+        const SegmentedBytes& plaintext, const OutputBufferAllocator& allocate_output, bool* dictionary_layout);
+
+    /**
+     * Value deduplication (see ValueDedupOptions).
+     * - UseValueDedup: whether per-value pages are deduplicated, from the column mode and the encryptor.
+     * - UseValueLayoutTag: whether per-value pages are tagged with their layout (DICTIONARY mode).
+     * - EncryptPerValueScatteredInto: SCATTER mode, same output as the regular per-value pipeline.
+     * - EncryptPerValueDictionaryInto: DICTIONARY mode. Returns std::nullopt without writing anything when the
+     *   dictionary layout would not be smaller, so the page takes the regular layout.
+     * - DecryptPerValueDictionaryInto: decrypts a page in the dictionary layout, after its layout tag.
+     */
+    bool UseValueDedup();
+    bool UseValueLayoutTag();
+    bool EncryptPerValueScatteredInto(
+        tcb::span<const uint8_t> level_bytes,
+        size_t value_bytes_size,
+        tcb::span<const uint32_t> indices,
+        const dbps::processing::TypedValuesBuffer& distinct_values,
+        const OutputBufferAllocator& allocate_output);
+    std::optional<bool> EncryptPerValueDictionaryInto(
+        tcb::span<const uint8_t> level_bytes,
+        size_t value_bytes_size,
+        const dbps::processing::DeduplicatedValues& deduplicated,
+        const dbps::processing::TypedValuesBuffer& distinct_values,
+        const OutputBufferAllocator& allocate_output);
+    bool DecryptPerValueDictionaryInto(tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Value-list layout (see ColumnEncryptionOptions::columnar_value_lists).
+     * - UseColumnarValueLists: whether value lists are encrypted in the columnar layout, from the column option,
+     *   the encryptor and the datatype (only variable-size values have a columnar layout).
+     * - GetCiphertextVersion: the dbps_agent_version recorded in the encryption metadata of the page: the
+     *   columnar version only if a columnar value list was written for it, so other pages stay readable by
+     *   earlier versions.
+     * - EncryptColumnValueList/EncryptColumnValueListInto: encrypt a value list in that layout. value_bytes are the
+     *   PLAIN values typed_buffer reads; columnar value lists are built from them in one pass.
+     * Decryption reads both layouts: the value-list header tells them apart.
+     * - CheckValueListLayout: rejects a columnar value list in a page whose version predates the layout
+     *   (sets error_stage_/error_message_ and returns false).
+     */
+    bool UseColumnarValueLists();
+    const char* GetCiphertextVersion();
+    bool CheckValueListLayout(tcb::span<const uint8_t> value_list_ciphertext);
+    std::vector<uint8_t> EncryptColumnValueList(
+        const dbps::processing::TypedValuesBuffer& typed_buffer, tcb::span<const uint8_t> value_bytes);
+    size_t EncryptColumnValueListInto(
+        const dbps::processing::TypedValuesBuffer& typed_buffer,
+        tcb::span<const uint8_t> value_bytes,
+        tcb::span<uint8_t> out);
+
+    /**
+     * Returns true if per-value pages carry a value layout tag, from encryption_metadata_.
+     * Sets error_stage_/error_message_ and returns std::nullopt if the value is not valid.
+     */
+    std::optional<bool> SafeGetValueLayoutTagged();
+
+    /**
+     * Joins decrypted level and value bytes into the span obtained from allocate_output, compressing them with
+     * the column compression, and releases both buffers.
+     */
+    bool CompressAndJoinPageInto(
+        std::vector<uint8_t> level_bytes, std::vector<uint8_t> value_bytes, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Upper bound of the EncryptPageInto output size for the given pipeline, or std::nullopt if it cannot be
+     * derived without the payload.
+     */
+    std::optional<size_t> GetMaxPageCiphertextSize(size_t plaintext_size, bool use_per_value);
+
+    /**
+     * Returns true if the page is a dictionary index data page (RLE_DICTIONARY/PLAIN_DICTIONARY data page) of a
+     * column with dictionary index passthrough enabled.
+     */
+    bool IsDictionaryIndexPassthroughPage();
+
+    /**
+     * Verifies the tag of a dictionary index passthrough page and copies its payload into the span obtained
+     * from allocate_output. Sets error_stage_ to "decrypt_integrity_check" on tag mismatch.
+     */
+    bool DecryptDictionaryIndexPassthroughInto(
+        tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Length of the tag in front of a dictionary index passthrough page: the encryptor's block tag length, or
+     * the u64 checksum for encryptors without block tags.
+     */
+    size_t GetIndexPageTagLength();
+
+    // Writes the tag of a passthrough page payload into tag (GetIndexPageTagLength() bytes).
+    void ComputeIndexPageTag(tcb::span<const uint8_t> payload, tcb::span<uint8_t> tag);
+
+    /**
+     * Returns true if the ciphertext uses the chunked framing of the streaming mode, from encryption_metadata_.
+     * Sets error_stage_/error_message_ and returns std::nullopt if the framing value is not valid.
+     */
+    std::optional<bool> SafeGetChunkedFraming();
+
+    /**
+     * Streaming mode pipelines. Pages are processed in chunks of the column streaming chunk size, and the
+     * output is written with the chunked framing into the span obtained from allocate_output.
+     * Return false and set error_stage_/error_message_ on failure.
+     * @throws InvalidInputException on malformed chunk streams (decryption)
+     */
+    bool EncryptPerBlockChunkedInto(tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output);
+    bool EncryptPerValueChunkedInto(tcb::span<const uint8_t> plaintext, const OutputBufferAllocator& allocate_output);
+    bool DecryptPerBlockChunkedInto(tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output);
+    bool DecryptPerValueChunkedInto(tcb::span<const uint8_t> ciphertext, const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Returns true if per-value pages are decrypted with the trusted single-pass decoder: the column trusts its
+     * ciphertext and the encryptor bounds the decrypted sizes.
+     */
+    bool UseTrustedValueDecryption();
+
+    /**
+     * Trusted per-value decryption of a non-chunked page, from its split level and value ciphertexts.
+     * @throws InvalidInputException if a length in the ciphertext overruns it
+     */
+    bool DecryptPerValueTrustedInto(
+        tcb::span<const uint8_t> encrypted_level_bytes,
+        tcb::span<const uint8_t> encrypted_value_bytes,
+        const OutputBufferAllocator& allocate_output);
+
+    /**
+     * Requests required_size bytes from allocate_output.
+     * Returns false and sets error_stage_/error_message_ if the allocated span is too small.
+     */
+    bool AllocateOutput(
+        const OutputBufferAllocator& allocate_output, size_t required_size, tcb::span<uint8_t>& output);
     
 };
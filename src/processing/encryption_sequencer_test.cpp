@@ -19,6 +19,7 @@
 #include "compression_utils.h"
 #include "parquet_utils.h"
 #include "parquet_testing_utils.h"
+#include "encryptors/aes_encryptor.h"
 #include "../common/enums.h"
 #include "../common/bytes_utils.h"
 #include <iostream>
@@ -31,6 +32,8 @@
 using namespace dbps::compression;
 
 using namespace dbps::external;
+using dbps::processing::BufferPool;
+using dbps::processing::BufferPoolOptions;
 
 // Test data constants - pure binary data
 const std::vector<uint8_t> HELLO_WORLD_DATA = BuildByteArrayValueBytesForTesting("Hello, World!");
@@ -454,6 +457,74 @@ TEST(EncryptionSequencer, RleDictionaryEncodingUsesPerBlockEncryption) {
     EXPECT_EQ(sequencer.decrypted_result_, rle_dict_data);
 }
 
+// Unsupported pages are dispatched to per-block encryption upfront, without decompressing the payload.
+TEST(EncryptionSequencer, UnsupportedPage_SkipsPayloadDecoding) {
+    // Not a valid SNAPPY stream: decompression would throw if the per-value pipeline was attempted.
+    std::vector<uint8_t> payload = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+
+    DataBatchEncryptionSequencer sequencer(
+        "dict_column",
+        Type::INT32,
+        std::nullopt,
+        CompressionCodec::SNAPPY,
+        Encoding::RLE_DICTIONARY,
+        {{"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", "1"}},
+        CompressionCodec::UNCOMPRESSED,
+        "test_key",
+        "test_user",
+        "{}",
+        {}
+    );
+
+    ASSERT_TRUE(sequencer.DecodeAndEncrypt(payload))
+        << sequencer.error_stage_ << " - " << sequencer.error_message_;
+    EXPECT_EQ(sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "per_block");
+
+    ASSERT_TRUE(sequencer.DecryptAndEncode(sequencer.encrypted_result_))
+        << sequencer.error_stage_ << " - " << sequencer.error_message_;
+    EXPECT_EQ(sequencer.decrypted_result_, payload);
+}
+
+// An uncompressed DATA_PAGE_V2 page of a column with an unsupported compression is still encrypted per-value.
+TEST(EncryptionSequencer, UncompressedDataPageV2_OnGzipColumn_UsesPerValue) {
+    std::vector<uint8_t> value_bytes;
+    append_f32_le(value_bytes, 1.5f);
+    append_f32_le(value_bytes, -2.0f);
+    std::vector<uint8_t> level_bytes = {};
+    auto plaintext = Join(level_bytes, value_bytes);
+
+    std::map<std::string, std::string> attribs = {
+        {"page_type", "DATA_PAGE_V2"},
+        {"data_page_num_values", "2"},
+        {"data_page_max_definition_level", "0"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v2_definition_levels_byte_length", "0"},
+        {"page_v2_repetition_levels_byte_length", "0"},
+        {"page_v2_num_nulls", "0"},
+        {"page_v2_is_compressed", "false"}};
+
+    DataBatchEncryptionSequencer sequencer(
+        "float_col_v2",
+        Type::FLOAT,
+        std::nullopt,
+        CompressionCodec::GZIP,
+        Encoding::PLAIN,
+        attribs,
+        CompressionCodec::UNCOMPRESSED,
+        "test_key",
+        "test_user",
+        "{}",
+        {});
+
+    ASSERT_TRUE(sequencer.DecodeAndEncrypt(plaintext))
+        << sequencer.error_stage_ << " - " << sequencer.error_message_;
+    EXPECT_EQ(sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "per_value");
+
+    ASSERT_TRUE(sequencer.DecryptAndEncode(sequencer.encrypted_result_))
+        << sequencer.error_stage_ << " - " << sequencer.error_message_;
+    EXPECT_EQ(sequencer.decrypted_result_, plaintext);
+}
+
 // Test FIXED_LEN_BYTE_ARRAY validation
 TEST(EncryptionSequencer, FixedLenByteArrayValidation) {
     
@@ -828,3 +899,1093 @@ TEST(EncryptionSequencer, DataPageV1MalformedDefinitionPayload_Throws) {
 
     EXPECT_THROW((void)sequencer.DecodeAndEncrypt(plaintext), InvalidInputException);
 }
+
+// -----------------------------------------------------------------------------
+// Multi-page batch coverage through DataBatchEncryptionSequencer.
+// -----------------------------------------------------------------------------
+
+namespace {
+    // Context of a BYTE_ARRAY test column. Without an encryptor, the context creates its default one.
+    std::shared_ptr<const ColumnEncryptionContext> MakeTestColumnContext(
+        const std::string& column_name, CompressionCodec::type compression = CompressionCodec::UNCOMPRESSED,
+        ColumnEncryptionOptions options = {}, std::unique_ptr<DBPSEncryptor> encryptor = nullptr) {
+        if (encryptor) {
+            return std::make_shared<const ColumnEncryptionContext>(
+                column_name, Type::BYTE_ARRAY, std::nullopt, compression, CompressionCodec::UNCOMPRESSED,
+                "test_key", "test_user", "{}", std::move(encryptor), std::move(options));
+        }
+        return std::make_shared<const ColumnEncryptionContext>(
+            column_name, Type::BYTE_ARRAY, std::nullopt, compression, CompressionCodec::UNCOMPRESSED,
+            "test_key", "test_user", "{}", std::move(options));
+    }
+
+    std::unique_ptr<DBPSEncryptor> MakeTestAesEncryptor(const std::string& column_name) {
+        return std::make_unique<AesEncryptor>(
+            "test_key", column_name, "test_user", "{}", Type::BYTE_ARRAY, std::vector<uint8_t>(32, 0x22));
+    }
+
+    std::map<std::string, std::string> DictPageAttributes(size_t num_values) {
+        return {{"page_type", "DICTIONARY_PAGE"}, {"dict_page_num_values", std::to_string(num_values)}};
+    }
+
+    std::map<std::string, std::string> RequiredDataPageV1Attributes(size_t num_values) {
+        return {
+            {"page_type", "DATA_PAGE_V1"},
+            {"data_page_num_values", std::to_string(num_values)},
+            {"data_page_max_definition_level", "0"},
+            {"data_page_max_repetition_level", "0"},
+            {"page_v1_repetition_level_encoding", "RLE"},
+            {"page_v1_definition_level_encoding", "RLE"}};
+    }
+}
+
+TEST(EncryptionSequencer, Batch_MatchesSinglePageResults) {
+    auto column_context = MakeTestColumnContext("batch_col");
+    std::vector<std::vector<uint8_t>> payloads = {
+        BuildByteArrayValueBytesForTesting("first_page"),
+        CombineRawBytesIntoValueBytesForTesting(
+            {{'a', 'b'}, {'c'}, {'d', 'e', 'f'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN),
+        BuildByteArrayValueBytesForTesting("third")};
+    std::vector<SequencerBatchPage> pages = {
+        {payloads[0], Encoding::PLAIN, DictPageAttributes(1)},
+        {payloads[1], Encoding::PLAIN, RequiredDataPageV1Attributes(3)},
+        {payloads[2], Encoding::PLAIN, DictPageAttributes(1)}};
+
+    DataBatchEncryptionSequencer batch_sequencer(column_context, {});
+    ASSERT_TRUE(batch_sequencer.DecodeAndEncryptBatch(pages))
+        << batch_sequencer.error_stage_ << " - " << batch_sequencer.error_message_;
+
+    const auto& batch_result = batch_sequencer.batch_result_;
+    ASSERT_EQ(batch_result.GetNumPages(), pages.size());
+    ASSERT_EQ(batch_result.page_encryption_metadata.size(), pages.size());
+    EXPECT_EQ(batch_result.page_offsets.front(), 0u);
+    EXPECT_EQ(batch_result.page_offsets.back(), batch_result.arena.size());
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        DataBatchEncryptionSequencer page_sequencer(
+            column_context, pages[i].encoding, pages[i].encoding_attributes, {});
+        ASSERT_TRUE(page_sequencer.DecodeAndEncrypt(pages[i].payload));
+        auto batch_page = batch_result.GetPage(i);
+        EXPECT_EQ(std::vector<uint8_t>(batch_page.begin(), batch_page.end()), page_sequencer.encrypted_result_);
+        EXPECT_EQ(batch_result.page_encryption_metadata[i], page_sequencer.encryption_metadata_);
+    }
+    EXPECT_EQ(batch_result.page_encryption_metadata[1].at("encrypt_mode_data_page"), "per_value");
+    EXPECT_THROW(batch_result.GetPage(pages.size()), InvalidInputException);
+}
+
+TEST(EncryptionSequencer, Batch_RoundTrip) {
+    auto column_context = MakeTestColumnContext("batch_col");
+    std::vector<std::vector<uint8_t>> payloads = {
+        BuildByteArrayValueBytesForTesting("dictionary_value"),
+        CombineRawBytesIntoValueBytesForTesting(
+            {{'x'}, {'y', 'y'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN)};
+    std::vector<SequencerBatchPage> pages = {
+        {payloads[0], Encoding::PLAIN, DictPageAttributes(1)},
+        {payloads[1], Encoding::PLAIN, RequiredDataPageV1Attributes(2)}};
+
+    DataBatchEncryptionSequencer encrypt_sequencer(column_context, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncryptBatch(pages));
+
+    // All pages of this batch share the same metadata, as encryption modes are decided per page type.
+    std::map<std::string, std::string> encryption_metadata;
+    for (const auto& page_metadata : encrypt_sequencer.batch_result_.page_encryption_metadata) {
+        encryption_metadata.insert(page_metadata.begin(), page_metadata.end());
+    }
+
+    std::vector<SequencerBatchPage> encrypted_pages;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        encrypted_pages.push_back(
+            {encrypt_sequencer.batch_result_.GetPage(i), pages[i].encoding, pages[i].encoding_attributes});
+    }
+    DataBatchEncryptionSequencer decrypt_sequencer(column_context, encryption_metadata);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncodeBatch(encrypted_pages))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+
+    ASSERT_EQ(decrypt_sequencer.batch_result_.GetNumPages(), pages.size());
+    EXPECT_TRUE(decrypt_sequencer.batch_result_.page_encryption_metadata.empty());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto decrypted_page = decrypt_sequencer.batch_result_.GetPage(i);
+        EXPECT_EQ(std::vector<uint8_t>(decrypted_page.begin(), decrypted_page.end()), payloads[i]);
+    }
+}
+
+TEST(EncryptionSequencer, Batch_EmptyBatch) {
+    DataBatchEncryptionSequencer sequencer(MakeTestColumnContext("batch_col"), {});
+    ASSERT_TRUE(sequencer.DecodeAndEncryptBatch({}));
+    EXPECT_EQ(sequencer.batch_result_.GetNumPages(), 0u);
+    EXPECT_TRUE(sequencer.batch_result_.arena.empty());
+}
+
+TEST(EncryptionSequencer, Batch_FailedPageReportsIndex) {
+    std::vector<uint8_t> good_payload = BuildByteArrayValueBytesForTesting("good");
+    std::vector<SequencerBatchPage> pages = {
+        {good_payload, Encoding::PLAIN, DictPageAttributes(1)},
+        {good_payload, Encoding::PLAIN, {{"page_type", "DICTIONARY_PAGE"}}}};
+
+    DataBatchEncryptionSequencer sequencer(MakeTestColumnContext("batch_col"), {});
+    EXPECT_FALSE(sequencer.DecodeAndEncryptBatch(pages));
+    EXPECT_EQ(sequencer.error_message_.rfind("page 1: ", 0), 0u) << sequencer.error_message_;
+    EXPECT_EQ(sequencer.batch_result_.GetNumPages(), 0u);
+}
+
+TEST(EncryptionSequencer, Batch_ThrowingPageClearsResult) {
+    auto column_context = MakeTestColumnContext("batch_col");
+    std::vector<uint8_t> payload = BuildByteArrayValueBytesForTesting("good");
+    DataBatchEncryptionSequencer encrypt_sequencer(column_context, Encoding::PLAIN, DictPageAttributes(1), {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(payload));
+
+    // The first page decrypts into the arena before the truncated second page throws.
+    const std::vector<uint8_t>& ciphertext = encrypt_sequencer.encrypted_result_;
+    std::vector<uint8_t> truncated(ciphertext.begin(), ciphertext.begin() + 1);
+    std::vector<SequencerBatchPage> pages = {
+        {ciphertext, Encoding::PLAIN, DictPageAttributes(1)},
+        {truncated, Encoding::PLAIN, DictPageAttributes(1)}};
+
+    DataBatchEncryptionSequencer decrypt_sequencer(column_context, encrypt_sequencer.encryption_metadata_);
+    EXPECT_ANY_THROW(decrypt_sequencer.DecryptAndEncodeBatch(pages));
+    EXPECT_EQ(decrypt_sequencer.batch_result_.GetNumPages(), 0u);
+    EXPECT_TRUE(decrypt_sequencer.batch_result_.arena.empty());
+}
+
+TEST(EncryptionSequencer, Into_WritesCallerBufferForBothPipelines) {
+    auto column_context = MakeTestColumnContext("batch_col");
+    auto payload = CombineRawBytesIntoValueBytesForTesting(
+        {{'a', 'b'}, {'c'}, {'d', 'e', 'f'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+
+    // PLAIN goes per-value, RLE_DICTIONARY goes per-block.
+    for (auto encoding : {Encoding::PLAIN, Encoding::RLE_DICTIONARY}) {
+        DataBatchEncryptionSequencer owned_sequencer(
+            column_context, encoding, RequiredDataPageV1Attributes(3), {});
+        ASSERT_TRUE(owned_sequencer.DecodeAndEncrypt(payload));
+
+        DataBatchEncryptionSequencer into_sequencer(
+            column_context, encoding, RequiredDataPageV1Attributes(3), {});
+        auto max_size = into_sequencer.GetMaxCiphertextSize(payload.size());
+        ASSERT_TRUE(max_size.has_value());
+
+        std::vector<uint8_t> caller_buffer(max_size.value());
+        size_t requested_size = 0;
+        ASSERT_TRUE(into_sequencer.DecodeAndEncryptInto(payload, [&](size_t size) {
+            requested_size = size;
+            return tcb::span<uint8_t>(caller_buffer);
+        })) << into_sequencer.error_stage_ << " - " << into_sequencer.error_message_;
+        EXPECT_LE(requested_size, max_size.value());
+        EXPECT_TRUE(into_sequencer.encrypted_result_.empty());
+        EXPECT_EQ(std::vector<uint8_t>(caller_buffer.begin(), caller_buffer.begin() + into_sequencer.output_size_),
+                  owned_sequencer.encrypted_result_);
+        EXPECT_EQ(into_sequencer.encryption_metadata_, owned_sequencer.encryption_metadata_);
+
+        // Decrypt back into a caller buffer.
+        DataBatchEncryptionSequencer decrypt_sequencer(
+            column_context, encoding, RequiredDataPageV1Attributes(3), into_sequencer.encryption_metadata_);
+        std::vector<uint8_t> plaintext_buffer;
+        ASSERT_TRUE(decrypt_sequencer.DecryptAndEncodeInto(owned_sequencer.encrypted_result_, [&](size_t size) {
+            plaintext_buffer.resize(size);
+            return tcb::span<uint8_t>(plaintext_buffer);
+        })) << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+        plaintext_buffer.resize(decrypt_sequencer.output_size_);
+        EXPECT_EQ(plaintext_buffer, payload);
+    }
+}
+
+TEST(EncryptionSequencer, Into_BufferTooSmallFails) {
+    auto payload = BuildByteArrayValueBytesForTesting("short");
+    DataBatchEncryptionSequencer sequencer(MakeTestColumnContext("batch_col"), Encoding::PLAIN, DictPageAttributes(1), {});
+
+    std::vector<uint8_t> caller_buffer(2);
+    EXPECT_FALSE(sequencer.DecodeAndEncryptInto(payload, [&](size_t) {
+        return tcb::span<uint8_t>(caller_buffer);
+    }));
+    EXPECT_EQ(sequencer.error_stage_, "output_allocation");
+    EXPECT_EQ(sequencer.output_size_, 0u);
+}
+
+TEST(EncryptionSequencer, Into_SegmentedPayloadMatchesContiguous) {
+    auto column_context = MakeTestColumnContext("batch_col");
+    auto payload = CombineRawBytesIntoValueBytesForTesting(
+        {{'a', 'b'}, {'c'}, {'d', 'e', 'f'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    const tcb::span<const uint8_t> all(payload);
+
+    for (auto encoding : {Encoding::PLAIN, Encoding::RLE_DICTIONARY}) {
+        DataBatchEncryptionSequencer owned_sequencer(
+            column_context, encoding, RequiredDataPageV1Attributes(3), {});
+        ASSERT_TRUE(owned_sequencer.DecodeAndEncrypt(payload));
+
+        // Boundaries inside a length prefix, inside a value, and at the ends.
+        for (size_t split : {size_t{0}, size_t{2}, size_t{5}, payload.size() - 1, payload.size()}) {
+            const std::vector<tcb::span<const uint8_t>> segments = {all.first(split), all.subspan(split)};
+            DataBatchEncryptionSequencer into_sequencer(
+                column_context, encoding, RequiredDataPageV1Attributes(3), {});
+            std::vector<uint8_t> caller_buffer;
+            ASSERT_TRUE(into_sequencer.DecodeAndEncryptInto(SegmentedBytes(segments), [&](size_t size) {
+                caller_buffer.resize(size);
+                return tcb::span<uint8_t>(caller_buffer);
+            })) << into_sequencer.error_stage_ << " - " << into_sequencer.error_message_;
+            caller_buffer.resize(into_sequencer.output_size_);
+            EXPECT_EQ(caller_buffer, owned_sequencer.encrypted_result_) << "split=" << split;
+            EXPECT_EQ(into_sequencer.encryption_metadata_, owned_sequencer.encryption_metadata_);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Streaming mode coverage: chunked framing for both pipelines.
+// -----------------------------------------------------------------------------
+
+TEST(EncryptionSequencer, Streaming_RoundTripForBothPipelines) {
+    constexpr size_t kChunkSize = 8;
+    ColumnEncryptionOptions options;
+    options.streaming_chunk_size = kChunkSize;
+    auto streaming_context = MakeTestColumnContext("streaming_col", CompressionCodec::UNCOMPRESSED, options);
+    std::vector<RawValueBytes> values;
+    for (size_t i = 0; i < 20; ++i) {
+        values.push_back(RawValueBytes(i % 5, static_cast<uint8_t>('a' + i)));
+    }
+    values.push_back(RawValueBytes(3 * kChunkSize, 'z'));  // Larger than a chunk
+    auto payload = CombineRawBytesIntoValueBytesForTesting(values, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    const auto attributes = RequiredDataPageV1Attributes(values.size());
+
+    // PLAIN goes per-value, RLE_DICTIONARY goes per-block.
+    for (auto encoding : {Encoding::PLAIN, Encoding::RLE_DICTIONARY}) {
+        DataBatchEncryptionSequencer encrypt_sequencer(streaming_context, encoding, attributes, {});
+        ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(payload))
+            << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+        const auto& metadata = encrypt_sequencer.encryption_metadata_;
+        EXPECT_EQ(metadata.at("encrypt_framing"), "chunked");
+        EXPECT_EQ(metadata.at("encrypt_mode_data_page"), encoding == Encoding::PLAIN ? "per_value" : "per_block");
+
+        // The per-block chunk stream starts with the chunk count and the payload size.
+        if (encoding == Encoding::RLE_DICTIONARY) {
+            const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+            EXPECT_EQ(read_u32_le(ciphertext.data()), (payload.size() + kChunkSize - 1) / kChunkSize);
+            EXPECT_EQ(read_u32_le(ciphertext.data() + 4), payload.size());
+            auto max_size = encrypt_sequencer.GetMaxCiphertextSize(payload.size());
+            ASSERT_TRUE(max_size.has_value());
+            EXPECT_LE(ciphertext.size(), max_size.value());
+        }
+
+        DataBatchEncryptionSequencer decrypt_sequencer(streaming_context, encoding, attributes, metadata);
+        ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_))
+            << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+        EXPECT_EQ(decrypt_sequencer.decrypted_result_, payload);
+
+        // Decryption follows the metadata, so non-chunked ciphertexts still decrypt on a streaming column.
+        DataBatchEncryptionSequencer legacy_sequencer(MakeTestColumnContext("batch_col"), encoding, attributes, {});
+        ASSERT_TRUE(legacy_sequencer.DecodeAndEncrypt(payload));
+        EXPECT_EQ(legacy_sequencer.encryption_metadata_.count("encrypt_framing"), 0u);
+        DataBatchEncryptionSequencer legacy_decrypt_sequencer(
+            streaming_context, encoding, attributes, legacy_sequencer.encryption_metadata_);
+        ASSERT_TRUE(legacy_decrypt_sequencer.DecryptAndEncode(legacy_sequencer.encrypted_result_));
+        EXPECT_EQ(legacy_decrypt_sequencer.decrypted_result_, payload);
+    }
+}
+
+TEST(EncryptionSequencer, Streaming_SnappyNullablePage_PerValueRoundTrip) {
+    auto value_bytes = CombineRawBytesIntoValueBytesForTesting(
+        {{'a', 'l', 'p', 'h', 'a'}, {'b', 'e', 't', 'a'}, {'g', 'a', 'm', 'm', 'a', '3'}},
+        Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    std::vector<uint8_t> level_bytes;
+    append_u32_le(level_bytes, 2u);
+    level_bytes.push_back(0x06);  // run_len = 3
+    level_bytes.push_back(0x01);  // def level value = 1 (present)
+    auto plaintext = Compress(Join(level_bytes, value_bytes), CompressionCodec::SNAPPY);
+
+    std::map<std::string, std::string> attributes = {
+        {"page_type", "DATA_PAGE_V1"},
+        {"data_page_num_values", "3"},
+        {"data_page_max_definition_level", "1"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v1_repetition_level_encoding", "RLE"},
+        {"page_v1_definition_level_encoding", "RLE"}};
+    ColumnEncryptionOptions options;
+    options.streaming_chunk_size = 4;
+    auto streaming_context = MakeTestColumnContext("streaming_col", CompressionCodec::SNAPPY, options);
+
+    DataBatchEncryptionSequencer encrypt_sequencer(streaming_context, Encoding::PLAIN, attributes, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(plaintext))
+        << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+    EXPECT_EQ(encrypt_sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "per_value");
+    EXPECT_FALSE(encrypt_sequencer.GetMaxCiphertextSize(plaintext.size()).has_value());
+
+    DataBatchEncryptionSequencer decrypt_sequencer(
+        streaming_context, Encoding::PLAIN, attributes, encrypt_sequencer.encryption_metadata_);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, plaintext);
+}
+
+TEST(EncryptionSequencer, Streaming_MalformedCiphertext) {
+    ColumnEncryptionOptions options;
+    options.streaming_chunk_size = 4;
+    auto streaming_context = MakeTestColumnContext("streaming_col", CompressionCodec::UNCOMPRESSED, options);
+    auto payload = BuildByteArrayValueBytesForTesting("streamed dictionary value");
+    DataBatchEncryptionSequencer encrypt_sequencer(
+        streaming_context, Encoding::RLE_DICTIONARY, DictPageAttributes(1), {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(payload));
+    auto metadata = encrypt_sequencer.encryption_metadata_;
+
+    // Truncated chunk streams are rejected.
+    std::vector<uint8_t> truncated(
+        encrypt_sequencer.encrypted_result_.begin(), encrypt_sequencer.encrypted_result_.end() - 1);
+    DataBatchEncryptionSequencer truncated_sequencer(
+        streaming_context, Encoding::RLE_DICTIONARY, DictPageAttributes(1), metadata);
+    EXPECT_THROW(truncated_sequencer.DecryptAndEncode(truncated), InvalidInputException);
+
+    // Unknown framings are rejected.
+    metadata["encrypt_framing"] = "unknown";
+    DataBatchEncryptionSequencer framing_sequencer(
+        streaming_context, Encoding::RLE_DICTIONARY, DictPageAttributes(1), metadata);
+    EXPECT_FALSE(framing_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+    EXPECT_EQ(framing_sequencer.error_stage_, "decrypt_framing_validation");
+}
+
+TEST(EncryptionSequencer, TrustedCiphertext_MatchesCheckedDecryption) {
+    auto value_bytes = CombineRawBytesIntoValueBytesForTesting(
+        {{'a', 'l', 'p', 'h', 'a'}, {}, {'g', 'a', 'm', 'm', 'a', '3'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    std::vector<uint8_t> level_bytes;
+    append_u32_le(level_bytes, 2u);
+    level_bytes.push_back(0x06);  // run_len = 3
+    level_bytes.push_back(0x01);  // def level value = 1 (present)
+    std::map<std::string, std::string> nullable_attributes = {
+        {"page_type", "DATA_PAGE_V1"},
+        {"data_page_num_values", "3"},
+        {"data_page_max_definition_level", "1"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v1_repetition_level_encoding", "RLE"},
+        {"page_v1_definition_level_encoding", "RLE"}};
+
+    for (auto compression : {CompressionCodec::UNCOMPRESSED, CompressionCodec::SNAPPY}) {
+        for (size_t streaming_chunk_size : {size_t{0}, size_t{8}}) {
+            ColumnEncryptionOptions checked_options;
+            checked_options.streaming_chunk_size = streaming_chunk_size;
+            ColumnEncryptionOptions trusted_options = checked_options;
+            trusted_options.trusted_ciphertext = true;
+            auto checked_context = MakeTestColumnContext("trusted_col", compression, checked_options);
+            auto trusted_context = MakeTestColumnContext("trusted_col", compression, trusted_options);
+            EXPECT_FALSE(checked_context->IsCiphertextTrusted());
+            EXPECT_TRUE(trusted_context->IsCiphertextTrusted());
+
+            const std::vector<std::pair<std::vector<uint8_t>, std::map<std::string, std::string>>> pages = {
+                {Compress(value_bytes, compression), DictPageAttributes(3)},
+                {Compress(Join(level_bytes, value_bytes), compression), nullable_attributes}};
+            for (const auto& [plaintext, attributes] : pages) {
+                DataBatchEncryptionSequencer encrypt_sequencer(checked_context, Encoding::PLAIN, attributes, {});
+                ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(plaintext))
+                    << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+                const auto& metadata = encrypt_sequencer.encryption_metadata_;
+                const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+
+                DataBatchEncryptionSequencer checked_sequencer(checked_context, Encoding::PLAIN, attributes, metadata);
+                ASSERT_TRUE(checked_sequencer.DecryptAndEncode(ciphertext))
+                    << checked_sequencer.error_stage_ << " - " << checked_sequencer.error_message_;
+                DataBatchEncryptionSequencer trusted_sequencer(trusted_context, Encoding::PLAIN, attributes, metadata);
+                ASSERT_TRUE(trusted_sequencer.DecryptAndEncode(ciphertext))
+                    << trusted_sequencer.error_stage_ << " - " << trusted_sequencer.error_message_;
+                EXPECT_EQ(trusted_sequencer.decrypted_result_, checked_sequencer.decrypted_result_);
+                EXPECT_EQ(trusted_sequencer.decrypted_result_, plaintext);
+
+                // Lengths that overrun a truncated ciphertext are still rejected.
+                std::vector<uint8_t> truncated(ciphertext.begin(), ciphertext.end() - 1);
+                DataBatchEncryptionSequencer truncated_sequencer(trusted_context, Encoding::PLAIN, attributes, metadata);
+                EXPECT_THROW(truncated_sequencer.DecryptAndEncode(truncated), InvalidInputException);
+            }
+        }
+    }
+}
+
+TEST(EncryptionSequencer, AesEncryptor_RoundTripsPages) {
+    auto value_bytes = CombineRawBytesIntoValueBytesForTesting(
+        {{'a', 'l', 'p', 'h', 'a'}, {}, {'g', 'a', 'm', 'm', 'a', '3'}}, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    std::vector<uint8_t> level_bytes;
+    append_u32_le(level_bytes, 2u);
+    level_bytes.push_back(0x06);  // run_len = 3
+    level_bytes.push_back(0x01);  // def level value = 1 (present)
+    std::map<std::string, std::string> nullable_attributes = {
+        {"page_type", "DATA_PAGE_V1"},
+        {"data_page_num_values", "3"},
+        {"data_page_max_definition_level", "1"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v1_repetition_level_encoding", "RLE"},
+        {"page_v1_definition_level_encoding", "RLE"}};
+    const std::vector<uint8_t> key(32, 0x11);
+
+    for (auto compression : {CompressionCodec::UNCOMPRESSED, CompressionCodec::SNAPPY}) {
+        for (bool trusted : {false, true}) {
+            ColumnEncryptionOptions options;
+            options.trusted_ciphertext = trusted;
+            auto context = MakeTestColumnContext(
+                "aes_col", compression, options,
+                std::make_unique<AesEncryptor>("test_key", "aes_col", "test_user", "{}", Type::BYTE_ARRAY, key));
+
+            const std::vector<std::pair<std::vector<uint8_t>, std::map<std::string, std::string>>> pages = {
+                {Compress(value_bytes, compression), DictPageAttributes(3)},
+                {Compress(Join(level_bytes, value_bytes), compression), nullable_attributes}};
+            for (const auto& [plaintext, attributes] : pages) {
+                DataBatchEncryptionSequencer encrypt_sequencer(context, Encoding::PLAIN, attributes, {});
+                ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(plaintext))
+                    << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+                const auto& metadata = encrypt_sequencer.encryption_metadata_;
+                const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+
+                DataBatchEncryptionSequencer decrypt_sequencer(context, Encoding::PLAIN, attributes, metadata);
+                ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+                    << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+                EXPECT_EQ(decrypt_sequencer.decrypted_result_, plaintext);
+
+                // A modified page fails authentication, trusted or not.
+                auto tampered = ciphertext;
+                tampered[tampered.size() - 1] ^= 0x01;
+                DataBatchEncryptionSequencer tampered_sequencer(context, Encoding::PLAIN, attributes, metadata);
+                EXPECT_THROW(tampered_sequencer.DecryptAndEncode(tampered), InvalidInputException);
+            }
+        }
+    }
+}
+
+TEST(EncryptionSequencer, AdaptiveModePolicy_TagsModePerPage) {
+    // Per-value fits the budget for small pages only, and per-block is cheaper for the others.
+    EncryptionCostModel cost_model;
+    cost_model.SetCost(Type::BYTE_ARRAY, EncryptionMode::PER_VALUE, 0.0, 1.0);
+    cost_model.SetCost(Type::BYTE_ARRAY, EncryptionMode::PER_BLOCK, 0.0, 0.5);
+    ColumnEncryptionOptions options;
+    options.mode_policy = std::make_shared<const EncryptionModePolicy>(cost_model, 64.0);
+    auto adaptive_context = MakeTestColumnContext("adaptive_col", CompressionCodec::UNCOMPRESSED, options);
+
+    const auto small_page = BuildByteArrayValueBytesForTesting("small");
+    const auto large_page = BuildByteArrayValueBytesForTesting(std::string(100, 'x'));
+    for (const auto& [page, expected_tag] : {std::make_pair(small_page, 0x01), std::make_pair(large_page, 0x00)}) {
+        DataBatchEncryptionSequencer encrypt_sequencer(
+            adaptive_context, Encoding::PLAIN, DictPageAttributes(1), {});
+        ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page))
+            << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+        const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+        EXPECT_EQ(encrypt_sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "adaptive");
+        EXPECT_EQ(ciphertext[0], expected_tag);
+        auto max_size = encrypt_sequencer.GetMaxCiphertextSize(page.size());
+        ASSERT_TRUE(max_size.has_value());
+        EXPECT_LE(ciphertext.size(), max_size.value());
+
+        DataBatchEncryptionSequencer decrypt_sequencer(
+            adaptive_context, Encoding::PLAIN, DictPageAttributes(1), encrypt_sequencer.encryption_metadata_);
+        ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+            << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+        EXPECT_EQ(decrypt_sequencer.decrypted_result_, page);
+
+        // Unknown mode tags are rejected.
+        auto bad_tag = ciphertext;
+        bad_tag[0] = 0x7f;
+        DataBatchEncryptionSequencer bad_tag_sequencer(
+            adaptive_context, Encoding::PLAIN, DictPageAttributes(1), encrypt_sequencer.encryption_metadata_);
+        EXPECT_FALSE(bad_tag_sequencer.DecryptAndEncode(bad_tag));
+        EXPECT_EQ(bad_tag_sequencer.error_stage_, "decrypt_encryption_mode_validation");
+    }
+}
+
+TEST(EncryptionSequencer, PerBlockModePolicy) {
+    ColumnEncryptionOptions options;
+    options.mode_policy = std::make_shared<const EncryptionModePolicy>(EncryptionModePolicy::Kind::PER_BLOCK);
+    auto per_block_context = MakeTestColumnContext("per_block_col", CompressionCodec::UNCOMPRESSED, options);
+
+    const auto page = BuildByteArrayValueBytesForTesting("per block value");
+    DataBatchEncryptionSequencer encrypt_sequencer(per_block_context, Encoding::PLAIN, DictPageAttributes(1), {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page));
+    EXPECT_EQ(encrypt_sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "per_block");
+
+    DataBatchEncryptionSequencer decrypt_sequencer(
+        per_block_context, Encoding::PLAIN, DictPageAttributes(1), encrypt_sequencer.encryption_metadata_);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, page);
+}
+
+TEST(EncryptionSequencer, DictionaryIndexPassthrough) {
+    // The XOR encryptor has no block tags, so its pages carry the checksum that must be allowed explicitly.
+    ColumnEncryptionOptions options;
+    options.dictionary_index_passthrough = true;
+    options.insecure_dictionary_index_checksum = true;
+    auto passthrough_context = MakeTestColumnContext("passthrough_col", CompressionCodec::UNCOMPRESSED, options);
+
+    // Bit width and RLE runs of the dictionary indices.
+    const std::vector<uint8_t> index_page = {0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    const auto attributes = RequiredDataPageV1Attributes(6);
+
+    DataBatchEncryptionSequencer encrypt_sequencer(passthrough_context, Encoding::RLE_DICTIONARY, attributes, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(index_page))
+        << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+    const auto& metadata = encrypt_sequencer.encryption_metadata_;
+    EXPECT_EQ(metadata.at("encrypt_mode_data_page"), "dictionary_index_passthrough");
+    const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+    ASSERT_EQ(ciphertext.size(), 8 + index_page.size());
+    EXPECT_TRUE(std::equal(index_page.begin(), index_page.end(), ciphertext.begin() + 8));
+    EXPECT_EQ(encrypt_sequencer.GetMaxCiphertextSize(index_page.size()), ciphertext.size());
+
+    DataBatchEncryptionSequencer decrypt_sequencer(passthrough_context, Encoding::RLE_DICTIONARY, attributes, metadata);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, index_page);
+
+    // Tampered pages and pages checked with another key are rejected.
+    auto tampered = ciphertext;
+    tampered.back() ^= 0x01;
+    DataBatchEncryptionSequencer tampered_sequencer(passthrough_context, Encoding::RLE_DICTIONARY, attributes, metadata);
+    EXPECT_FALSE(tampered_sequencer.DecryptAndEncode(tampered));
+    EXPECT_EQ(tampered_sequencer.error_stage_, "decrypt_integrity_check");
+    auto other_key_context = std::make_shared<const ColumnEncryptionContext>(
+        "passthrough_col", Type::BYTE_ARRAY, std::nullopt, CompressionCodec::UNCOMPRESSED,
+        CompressionCodec::UNCOMPRESSED, "other_key", "test_user", "{}", options);
+    DataBatchEncryptionSequencer other_key_sequencer(other_key_context, Encoding::RLE_DICTIONARY, attributes, metadata);
+    EXPECT_FALSE(other_key_sequencer.DecryptAndEncode(ciphertext));
+    EXPECT_EQ(other_key_sequencer.error_stage_, "decrypt_integrity_check");
+
+    // The dictionary page and non-dictionary data pages are still encrypted.
+    const auto dictionary_page = BuildByteArrayValueBytesForTesting("dictionary value");
+    DataBatchEncryptionSequencer dictionary_sequencer(passthrough_context, Encoding::PLAIN, DictPageAttributes(1), {});
+    ASSERT_TRUE(dictionary_sequencer.DecodeAndEncrypt(dictionary_page));
+    EXPECT_EQ(dictionary_sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "per_value");
+    const auto plain_page = BuildByteArrayValueBytesForTesting("plain value");
+    DataBatchEncryptionSequencer plain_sequencer(passthrough_context, Encoding::PLAIN, RequiredDataPageV1Attributes(1), {});
+    ASSERT_TRUE(plain_sequencer.DecodeAndEncrypt(plain_page));
+    EXPECT_EQ(plain_sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "per_value");
+}
+
+TEST(EncryptionSequencer, DictionaryIndexPassthrough_AesPagesCarryBlockTag) {
+    ColumnEncryptionOptions options;
+    options.dictionary_index_passthrough = true;
+    auto make_context = [&](uint8_t key_byte) {
+        return MakeTestColumnContext(
+            "passthrough_col", CompressionCodec::UNCOMPRESSED, options,
+            std::make_unique<AesEncryptor>("test_key", "passthrough_col", "test_user", "{}", Type::BYTE_ARRAY,
+                                           std::vector<uint8_t>(32, key_byte)));
+    };
+    auto context = make_context(0x44);
+    const std::vector<uint8_t> index_page = {0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    const auto attributes = RequiredDataPageV1Attributes(6);
+
+    DataBatchEncryptionSequencer encrypt_sequencer(context, Encoding::RLE_DICTIONARY, attributes, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(index_page))
+        << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+    const auto& metadata = encrypt_sequencer.encryption_metadata_;
+    const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+    ASSERT_EQ(ciphertext.size(), AesEncryptor::kBlockTagLength + index_page.size());
+    EXPECT_TRUE(std::equal(index_page.begin(), index_page.end(), ciphertext.begin() + AesEncryptor::kBlockTagLength));
+    EXPECT_EQ(encrypt_sequencer.GetMaxCiphertextSize(index_page.size()), ciphertext.size());
+
+    DataBatchEncryptionSequencer decrypt_sequencer(context, Encoding::RLE_DICTIONARY, attributes, metadata);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, index_page);
+
+    // The tag is a MAC: a modified page or tag fails, and so does the same key id with other key material.
+    for (size_t i = 0; i < ciphertext.size(); ++i) {
+        auto tampered = ciphertext;
+        tampered[i] ^= 0x01;
+        DataBatchEncryptionSequencer tampered_sequencer(context, Encoding::RLE_DICTIONARY, attributes, metadata);
+        EXPECT_FALSE(tampered_sequencer.DecryptAndEncode(tampered)) << "byte " << i;
+        EXPECT_EQ(tampered_sequencer.error_stage_, "decrypt_integrity_check");
+    }
+    DataBatchEncryptionSequencer other_key_sequencer(make_context(0x45), Encoding::RLE_DICTIONARY, attributes, metadata);
+    EXPECT_FALSE(other_key_sequencer.DecryptAndEncode(ciphertext));
+    EXPECT_EQ(other_key_sequencer.error_stage_, "decrypt_integrity_check");
+}
+
+TEST(EncryptionSequencer, DictionaryIndexPassthrough_ChecksumRequiresOptIn) {
+    // Without the opt-in, encryptors without block tags cannot write passthrough pages...
+    ColumnEncryptionOptions options;
+    options.dictionary_index_passthrough = true;
+    auto rejected_context = MakeTestColumnContext("passthrough_col", CompressionCodec::UNCOMPRESSED, options);
+    EXPECT_FALSE(rejected_context->IsValid());
+    EXPECT_EQ(rejected_context->GetErrorStage(), "parameter_validation");
+    const std::vector<uint8_t> index_page = {0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    const auto attributes = RequiredDataPageV1Attributes(6);
+    DataBatchEncryptionSequencer rejected_sequencer(rejected_context, Encoding::RLE_DICTIONARY, attributes, {});
+    EXPECT_FALSE(rejected_sequencer.DecodeAndEncrypt(index_page));
+    EXPECT_EQ(rejected_sequencer.error_stage_, "parameter_validation");
+
+    // ...nor read checksum-tagged ones, whatever the writer allowed.
+    options.insecure_dictionary_index_checksum = true;
+    auto insecure_context = MakeTestColumnContext("passthrough_col", CompressionCodec::UNCOMPRESSED, options);
+    DataBatchEncryptionSequencer encrypt_sequencer(insecure_context, Encoding::RLE_DICTIONARY, attributes, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(index_page));
+    DataBatchEncryptionSequencer decrypt_sequencer(
+        MakeTestColumnContext("passthrough_col"), Encoding::RLE_DICTIONARY, attributes,
+        encrypt_sequencer.encryption_metadata_);
+    EXPECT_FALSE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+    EXPECT_EQ(decrypt_sequencer.error_stage_, "decrypt_integrity_check");
+}
+
+TEST(EncryptionSequencer, DictionaryIndexPassthrough_DisabledByDefault) {
+    auto column_context = MakeTestColumnContext("col");
+    const std::vector<uint8_t> index_page = {0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    DataBatchEncryptionSequencer sequencer(
+        column_context, Encoding::RLE_DICTIONARY, RequiredDataPageV1Attributes(6), {});
+    ASSERT_TRUE(sequencer.DecodeAndEncrypt(index_page));
+    EXPECT_EQ(sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "per_block");
+}
+
+TEST(EncryptionSequencer, BufferPool_RecyclesPageBuffers) {
+    ColumnEncryptionOptions options;
+    options.buffer_pool = std::make_shared<BufferPool>(BufferPoolOptions{1});
+    auto pooled_context = MakeTestColumnContext("pooled_col", CompressionCodec::UNCOMPRESSED, options);
+    auto& pool = *options.buffer_pool;
+
+    const auto page = BuildByteArrayValueBytesForTesting(std::string(64, 'p'));
+    std::vector<uint64_t> heap_allocations_per_page;
+    for (int i = 0; i < 3; ++i) {
+        const uint64_t heap_allocations_before = pool.GetStats().heap_allocations;
+        DataBatchEncryptionSequencer encrypt_sequencer(pooled_context, Encoding::PLAIN, DictPageAttributes(1), {});
+        ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page))
+            << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+        EXPECT_EQ(encrypt_sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "per_value");
+
+        DataBatchEncryptionSequencer decrypt_sequencer(
+            pooled_context, Encoding::PLAIN, DictPageAttributes(1), encrypt_sequencer.encryption_metadata_);
+        ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_))
+            << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+        EXPECT_EQ(decrypt_sequencer.decrypted_result_, page);
+
+        // The caller hands the results back once consumed, like the API server does.
+        pool.Release(std::move(encrypt_sequencer.encrypted_result_));
+        pool.Release(std::move(decrypt_sequencer.decrypted_result_));
+        heap_allocations_per_page.push_back(pool.GetStats().heap_allocations - heap_allocations_before);
+    }
+
+    // After the first page, every buffer of the pipeline is recycled.
+    EXPECT_GT(heap_allocations_per_page[0], 0u);
+    EXPECT_EQ(heap_allocations_per_page[1], 0u);
+    EXPECT_EQ(heap_allocations_per_page[2], 0u);
+    EXPECT_GT(pool.GetStats().releases, 0u);
+    EXPECT_EQ(BufferPool::GetDefault(), nullptr);
+}
+
+TEST(EncryptionSequencer, BufferPool_ReleasesBuffersWhenOutputAllocationFails) {
+    const auto page = Compress(BuildByteArrayValueBytesForTesting(std::string(64, 'p')), CompressionCodec::SNAPPY);
+    // Compressed pages are staged in pooled buffers before the output is allocated, chunked or not.
+    for (size_t streaming_chunk_size : {size_t{0}, size_t{8}}) {
+        ColumnEncryptionOptions options;
+        options.streaming_chunk_size = streaming_chunk_size;
+        options.buffer_pool = std::make_shared<BufferPool>(BufferPoolOptions{1});
+        auto pooled_context = MakeTestColumnContext("pooled_col", CompressionCodec::SNAPPY, options);
+        auto& pool = *options.buffer_pool;
+
+        DataBatchEncryptionSequencer encrypt_sequencer(pooled_context, Encoding::PLAIN, DictPageAttributes(1), {});
+        ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page))
+            << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+
+        const auto stats_before = pool.GetStats();
+        std::vector<uint8_t> caller_buffer(2);
+        DataBatchEncryptionSequencer decrypt_sequencer(
+            pooled_context, Encoding::PLAIN, DictPageAttributes(1), encrypt_sequencer.encryption_metadata_);
+        EXPECT_FALSE(decrypt_sequencer.DecryptAndEncodeInto(encrypt_sequencer.encrypted_result_, [&](size_t) {
+            return tcb::span<uint8_t>(caller_buffer);
+        }));
+        EXPECT_EQ(decrypt_sequencer.error_stage_, "output_allocation");
+        const auto stats_after = pool.GetStats();
+        EXPECT_GT(stats_after.acquisitions, stats_before.acquisitions);
+        EXPECT_EQ(stats_after.acquisitions - stats_before.acquisitions, stats_after.releases - stats_before.releases)
+            << "streaming_chunk_size " << streaming_chunk_size;
+    }
+}
+
+namespace {
+    using dbps::processing::ValueDedupMode;
+
+    // BYTE_ARRAY page of num_values status codes cycling over num_distinct values.
+    std::vector<uint8_t> BuildStatusCodesPage(size_t num_values, size_t num_distinct) {
+        std::vector<std::vector<uint8_t>> values;
+        for (size_t i = 0; i < num_values; ++i) {
+            const std::string value = "status_" + std::to_string(i % num_distinct);
+            values.emplace_back(value.begin(), value.end());
+        }
+        return CombineRawBytesIntoValueBytesForTesting(values, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+    }
+}
+
+TEST(EncryptionSequencer, ValueDedup_ScatterMatchesRegularCiphertext) {
+    const auto page = BuildStatusCodesPage(1000, 4);
+    ColumnEncryptionOptions scatter_options;
+    scatter_options.value_dedup.mode = ValueDedupMode::SCATTER;
+    auto regular_context = MakeTestColumnContext("dedup_col");
+    auto scatter_context = MakeTestColumnContext("dedup_col", CompressionCodec::UNCOMPRESSED, scatter_options);
+
+    DataBatchEncryptionSequencer regular_sequencer(regular_context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(regular_sequencer.DecodeAndEncrypt(page));
+    DataBatchEncryptionSequencer scatter_sequencer(scatter_context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(scatter_sequencer.DecodeAndEncrypt(page))
+        << scatter_sequencer.error_stage_ << " - " << scatter_sequencer.error_message_;
+    EXPECT_EQ(scatter_sequencer.encrypted_result_, regular_sequencer.encrypted_result_);
+    EXPECT_EQ(scatter_sequencer.encryption_metadata_, regular_sequencer.encryption_metadata_);
+
+    // AES value ciphertexts depend on their position, so SCATTER leaves AES pages to the regular pipeline.
+    auto aes_context = MakeTestColumnContext(
+        "dedup_col", CompressionCodec::UNCOMPRESSED, scatter_options, MakeTestAesEncryptor("dedup_col"));
+    DataBatchEncryptionSequencer aes_sequencer(aes_context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(aes_sequencer.DecodeAndEncrypt(page));
+    DataBatchEncryptionSequencer aes_decrypt_sequencer(
+        aes_context, Encoding::PLAIN, DictPageAttributes(1000), aes_sequencer.encryption_metadata_);
+    ASSERT_TRUE(aes_decrypt_sequencer.DecryptAndEncode(aes_sequencer.encrypted_result_));
+    EXPECT_EQ(aes_decrypt_sequencer.decrypted_result_, page);
+}
+
+TEST(EncryptionSequencer, ValueDedup_DictionaryLayoutRoundTrip) {
+    std::vector<uint8_t> level_bytes;
+    append_u32_le(level_bytes, 3u);
+    level_bytes.push_back(0xD0);  // run_len = 1000, varint of 1000 << 1
+    level_bytes.push_back(0x0F);
+    level_bytes.push_back(0x01);  // def level value = 1 (present)
+    std::map<std::string, std::string> nullable_attributes = {
+        {"page_type", "DATA_PAGE_V1"},
+        {"data_page_num_values", "1000"},
+        {"data_page_max_definition_level", "1"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v1_repetition_level_encoding", "RLE"},
+        {"page_v1_definition_level_encoding", "RLE"}};
+    const auto value_bytes = BuildStatusCodesPage(1000, 4);
+    ColumnEncryptionOptions dictionary_options;
+    dictionary_options.value_dedup.mode = ValueDedupMode::DICTIONARY;
+
+    for (bool use_aes : {false, true}) {
+        for (auto compression : {CompressionCodec::UNCOMPRESSED, CompressionCodec::SNAPPY}) {
+            auto regular_context = MakeTestColumnContext(
+                "dedup_col", compression, {}, use_aes ? MakeTestAesEncryptor("dedup_col") : nullptr);
+            auto dictionary_context = MakeTestColumnContext(
+                "dedup_col", compression, dictionary_options, use_aes ? MakeTestAesEncryptor("dedup_col") : nullptr);
+            const std::vector<std::pair<std::vector<uint8_t>, std::map<std::string, std::string>>> pages = {
+                {Compress(value_bytes, compression), DictPageAttributes(1000)},
+                {Compress(Join(level_bytes, value_bytes), compression), nullable_attributes}};
+            for (const auto& [plaintext, attributes] : pages) {
+                DataBatchEncryptionSequencer regular_sequencer(regular_context, Encoding::PLAIN, attributes, {});
+                ASSERT_TRUE(regular_sequencer.DecodeAndEncrypt(plaintext));
+                DataBatchEncryptionSequencer encrypt_sequencer(dictionary_context, Encoding::PLAIN, attributes, {});
+                ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(plaintext))
+                    << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+                const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+                const auto& metadata = encrypt_sequencer.encryption_metadata_;
+                EXPECT_EQ(metadata.at("encrypt_value_dedup"), "dictionary");
+                ASSERT_FALSE(ciphertext.empty());
+                EXPECT_EQ(ciphertext[0], 0x01);
+                EXPECT_LT(ciphertext.size(), regular_sequencer.encrypted_result_.size() / 4);
+                if (compression == CompressionCodec::UNCOMPRESSED) {
+                    auto max_size = encrypt_sequencer.GetMaxCiphertextSize(plaintext.size());
+                    ASSERT_TRUE(max_size.has_value());
+                    EXPECT_LE(ciphertext.size(), max_size.value());
+                }
+
+                DataBatchEncryptionSequencer decrypt_sequencer(dictionary_context, Encoding::PLAIN, attributes, metadata);
+                ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+                    << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+                EXPECT_EQ(decrypt_sequencer.decrypted_result_, plaintext);
+
+                // Decryption follows the metadata, not the column settings.
+                DataBatchEncryptionSequencer regular_decrypt_sequencer(regular_context, Encoding::PLAIN, attributes, metadata);
+                ASSERT_TRUE(regular_decrypt_sequencer.DecryptAndEncode(ciphertext));
+                EXPECT_EQ(regular_decrypt_sequencer.decrypted_result_, plaintext);
+            }
+        }
+    }
+}
+
+TEST(EncryptionSequencer, ValueDedup_DictionaryTurnsOffForDistinctValues) {
+    ColumnEncryptionOptions options;
+    options.value_dedup.mode = ValueDedupMode::DICTIONARY;
+    auto context = MakeTestColumnContext("dedup_col", CompressionCodec::UNCOMPRESSED, options);
+    auto regular_context = MakeTestColumnContext("dedup_col");
+    const auto page = BuildStatusCodesPage(1000, 1000);
+
+    DataBatchEncryptionSequencer encrypt_sequencer(context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page));
+    DataBatchEncryptionSequencer regular_sequencer(regular_context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(regular_sequencer.DecodeAndEncrypt(page));
+
+    // The page keeps the regular layout behind its layout tag.
+    const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+    ASSERT_EQ(ciphertext.size(), regular_sequencer.encrypted_result_.size() + 1);
+    EXPECT_EQ(ciphertext[0], 0x00);
+    EXPECT_TRUE(std::equal(ciphertext.begin() + 1, ciphertext.end(), regular_sequencer.encrypted_result_.begin()));
+
+    DataBatchEncryptionSequencer decrypt_sequencer(
+        context, Encoding::PLAIN, DictPageAttributes(1000), encrypt_sequencer.encryption_metadata_);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext));
+    EXPECT_EQ(decrypt_sequencer.decrypted_result_, page);
+}
+
+TEST(EncryptionSequencer, ValueDedup_BatchMixesLayouts) {
+    ColumnEncryptionOptions options;
+    options.value_dedup.mode = ValueDedupMode::DICTIONARY;
+    auto context = MakeTestColumnContext("dedup_col", CompressionCodec::UNCOMPRESSED, options);
+    std::vector<std::vector<uint8_t>> payloads = {
+        BuildStatusCodesPage(500, 3), BuildStatusCodesPage(500, 500), BuildStatusCodesPage(2000, 2)};
+    std::vector<SequencerBatchPage> pages;
+    for (const auto& payload : payloads) {
+        pages.push_back({payload, Encoding::PLAIN, RequiredDataPageV1Attributes(payload == payloads[2] ? 2000 : 500)});
+    }
+
+    DataBatchEncryptionSequencer encrypt_sequencer(context, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncryptBatch(pages));
+    const auto& batch_result = encrypt_sequencer.batch_result_;
+    EXPECT_EQ(batch_result.GetPage(0)[0], 0x01);
+    EXPECT_EQ(batch_result.GetPage(1)[0], 0x00);
+    EXPECT_EQ(batch_result.GetPage(2)[0], 0x01);
+    for (const auto& page_metadata : batch_result.page_encryption_metadata) {
+        EXPECT_EQ(page_metadata, batch_result.page_encryption_metadata[0]);
+    }
+
+    std::vector<SequencerBatchPage> encrypted_pages;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        encrypted_pages.push_back({batch_result.GetPage(i), pages[i].encoding, pages[i].encoding_attributes});
+    }
+    DataBatchEncryptionSequencer decrypt_sequencer(context, batch_result.page_encryption_metadata[0]);
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncodeBatch(encrypted_pages))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto decrypted_page = decrypt_sequencer.batch_result_.GetPage(i);
+        EXPECT_EQ(std::vector<uint8_t>(decrypted_page.begin(), decrypted_page.end()), payloads[i]);
+    }
+}
+
+TEST(EncryptionSequencer, ValueDedup_MalformedDictionaryCiphertext) {
+    ColumnEncryptionOptions options;
+    options.value_dedup.mode = ValueDedupMode::DICTIONARY;
+    auto context = MakeTestColumnContext("dedup_col", CompressionCodec::UNCOMPRESSED, options);
+    const auto page = BuildStatusCodesPage(1000, 4);
+    DataBatchEncryptionSequencer encrypt_sequencer(context, Encoding::PLAIN, DictPageAttributes(1000), {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(page));
+    const auto& metadata = encrypt_sequencer.encryption_metadata_;
+
+    auto bad_tag = encrypt_sequencer.encrypted_result_;
+    bad_tag[0] = 0x07;
+    DataBatchEncryptionSequencer bad_tag_sequencer(context, Encoding::PLAIN, DictPageAttributes(1000), metadata);
+    EXPECT_FALSE(bad_tag_sequencer.DecryptAndEncode(bad_tag));
+    EXPECT_EQ(bad_tag_sequencer.error_stage_, "decrypt_value_dedup_validation");
+
+    auto bad_metadata = metadata;
+    bad_metadata["encrypt_value_dedup"] = "bitmap";
+    DataBatchEncryptionSequencer bad_metadata_sequencer(context, Encoding::PLAIN, DictPageAttributes(1000), bad_metadata);
+    EXPECT_FALSE(bad_metadata_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+    EXPECT_EQ(bad_metadata_sequencer.error_stage_, "decrypt_value_dedup_validation");
+
+    std::vector<uint8_t> truncated(encrypt_sequencer.encrypted_result_.begin(), encrypt_sequencer.encrypted_result_.end() - 1);
+    DataBatchEncryptionSequencer truncated_sequencer(context, Encoding::PLAIN, DictPageAttributes(1000), metadata);
+    EXPECT_THROW(truncated_sequencer.DecryptAndEncode(truncated), InvalidInputException);
+
+    // An index block whose value count does not match the page is rejected before expansion.
+    for (size_t num_values : {size_t{999}, size_t{1001}}) {
+        DataBatchEncryptionSequencer mismatch_sequencer(context, Encoding::PLAIN, DictPageAttributes(num_values), metadata);
+        EXPECT_FALSE(mismatch_sequencer.DecryptAndEncode(encrypt_sequencer.encrypted_result_));
+        EXPECT_EQ(mismatch_sequencer.error_stage_, "decrypt_value_dedup_validation");
+        EXPECT_NE(mismatch_sequencer.error_message_.find("holds 1000 values, the page expects"), std::string::npos)
+            << mismatch_sequencer.error_message_;
+    }
+}
+
+TEST(EncryptionSequencer, ColumnarValueLists_RoundTrip) {
+    std::vector<uint8_t> level_bytes;
+    append_u32_le(level_bytes, 3u);
+    level_bytes.push_back(0xD0);  // run_len = 1000, varint of 1000 << 1
+    level_bytes.push_back(0x0F);
+    level_bytes.push_back(0x01);  // def level value = 1 (present)
+    std::map<std::string, std::string> nullable_attributes = {
+        {"page_type", "DATA_PAGE_V1"},
+        {"data_page_num_values", "1000"},
+        {"data_page_max_definition_level", "1"},
+        {"data_page_max_repetition_level", "0"},
+        {"page_v1_repetition_level_encoding", "RLE"},
+        {"page_v1_definition_level_encoding", "RLE"}};
+    const auto value_bytes = BuildStatusCodesPage(1000, 1000);
+
+    for (bool use_aes : {false, true}) {
+        for (auto compression : {CompressionCodec::UNCOMPRESSED, CompressionCodec::SNAPPY}) {
+            for (bool trusted : {false, true}) {
+                ColumnEncryptionOptions row_options;
+                row_options.trusted_ciphertext = trusted;
+                ColumnEncryptionOptions columnar_options = row_options;
+                columnar_options.columnar_value_lists = true;
+                auto row_context = MakeTestColumnContext(
+                    "columnar_col", compression, row_options, use_aes ? MakeTestAesEncryptor("columnar_col") : nullptr);
+                auto columnar_context = MakeTestColumnContext(
+                    "columnar_col", compression, columnar_options,
+                    use_aes ? MakeTestAesEncryptor("columnar_col") : nullptr);
+                EXPECT_FALSE(row_context->IsColumnarValueListEnabled());
+                EXPECT_TRUE(columnar_context->IsColumnarValueListEnabled());
+                const std::vector<std::pair<std::vector<uint8_t>, std::map<std::string, std::string>>> pages = {
+                    {Compress(value_bytes, compression), DictPageAttributes(1000)},
+                    {Compress(Join(level_bytes, value_bytes), compression), nullable_attributes}};
+                for (const auto& [plaintext, attributes] : pages) {
+                    DataBatchEncryptionSequencer row_sequencer(row_context, Encoding::PLAIN, attributes, {});
+                    ASSERT_TRUE(row_sequencer.DecodeAndEncrypt(plaintext));
+                    EXPECT_EQ(row_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.01");
+
+                    DataBatchEncryptionSequencer encrypt_sequencer(columnar_context, Encoding::PLAIN, attributes, {});
+                    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncrypt(plaintext))
+                        << encrypt_sequencer.error_stage_ << " - " << encrypt_sequencer.error_message_;
+                    const auto& ciphertext = encrypt_sequencer.encrypted_result_;
+                    const auto& metadata = encrypt_sequencer.encryption_metadata_;
+                    EXPECT_EQ(metadata.at("dbps_agent_version"), "v0.02");
+                    // Short values save three of their four length bytes each.
+                    EXPECT_EQ(ciphertext.size() + 3 * 1000 - 1, row_sequencer.encrypted_result_.size());
+                    if (compression == CompressionCodec::UNCOMPRESSED) {
+                        auto max_size = encrypt_sequencer.GetMaxCiphertextSize(plaintext.size());
+                        ASSERT_TRUE(max_size.has_value());
+                        EXPECT_LE(ciphertext.size(), max_size.value());
+                    }
+
+                    DataBatchEncryptionSequencer decrypt_sequencer(columnar_context, Encoding::PLAIN, attributes, metadata);
+                    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncode(ciphertext))
+                        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+                    EXPECT_EQ(decrypt_sequencer.decrypted_result_, plaintext);
+
+                    // Decryption follows the ciphertext header, not the column settings.
+                    DataBatchEncryptionSequencer row_decrypt_sequencer(row_context, Encoding::PLAIN, attributes, metadata);
+                    ASSERT_TRUE(row_decrypt_sequencer.DecryptAndEncode(ciphertext));
+                    EXPECT_EQ(row_decrypt_sequencer.decrypted_result_, plaintext);
+
+                    std::vector<uint8_t> truncated(ciphertext.begin(), ciphertext.end() - 1);
+                    DataBatchEncryptionSequencer truncated_sequencer(columnar_context, Encoding::PLAIN, attributes, metadata);
+                    EXPECT_THROW(truncated_sequencer.DecryptAndEncode(truncated), InvalidInputException);
+                }
+            }
+        }
+    }
+}
+
+TEST(EncryptionSequencer, ColumnarValueLists_StreamingAndDictionaryDedup) {
+    const auto page = BuildStatusCodesPage(1000, 4);
+    const auto attributes = RequiredDataPageV1Attributes(1000);
+
+    // Chunk streams carry columnar value lists in their frames.
+    ColumnEncryptionOptions streaming_options;
+    streaming_options.streaming_chunk_size = 64;
+    streaming_options.columnar_value_lists = true;
+    auto streaming_context = MakeTestColumnContext("columnar_col", CompressionCodec::UNCOMPRESSED, streaming_options);
+    DataBatchEncryptionSequencer streaming_sequencer(streaming_context, Encoding::PLAIN, attributes, {});
+    ASSERT_TRUE(streaming_sequencer.DecodeAndEncrypt(page))
+        << streaming_sequencer.error_stage_ << " - " << streaming_sequencer.error_message_;
+    EXPECT_EQ(streaming_sequencer.encryption_metadata_.at("encrypt_framing"), "chunked");
+    EXPECT_EQ(streaming_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.02");
+    DataBatchEncryptionSequencer streaming_decrypt_sequencer(
+        streaming_context, Encoding::PLAIN, attributes, streaming_sequencer.encryption_metadata_);
+    ASSERT_TRUE(streaming_decrypt_sequencer.DecryptAndEncode(streaming_sequencer.encrypted_result_))
+        << streaming_decrypt_sequencer.error_stage_ << " - " << streaming_decrypt_sequencer.error_message_;
+    EXPECT_EQ(streaming_decrypt_sequencer.decrypted_result_, page);
+
+    // The distinct values of a deduplicated page use the columnar layout too.
+    ColumnEncryptionOptions options;
+    options.value_dedup.mode = ValueDedupMode::DICTIONARY;
+    options.columnar_value_lists = true;
+    auto dedup_context = MakeTestColumnContext("columnar_col", CompressionCodec::UNCOMPRESSED, options);
+    DataBatchEncryptionSequencer dedup_sequencer(dedup_context, Encoding::PLAIN, attributes, {});
+    ASSERT_TRUE(dedup_sequencer.DecodeAndEncrypt(page))
+        << dedup_sequencer.error_stage_ << " - " << dedup_sequencer.error_message_;
+    EXPECT_EQ(dedup_sequencer.encryption_metadata_.at("encrypt_value_dedup"), "dictionary");
+    EXPECT_EQ(dedup_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.02");
+    DataBatchEncryptionSequencer dedup_decrypt_sequencer(
+        dedup_context, Encoding::PLAIN, attributes, dedup_sequencer.encryption_metadata_);
+    ASSERT_TRUE(dedup_decrypt_sequencer.DecryptAndEncode(dedup_sequencer.encrypted_result_))
+        << dedup_decrypt_sequencer.error_stage_ << " - " << dedup_decrypt_sequencer.error_message_;
+    EXPECT_EQ(dedup_decrypt_sequencer.decrypted_result_, page);
+
+    // Versions past the columnar layout are still rejected.
+    auto metadata = streaming_sequencer.encryption_metadata_;
+    metadata["dbps_agent_version"] = "v0.03";
+    DataBatchEncryptionSequencer future_sequencer(streaming_context, Encoding::PLAIN, attributes, metadata);
+    EXPECT_FALSE(future_sequencer.DecryptAndEncode(streaming_sequencer.encrypted_result_));
+}
+
+TEST(EncryptionSequencer, ColumnarValueLists_VersionOnlyOnColumnarPages) {
+    // Per-block pages of a BYTE_ARRAY column are unchanged and keep the earlier version.
+    ColumnEncryptionOptions columnar_options;
+    columnar_options.columnar_value_lists = true;
+    auto row_context = MakeTestColumnContext("columnar_col");
+    auto columnar_context = MakeTestColumnContext("columnar_col", CompressionCodec::UNCOMPRESSED, columnar_options);
+    const auto index_page = std::vector<uint8_t>{0x02, 0x06, 0x01, 0x03, 0x02, 0x00};
+    const auto index_attributes = RequiredDataPageV1Attributes(6);
+    DataBatchEncryptionSequencer row_block_sequencer(row_context, Encoding::RLE_DICTIONARY, index_attributes, {});
+    ASSERT_TRUE(row_block_sequencer.DecodeAndEncrypt(index_page));
+    DataBatchEncryptionSequencer block_sequencer(columnar_context, Encoding::RLE_DICTIONARY, index_attributes, {});
+    ASSERT_TRUE(block_sequencer.DecodeAndEncrypt(index_page));
+    EXPECT_EQ(block_sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "per_block");
+    EXPECT_EQ(block_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.01");
+    EXPECT_EQ(block_sequencer.encrypted_result_, row_block_sequencer.encrypted_result_);
+
+    // So are dictionary index passthrough pages.
+    ColumnEncryptionOptions passthrough_options;
+    passthrough_options.dictionary_index_passthrough = true;
+    passthrough_options.columnar_value_lists = true;
+    auto passthrough_context = MakeTestColumnContext(
+        "columnar_col", CompressionCodec::UNCOMPRESSED, passthrough_options, MakeTestAesEncryptor("columnar_col"));
+    DataBatchEncryptionSequencer passthrough_sequencer(passthrough_context, Encoding::RLE_DICTIONARY, index_attributes, {});
+    ASSERT_TRUE(passthrough_sequencer.DecodeAndEncrypt(index_page));
+    EXPECT_EQ(passthrough_sequencer.encryption_metadata_.at("encrypt_mode_data_page"), "dictionary_index_passthrough");
+    EXPECT_EQ(passthrough_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.01");
+
+    // Fixed-size values have no columnar layout.
+    std::vector<uint8_t> int64_page;
+    for (int64_t i = 0; i < 100; ++i) {
+        append_i64_le(int64_page, i * 7919);
+    }
+    ColumnEncryptionOptions int64_options;
+    int64_options.columnar_value_lists = true;
+    auto int64_context = std::make_shared<const ColumnEncryptionContext>(
+        "int64_col", Type::INT64, std::nullopt, CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}", int64_options);
+    auto int64_row_context = std::make_shared<const ColumnEncryptionContext>(
+        "int64_col", Type::INT64, std::nullopt, CompressionCodec::UNCOMPRESSED, CompressionCodec::UNCOMPRESSED,
+        "test_key", "test_user", "{}");
+    DataBatchEncryptionSequencer int64_sequencer(int64_context, Encoding::PLAIN, DictPageAttributes(100), {});
+    ASSERT_TRUE(int64_sequencer.DecodeAndEncrypt(int64_page));
+    DataBatchEncryptionSequencer int64_row_sequencer(int64_row_context, Encoding::PLAIN, DictPageAttributes(100), {});
+    ASSERT_TRUE(int64_row_sequencer.DecodeAndEncrypt(int64_page));
+    EXPECT_EQ(int64_sequencer.encryption_metadata_.at("encrypt_mode_dict_page"), "per_value");
+    EXPECT_EQ(int64_sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.01");
+    EXPECT_EQ(int64_sequencer.encrypted_result_, int64_row_sequencer.encrypted_result_);
+
+    // Per-value pages of the same BYTE_ARRAY column hold a columnar value list.
+    const auto value_page = BuildStatusCodesPage(10, 10);
+    DataBatchEncryptionSequencer sequencer(columnar_context, Encoding::PLAIN, DictPageAttributes(10), {});
+    ASSERT_TRUE(sequencer.DecodeAndEncrypt(value_page));
+    EXPECT_EQ(sequencer.encryption_metadata_.at("dbps_agent_version"), "v0.02");
+}
+
+TEST(EncryptionSequencer, ColumnarValueLists_BatchDecryptsWithPerPageMetadata) {
+    ColumnEncryptionOptions columnar_options;
+    columnar_options.columnar_value_lists = true;
+    auto context = MakeTestColumnContext("columnar_col", CompressionCodec::UNCOMPRESSED, columnar_options);
+    std::vector<std::vector<uint8_t>> payloads = {
+        BuildStatusCodesPage(10, 10),
+        std::vector<uint8_t>{0x02, 0x06, 0x01, 0x03, 0x02, 0x00},
+        BuildStatusCodesPage(20, 5)};
+    std::vector<SequencerBatchPage> pages = {
+        {payloads[0], Encoding::PLAIN, DictPageAttributes(10)},
+        {payloads[1], Encoding::RLE_DICTIONARY, RequiredDataPageV1Attributes(6)},
+        {payloads[2], Encoding::PLAIN, RequiredDataPageV1Attributes(20)}};
+
+    DataBatchEncryptionSequencer encrypt_sequencer(context, {});
+    ASSERT_TRUE(encrypt_sequencer.DecodeAndEncryptBatch(pages));
+    const auto& page_metadata = encrypt_sequencer.batch_result_.page_encryption_metadata;
+    ASSERT_EQ(page_metadata.size(), pages.size());
+    EXPECT_EQ(page_metadata[0].at("dbps_agent_version"), "v0.02");
+    EXPECT_EQ(page_metadata[1].at("dbps_agent_version"), "v0.01");
+    EXPECT_EQ(page_metadata[1].at("encrypt_mode_data_page"), "per_block");
+    EXPECT_EQ(page_metadata[2].at("dbps_agent_version"), "v0.02");
+
+    // Each page is decrypted with its own metadata; the sequencer itself has none.
+    std::vector<SequencerBatchPage> encrypted_pages;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        encrypted_pages.push_back({encrypt_sequencer.batch_result_.GetPage(i), pages[i].encoding,
+                                   pages[i].encoding_attributes, page_metadata[i]});
+    }
+    DataBatchEncryptionSequencer decrypt_sequencer(context, {});
+    ASSERT_TRUE(decrypt_sequencer.DecryptAndEncodeBatch(encrypted_pages))
+        << decrypt_sequencer.error_stage_ << " - " << decrypt_sequencer.error_message_;
+    ASSERT_EQ(decrypt_sequencer.batch_result_.GetNumPages(), pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto decrypted_page = decrypt_sequencer.batch_result_.GetPage(i);
+        EXPECT_EQ(std::vector<uint8_t>(decrypted_page.begin(), decrypted_page.end()), payloads[i]) << "page " << i;
+    }
+
+    // A columnar page whose metadata claims the earlier version is rejected before decryption.
+    encrypted_pages[2].encryption_metadata = page_metadata[1];
+    encrypted_pages[2].encryption_metadata["encrypt_mode_data_page"] = page_metadata[2].at("encrypt_mode_data_page");
+    DataBatchEncryptionSequencer mislabelled_sequencer(context, {});
+    EXPECT_FALSE(mislabelled_sequencer.DecryptAndEncodeBatch(encrypted_pages));
+    EXPECT_EQ(mislabelled_sequencer.error_stage_, "decrypt_version_check");
+    EXPECT_EQ(mislabelled_sequencer.batch_result_.GetNumPages(), 0u);
+}
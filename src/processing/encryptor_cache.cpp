@@ -0,0 +1,175 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "encryptor_cache.h"
+
+#include <algorithm>
+
+bool EncryptorCacheKey::operator==(const EncryptorCacheKey& other) const {
+    return datatype == other.datatype && key_id == other.key_id && column_name == other.column_name &&
+           user_id == other.user_id && application_context == other.application_context;
+}
+
+size_t EncryptorCacheKeyHash::operator()(const EncryptorCacheKey& key) const {
+    std::hash<std::string> string_hash;
+    size_t hash = std::hash<int>{}(static_cast<int>(key.datatype));
+    for (const std::string* part : {&key.key_id, &key.column_name, &key.user_id, &key.application_context}) {
+        hash ^= string_hash(*part) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+EncryptorCache::EncryptorCache(EncryptorCacheOptions options)
+    : options_(std::move(options)),
+      shard_capacity_(options_.capacity == 0
+          ? 0
+          : (options_.capacity + std::max<size_t>(options_.num_shards, 1) - 1) /
+                std::max<size_t>(options_.num_shards, 1)) {
+    const size_t num_shards = std::max<size_t>(options_.num_shards, 1);
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+EncryptorCache::Shard& EncryptorCache::GetShard(const EncryptorCacheKey& key) {
+    // The shard index uses the high bits, so it does not correlate with the bucket of the key within the shard.
+    const size_t hash = EncryptorCacheKeyHash{}(key);
+    return *shards_[(hash >> (sizeof(size_t) * 4)) % shards_.size()];
+}
+
+std::chrono::steady_clock::time_point EncryptorCache::Now() const {
+    return options_.clock ? options_.clock() : std::chrono::steady_clock::now();
+}
+
+bool EncryptorCache::IsExpired(const Entry& entry, std::chrono::steady_clock::time_point now) const {
+    return options_.ttl.count() > 0 && now - entry.created_at >= options_.ttl;
+}
+
+std::shared_ptr<DBPSEncryptor> EncryptorCache::GetOrCreate(const EncryptorCacheKey& key, const Factory& factory) {
+    Shard& shard = GetShard(key);
+    uint64_t invalidation_generation = 0;
+    if (shard_capacity_ > 0) {
+        const auto now = Now();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        invalidation_generation = shard.invalidation_generation;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            if (!IsExpired(*it->second, now)) {
+                shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return it->second->encryptor;
+            }
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+            expirations_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    // Created without holding the lock: encryptor construction may look up key material.
+    std::shared_ptr<DBPSEncryptor> encryptor = factory();
+    if (shard_capacity_ == 0 || !encryptor || !encryptor->IsThreadSafe()) {
+        return encryptor;
+    }
+
+    const auto now = Now();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.invalidation_generation != invalidation_generation) {
+        // Invalidated while the factory ran: the encryptor may use the dropped key material.
+        return encryptor;
+    }
+    auto it = shard.index.find(key);
+    if (it != shard.index.end() && !IsExpired(*it->second, now)) {
+        // Another caller inserted the key meanwhile. Keep a single instance.
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->encryptor;
+    }
+    if (it != shard.index.end()) {
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+        expirations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.entries.push_front(Entry{key, encryptor, now});
+    shard.index.emplace(key, shard.entries.begin());
+    while (shard.entries.size() > shard_capacity_) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return encryptor;
+}
+
+bool EncryptorCache::Invalidate(const EncryptorCacheKey& key) {
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.invalidation_generation;
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        return false;
+    }
+    shard.entries.erase(it->second);
+    shard.index.erase(it);
+    invalidations_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t EncryptorCache::InvalidateKeyId(const std::string& key_id) {
+    size_t num_dropped = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        ++shard->invalidation_generation;
+        for (auto it = shard->entries.begin(); it != shard->entries.end();) {
+            if (it->key.key_id == key_id) {
+                shard->index.erase(it->key);
+                it = shard->entries.erase(it);
+                ++num_dropped;
+            } else {
+                ++it;
+            }
+        }
+    }
+    invalidations_.fetch_add(num_dropped, std::memory_order_relaxed);
+    return num_dropped;
+}
+
+void EncryptorCache::Clear() {
+    size_t num_dropped = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        ++shard->invalidation_generation;
+        num_dropped += shard->entries.size();
+        shard->index.clear();
+        shard->entries.clear();
+    }
+    invalidations_.fetch_add(num_dropped, std::memory_order_relaxed);
+}
+
+EncryptorCacheStats EncryptorCache::GetStats() const {
+    EncryptorCacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.expirations = expirations_.load(std::memory_order_relaxed);
+    stats.invalidations = invalidations_.load(std::memory_order_relaxed);
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.size += shard->entries.size();
+    }
+    return stats;
+}
@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "enums.h"
+#include "encryptors/dbps_encryptor.h"
+
+#ifndef DBPS_EXPORT
+#define DBPS_EXPORT
+#endif
+
+using namespace dbps::external;
+
+/**
+ * Identity of an encryptor instance: the context parameters it is constructed with.
+ */
+struct EncryptorCacheKey {
+    std::string key_id;
+    std::string column_name;
+    std::string user_id;
+    std::string application_context;
+    Type::type datatype;
+
+    bool operator==(const EncryptorCacheKey& other) const;
+};
+
+struct EncryptorCacheKeyHash {
+    size_t operator()(const EncryptorCacheKey& key) const;
+};
+
+/**
+ * Settings of an EncryptorCache.
+ */
+struct EncryptorCacheOptions {
+    // Maximum number of cached encryptors, split evenly across the shards. 0 disables caching.
+    size_t capacity = 1024;
+
+    // Number of independently locked shards. Requests for different keys mostly take different locks.
+    size_t num_shards = 16;
+
+    // Time after creation at which a cached encryptor is dropped, e.g. to pick up rotated key material.
+    // 0 keeps encryptors until they are evicted or invalidated.
+    std::chrono::milliseconds ttl{0};
+
+    // Time source for the TTL. Null uses std::chrono::steady_clock.
+    std::function<std::chrono::steady_clock::time_point()> clock;
+};
+
+/**
+ * Cache counters. Every GetOrCreate call counts one hit or one miss.
+ */
+struct EncryptorCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Entries dropped to make room for new ones (least recently used first).
+    uint64_t evictions = 0;
+    // Entries dropped on lookup because their TTL had passed.
+    uint64_t expirations = 0;
+    // Entries dropped by Invalidate/InvalidateKeyId/Clear.
+    uint64_t invalidations = 0;
+    size_t size = 0;
+};
+
+/**
+ * Sharded, thread-safe LRU cache of ready-to-use encryptor instances.
+ *
+ * Creating an encryptor may involve a key lookup and a key schedule expansion, so servers that build a
+ * ColumnEncryptionContext per request share one cache across requests (see ColumnEncryptionOptions): each
+ * context then gets the cached instance for its key, column, user, application context and datatype.
+ *
+ * Cached instances serve concurrent requests, so only encryptors whose IsThreadSafe() is true are cached.
+ * Others are returned to the caller without being kept, and each call creates a new one.
+ *
+ * The factory runs without holding a shard lock. Concurrent misses on the same key may both create an
+ * encryptor; the first one inserted is kept and returned to both callers. An encryptor whose shard was
+ * invalidated while the factory ran is returned to its caller but not cached, as it may have been built from
+ * the key material the invalidation was meant to drop.
+ */
+class DBPS_EXPORT EncryptorCache {
+public:
+    using Factory = std::function<std::unique_ptr<DBPSEncryptor>()>;
+
+    explicit EncryptorCache(EncryptorCacheOptions options = {});
+
+    EncryptorCache(const EncryptorCache&) = delete;
+    EncryptorCache& operator=(const EncryptorCache&) = delete;
+
+    // Returns the cached encryptor of key, or creates one with factory and caches it.
+    std::shared_ptr<DBPSEncryptor> GetOrCreate(const EncryptorCacheKey& key, const Factory& factory);
+
+    // Drops the encryptor of key. Returns true if one was cached. Instances in use stay valid.
+    bool Invalidate(const EncryptorCacheKey& key);
+
+    // Drops every encryptor of a key_id, e.g. after the key was rotated or revoked. Returns the number dropped.
+    size_t InvalidateKeyId(const std::string& key_id);
+
+    // Drops every encryptor.
+    void Clear();
+
+    EncryptorCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        EncryptorCacheKey key;
+        std::shared_ptr<DBPSEncryptor> encryptor;
+        std::chrono::steady_clock::time_point created_at;
+    };
+
+    // Entries in recency order (most recently used first), indexed by key.
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<EncryptorCacheKey, std::list<Entry>::iterator, EncryptorCacheKeyHash> index;
+        // Bumped by every invalidation of the shard, so misses that started before it do not insert.
+        uint64_t invalidation_generation = 0;
+    };
+
+    const EncryptorCacheOptions options_;
+    const size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> expirations_{0};
+    std::atomic<uint64_t> invalidations_{0};
+
+    Shard& GetShard(const EncryptorCacheKey& key);
+    std::chrono::steady_clock::time_point Now() const;
+    bool IsExpired(const Entry& entry, std::chrono::steady_clock::time_point now) const;
+};
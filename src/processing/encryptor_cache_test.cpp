@@ -0,0 +1,272 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "encryptor_cache.h"
+#include "encryptors/basic_xor_encryptor.h"
+#include "../common/enums.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dbps::external;
+
+namespace {
+    EncryptorCacheKey MakeKey(const std::string& key_id, const std::string& column_name = "col") {
+        return {key_id, column_name, "user", "{}", Type::INT32};
+    }
+
+    // Factory of BasicXorEncryptor instances that counts its calls.
+    struct CountingFactory {
+        std::shared_ptr<std::atomic<size_t>> calls = std::make_shared<std::atomic<size_t>>(0);
+
+        EncryptorCache::Factory For(const EncryptorCacheKey& key) const {
+            auto counter = calls;
+            return [counter, key]() -> std::unique_ptr<DBPSEncryptor> {
+                counter->fetch_add(1);
+                return std::make_unique<BasicXorEncryptor>(
+                    key.key_id, key.column_name, key.user_id, key.application_context, key.datatype);
+            };
+        }
+    };
+
+    class NotThreadSafeEncryptor : public BasicXorEncryptor {
+    public:
+        NotThreadSafeEncryptor() : BasicXorEncryptor("key", "col", "user", "{}", Type::INT32) {}
+        bool IsThreadSafe() const override { return false; }
+    };
+}
+
+TEST(EncryptorCache, SameKey_ReturnsCachedInstance) {
+    EncryptorCache cache;
+    CountingFactory factory;
+    auto key = MakeKey("key1");
+
+    auto first = cache.GetOrCreate(key, factory.For(key));
+    auto second = cache.GetOrCreate(key, factory.For(key));
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(factory.calls->load(), 1u);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(EncryptorCache, EveryKeyField_SelectsItsOwnInstance) {
+    EncryptorCache cache;
+    CountingFactory factory;
+    const EncryptorCacheKey base = MakeKey("key1");
+    std::vector<EncryptorCacheKey> keys(5, base);
+    keys[1].key_id = "key2";
+    keys[2].column_name = "other_col";
+    keys[3].user_id = "other_user";
+    keys[4].application_context = R"({"other": true})";
+    auto other_datatype = base;
+    other_datatype.datatype = Type::INT64;
+    keys.push_back(other_datatype);
+
+    std::set<DBPSEncryptor*> instances;
+    for (const auto& key : keys) {
+        instances.insert(cache.GetOrCreate(key, factory.For(key)).get());
+    }
+    EXPECT_EQ(instances.size(), keys.size());
+    EXPECT_EQ(cache.GetStats().misses, keys.size());
+}
+
+TEST(EncryptorCache, EvictsLeastRecentlyUsed) {
+    EncryptorCacheOptions options;
+    options.capacity = 2;
+    options.num_shards = 1;
+    EncryptorCache cache(options);
+    CountingFactory factory;
+    auto key1 = MakeKey("key1");
+    auto key2 = MakeKey("key2");
+    auto key3 = MakeKey("key3");
+
+    auto encryptor1 = cache.GetOrCreate(key1, factory.For(key1));
+    cache.GetOrCreate(key2, factory.For(key2));
+    // key1 becomes the most recently used, so key2 is evicted by key3.
+    EXPECT_EQ(cache.GetOrCreate(key1, factory.For(key1)), encryptor1);
+    cache.GetOrCreate(key3, factory.For(key3));
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(cache.GetOrCreate(key1, factory.For(key1)), encryptor1);
+    EXPECT_EQ(factory.calls->load(), 3u);
+    cache.GetOrCreate(key2, factory.For(key2));
+    EXPECT_EQ(factory.calls->load(), 4u);
+}
+
+TEST(EncryptorCache, Ttl_ExpiresEntries) {
+    auto now = std::make_shared<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::time_point{});
+    EncryptorCacheOptions options;
+    options.ttl = std::chrono::seconds(10);
+    options.clock = [now]() { return *now; };
+    EncryptorCache cache(options);
+    CountingFactory factory;
+    auto key = MakeKey("key1");
+
+    auto first = cache.GetOrCreate(key, factory.For(key));
+    *now += std::chrono::seconds(9);
+    EXPECT_EQ(cache.GetOrCreate(key, factory.For(key)), first);
+
+    // The TTL counts from creation, not from the last use.
+    *now += std::chrono::seconds(1);
+    auto second = cache.GetOrCreate(key, factory.For(key));
+    EXPECT_NE(second, first);
+    EXPECT_EQ(factory.calls->load(), 2u);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.expirations, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(EncryptorCache, Invalidate_DropsEntries) {
+    EncryptorCache cache;
+    CountingFactory factory;
+    auto key1 = MakeKey("key1", "col_a");
+    auto key1_other_column = MakeKey("key1", "col_b");
+    auto key2 = MakeKey("key2");
+    for (const auto& key : {key1, key1_other_column, key2}) {
+        cache.GetOrCreate(key, factory.For(key));
+    }
+
+    auto in_use = cache.GetOrCreate(key2, factory.For(key2));
+    EXPECT_TRUE(cache.Invalidate(key2));
+    EXPECT_FALSE(cache.Invalidate(key2));
+    // Instances already handed out stay usable.
+    std::vector<uint8_t> data = {1, 2, 3};
+    EXPECT_EQ(in_use->DecryptBlock(in_use->EncryptBlock(data)), data);
+
+    EXPECT_EQ(cache.InvalidateKeyId("key1"), 2u);
+    EXPECT_EQ(cache.GetStats().size, 0u);
+    EXPECT_EQ(cache.GetStats().invalidations, 3u);
+
+    cache.GetOrCreate(key1, factory.For(key1));
+    cache.Clear();
+    EXPECT_EQ(cache.GetStats().size, 0u);
+    EXPECT_EQ(cache.GetStats().invalidations, 4u);
+}
+
+TEST(EncryptorCache, InvalidationDuringFactory_SkipsInsert) {
+    EncryptorCache cache;
+    CountingFactory factory;
+    auto key = MakeKey("key1");
+    auto invalidating_factory = [&cache, &factory, &key]() {
+        // Stands for a key rotation that lands while the miss is still building its encryptor.
+        cache.InvalidateKeyId(key.key_id);
+        return factory.For(key)();
+    };
+
+    auto stale = cache.GetOrCreate(key, invalidating_factory);
+    ASSERT_NE(stale, nullptr);
+    EXPECT_EQ(cache.GetStats().size, 0u);
+
+    // The next lookup creates a fresh instance instead of serving the stale one.
+    auto fresh = cache.GetOrCreate(key, factory.For(key));
+    EXPECT_NE(fresh, stale);
+    EXPECT_EQ(cache.GetOrCreate(key, factory.For(key)), fresh);
+    EXPECT_EQ(factory.calls->load(), 2u);
+
+    auto invalidate_key = [&cache, &factory, &key]() {
+        cache.Invalidate(key);
+        return factory.For(key)();
+    };
+    cache.Clear();
+    cache.GetOrCreate(key, invalidate_key);
+    EXPECT_EQ(cache.GetStats().size, 0u);
+}
+
+TEST(EncryptorCache, NotThreadSafeEncryptors_AreNotCached) {
+    EncryptorCache cache;
+    size_t calls = 0;
+    auto factory = [&calls]() -> std::unique_ptr<DBPSEncryptor> {
+        ++calls;
+        return std::make_unique<NotThreadSafeEncryptor>();
+    };
+    auto key = MakeKey("key");
+    auto first = cache.GetOrCreate(key, factory);
+    auto second = cache.GetOrCreate(key, factory);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(calls, 2u);
+    EXPECT_EQ(cache.GetStats().size, 0u);
+}
+
+TEST(EncryptorCache, ZeroCapacity_DisablesCaching) {
+    EncryptorCacheOptions options;
+    options.capacity = 0;
+    EncryptorCache cache(options);
+    CountingFactory factory;
+    auto key = MakeKey("key");
+    EXPECT_NE(cache.GetOrCreate(key, factory.For(key)), cache.GetOrCreate(key, factory.For(key)));
+    EXPECT_EQ(factory.calls->load(), 2u);
+    EXPECT_EQ(cache.GetStats().misses, 2u);
+}
+
+TEST(EncryptorCache, ConcurrentLookups_ShareOneInstancePerKey) {
+    EncryptorCacheOptions options;
+    options.capacity = 64;
+    options.num_shards = 4;
+    EncryptorCache cache(options);
+    CountingFactory factory;
+    constexpr size_t kNumThreads = 8;
+    constexpr size_t kLookupsPerThread = 2000;
+    constexpr size_t kNumKeys = 16;
+
+    std::vector<std::vector<DBPSEncryptor*>> seen(kNumThreads, std::vector<DBPSEncryptor*>(kNumKeys, nullptr));
+    std::atomic<bool> mismatch{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < kLookupsPerThread; ++i) {
+                const size_t k = (i * 7 + t) % kNumKeys;
+                auto key = MakeKey("key" + std::to_string(k));
+                auto encryptor = cache.GetOrCreate(key, factory.For(key));
+                if (seen[t][k] == nullptr) {
+                    seen[t][k] = encryptor.get();
+                } else if (seen[t][k] != encryptor.get()) {
+                    mismatch = true;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every key keeps one instance: the capacity holds all keys, so nothing is replaced.
+    EXPECT_FALSE(mismatch.load());
+    for (size_t k = 0; k < kNumKeys; ++k) {
+        for (size_t t = 1; t < kNumThreads; ++t) {
+            EXPECT_EQ(seen[t][k], seen[0][k]) << "key " << k;
+        }
+    }
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits + stats.misses, kNumThreads * kLookupsPerThread);
+    EXPECT_EQ(stats.size, kNumKeys);
+    EXPECT_EQ(stats.evictions, 0u);
+}
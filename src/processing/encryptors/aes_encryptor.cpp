@@ -0,0 +1,514 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "aes_encryptor.h"
+#include "encryptor_utils.h"
+#include "../buffer_pool.h"
+#include "../../common/exceptions.h"
+#include "../../common/enum_utils.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+using namespace dbps::processing;
+using namespace dbps::external;
+
+// ---------------------------------------------------------------------------
+// OpenSSL helpers
+// ---------------------------------------------------------------------------
+
+namespace {
+    struct CipherContextDeleter {
+        void operator()(EVP_CIPHER_CTX* ctx) const { EVP_CIPHER_CTX_free(ctx); }
+    };
+    using CipherContext = std::unique_ptr<EVP_CIPHER_CTX, CipherContextDeleter>;
+
+    // EVP lengths are ints, so larger inputs are passed in chunks of this size.
+    constexpr size_t kMaxUpdateBytes = size_t{1} << 30;
+
+    void CheckOpenSsl(int result, const char* operation) {
+        if (result != 1) {
+            throw DBPSBaseException(std::string("AesEncryptor: OpenSSL ") + operation + " failed");
+        }
+    }
+
+    const EVP_CIPHER* GetGcmCipher(size_t key_size) {
+        switch (key_size) {
+            case 16: return EVP_aes_128_gcm();
+            case 24: return EVP_aes_192_gcm();
+            default: return EVP_aes_256_gcm();
+        }
+    }
+
+    const EVP_CIPHER* GetCtrCipher(size_t key_size) {
+        switch (key_size) {
+            case 16: return EVP_aes_128_ctr();
+            case 24: return EVP_aes_192_ctr();
+            default: return EVP_aes_256_ctr();
+        }
+    }
+
+    std::vector<uint8_t> ValidateKey(std::vector<uint8_t> key) {
+        if (key.size() != 16 && key.size() != 24 && key.size() != 32) {
+            throw InvalidInputException(
+                "AesEncryptor: key must be 16, 24 or 32 bytes, got " + std::to_string(key.size()));
+        }
+        return key;
+    }
+
+    // Subkey of the key size: the first bytes of HMAC-SHA256(key, label).
+    std::vector<uint8_t> DeriveSubkey(const std::vector<uint8_t>& key, const std::string& label) {
+        uint8_t digest[EVP_MAX_MD_SIZE];
+        unsigned int digest_size = 0;
+        if (HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+                 reinterpret_cast<const uint8_t*>(label.data()), label.size(), digest, &digest_size) == nullptr) {
+            throw DBPSBaseException("AesEncryptor: OpenSSL key derivation failed");
+        }
+        std::vector<uint8_t> subkey(digest, digest + key.size());
+        OPENSSL_cleanse(digest, sizeof(digest));
+        return subkey;
+    }
+
+    void FillRandomNonce(uint8_t* nonce) {
+        CheckOpenSsl(RAND_bytes(nonce, static_cast<int>(AesEncryptor::kNonceLength)), "nonce generation");
+    }
+
+    // GCM context initialized with the key and nonce, with the column name (and its length) as the first AAD.
+    CipherContext NewGcmContext(
+        const std::vector<uint8_t>& key, const uint8_t* nonce, const std::string& column_name, bool encrypt) {
+        CipherContext ctx(EVP_CIPHER_CTX_new());
+        if (!ctx) {
+            throw DBPSBaseException("AesEncryptor: OpenSSL context allocation failed");
+        }
+        CheckOpenSsl(EVP_CipherInit_ex(ctx.get(), GetGcmCipher(key.size()), nullptr, nullptr, nullptr, encrypt),
+                     "GCM init");
+        CheckOpenSsl(EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_IVLEN,
+                                         static_cast<int>(AesEncryptor::kNonceLength), nullptr), "GCM IV length");
+        CheckOpenSsl(EVP_CipherInit_ex(ctx.get(), nullptr, nullptr, key.data(), nonce, encrypt), "GCM key setup");
+        uint8_t name_length[4];
+        write_u32_le(name_length, static_cast<uint32_t>(column_name.size()));
+        int ignored = 0;
+        CheckOpenSsl(EVP_CipherUpdate(ctx.get(), nullptr, &ignored, name_length, sizeof(name_length)), "GCM AAD");
+        if (!column_name.empty()) {
+            CheckOpenSsl(EVP_CipherUpdate(ctx.get(), nullptr, &ignored,
+                                          reinterpret_cast<const uint8_t*>(column_name.data()),
+                                          static_cast<int>(column_name.size())), "GCM AAD");
+        }
+        return ctx;
+    }
+
+    // CTR context starting the key stream of a page: the nonce followed by a zero block counter.
+    CipherContext NewCtrContext(const std::vector<uint8_t>& key, const uint8_t* nonce) {
+        CipherContext ctx(EVP_CIPHER_CTX_new());
+        if (!ctx) {
+            throw DBPSBaseException("AesEncryptor: OpenSSL context allocation failed");
+        }
+        uint8_t iv[16] = {};
+        std::memcpy(iv, nonce, AesEncryptor::kNonceLength);
+        CheckOpenSsl(EVP_EncryptInit_ex(ctx.get(), GetCtrCipher(key.size()), nullptr, key.data(), iv), "CTR init");
+        return ctx;
+    }
+
+    // Runs n bytes through the context: AAD when out is null, otherwise data. CTR contexts carry their key
+    // stream position over calls, so consecutive calls encrypt consecutive slices of one key stream.
+    void CipherUpdate(EVP_CIPHER_CTX* ctx, const uint8_t* in, uint8_t* out, size_t n) {
+        while (n > 0) {
+            const size_t chunk = std::min(n, kMaxUpdateBytes);
+            int written = 0;
+            CheckOpenSsl(EVP_CipherUpdate(ctx, out, &written, in, static_cast<int>(chunk)), "update");
+            in += chunk;
+            if (out != nullptr) {
+                out += chunk;
+            }
+            n -= chunk;
+        }
+    }
+
+    // End offset of the [u32 size][payload] record starting at `cursor` in records[0, size).
+    size_t GetRecordEnd(const uint8_t* records, size_t size, size_t cursor) {
+        if (size - cursor < ::kSizePrefixBytes) {
+            throw InvalidInputException("AesEncryptor: truncated length prefix");
+        }
+        const size_t payload_size = read_u32_le(records + cursor);
+        if (size - cursor - ::kSizePrefixBytes < payload_size) {
+            throw InvalidInputException("AesEncryptor: truncated element payload");
+        }
+        return cursor + ::kSizePrefixBytes + payload_size;
+    }
+}
+
+AesEncryptor::AesEncryptor(
+    const std::string& key_id,
+    const std::string& column_name,
+    const std::string& user_id,
+    const std::string& application_context,
+    Type::type datatype,
+    std::vector<uint8_t> key)
+    : DBPSEncryptor(key_id, column_name, user_id, application_context, datatype) {
+    key = ValidateKey(std::move(key));
+    block_key_ = DeriveSubkey(key, "dbps block encryption");
+    value_key_ = DeriveSubkey(key, "dbps value encryption");
+    page_mac_key_ = DeriveSubkey(key, "dbps page authentication");
+    // Block tags carry no column AAD, so the column name is bound into their subkey instead.
+    block_tag_key_ = DeriveSubkey(key, "dbps block authentication:" + column_name);
+    OPENSSL_cleanse(key.data(), key.size());
+}
+
+AesEncryptor::~AesEncryptor() {
+    for (auto* key : {&block_key_, &value_key_, &page_mac_key_, &block_tag_key_}) {
+        OPENSSL_cleanse(key->data(), key->size());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Block encryption  (AES-GCM)
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> AesEncryptor::EncryptBlock(tcb::span<const uint8_t> data) {
+    auto out = AcquireUninitializedBuffer(data.size() + kOverheadLength);
+    EncryptBlockInto(data, tcb::span<uint8_t>(out.data(), out.size()));
+    return out;
+}
+
+std::vector<uint8_t> AesEncryptor::DecryptBlock(tcb::span<const uint8_t> data) {
+    if (data.size() < kOverheadLength) {
+        throw InvalidInputException("AesEncryptor: block ciphertext is shorter than its nonce and tag");
+    }
+    auto out = AcquireUninitializedBuffer(data.size() - kOverheadLength);
+    DecryptBlockInto(data, tcb::span<uint8_t>(out.data(), out.size()));
+    return out;
+}
+
+size_t AesEncryptor::EncryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+    const size_t output_size = data.size() + kOverheadLength;
+    if (out.size() < output_size) {
+        throw InvalidInputException("EncryptBlockInto: output buffer is smaller than the ciphertext");
+    }
+    uint8_t* nonce = out.data();
+    FillRandomNonce(nonce);
+    auto ctx = NewGcmContext(block_key_, nonce, column_name_, true);
+    CipherUpdate(ctx.get(), data.data(), out.data() + kNonceLength, data.size());
+    int ignored = 0;
+    CheckOpenSsl(EVP_EncryptFinal_ex(ctx.get(), nullptr, &ignored), "GCM final");
+    CheckOpenSsl(EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, static_cast<int>(kAuthTagLength),
+                                     out.data() + kNonceLength + data.size()), "GCM tag");
+    return output_size;
+}
+
+size_t AesEncryptor::DecryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+    if (data.size() < kOverheadLength) {
+        throw InvalidInputException("AesEncryptor: block ciphertext is shorter than its nonce and tag");
+    }
+    const size_t plaintext_size = data.size() - kOverheadLength;
+    if (out.size() < plaintext_size) {
+        throw InvalidInputException("DecryptBlockInto: output buffer is smaller than the plaintext");
+    }
+    auto ctx = NewGcmContext(block_key_, data.data(), column_name_, false);
+    CipherUpdate(ctx.get(), data.data() + kNonceLength, out.data(), plaintext_size);
+    uint8_t tag[kAuthTagLength];
+    std::memcpy(tag, data.data() + kNonceLength + plaintext_size, kAuthTagLength);
+    CheckOpenSsl(EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, static_cast<int>(kAuthTagLength), tag),
+                 "GCM tag");
+    int ignored = 0;
+    if (EVP_DecryptFinal_ex(ctx.get(), nullptr, &ignored) != 1) {
+        // Unauthenticated plaintext is not handed out.
+        OPENSSL_cleanse(out.data(), plaintext_size);
+        throw InvalidInputException("AesEncryptor: block authentication failed");
+    }
+    return plaintext_size;
+}
+
+std::optional<size_t> AesEncryptor::MaxBlockCiphertextSize(size_t plaintext_size) const {
+    return plaintext_size + kOverheadLength;
+}
+
+std::optional<size_t> AesEncryptor::MaxBlockPlaintextSize(size_t ciphertext_size) const {
+    return ciphertext_size > kOverheadLength ? ciphertext_size - kOverheadLength : 0;
+}
+
+std::optional<size_t> AesEncryptor::MaxValueListCiphertextSize(size_t value_bytes_size) const {
+    // CTR keeps the element sizes, so the PLAIN layout of the values is kept between the nonce and the tag.
+    return kFixedHeaderLength + kOverheadLength + value_bytes_size;
+}
+
+std::optional<size_t> AesEncryptor::MaxValueListPlaintextSize(size_t ciphertext_size) const {
+    const size_t min_size = kVariableHeaderLength + kOverheadLength;
+    return ciphertext_size > min_size ? ciphertext_size - min_size : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Block tags  (HMAC-SHA256)
+// ---------------------------------------------------------------------------
+
+void AesEncryptor::ComputeBlockTag(tcb::span<const uint8_t> data, tcb::span<uint8_t> tag) {
+    if (tag.size() != kBlockTagLength) {
+        throw InvalidInputException("AesEncryptor: block tag must be " + std::to_string(kBlockTagLength) + " bytes");
+    }
+    unsigned int tag_size = 0;
+    if (HMAC(EVP_sha256(), block_tag_key_.data(), static_cast<int>(block_tag_key_.size()),
+             data.data(), data.size(), tag.data(), &tag_size) == nullptr || tag_size != kBlockTagLength) {
+        throw DBPSBaseException("AesEncryptor: OpenSSL block tag failed");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Value-level encryption  (AES-CTR over the page, one GMAC tag per page)
+// ---------------------------------------------------------------------------
+
+void AesEncryptor::ComputePageTag(
+    tcb::span<const uint8_t> authenticated_bytes, const uint8_t* nonce, uint8_t* tag) const {
+    auto ctx = NewGcmContext(page_mac_key_, nonce, column_name_, true);
+    CipherUpdate(ctx.get(), authenticated_bytes.data(), nullptr, authenticated_bytes.size());
+    int ignored = 0;
+    CheckOpenSsl(EVP_EncryptFinal_ex(ctx.get(), nullptr, &ignored), "GMAC final");
+    CheckOpenSsl(EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, static_cast<int>(kAuthTagLength), tag),
+                 "GMAC tag");
+}
+
+tcb::span<const uint8_t> AesEncryptor::VerifyPageAndGetRecords(
+    tcb::span<const uint8_t> encrypted_bytes, size_t header_length, const uint8_t*& nonce) {
+    if (encrypted_bytes.size() < header_length + kOverheadLength) {
+        throw InvalidInputException("AesEncryptor: value list ciphertext is shorter than its nonce and tag");
+    }
+    const size_t tag_offset = encrypted_bytes.size() - kAuthTagLength;
+    nonce = encrypted_bytes.data() + header_length;
+    uint8_t expected_tag[kAuthTagLength];
+    ComputePageTag(encrypted_bytes.first(tag_offset), nonce, expected_tag);
+    if (CRYPTO_memcmp(expected_tag, encrypted_bytes.data() + tag_offset, kAuthTagLength) != 0) {
+        throw InvalidInputException("AesEncryptor: value list authentication failed");
+    }
+    return encrypted_bytes.subspan(header_length + kNonceLength, tag_offset - header_length - kNonceLength);
+}
+
+template <typename TypedBuffer>
+size_t AesEncryptor::EncryptTypedElementsInto(const TypedBuffer& input_buffer, tcb::span<uint8_t> out) {
+    constexpr bool is_fixed = TypedBuffer::is_fixed_sized;
+    constexpr size_t header_length = is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
+    const size_t num_elements = input_buffer.GetNumElements();
+    const size_t records_size = input_buffer.GetRecordsSize();
+    const size_t output_size = header_length + kOverheadLength + records_size;
+    if (out.size() < output_size) {
+        throw InvalidInputException(
+            "EncryptValueListInto: output buffer too small: " + std::to_string(output_size) +
+            " bytes required, " + std::to_string(out.size()) + " bytes provided");
+    }
+    const size_t element_size = (is_fixed && num_elements > 0) ? input_buffer.GetElementSize() : 0;
+    WriteHeader(out, {is_fixed, static_cast<uint32_t>(num_elements), static_cast<uint32_t>(element_size)});
+    uint8_t* nonce = out.data() + header_length;
+    FillRandomNonce(nonce);
+
+    // One CTR context encrypts every value of the page: a single call over the contiguous run of fixed-size
+    // elements, one call per payload for variable-size elements, whose length prefixes are copied as-is.
+    auto records_out = out.subspan(header_length + kNonceLength, records_size);
+    if (num_elements > 0) {
+        if constexpr (!is_fixed) {
+            input_buffer.CopyRecordsInto(records_out);
+        }
+        auto ctx = NewCtrContext(value_key_, nonce);
+        input_buffer.TransformPayloadsInto(
+            records_out, 0, num_elements, [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> encrypted) {
+                CipherUpdate(ctx.get(), in.data(), encrypted.data(), in.size());
+            });
+    }
+    const size_t tag_offset = header_length + kNonceLength + records_size;
+    ComputePageTag(out.first(tag_offset), nonce, out.data() + tag_offset);
+    return output_size;
+}
+
+std::vector<uint8_t> AesEncryptor::EncryptValueList(const TypedValuesBuffer& typed_buffer) {
+    return std::visit([&](const auto& input_buffer) {
+        using TypedBuffer = std::decay_t<decltype(input_buffer)>;
+        constexpr size_t header_length =
+            TypedBuffer::is_fixed_sized ? kFixedHeaderLength : kVariableHeaderLength;
+        std::vector<uint8_t> result =
+            AcquireUninitializedBuffer(header_length + kOverheadLength + input_buffer.GetRecordsSize());
+        EncryptTypedElementsInto(input_buffer, result);
+        return result;
+    }, typed_buffer);
+}
+
+size_t AesEncryptor::EncryptValueListInto(const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) {
+    return std::visit([&](const auto& input_buffer) {
+        return EncryptTypedElementsInto(input_buffer, out);
+    }, typed_buffer);
+}
+
+// Columnar layout: the data region of the values is encrypted behind the packed sizes with one call. The key
+// stream slices match the records layout, element by element.
+size_t AesEncryptor::EncryptColumnarValuesInto(const ByteArrayOffsetsBuffer& values, tcb::span<uint8_t> out) {
+    const size_t num_elements = values.GetNumElements();
+    const auto payloads = values.GetData();
+    const auto value_sizes = GetValueSizes(values);
+    const uint8_t size_width = GetSizeWidth(value_sizes);
+    const size_t sizes_offset = kColumnarHeaderLength + kNonceLength;
+    const size_t payloads_offset = sizes_offset + num_elements * size_width;
+    const size_t tag_offset = payloads_offset + payloads.size();
+    const size_t output_size = tag_offset + kAuthTagLength;
+    if (out.size() < output_size) {
+        throw InvalidInputException(
+            "EncryptColumnarValuesInto: output buffer too small: " + std::to_string(output_size) +
+            " bytes required, " + std::to_string(out.size()) + " bytes provided");
+    }
+    WriteHeader(out, {false, static_cast<uint32_t>(num_elements), 0, true, size_width});
+    uint8_t* nonce = out.data() + kColumnarHeaderLength;
+    FillRandomNonce(nonce);
+    WritePackedValueSizes(out.subspan(sizes_offset), value_sizes, size_width);
+    if (!payloads.empty()) {
+        auto ctx = NewCtrContext(value_key_, nonce);
+        CipherUpdate(ctx.get(), payloads.data(), out.data() + payloads_offset, payloads.size());
+    }
+    ComputePageTag(out.first(tag_offset), nonce, out.data() + tag_offset);
+    return output_size;
+}
+
+// ---------------------------------------------------------------------------
+// Value-level decryption
+//
+// The page tag is verified before any value is decrypted. The values are then decrypted with one CTR context,
+// in element order, into a typed buffer matching datatype_ (DecryptValueList) or into PLAIN value bytes
+// (DecryptTrustedValueListInto).
+// ---------------------------------------------------------------------------
+
+TypedValuesBuffer AesEncryptor::DecryptValueList(tcb::span<const uint8_t> encrypted_bytes) {
+    auto header = ReadHeader(encrypted_bytes);
+    const size_t num_elements = static_cast<size_t>(header.num_elements);
+    if (header.is_columnar) {
+        if (datatype_ != Type::BYTE_ARRAY) {
+            throw InvalidInputException(
+                std::string("DecryptValueList: unsupported variable-size datatype: ")
+                + std::string(dbps::enum_utils::to_string(datatype_)));
+        }
+        const uint8_t* nonce = nullptr;
+        const auto value_list =
+            ReadColumnarValueList(header, VerifyPageAndGetRecords(encrypted_bytes, kColumnarHeaderLength, nonce));
+        std::vector<uint8_t> value_bytes = AcquireUninitializedBuffer(value_list.GetPlainSize());
+        DecryptColumnarValueListInto(value_list, nonce, value_bytes);
+        return TypedBufferRawBytesVariableSized::FromSerializedBuffer(std::move(value_bytes), num_elements);
+    }
+    const size_t header_length = header.is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
+    const uint8_t* nonce = nullptr;
+    const auto records = VerifyPageAndGetRecords(encrypted_bytes, header_length, nonce);
+    auto ctx = NewCtrContext(value_key_, nonce);
+    auto decrypt_kernel = [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        CipherUpdate(ctx.get(), in.data(), out.data(), in.size());
+    };
+
+    if (header.is_fixed) {
+        TypedBufferRawBytesFixedSized encrypted_buffer{
+            records, num_elements, 0, RawBytesFixedSizedCodec{header.element_size}};
+        auto decrypt_into = [&](auto output_buffer) -> TypedValuesBuffer {
+            encrypted_buffer.TransformInto(output_buffer, decrypt_kernel);
+            return output_buffer;
+        };
+        switch (datatype_) {
+            case Type::INT32:
+                return decrypt_into(TypedBufferI32{num_elements});
+            case Type::INT64:
+                return decrypt_into(TypedBufferI64{num_elements});
+            case Type::INT96:
+                return decrypt_into(TypedBufferInt96{num_elements});
+            case Type::FLOAT:
+                return decrypt_into(TypedBufferFloat{num_elements});
+            case Type::DOUBLE:
+                return decrypt_into(TypedBufferDouble{num_elements});
+            case Type::FIXED_LEN_BYTE_ARRAY:
+                return decrypt_into(
+                    TypedBufferRawBytesFixedSized{num_elements, 0, RawBytesFixedSizedCodec{header.element_size}});
+            default:
+                throw InvalidInputException(
+                    std::string("DecryptValueList: unsupported fixed-size datatype: ")
+                    + std::string(dbps::enum_utils::to_string(datatype_)));
+        }
+    }
+
+    if (datatype_ != Type::BYTE_ARRAY) {
+        throw InvalidInputException(
+            std::string("DecryptValueList: unsupported variable-size datatype: ")
+            + std::string(dbps::enum_utils::to_string(datatype_)));
+    }
+    TypedBufferRawBytesVariableSized encrypted_buffer{records, num_elements, 0};
+    TypedBufferRawBytesVariableSized output_buffer{num_elements, records.size(), true};
+    encrypted_buffer.TransformInto(output_buffer, decrypt_kernel);
+    return output_buffer;
+}
+
+size_t AesEncryptor::DecryptTrustedValueListInto(
+    tcb::span<const uint8_t> encrypted_bytes, tcb::span<uint8_t> out) {
+    auto header = ReadHeader(encrypted_bytes);
+    const size_t num_elements = static_cast<size_t>(header.num_elements);
+    if (header.is_columnar) {
+        const uint8_t* nonce = nullptr;
+        const auto value_list =
+            ReadColumnarValueList(header, VerifyPageAndGetRecords(encrypted_bytes, kColumnarHeaderLength, nonce));
+        const size_t plain_size = value_list.GetPlainSize();
+        if (out.size() < plain_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+        }
+        DecryptColumnarValueListInto(value_list, nonce, out.first(plain_size));
+        return plain_size;
+    }
+    const size_t header_length = header.is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
+    const uint8_t* nonce = nullptr;
+    const auto records = VerifyPageAndGetRecords(encrypted_bytes, header_length, nonce);
+    auto ctx = NewCtrContext(value_key_, nonce);
+
+    if (header.is_fixed) {
+        const size_t element_size = static_cast<size_t>(header.element_size);
+        if (element_size == 0 || num_elements > records.size() / element_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: fixed-size elements overrun the input");
+        }
+        const size_t payload_size = num_elements * element_size;
+        if (out.size() < payload_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+        }
+        CipherUpdate(ctx.get(), records.data(), out.data(), payload_size);
+        return payload_size;
+    }
+
+    if (out.size() < records.size()) {
+        throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+    }
+    size_t cursor = 0;
+    for (size_t i = 0; i < num_elements; ++i) {
+        const size_t record_end = GetRecordEnd(records.data(), records.size(), cursor);
+        std::memcpy(out.data() + cursor, records.data() + cursor, ::kSizePrefixBytes);
+        cursor += ::kSizePrefixBytes;
+        CipherUpdate(ctx.get(), records.data() + cursor, out.data() + cursor, record_end - cursor);
+        cursor = record_end;
+    }
+    return cursor;
+}
+
+// The payloads are decrypted with one call into the tail of out, then moved forward to their records.
+void AesEncryptor::DecryptColumnarValueListInto(
+    const ColumnarValueList& value_list, const uint8_t* nonce, tcb::span<uint8_t> out) {
+    const size_t prefixes_size = value_list.value_sizes.size() * ::kSizePrefixBytes;
+    const size_t payloads_size = value_list.payloads.size();
+    if (payloads_size > 0) {
+        auto ctx = NewCtrContext(value_key_, nonce);
+        CipherUpdate(ctx.get(), value_list.payloads.data(), out.data() + prefixes_size, payloads_size);
+    }
+    ExpandColumnarPayloadsIntoRecords(value_list.value_sizes, out);
+}
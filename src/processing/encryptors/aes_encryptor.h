@@ -0,0 +1,150 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "dbps_encryptor.h"
+
+namespace dbps::processing {
+    struct ColumnarValueList;
+}
+
+using namespace dbps::processing;
+
+/**
+ * AES implementation of the DBPSEncryptor interface, on top of OpenSSL EVP (AES-NI where the CPU has it).
+ *
+ * - Block encryption uses AES-GCM with a random 96-bit nonce per block:
+ *     [12-byte nonce][ciphertext][16-byte tag]
+ * - Value encryption uses AES-CTR with one cipher context per page. Every page gets a random 96-bit nonce,
+ *   and the values are encrypted as consecutive slices of the page key stream: fixed-size values in one
+ *   call over the whole run, variable-size values one payload at a time without re-initializing the context.
+ *   The lengths of variable-size values stay in the clear, as in the PLAIN encoding. A single GMAC tag
+ *   authenticates the whole page ciphertext, header and lengths included:
+ *     Fixed:    [0x01][uint32 count][uint32 elem_size][12-byte nonce] <encrypted elements>                [16-byte tag]
+ *     Variable: [0x00][uint32 count]                  [12-byte nonce] <length-prefixed encrypted elements> [16-byte tag]
+ *     Columnar: [0x02][uint32 count][uint8 size_width][12-byte nonce] <packed sizes> <encrypted payloads> [16-byte tag]
+ *   The columnar layout (see encryptor_utils.h) keeps the payloads of variable-size values contiguous, so they
+ *   are encrypted and decrypted with a single call, like fixed-size values.
+ *
+ * The column name is authenticated with every block and page, so ciphertexts do not decrypt under another
+ * column. Blocks, values, page tags and block tags (see ComputeBlockTag) use their own subkeys, derived from
+ * the key with HMAC-SHA256.
+ *
+ * The key material is provided by the caller: key_id only identifies the key, it is not used to derive it.
+ */
+class DBPS_EXPORT AesEncryptor : public DBPSEncryptor {
+public:
+    /**
+     * Constructor that initializes the encryptor with context parameters and key material.
+     *
+     * @param key_id The encryption key identifier
+     * @param column_name The name of the column being encrypted/decrypted
+     * @param user_id The user identifier for context
+     * @param application_context Additional application context information
+     * @param datatype The data type of the column being encrypted/decrypted.
+     *    It is needed for correct type specific parsing during the DecryptValueList call.
+     * @param key The AES key: 16, 24 or 32 bytes for AES-128, AES-192 or AES-256
+     * @throws InvalidInputException if the key size is not a valid AES key size
+     */
+    AesEncryptor(
+        const std::string& key_id,
+        const std::string& column_name,
+        const std::string& user_id,
+        const std::string& application_context,
+        dbps::external::Type::type datatype,
+        std::vector<uint8_t> key);
+
+    // Wipes the keys.
+    ~AesEncryptor() override;
+
+    static constexpr size_t kNonceLength = 12;
+    static constexpr size_t kAuthTagLength = 16;
+    // Bytes added to a block or to a value list, next to the value-list header.
+    static constexpr size_t kOverheadLength = kNonceLength + kAuthTagLength;
+    static constexpr size_t kBlockTagLength = 32;
+
+    // Block encryption methods
+    std::vector<uint8_t> EncryptBlock(tcb::span<const uint8_t> data) override;
+
+    std::vector<uint8_t> DecryptBlock(tcb::span<const uint8_t> data) override;
+
+    size_t EncryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) override;
+
+    size_t DecryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) override;
+
+    // Output size bounds
+    std::optional<size_t> MaxBlockCiphertextSize(size_t plaintext_size) const override;
+
+    std::optional<size_t> MaxBlockPlaintextSize(size_t ciphertext_size) const override;
+
+    std::optional<size_t> MaxValueListCiphertextSize(size_t value_bytes_size) const override;
+
+    std::optional<size_t> MaxValueListPlaintextSize(size_t ciphertext_size) const override;
+
+    // Block tags: HMAC-SHA256 under their own subkey, over the column name and the data.
+    size_t GetBlockTagLength() const override {
+        return kBlockTagLength;
+    }
+
+    void ComputeBlockTag(tcb::span<const uint8_t> data, tcb::span<uint8_t> tag) override;
+
+    // Value encryption methods
+    std::vector<uint8_t> EncryptValueList(const TypedValuesBuffer& typed_buffer) override;
+
+    size_t EncryptValueListInto(const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) override;
+
+    bool SupportsColumnarValueList() const override {
+        return true;
+    }
+
+    // The data region of values is encrypted straight into the payload region, with one call.
+    size_t EncryptColumnarValuesInto(const ByteArrayOffsetsBuffer& values, tcb::span<uint8_t> out) override;
+
+    TypedValuesBuffer DecryptValueList(tcb::span<const uint8_t> encrypted_bytes) override;
+
+    // Every call uses its own cipher contexts; the encryptor only holds the keys.
+    bool IsThreadSafe() const override {
+        return true;
+    }
+
+    // The page tag is still verified; only the element count check against the payload is skipped.
+    size_t DecryptTrustedValueListInto(tcb::span<const uint8_t> encrypted_bytes, tcb::span<uint8_t> out) override;
+
+private:
+    // Subkeys for block encryption, value encryption, page authentication and block tags.
+    std::vector<uint8_t> block_key_;
+    std::vector<uint8_t> value_key_;
+    std::vector<uint8_t> page_mac_key_;
+    std::vector<uint8_t> block_tag_key_;
+
+    template <typename InputBuffer>
+    size_t EncryptTypedElementsInto(const InputBuffer& input_buffer, tcb::span<uint8_t> out);
+
+    // Decrypts the payloads of a verified columnar value list into PLAIN value bytes. out holds exactly
+    // value_list.GetPlainSize() bytes.
+    void DecryptColumnarValueListInto(
+        const ColumnarValueList& value_list, const uint8_t* nonce, tcb::span<uint8_t> out);
+
+    // Checks the page tag and returns the records of a value-list ciphertext with the given header length.
+    tcb::span<const uint8_t> VerifyPageAndGetRecords(
+        tcb::span<const uint8_t> encrypted_bytes, size_t header_length, const uint8_t*& nonce);
+
+    // Tag of a value-list ciphertext: the header, nonce and records before the tag position.
+    void ComputePageTag(tcb::span<const uint8_t> authenticated_bytes, const uint8_t* nonce, uint8_t* tag) const;
+};
@@ -0,0 +1,355 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "aes_encryptor.h"
+#include "encryptor_utils.h"
+#include "../../common/enums.h"
+#include "../../common/exceptions.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace dbps::external;
+using namespace dbps::processing;
+
+namespace {
+    std::vector<uint8_t> TestKey(uint8_t seed = 0x42, size_t size = 32) {
+        std::vector<uint8_t> key(size);
+        for (size_t i = 0; i < size; ++i) {
+            key[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return key;
+    }
+
+    AesEncryptor MakeEncryptor(Type::type datatype, const std::string& column_name = "test_column") {
+        return AesEncryptor("test_key", column_name, "test_user", "test_context", datatype, TestKey());
+    }
+
+    // PLAIN value bytes of INT64 values.
+    std::vector<uint8_t> Int64ValueBytes(size_t count) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i < count; ++i) {
+            append_u64_le(bytes, static_cast<uint64_t>(i * 0x0101010101ull + 17));
+        }
+        return bytes;
+    }
+
+    // PLAIN value bytes of BYTE_ARRAY values: [u32 length][payload] records.
+    std::vector<uint8_t> ByteArrayValueBytes(const std::vector<std::string>& values) {
+        std::vector<uint8_t> bytes;
+        for (const auto& value : values) {
+            append_u32_le(bytes, static_cast<uint32_t>(value.size()));
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+        return bytes;
+    }
+
+    const std::vector<std::string> kByteArrayValues = {
+        "", "a", "hello", std::string("x\0y\0z", 5), std::string(100, 'Q'), std::string(1000, 'z')};
+}
+
+// --- Construction ---
+
+TEST(AesEncryptor, RejectsInvalidKeySizes) {
+    for (size_t key_size : {0, 8, 15, 17, 31, 33, 64}) {
+        EXPECT_THROW(AesEncryptor("k", "c", "u", "ctx", Type::INT32, TestKey(1, key_size)), InvalidInputException)
+            << "key_size=" << key_size;
+    }
+    for (size_t key_size : {16, 24, 32}) {
+        AesEncryptor encryptor("k", "c", "u", "ctx", Type::INT32, TestKey(1, key_size));
+        std::vector<uint8_t> data = {1, 2, 3};
+        EXPECT_EQ(encryptor.DecryptBlock(encryptor.EncryptBlock(data)), data) << "key_size=" << key_size;
+    }
+}
+
+// --- Block encryption (AES-GCM) ---
+
+TEST(AesEncryptor, EncryptDecryptBlock_RoundTrip) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    for (size_t size : {0, 1, 15, 16, 17, 1000, 100000}) {
+        std::vector<uint8_t> original(size);
+        for (size_t i = 0; i < size; ++i) {
+            original[i] = static_cast<uint8_t>(i * 31);
+        }
+        auto encrypted = encryptor.EncryptBlock(original);
+        ASSERT_EQ(encrypted.size(), size + AesEncryptor::kOverheadLength);
+        EXPECT_EQ(encryptor.MaxBlockCiphertextSize(size), std::optional<size_t>(encrypted.size()));
+        EXPECT_EQ(encryptor.MaxBlockPlaintextSize(encrypted.size()), std::optional<size_t>(size));
+        EXPECT_EQ(encryptor.DecryptBlock(encrypted), original) << "size=" << size;
+    }
+}
+
+TEST(AesEncryptor, EncryptBlock_UsesFreshNonces) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    std::vector<uint8_t> data(64, 0x5A);
+    auto encrypted1 = encryptor.EncryptBlock(data);
+    auto encrypted2 = encryptor.EncryptBlock(data);
+    EXPECT_NE(encrypted1, encrypted2);
+    EXPECT_EQ(encryptor.DecryptBlock(encrypted1), encryptor.DecryptBlock(encrypted2));
+}
+
+TEST(AesEncryptor, EncryptDecryptBlockInto_ChecksOutputSize) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    std::vector<uint8_t> original = {1, 2, 3, 4, 5, 10, 20, 30, 40, 50};
+
+    std::vector<uint8_t> encrypted(original.size() + AesEncryptor::kOverheadLength + 4, 0xEE);
+    const size_t encrypted_size = encryptor.EncryptBlockInto(original, encrypted);
+    ASSERT_EQ(encrypted_size, original.size() + AesEncryptor::kOverheadLength);
+    EXPECT_EQ(encrypted.back(), 0xEE);
+
+    std::vector<uint8_t> decrypted(original.size());
+    ASSERT_EQ(encryptor.DecryptBlockInto(
+        tcb::span<const uint8_t>(encrypted.data(), encrypted_size), decrypted), original.size());
+    EXPECT_EQ(decrypted, original);
+
+    std::vector<uint8_t> too_small(original.size() + AesEncryptor::kOverheadLength - 1);
+    EXPECT_THROW(encryptor.EncryptBlockInto(original, too_small), InvalidInputException);
+    std::vector<uint8_t> too_small_plaintext(original.size() - 1);
+    EXPECT_THROW(encryptor.DecryptBlockInto(
+        tcb::span<const uint8_t>(encrypted.data(), encrypted_size), too_small_plaintext), InvalidInputException);
+}
+
+TEST(AesEncryptor, DecryptBlock_RejectsTamperedOrForeignCiphertext) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+    const auto encrypted = encryptor.EncryptBlock(data);
+
+    // Any flipped bit (nonce, ciphertext or tag) fails authentication.
+    for (size_t i = 0; i < encrypted.size(); ++i) {
+        auto tampered = encrypted;
+        tampered[i] ^= 0x01;
+        EXPECT_THROW(encryptor.DecryptBlock(tampered), InvalidInputException) << "byte " << i;
+    }
+    EXPECT_THROW(encryptor.DecryptBlock(std::vector<uint8_t>(encrypted.begin(), encrypted.end() - 1)),
+                 InvalidInputException);
+    EXPECT_THROW(encryptor.DecryptBlock(std::vector<uint8_t>(AesEncryptor::kOverheadLength - 1)),
+                 InvalidInputException);
+
+    // Another key or another column does not authenticate it either.
+    AesEncryptor other_key("test_key", "test_column", "test_user", "test_context", Type::BYTE_ARRAY, TestKey(7));
+    EXPECT_THROW(other_key.DecryptBlock(encrypted), InvalidInputException);
+    auto other_column = MakeEncryptor(Type::BYTE_ARRAY, "other_column");
+    EXPECT_THROW(other_column.DecryptBlock(encrypted), InvalidInputException);
+}
+
+// --- Value encryption (AES-CTR with one tag per page) ---
+
+TEST(AesEncryptor, EncryptDecryptValueList_RoundTrip_INT64) {
+    auto encryptor = MakeEncryptor(Type::INT64);
+    const size_t num_values = 1000;
+    const auto value_bytes = Int64ValueBytes(num_values);
+    TypedValuesBuffer typed_buffer = TypedBufferI64{value_bytes, num_values};
+
+    auto encrypted = encryptor.EncryptValueList(typed_buffer);
+    ASSERT_EQ(encrypted.size(), kFixedHeaderLength + AesEncryptor::kOverheadLength + value_bytes.size());
+    EXPECT_EQ(encryptor.MaxValueListCiphertextSize(value_bytes.size()), std::optional<size_t>(encrypted.size()));
+    auto header = ReadHeader(encrypted);
+    EXPECT_TRUE(header.is_fixed);
+    EXPECT_EQ(header.num_elements, num_values);
+    EXPECT_EQ(header.element_size, 8u);
+    // Each page has its own nonce.
+    EXPECT_NE(encryptor.EncryptValueList(typed_buffer), encrypted);
+
+    auto decrypted = encryptor.DecryptValueList(encrypted);
+    auto* out = std::get_if<TypedBufferI64>(&decrypted);
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(out->FinalizeAndTakeBuffer(), value_bytes);
+}
+
+TEST(AesEncryptor, EncryptDecryptValueList_RoundTrip_BYTE_ARRAY) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    const auto value_bytes = ByteArrayValueBytes(kByteArrayValues);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{value_bytes, kByteArrayValues.size()};
+
+    auto encrypted = encryptor.EncryptValueList(typed_buffer);
+    ASSERT_EQ(encrypted.size(), kVariableHeaderLength + AesEncryptor::kOverheadLength + value_bytes.size());
+    // Lengths stay in the clear after the header and nonce; payloads do not.
+    const size_t records_offset = kVariableHeaderLength + AesEncryptor::kNonceLength;
+    EXPECT_EQ(read_u32_le(encrypted.data() + records_offset), 0u);
+    EXPECT_EQ(read_u32_le(encrypted.data() + records_offset + 4), 1u);
+    EXPECT_NE(encrypted[records_offset + 8], 'a');
+
+    auto decrypted = encryptor.DecryptValueList(encrypted);
+    auto* out = std::get_if<TypedBufferRawBytesVariableSized>(&decrypted);
+    ASSERT_NE(out, nullptr);
+    ASSERT_EQ(out->GetNumElements(), kByteArrayValues.size());
+    for (size_t i = 0; i < kByteArrayValues.size(); ++i) {
+        const auto actual = out->GetElement(i);
+        EXPECT_EQ(std::string(actual.begin(), actual.end()), kByteArrayValues[i]) << "element " << i;
+    }
+}
+
+TEST(AesEncryptor, EncryptDecryptValueList_Empty) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(), 0};
+    auto encrypted = encryptor.EncryptValueList(typed_buffer);
+    ASSERT_EQ(encrypted.size(), kVariableHeaderLength + AesEncryptor::kOverheadLength);
+    auto decrypted = encryptor.DecryptValueList(encrypted);
+    auto* out = std::get_if<TypedBufferRawBytesVariableSized>(&decrypted);
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(out->GetNumElements(), 0u);
+}
+
+TEST(AesEncryptor, EncryptValueListInto_ChecksOutputSize) {
+    auto encryptor = MakeEncryptor(Type::INT64);
+    const auto value_bytes = Int64ValueBytes(10);
+    TypedValuesBuffer typed_buffer = TypedBufferI64{value_bytes, 10};
+
+    const size_t max_size = encryptor.MaxValueListCiphertextSize(value_bytes.size()).value();
+    std::vector<uint8_t> out(max_size);
+    ASSERT_EQ(encryptor.EncryptValueListInto(typed_buffer, out), max_size);
+    auto decrypted = encryptor.DecryptValueList(out);
+    EXPECT_EQ(std::get<TypedBufferI64>(decrypted).FinalizeAndTakeBuffer(), value_bytes);
+
+    std::vector<uint8_t> too_small(max_size - 1);
+    EXPECT_THROW(encryptor.EncryptValueListInto(typed_buffer, too_small), InvalidInputException);
+}
+
+TEST(AesEncryptor, DecryptValueList_RejectsTamperedPages) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    const auto value_bytes = ByteArrayValueBytes(kByteArrayValues);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{value_bytes, kByteArrayValues.size()};
+    const auto encrypted = encryptor.EncryptValueList(typed_buffer);
+
+    // The tag covers the header, the nonce, the length prefixes and the payloads.
+    for (size_t i = 0; i < encrypted.size(); i += 7) {
+        auto tampered = encrypted;
+        tampered[i] ^= 0x01;
+        EXPECT_THROW(encryptor.DecryptValueList(tampered), InvalidInputException) << "byte " << i;
+    }
+    EXPECT_THROW(encryptor.DecryptValueList(std::vector<uint8_t>(encrypted.begin(), encrypted.end() - 1)),
+                 InvalidInputException);
+    auto other_column = MakeEncryptor(Type::BYTE_ARRAY, "other_column");
+    EXPECT_THROW(other_column.DecryptValueList(encrypted), InvalidInputException);
+}
+
+TEST(AesEncryptor, ComputeBlockTag_IsKeyedAndColumnBound) {
+    auto encryptor = MakeEncryptor(Type::INT64);
+    ASSERT_EQ(encryptor.GetBlockTagLength(), AesEncryptor::kBlockTagLength);
+    const std::vector<uint8_t> data = {1, 2, 3, 4, 5};
+    auto tag_of = [&data](AesEncryptor& tagging_encryptor, tcb::span<const uint8_t> bytes) {
+        std::vector<uint8_t> tag(AesEncryptor::kBlockTagLength);
+        tagging_encryptor.ComputeBlockTag(bytes, tag);
+        return tag;
+    };
+
+    const auto tag = tag_of(encryptor, data);
+    EXPECT_EQ(tag_of(encryptor, data), tag);
+    auto modified = data;
+    modified[0] ^= 0x01;
+    EXPECT_NE(tag_of(encryptor, modified), tag);
+    auto other_column = MakeEncryptor(Type::INT64, "other_column");
+    EXPECT_NE(tag_of(other_column, data), tag);
+    AesEncryptor other_key("test_key", "test_column", "test_user", "test_context", Type::INT64, TestKey(0x43));
+    EXPECT_NE(tag_of(other_key, data), tag);
+
+    std::vector<uint8_t> short_tag(AesEncryptor::kBlockTagLength - 1);
+    EXPECT_THROW(encryptor.ComputeBlockTag(data, short_tag), InvalidInputException);
+}
+
+TEST(AesEncryptor, DecryptTrustedValueListInto_MatchesDecryptValueList) {
+    {
+        auto encryptor = MakeEncryptor(Type::INT64);
+        const auto value_bytes = Int64ValueBytes(500);
+        auto encrypted = encryptor.EncryptValueList(TypedBufferI64{value_bytes, 500});
+        std::vector<uint8_t> out(encryptor.MaxValueListPlaintextSize(encrypted.size()).value());
+        ASSERT_GE(out.size(), value_bytes.size());
+        ASSERT_EQ(encryptor.DecryptTrustedValueListInto(encrypted, out), value_bytes.size());
+        EXPECT_TRUE(std::equal(value_bytes.begin(), value_bytes.end(), out.begin()));
+    }
+    {
+        auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+        const auto value_bytes = ByteArrayValueBytes(kByteArrayValues);
+        auto encrypted = encryptor.EncryptValueList(
+            TypedBufferRawBytesVariableSized{value_bytes, kByteArrayValues.size()});
+        std::vector<uint8_t> out(encryptor.MaxValueListPlaintextSize(encrypted.size()).value());
+        ASSERT_EQ(encryptor.DecryptTrustedValueListInto(encrypted, out), value_bytes.size());
+        EXPECT_TRUE(std::equal(value_bytes.begin(), value_bytes.end(), out.begin()));
+
+        // Trusted input is still authenticated.
+        auto tampered = encrypted;
+        tampered[tampered.size() / 2] ^= 0x01;
+        EXPECT_THROW(encryptor.DecryptTrustedValueListInto(tampered, out), InvalidInputException);
+        std::vector<uint8_t> too_small(value_bytes.size() - 1);
+        EXPECT_THROW(encryptor.DecryptTrustedValueListInto(encrypted, too_small), InvalidInputException);
+    }
+}
+
+TEST(AesEncryptor, EncryptColumnarValueListInto_RoundTrip) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    ASSERT_TRUE(encryptor.SupportsColumnarValueList());
+    const auto value_bytes = ByteArrayValueBytes(kByteArrayValues);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{value_bytes, kByteArrayValues.size()};
+
+    const size_t max_size = encryptor.MaxValueListCiphertextSize(value_bytes.size()).value();
+    std::vector<uint8_t> encrypted(max_size);
+    encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, encrypted));
+
+    // The 1000-byte value needs two-byte sizes.
+    auto header = ReadHeader(encrypted);
+    EXPECT_TRUE(header.is_columnar);
+    EXPECT_EQ(header.size_width, 2);
+    EXPECT_EQ(encrypted.size(), kColumnarHeaderLength + AesEncryptor::kOverheadLength + value_bytes.size() -
+                                    2 * kByteArrayValues.size());
+    EXPECT_LE(encrypted.size(), max_size);
+    // Sizes stay in the clear after the header and nonce; payloads do not.
+    const size_t sizes_offset = kColumnarHeaderLength + AesEncryptor::kNonceLength;
+    EXPECT_EQ(encrypted[sizes_offset + 2], 1);
+    const size_t last_payload_offset = encrypted.size() - AesEncryptor::kAuthTagLength - 1000;
+    EXPECT_NE(std::string(encrypted.begin() + last_payload_offset, encrypted.end() - AesEncryptor::kAuthTagLength),
+              kByteArrayValues.back());
+
+    auto decrypted = encryptor.DecryptValueList(encrypted);
+    EXPECT_EQ(std::get<TypedBufferRawBytesVariableSized>(decrypted).FinalizeAndTakeBuffer(), value_bytes);
+
+    std::vector<uint8_t> out(encryptor.MaxValueListPlaintextSize(encrypted.size()).value() +
+                             GetColumnarSizeExpansion(header));
+    out.resize(encryptor.DecryptTrustedValueListInto(encrypted, out));
+    EXPECT_EQ(out, value_bytes);
+
+    std::vector<uint8_t> too_small(encrypted.size() - 1);
+    EXPECT_THROW(encryptor.EncryptColumnarValueListInto(typed_buffer, too_small), InvalidInputException);
+}
+
+TEST(AesEncryptor, EncryptColumnarValueListInto_Empty) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(), 0};
+    std::vector<uint8_t> encrypted(encryptor.MaxValueListCiphertextSize(0).value());
+    encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, encrypted));
+    ASSERT_EQ(encrypted.size(), kColumnarHeaderLength + AesEncryptor::kOverheadLength);
+    auto decrypted = encryptor.DecryptValueList(encrypted);
+    EXPECT_EQ(std::get<TypedBufferRawBytesVariableSized>(decrypted).GetNumElements(), 0u);
+}
+
+TEST(AesEncryptor, DecryptColumnarValueList_RejectsTamperedPages) {
+    auto encryptor = MakeEncryptor(Type::BYTE_ARRAY);
+    const auto value_bytes = ByteArrayValueBytes(kByteArrayValues);
+    TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{value_bytes, kByteArrayValues.size()};
+    std::vector<uint8_t> encrypted(encryptor.MaxValueListCiphertextSize(value_bytes.size()).value());
+    encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, encrypted));
+
+    // The tag covers the header, the nonce, the packed sizes and the payloads.
+    std::vector<uint8_t> out(value_bytes.size());
+    for (size_t i = 0; i < encrypted.size(); i += 7) {
+        auto tampered = encrypted;
+        tampered[i] ^= 0x01;
+        EXPECT_THROW(encryptor.DecryptValueList(tampered), InvalidInputException) << "byte " << i;
+        EXPECT_THROW(encryptor.DecryptTrustedValueListInto(tampered, out), InvalidInputException) << "byte " << i;
+    }
+}
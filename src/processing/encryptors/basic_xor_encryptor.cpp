@@ -17,9 +17,15 @@
 
 #include "basic_xor_encryptor.h"
 #include "encryptor_utils.h"
+#include "../buffer_pool.h"
+#include "../byte_buffer_view.h"
+#include "../work_stealing_thread_pool.h"
 #include "../../common/exceptions.h"
 #include "../../common/enum_utils.h"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace dbps::processing;
 using namespace dbps::external;
 
@@ -35,20 +41,64 @@ void BasicXorEncryptor::XorEncryptInto(tcb::span<const uint8_t> data, tcb::span<
     if (data_size != out_size) {
         throw InvalidInputException("XorEncryptInto: input and output sizes must match");
     }
-    const size_t n = data_size;
-    const uint8_t* src = data.data();
-    uint8_t* dst = out.data();
-    size_t key_hash = key_id_hash_;
-    for (size_t i = 0; i < n; ++i) {
-        dst[i] = src[i] ^ (key_hash & 0xFF);
-        key_hash = (key_hash << 1) | (key_hash >> 31);
-    }
+    key_stream_.Apply(data.data(), out.data(), data_size);
 }
 
 void BasicXorEncryptor::XorDecryptInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
     XorEncryptInto(data, out);
 }
 
+// ---------------------------------------------------------------------------
+// Intra-page parallelism
+//
+// Each element is encrypted independently (the key stream restarts on every element), so a large
+// values buffer can be split into contiguous element ranges that are processed concurrently.
+// XOR keeps the element sizes, so every range writes its outputs in place at their final position:
+// - Encryption copies the input records (length prefixes included) and transforms the payloads in place.
+// - Decryption reserves the variable-size output slots upfront from the ciphertext element sizes.
+// Buffers smaller than parallel_threshold_bytes_ are processed sequentially on the calling thread.
+// ---------------------------------------------------------------------------
+
+namespace {
+    // Ranges per thread. Using more ranges than threads lets work-stealing balance uneven ranges.
+    constexpr size_t kParallelRangesPerThread = 4;
+
+    struct ElementRange {
+        size_t begin;
+        size_t end;
+    };
+
+    ElementRange GetElementRange(size_t range_index, size_t num_ranges, size_t num_elements) {
+        return {range_index * num_elements / num_ranges, (range_index + 1) * num_elements / num_ranges};
+    }
+
+    // Payload sizes of the elements of a read-only variable-size buffer, to reserve a same-sized output.
+    std::vector<size_t> GetElementSizes(const TypedBufferRawBytesVariableSized& buffer) {
+        std::vector<size_t> element_sizes(buffer.GetNumElements());
+        buffer.ForEachBatch([&](size_t first_position, tcb::span<const tcb::span<const uint8_t>> batch) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                element_sizes[first_position + i] = batch[i].size();
+            }
+        });
+        return element_sizes;
+    }
+}
+
+WorkStealingThreadPool& BasicXorEncryptor::GetThreadPool() const {
+    return thread_pool_ != nullptr ? *thread_pool_ : WorkStealingThreadPool::GetSharedPool();
+}
+
+size_t BasicXorEncryptor::GetNumParallelRanges(size_t raw_buffer_size, size_t num_elements) const {
+    if (parallel_threshold_bytes_ == 0 || raw_buffer_size < parallel_threshold_bytes_ || num_elements < 2) {
+        return 1;
+    }
+    const size_t num_threads = GetThreadPool().GetNumThreads();
+    if (num_threads == 0) {
+        return 1;
+    }
+    return std::min(num_elements, (num_threads + 1) * kParallelRangesPerThread);
+}
+
 // ---------------------------------------------------------------------------
 // Block encryption
 // ---------------------------------------------------------------------------
@@ -57,7 +107,8 @@ std::vector<uint8_t> BasicXorEncryptor::EncryptBlock(tcb::span<const uint8_t> da
     if (data.empty()) {
         return {};
     }
-    std::vector<uint8_t> out(data.size());
+    // Fully overwritten below, so recycled memory of the thread's BufferPool is not cleared first.
+    auto out = AcquireUninitializedBuffer(data.size());
     XorEncryptInto(data, tcb::span<uint8_t>(out.data(), out.size()));
     return out;
 }
@@ -66,11 +117,53 @@ std::vector<uint8_t> BasicXorEncryptor::DecryptBlock(tcb::span<const uint8_t> da
     if (data.empty()) {
         return {};
     }
-    std::vector<uint8_t> out(data.size());
+    auto out = AcquireUninitializedBuffer(data.size());
     XorDecryptInto(data, tcb::span<uint8_t>(out.data(), out.size()));
     return out;
 }
 
+size_t BasicXorEncryptor::EncryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+    if (out.size() < data.size()) {
+        throw InvalidInputException("EncryptBlockInto: output buffer is smaller than the input");
+    }
+    XorEncryptInto(data, out.first(data.size()));
+    return data.size();
+}
+
+size_t BasicXorEncryptor::EncryptSegmentedBlockInto(const SegmentedBytes& data, tcb::span<uint8_t> out) {
+    if (out.size() < data.size()) {
+        throw InvalidInputException("EncryptSegmentedBlockInto: output buffer is smaller than the input");
+    }
+    // The key stream position is the number of bytes written so far.
+    size_t written = 0;
+    data.ForEachSegment([&](tcb::span<const uint8_t> segment) {
+        written = key_stream_.Apply(segment.data(), out.data() + written, segment.size(), written);
+    });
+    return written;
+}
+
+size_t BasicXorEncryptor::DecryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+    if (out.size() < data.size()) {
+        throw InvalidInputException("DecryptBlockInto: output buffer is smaller than the input");
+    }
+    XorDecryptInto(data, out.first(data.size()));
+    return data.size();
+}
+
+std::optional<size_t> BasicXorEncryptor::MaxBlockCiphertextSize(size_t plaintext_size) const {
+    return plaintext_size;
+}
+
+std::optional<size_t> BasicXorEncryptor::MaxBlockPlaintextSize(size_t ciphertext_size) const {
+    return ciphertext_size;
+}
+
+std::optional<size_t> BasicXorEncryptor::MaxValueListCiphertextSize(size_t value_bytes_size) const {
+    // Fixed-size elements are stored as-is after the header. Variable-size elements keep a 4-byte length
+    // prefix each, same as PLAIN BYTE_ARRAY values. The fixed-size header is the larger one.
+    return kFixedHeaderLength + value_bytes_size;
+}
+
 // ---------------------------------------------------------------------------
 // Value-level encryption  (TypedValuesBuffer in -> bytes out)
 //
@@ -101,67 +194,66 @@ std::vector<uint8_t> BasicXorEncryptor::DecryptBlock(tcb::span<const uint8_t> da
 // ---------------------------------------------------------------------------
 
 template <typename TypedBuffer>
-std::vector<uint8_t> BasicXorEncryptor::EncryptTypedElements(
-    const TypedBuffer& input_buffer) {
+size_t BasicXorEncryptor::EncryptTypedElementsInto(
+    const TypedBuffer& input_buffer, tcb::span<uint8_t> out) {
     constexpr bool is_fixed = TypedBuffer::is_fixed_sized;
     constexpr size_t prefix_length = is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
     const size_t num_elements = input_buffer.GetNumElements();
 
-    // If there are no elements, return an empty buffer with the header.
+    // The ciphertext keeps the input layout behind the header: contiguous elements for fixed-size types,
+    // length-prefixed elements for variable-size types.
+    const size_t records_size = input_buffer.GetRecordsSize();
+    const size_t output_size = prefix_length + records_size;
+    if (out.size() < output_size) {
+        throw InvalidInputException(
+            "EncryptValueListInto: output buffer too small: " + std::to_string(output_size) +
+            " bytes required, " + std::to_string(out.size()) + " bytes provided");
+    }
+    // The element size stays 0 in the header of an empty list.
+    const size_t element_size = (is_fixed && num_elements > 0) ? input_buffer.GetElementSize() : 0;
+    WriteHeader(out, {is_fixed, static_cast<uint32_t>(num_elements), static_cast<uint32_t>(element_size)});
     if (num_elements == 0) {
-        std::vector<uint8_t> result(prefix_length);
-        WriteHeader(result, {is_fixed, 0, 0});
-        return result;
+        return output_size;
     }
 
-    // Encrypt the elements by traversing the typed input buffer and encrypt each element separately:
-    // - Create an output raw-bytes buffer to capture the encrypted elements as bytes.
-    // - For each element: read its raw bytes, get a writable span on the output, and encrypt in-place.
-    // - Finalize the output buffer into a contiguous byte vector.
-
-    std::vector<uint8_t> final_buffer;
-    size_t element_size = 0;
-
-    // Encrypt fixed-size elements
-    if constexpr (is_fixed) {
-        element_size = input_buffer.GetElementSize();
-        TypedBufferRawBytesFixedSized output_buffer{
-            num_elements, prefix_length, RawBytesFixedSizedCodec{element_size}};
-
-        size_t output_index = 0;
-        tcb::span<const uint8_t> raw_bytes;
-        
-        while (input_buffer.ElementsIteratorNext(raw_bytes)) {
-            auto write_span = output_buffer.GetWritableRawElement(output_index, element_size);
-            XorEncryptInto(raw_bytes, write_span);
-            output_index++;
+    // Encrypt the elements by transforming the payloads of the input records into the output records:
+    // - Fixed-size records are all payload, so each run of elements is encrypted in one kernel call.
+    // - Variable-size records are copied in one bulk operation, length prefixes included, and each payload is
+    //   then encrypted in place.
+    // Large buffers are split into element ranges; each range writes its own outputs at their final position.
+    auto records_out = out.subspan(prefix_length, records_size);
+    if constexpr (!is_fixed) {
+        input_buffer.CopyRecordsInto(records_out);
+    }
+    auto encrypt_kernel = [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> encrypted) {
+        if constexpr (is_fixed) {
+            // The key stream restarts on every element.
+            key_stream_.ApplyPerElement(in.data(), encrypted.data(), in.size() / element_size, element_size);
+        } else {
+            XorEncryptInto(in, encrypted);
         }
-        final_buffer = output_buffer.FinalizeAndTakeBuffer();
-    }   
-    
-    // Encrypt variable-size elements
-    else {
-        auto reserved_bytes_hint = input_buffer.GetRawBufferSize();
-        TypedBufferRawBytesVariableSized output_buffer{
-            num_elements, reserved_bytes_hint, true, prefix_length};
+    };
 
-        size_t output_index = 0;
-        tcb::span<const uint8_t> raw_bytes;
-        
-        while (input_buffer.ElementsIteratorNext(raw_bytes)) {
-            auto write_span = output_buffer.GetWritableRawElement(output_index, raw_bytes.size());
-            XorEncryptInto(raw_bytes, write_span);
-            output_index++;
-        }
-        final_buffer = output_buffer.FinalizeAndTakeBuffer();
+    const size_t num_ranges = GetNumParallelRanges(input_buffer.GetRawBufferSize(), num_elements);
+    if (num_ranges > 1) {
+        input_buffer.PrepareForConcurrentReads();
+        GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+            auto range = GetElementRange(range_index, num_ranges, num_elements);
+            input_buffer.TransformPayloadsInto(records_out, range.begin, range.end, encrypt_kernel);
+        });
+    } else {
+        input_buffer.TransformPayloadsInto(records_out, 0, num_elements, encrypt_kernel);
     }
+    return output_size;
+}
 
-    // Write the header to the final buffer and return it.
-    WriteHeader(final_buffer, {is_fixed,
-        static_cast<uint32_t>(num_elements),
-        static_cast<uint32_t>(element_size)});
-
-    return final_buffer;
+template <typename TypedBuffer>
+std::vector<uint8_t> BasicXorEncryptor::EncryptTypedElements(
+    const TypedBuffer& input_buffer) {
+    constexpr size_t prefix_length = TypedBuffer::is_fixed_sized ? kFixedHeaderLength : kVariableHeaderLength;
+    std::vector<uint8_t> result = AcquireUninitializedBuffer(prefix_length + input_buffer.GetRecordsSize());
+    EncryptTypedElementsInto(input_buffer, result);
+    return result;
 }
 
 std::vector<uint8_t> BasicXorEncryptor::EncryptValueList(
@@ -184,6 +276,103 @@ std::vector<uint8_t> BasicXorEncryptor::EncryptValueList(
     }, typed_buffer);
 }
 
+size_t BasicXorEncryptor::EncryptValueListInto(
+    const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) {
+    return std::visit([&](const auto& input_buffer) {
+        return EncryptTypedElementsInto(input_buffer, out);
+    }, typed_buffer);
+}
+
+size_t BasicXorEncryptor::EncryptDeduplicatedValueListInto(
+    const TypedValuesBuffer& distinct_values, tcb::span<const uint32_t> indices, tcb::span<uint8_t> out) {
+    return std::visit([&](const auto& input_buffer) -> size_t {
+        constexpr bool is_fixed = std::decay_t<decltype(input_buffer)>::is_fixed_sized;
+        constexpr size_t prefix_length = is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
+        const size_t num_distinct = input_buffer.GetNumElements();
+
+        // The distinct ciphertext records are laid out like their plaintext records behind the header.
+        auto distinct_ciphertext = EncryptTypedElements(input_buffer);
+        auto records = tcb::span<const uint8_t>(distinct_ciphertext).subspan(prefix_length);
+        std::vector<size_t> record_offsets(num_distinct + 1);
+        if constexpr (is_fixed) {
+            const size_t element_size = num_distinct > 0 ? input_buffer.GetElementSize() : 0;
+            for (size_t i = 0; i <= num_distinct; ++i) {
+                record_offsets[i] = i * element_size;
+            }
+        } else {
+            for (size_t i = 0; i < num_distinct; ++i) {
+                record_offsets[i + 1] =
+                    record_offsets[i] + ::kSizePrefixBytes + read_u32_le(records, record_offsets[i]);
+            }
+        }
+
+        size_t output_size = prefix_length;
+        for (uint32_t index : indices) {
+            if (index >= num_distinct) {
+                throw InvalidInputException("EncryptDeduplicatedValueListInto: index " + std::to_string(index) +
+                                            " out of range of " + std::to_string(num_distinct) + " distinct values");
+            }
+            output_size += record_offsets[index + 1] - record_offsets[index];
+        }
+        if (out.size() < output_size) {
+            throw InvalidInputException(
+                "EncryptDeduplicatedValueListInto: output buffer too small: " + std::to_string(output_size) +
+                " bytes required, " + std::to_string(out.size()) + " bytes provided");
+        }
+
+        const size_t element_size = (is_fixed && !indices.empty()) ? record_offsets[1] : 0;
+        WriteHeader(out, {is_fixed, static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(element_size)});
+        uint8_t* record_out = out.data() + prefix_length;
+        for (uint32_t index : indices) {
+            const size_t record_size = record_offsets[index + 1] - record_offsets[index];
+            std::memcpy(record_out, records.data() + record_offsets[index], record_size);
+            record_out += record_size;
+        }
+        ReleaseBuffer(std::move(distinct_ciphertext));
+        return output_size;
+    }, distinct_values);
+}
+
+// ---------------------------------------------------------------------------
+// Columnar value-level encryption
+//
+// Output layout for variable-size elements (see encryptor_utils.h):
+//   [0x02][uint32 count][uint8 size_width] <packed sizes> <encrypted payloads back to back>
+// The payload region is XORed with the key stream as one range, from its first byte: unlike the records
+// layout, the key stream does not restart on every element. Large regions are split into byte ranges, each
+// starting at its own key stream position.
+// ---------------------------------------------------------------------------
+
+size_t BasicXorEncryptor::EncryptColumnarValuesInto(const ByteArrayOffsetsBuffer& values, tcb::span<uint8_t> out) {
+    const size_t num_elements = values.GetNumElements();
+    const auto payloads = values.GetData();
+    const auto value_sizes = GetValueSizes(values);
+    const uint8_t size_width = GetSizeWidth(value_sizes);
+    const size_t payloads_offset = kColumnarHeaderLength + num_elements * size_width;
+    const size_t output_size = payloads_offset + payloads.size();
+    if (out.size() < output_size) {
+        throw InvalidInputException(
+            "EncryptColumnarValuesInto: output buffer too small: " + std::to_string(output_size) +
+            " bytes required, " + std::to_string(out.size()) + " bytes provided");
+    }
+    WriteHeader(out, {false, static_cast<uint32_t>(num_elements), 0, true, size_width});
+    WritePackedValueSizes(out.subspan(kColumnarHeaderLength), value_sizes, size_width);
+    XorPayloadRegionInto(payloads, out.data() + payloads_offset);
+    return output_size;
+}
+
+void BasicXorEncryptor::XorPayloadRegionInto(tcb::span<const uint8_t> payloads, uint8_t* out) {
+    const size_t num_ranges = GetNumParallelRanges(payloads.size(), payloads.size());
+    if (num_ranges <= 1) {
+        key_stream_.Apply(payloads.data(), out, payloads.size());
+        return;
+    }
+    GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+        auto range = GetElementRange(range_index, num_ranges, payloads.size());
+        key_stream_.Apply(payloads.data() + range.begin, out + range.begin, range.end - range.begin, range.begin);
+    });
+}
+
 // ---------------------------------------------------------------------------
 // Value-level decryption  (bytes in -> TypedValuesBuffer out)
 //
@@ -195,14 +384,60 @@ std::vector<uint8_t> BasicXorEncryptor::EncryptValueList(
 template <typename TypedBuffer>
 TypedBuffer BasicXorEncryptor::DecryptFixedSizedElementsIntoTypedBuffer(
     const TypedBufferRawBytesFixedSized& encrypted_buffer, TypedBuffer output_buffer) {
-    size_t output_index = 0;
-    tcb::span<const uint8_t> element_bytes;
     size_t element_size = encrypted_buffer.GetElementSize();
-    while (encrypted_buffer.ElementsIteratorNext(element_bytes)) {
-        auto write_span = output_buffer.GetWritableRawElement(output_index, element_size);
-        XorDecryptInto(element_bytes, write_span);
-        output_index++;
+    const size_t num_elements = encrypted_buffer.GetNumElements();
+    const size_t num_ranges = GetNumParallelRanges(encrypted_buffer.GetRawBufferSize(), num_elements);
+
+    if (num_ranges > 1) {
+        // Each range reads the shared view with its own cursor.
+        const ByteBufferView<RawBytesFixedSizedCodec> encrypted_view(encrypted_buffer);
+        GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+            auto range = GetElementRange(range_index, num_ranges, num_elements);
+            auto cursor = encrypted_view.GetCursor(range.begin, range.end);
+            tcb::span<const uint8_t> element_bytes;
+            for (size_t i = range.begin; cursor.NextRaw(element_bytes); ++i) {
+                auto write_span = output_buffer.GetWritableRawElement(i, element_size);
+                XorDecryptInto(element_bytes, write_span);
+            }
+        });
+        return output_buffer;
+    }
+
+    encrypted_buffer.TransformInto(output_buffer, [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        key_stream_.ApplyPerElement(in.data(), out.data(), in.size() / element_size, element_size);
+    });
+    return output_buffer;
+}
+
+// Helper function to decrypt variable-size elements into a BYTE_ARRAY typed buffer.
+TypedBufferRawBytesVariableSized BasicXorEncryptor::DecryptVariableSizedElements(
+    const TypedBufferRawBytesVariableSized& encrypted_buffer) {
+    const size_t num_elements = encrypted_buffer.GetNumElements();
+    const size_t num_ranges = GetNumParallelRanges(encrypted_buffer.GetRawBufferSize(), num_elements);
+
+    if (num_ranges > 1) {
+        // Ciphertexts have the plaintext sizes, so the output slots are reserved upfront and each range
+        // fills its own slots in place, reading the shared view with its own cursor.
+        const ByteBufferView<RawBytesVariableSizedCodec> encrypted_view(encrypted_buffer);
+        TypedBufferRawBytesVariableSized output_buffer{num_elements, encrypted_buffer.GetRawBufferSize(), true};
+        output_buffer.ReserveElementSizes(GetElementSizes(encrypted_buffer));
+        GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+            auto range = GetElementRange(range_index, num_ranges, num_elements);
+            auto cursor = encrypted_view.GetCursor(range.begin, range.end);
+            tcb::span<const uint8_t> element_bytes;
+            for (size_t i = range.begin; cursor.NextRaw(element_bytes); ++i) {
+                auto write_span = output_buffer.GetWritableRawElement(i, element_bytes.size());
+                XorDecryptInto(element_bytes, write_span);
+            }
+        });
+        return output_buffer;
     }
+
+    auto reserved_bytes_hint = encrypted_buffer.GetRawBufferSize();
+    TypedBufferRawBytesVariableSized output_buffer{num_elements, reserved_bytes_hint, true};
+    encrypted_buffer.TransformInto(output_buffer, [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        XorDecryptInto(in, out);
+    });
     return output_buffer;
 }
 
@@ -247,6 +482,19 @@ TypedValuesBuffer BasicXorEncryptor::DecryptValueList(
         }
     } 
     
+    // Decrypt columnar variable-size elements into PLAIN records, handed over to the typed buffer as-is.
+    else if (header.is_columnar) {
+        if (datatype_ != Type::BYTE_ARRAY) {
+            throw InvalidInputException(
+                std::string("DecryptValueList: unsupported variable-size datatype: ")
+                + std::string(dbps::enum_utils::to_string(datatype_)));
+        }
+        const auto value_list = ReadColumnarValueList(header, encrypted_bytes.subspan(kColumnarHeaderLength));
+        std::vector<uint8_t> value_bytes = AcquireUninitializedBuffer(value_list.GetPlainSize());
+        DecryptColumnarValueListInto(value_list, value_bytes);
+        return TypedBufferRawBytesVariableSized::FromSerializedBuffer(std::move(value_bytes), num_elements);
+    }
+
     // Decrypt variable-size elements
     else {
         // Create a variable-sized byte buffer for reading the encrypted elements.
@@ -254,18 +502,8 @@ TypedValuesBuffer BasicXorEncryptor::DecryptValueList(
 
         switch (datatype_) {
             // Create a BYTE-ARRAY typed buffer for storing the decrypted elements.
-            case Type::BYTE_ARRAY: {
-                auto reserved_bytes_hint = encrypted_buffer.GetRawBufferSize();
-                TypedBufferRawBytesVariableSized output_buffer{num_elements, reserved_bytes_hint, true};
-                size_t output_index = 0;
-                tcb::span<const uint8_t> element_bytes;
-                while (encrypted_buffer.ElementsIteratorNext(element_bytes)) {
-                    auto write_span = output_buffer.GetWritableRawElement(output_index, element_bytes.size());
-                    XorDecryptInto(element_bytes, write_span);
-                    output_index++;
-                }   
-                return output_buffer;
-            }
+            case Type::BYTE_ARRAY:
+                return DecryptVariableSizedElements(encrypted_buffer);
             default:
                 throw InvalidInputException(
                     std::string("DecryptValueList: unsupported variable-size datatype: ")
@@ -273,3 +511,122 @@ TypedValuesBuffer BasicXorEncryptor::DecryptValueList(
         }
     }
 }
+
+// ---------------------------------------------------------------------------
+// Trusted value-level decryption  (bytes in -> PLAIN value bytes out)
+//
+// Ciphertexts keep the PLAIN layout of the values behind their header, so trusted input is decrypted straight
+// into the output in a single pass: fixed-size elements run by run, variable-size elements record by record,
+// copying each length prefix and decrypting its payload. Unlike DecryptValueList, no typed buffer or element
+// index is built, and the element count is not checked against the payload size. Every length that is read is
+// still checked against the input, and the output is checked once upfront.
+// ---------------------------------------------------------------------------
+
+namespace {
+    // End offset of the [u32 size][payload] record starting at `cursor` in records[0, size).
+    size_t GetTrustedRecordEnd(const uint8_t* records, size_t size, size_t cursor) {
+        if (size - cursor < ::kSizePrefixBytes) {
+            throw InvalidInputException("DecryptTrustedValueListInto: truncated length prefix");
+        }
+        const size_t payload_size = read_u32_le(records + cursor);
+        if (size - cursor - ::kSizePrefixBytes < payload_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: truncated element payload");
+        }
+        return cursor + ::kSizePrefixBytes + payload_size;
+    }
+}
+
+std::optional<size_t> BasicXorEncryptor::MaxValueListPlaintextSize(size_t ciphertext_size) const {
+    // The values follow a header of at least kVariableHeaderLength bytes and keep their sizes.
+    return ciphertext_size > kVariableHeaderLength ? ciphertext_size - kVariableHeaderLength : 0;
+}
+
+size_t BasicXorEncryptor::DecryptTrustedValueListInto(
+    tcb::span<const uint8_t> encrypted_bytes, tcb::span<uint8_t> out) {
+    auto header = ReadHeader(encrypted_bytes);
+    const size_t num_elements = static_cast<size_t>(header.num_elements);
+
+    if (header.is_fixed) {
+        const size_t element_size = static_cast<size_t>(header.element_size);
+        const auto payload = encrypted_bytes.subspan(kFixedHeaderLength);
+        if (element_size == 0 || num_elements > payload.size() / element_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: fixed-size elements overrun the input");
+        }
+        const size_t payload_size = num_elements * element_size;
+        if (out.size() < payload_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+        }
+        auto decrypt_elements = [&](size_t begin, size_t end) {
+            key_stream_.ApplyPerElement(payload.data() + begin * element_size, out.data() + begin * element_size,
+                                        end - begin, element_size);
+        };
+        const size_t num_ranges = GetNumParallelRanges(payload_size, num_elements);
+        if (num_ranges > 1) {
+            GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+                auto range = GetElementRange(range_index, num_ranges, num_elements);
+                decrypt_elements(range.begin, range.end);
+            });
+        } else {
+            decrypt_elements(0, num_elements);
+        }
+        return payload_size;
+    }
+
+    if (header.is_columnar) {
+        const auto value_list = ReadColumnarValueList(header, encrypted_bytes.subspan(kColumnarHeaderLength));
+        const size_t plain_size = value_list.GetPlainSize();
+        if (out.size() < plain_size) {
+            throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+        }
+        DecryptColumnarValueListInto(value_list, out.first(plain_size));
+        return plain_size;
+    }
+
+    const auto records = encrypted_bytes.subspan(kVariableHeaderLength);
+    const uint8_t* in = records.data();
+    const size_t records_size = records.size();
+    if (out.size() < records_size) {
+        throw InvalidInputException("DecryptTrustedValueListInto: output buffer is smaller than the values");
+    }
+
+    // Decrypts `count` records starting at `cursor`, at the same offsets in out. Returns the end offset.
+    auto decrypt_records = [&](size_t cursor, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const size_t record_end = GetTrustedRecordEnd(in, records_size, cursor);
+            std::memcpy(out.data() + cursor, in + cursor, ::kSizePrefixBytes);
+            cursor += ::kSizePrefixBytes;
+            key_stream_.Apply(in + cursor, out.data() + cursor, record_end - cursor);
+            cursor = record_end;
+        }
+        return cursor;
+    };
+
+    const size_t num_ranges = GetNumParallelRanges(records_size, num_elements);
+    if (num_ranges <= 1) {
+        return decrypt_records(0, num_elements);
+    }
+
+    // Ranges need their start offsets: one walk over the length prefixes finds them, skipping the payloads.
+    std::vector<size_t> range_starts(num_ranges);
+    size_t cursor = 0;
+    for (size_t range_index = 0; range_index < num_ranges; ++range_index) {
+        range_starts[range_index] = cursor;
+        auto range = GetElementRange(range_index, num_ranges, num_elements);
+        for (size_t i = range.begin; i < range.end; ++i) {
+            cursor = GetTrustedRecordEnd(in, records_size, cursor);
+        }
+    }
+    GetThreadPool().ParallelFor(num_ranges, [&](size_t range_index) {
+        auto range = GetElementRange(range_index, num_ranges, num_elements);
+        decrypt_records(range_starts[range_index], range.end - range.begin);
+    });
+    return cursor;
+}
+
+// Columnar value lists decrypt into PLAIN records: the payload region is decrypted into the tail of out, then
+// the payloads are moved forward to their records.
+void BasicXorEncryptor::DecryptColumnarValueListInto(const ColumnarValueList& value_list, tcb::span<uint8_t> out) {
+    const size_t prefixes_size = value_list.value_sizes.size() * ::kSizePrefixBytes;
+    XorPayloadRegionInto(value_list.payloads, out.data() + prefixes_size);
+    ExpandColumnarPayloadsIntoRecords(value_list.value_sizes, out);
+}
@@ -18,6 +18,12 @@
 #pragma once
 
 #include "dbps_encryptor.h"
+#include "xor_kernels.h"
+
+namespace dbps::processing {
+    class WorkStealingThreadPool;
+    struct ColumnarValueList;
+}
 
 using namespace dbps::processing;
 
@@ -26,6 +32,8 @@ using namespace dbps::processing;
  * 
  * This implementation provides:
  * - Block encryption/decryption using XOR with key_id hash (same as current encryption_sequencer)
+ * - A key stream precomputed per key and XORed with SIMD kernels selected at runtime (see XorKeyStream)
+ * - Value encryption/decryption, split into element ranges processed on a thread pool for large buffers
  * 
  * This is a simple, default encryption implementation that can be replaced with more
  * sophisticated encryption providers (e.g., Protegrity) in the future.
@@ -41,15 +49,27 @@ public:
      * @param application_context Additional application context information
      * @param datatype The data type of the column being encrypted/decrypted. 
      *    It is needed for correct type specific parsing during the DecryptValueList call.
+     * @param parallel_threshold_bytes Minimum size of a values buffer for EncryptValueList/DecryptValueList
+     *    to split it into element ranges processed in parallel. 0 disables intra-page parallelism.
+     * @param thread_pool Thread pool for the parallel ranges. If null, the process-wide shared pool is used.
+     *    The pool is not owned and must outlive the encryptor.
      */
     BasicXorEncryptor(
         const std::string& key_id,
         const std::string& column_name,
         const std::string& user_id,
         const std::string& application_context,
-        dbps::external::Type::type datatype)
+        dbps::external::Type::type datatype,
+        size_t parallel_threshold_bytes = kDefaultParallelThresholdBytes,
+        WorkStealingThreadPool* thread_pool = nullptr)
         : DBPSEncryptor(key_id, column_name, user_id, application_context, datatype),
-          key_id_hash_(std::hash<std::string>{}(key_id)) {}
+          key_id_hash_(std::hash<std::string>{}(key_id)),
+          key_stream_(key_id_hash_),
+          parallel_threshold_bytes_(parallel_threshold_bytes),
+          thread_pool_(thread_pool) {}
+
+    // Below this size, splitting a values buffer costs more in task dispatch than it saves.
+    static constexpr size_t kDefaultParallelThresholdBytes = 1024 * 1024;
 
     ~BasicXorEncryptor() override = default;
 
@@ -58,13 +78,72 @@ public:
 
     std::vector<uint8_t> DecryptBlock(tcb::span<const uint8_t> data) override;
 
+    // XOR is length-preserving, so blocks are encrypted/decrypted directly into the caller's buffer.
+    size_t EncryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) override;
+
+    size_t DecryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) override;
+
+    // The key stream carries over segment boundaries, so segmented blocks are encrypted without gathering them.
+    size_t EncryptSegmentedBlockInto(const SegmentedBytes& data, tcb::span<uint8_t> out) override;
+
+    // Output size bounds
+    std::optional<size_t> MaxBlockCiphertextSize(size_t plaintext_size) const override;
+
+    std::optional<size_t> MaxBlockPlaintextSize(size_t ciphertext_size) const override;
+
+    std::optional<size_t> MaxValueListCiphertextSize(size_t value_bytes_size) const override;
+
+    std::optional<size_t> MaxValueListPlaintextSize(size_t ciphertext_size) const override;
+
     // Value encryption methods
     std::vector<uint8_t> EncryptValueList(const TypedValuesBuffer& typed_buffer) override;
 
+    // XOR keeps each value's size, so value lists are encrypted directly into the caller's buffer too.
+    size_t EncryptValueListInto(const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) override;
+
+    bool IsLengthPreserving() const override {
+        return true;
+    }
+
+    // All state is set at construction, and parallel ranges run on a pool that takes concurrent ParallelFor calls.
+    bool IsThreadSafe() const override {
+        return true;
+    }
+
+    // Every value is XORed with the key stream from its first byte, so equal values have equal ciphertexts.
+    bool IsValueEncryptionDeterministic() const override {
+        return true;
+    }
+
+    size_t EncryptDeduplicatedValueListInto(
+        const TypedValuesBuffer& distinct_values,
+        tcb::span<const uint32_t> indices,
+        tcb::span<uint8_t> out) override;
+
+    bool SupportsColumnarValueList() const override {
+        return true;
+    }
+
+    // The payload region is XORed as one key stream range, so the kernel runs over all payload bytes at once.
+    size_t EncryptColumnarValuesInto(const ByteArrayOffsetsBuffer& values, tcb::span<uint8_t> out) override;
+
     TypedValuesBuffer DecryptValueList(tcb::span<const uint8_t> encrypted_bytes) override;
 
+    // Single pass over the ciphertext records, decrypting them straight into out.
+    size_t DecryptTrustedValueListInto(tcb::span<const uint8_t> encrypted_bytes, tcb::span<uint8_t> out) override;
+
 private:
     const size_t key_id_hash_;
+    const XorKeyStream key_stream_;
+
+    // Settings for intra-page parallelism of the value encryption/decryption.
+    const size_t parallel_threshold_bytes_;
+    WorkStealingThreadPool* const thread_pool_;
+
+    WorkStealingThreadPool& GetThreadPool() const;
+
+    // Number of element ranges to split a values buffer into. 1 means the buffer is processed sequentially.
+    size_t GetNumParallelRanges(size_t raw_buffer_size, size_t num_elements) const;
 
     void XorEncryptInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out);
     void XorDecryptInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out);
@@ -72,9 +151,21 @@ private:
     template <typename InputBuffer>
     std::vector<uint8_t> EncryptTypedElements(const InputBuffer& input_buffer);
 
+    template <typename InputBuffer>
+    size_t EncryptTypedElementsInto(const InputBuffer& input_buffer, tcb::span<uint8_t> out);
+
     template <typename TypedBuffer>
     TypedBuffer DecryptFixedSizedElementsIntoTypedBuffer(
         const TypedBufferRawBytesFixedSized& encrypted_buffer,
         TypedBuffer output_buffer);
+
+    TypedBufferRawBytesVariableSized DecryptVariableSizedElements(
+        const TypedBufferRawBytesVariableSized& encrypted_buffer);
+
+    // XORs a columnar payload region into out, which holds payloads.size() bytes.
+    void XorPayloadRegionInto(tcb::span<const uint8_t> payloads, uint8_t* out);
+
+    // Decrypts a columnar value list into PLAIN value bytes. out holds exactly value_list.GetPlainSize() bytes.
+    void DecryptColumnarValueListInto(const ColumnarValueList& value_list, tcb::span<uint8_t> out);
 };
 
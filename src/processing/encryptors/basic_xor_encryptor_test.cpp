@@ -16,11 +16,14 @@
 // under the License.
 
 #include "basic_xor_encryptor.h"
+#include "encryptor_utils.h"
+#include "../work_stealing_thread_pool.h"
 #include "../../common/enums.h"
 #include "../../common/exceptions.h"
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace dbps::external;
@@ -57,6 +60,99 @@ TEST(BasicXorEncryptor, EncryptBlock_DifferentKeys) {
     EXPECT_NE(encrypted1, encrypted2);
 }
 
+TEST(BasicXorEncryptor, EncryptDecryptBlockInto_MatchesBlockMethods) {
+    BasicXorEncryptor encryptor("test_key", "test_column", "test_user", "test_context", Type::BYTE_ARRAY);
+
+    std::vector<uint8_t> original = {1, 2, 3, 4, 5, 10, 20, 30, 40, 50};
+    ASSERT_EQ(encryptor.MaxBlockCiphertextSize(original.size()), std::optional<size_t>(original.size()));
+
+    // A larger output buffer is allowed; only the written prefix holds the ciphertext.
+    std::vector<uint8_t> encrypted(original.size() + 4, 0xEE);
+    ASSERT_EQ(encryptor.EncryptBlockInto(original, encrypted), original.size());
+    EXPECT_EQ(std::vector<uint8_t>(encrypted.begin(), encrypted.begin() + original.size()),
+              encryptor.EncryptBlock(original));
+    EXPECT_EQ(encrypted.back(), 0xEE);
+
+    std::vector<uint8_t> decrypted(original.size());
+    ASSERT_EQ(encryptor.DecryptBlockInto(
+        tcb::span<const uint8_t>(encrypted.data(), original.size()), decrypted), original.size());
+    EXPECT_EQ(decrypted, original);
+
+    std::vector<uint8_t> too_small(original.size() - 1);
+    EXPECT_THROW(encryptor.EncryptBlockInto(original, too_small), InvalidInputException);
+}
+
+TEST(BasicXorEncryptor, EncryptSegmentedBlockInto_MatchesEncryptBlock) {
+    BasicXorEncryptor encryptor("test_key", "test_column", "test_user", "test_context", Type::BYTE_ARRAY);
+
+    std::vector<uint8_t> original(37);
+    for (size_t i = 0; i < original.size(); ++i) {
+        original[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    const auto expected = encryptor.EncryptBlock(original);
+
+    // The keystream carries over segment boundaries, including empty segments.
+    const tcb::span<const uint8_t> all(original);
+    const std::vector<tcb::span<const uint8_t>> segments = {
+        all.first(5), {}, all.subspan(5, 1), all.subspan(6, 20), all.subspan(26)};
+    std::vector<uint8_t> encrypted(original.size());
+    ASSERT_EQ(encryptor.EncryptSegmentedBlockInto(SegmentedBytes(segments), encrypted), original.size());
+    EXPECT_EQ(encrypted, expected);
+
+    std::vector<uint8_t> too_small(original.size() - 1);
+    EXPECT_THROW(encryptor.EncryptSegmentedBlockInto(SegmentedBytes(segments), too_small), InvalidInputException);
+}
+
+TEST(BasicXorEncryptor, MaxValueListCiphertextSize_BoundsOutput) {
+    BasicXorEncryptor encryptor("test_key", "test_column", "test_user", "test_context", Type::BYTE_ARRAY);
+
+    std::vector<uint8_t> value_bytes;
+    for (const std::string value : {"a", "bcd", ""}) {
+        append_u32_le(value_bytes, static_cast<uint32_t>(value.size()));
+        value_bytes.insert(value_bytes.end(), value.begin(), value.end());
+    }
+    auto encrypted = encryptor.EncryptValueList(TypedBufferRawBytesVariableSized{
+        tcb::span<const uint8_t>(value_bytes.data(), value_bytes.size()), 3});
+    auto max_size = encryptor.MaxValueListCiphertextSize(value_bytes.size());
+    ASSERT_TRUE(max_size.has_value());
+    EXPECT_LE(encrypted.size(), max_size.value());
+}
+
+TEST(BasicXorEncryptor, EncryptValueListInto_MatchesEncryptValueList) {
+    BasicXorEncryptor encryptor("test_key", "test_column", "test_user", "test_context", Type::BYTE_ARRAY);
+    EXPECT_TRUE(encryptor.IsLengthPreserving());
+
+    std::vector<uint8_t> value_bytes;
+    for (const std::string value : {"a", "bcd", "", "efgh"}) {
+        append_u32_le(value_bytes, static_cast<uint32_t>(value.size()));
+        value_bytes.insert(value_bytes.end(), value.begin(), value.end());
+    }
+    TypedValuesBuffer variable_values = TypedBufferRawBytesVariableSized{
+        tcb::span<const uint8_t>(value_bytes.data(), value_bytes.size()), 4};
+    TypedValuesBuffer fixed_values = TypedBufferRawBytesFixedSized{
+        tcb::span<const uint8_t>(value_bytes.data(), 12), 3, 0, RawBytesFixedSizedCodec{4}};
+    TypedValuesBuffer empty_values = TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(), 0};
+
+    for (const auto* values : {&variable_values, &fixed_values, &empty_values}) {
+        auto expected = encryptor.EncryptValueList(*values);
+        auto max_size = encryptor.MaxValueListCiphertextSize(value_bytes.size());
+        ASSERT_TRUE(max_size.has_value());
+        std::vector<uint8_t> out(max_size.value(), 0xEE);
+        const size_t written = encryptor.EncryptValueListInto(*values, out);
+        ASSERT_EQ(written, expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+
+        std::vector<uint8_t> short_out(expected.size() - 1);
+        EXPECT_THROW(encryptor.EncryptValueListInto(*values, short_out), InvalidInputException);
+    }
+
+    // Variable-size ciphertexts keep the plaintext length prefixes behind the header.
+    auto encrypted = encryptor.EncryptValueList(variable_values);
+    ASSERT_EQ(encrypted.size(), kVariableHeaderLength + value_bytes.size());
+    EXPECT_EQ(read_u32_le(encrypted.data() + kVariableHeaderLength), 1u);
+    EXPECT_EQ(read_u32_le(encrypted.data() + kVariableHeaderLength + 5), 3u);
+}
+
 TEST(BasicXorEncryptor, EncryptDecryptValueList_RoundTrip_INT32) {
     BasicXorEncryptor encryptor("test_key", "int32_column", "test_user", "test_context", Type::INT32);
     
@@ -166,3 +262,306 @@ TEST(BasicXorEncryptor, EncryptDecryptValueList_RoundTrip_BYTE_ARRAY) {
         EXPECT_TRUE(std::equal(expected_span.begin(), expected_span.end(), actual.begin()));
     }
 }
+
+// ---------------------------------------------------------------------------
+// Intra-page parallelism: a threshold of 1 byte forces the parallel path on small buffers,
+// and the results must match the sequential path byte for byte.
+// ---------------------------------------------------------------------------
+
+TEST(BasicXorEncryptor, ParallelValueList_MatchesSequential_INT32) {
+    WorkStealingThreadPool pool(3);
+    BasicXorEncryptor sequential("test_key", "int32_column", "test_user", "test_context", Type::INT32, 0);
+    BasicXorEncryptor parallel("test_key", "int32_column", "test_user", "test_context", Type::INT32, 1, &pool);
+
+    std::vector<uint8_t> input_bytes;
+    const size_t num_values = 1001;
+    for (size_t i = 0; i < num_values; ++i) {
+        append_i32_le(input_bytes, static_cast<int32_t>(i * 7919) - 5000);
+    }
+    const auto input_span = tcb::span<const uint8_t>(input_bytes.data(), input_bytes.size());
+
+    std::vector<uint8_t> sequential_blob = sequential.EncryptValueList(TypedBufferI32{input_span, num_values});
+    std::vector<uint8_t> parallel_blob = parallel.EncryptValueList(TypedBufferI32{input_span, num_values});
+    EXPECT_EQ(sequential_blob, parallel_blob);
+
+    TypedValuesBuffer decrypted_buffer = parallel.DecryptValueList(parallel_blob);
+    auto* out = std::get_if<TypedBufferI32>(&decrypted_buffer);
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(out->FinalizeAndTakeBuffer(), input_bytes);
+}
+
+TEST(BasicXorEncryptor, ParallelValueList_MatchesSequential_FIXED_LEN_BYTE_ARRAY) {
+    WorkStealingThreadPool pool(2);
+    BasicXorEncryptor sequential("test_key", "flba_column", "test_user", "test_context", Type::FIXED_LEN_BYTE_ARRAY, 0);
+    BasicXorEncryptor parallel("test_key", "flba_column", "test_user", "test_context", Type::FIXED_LEN_BYTE_ARRAY, 1, &pool);
+
+    const size_t element_size = 16;
+    const size_t num_values = 333;
+    std::vector<uint8_t> input_bytes(element_size * num_values);
+    for (size_t i = 0; i < input_bytes.size(); ++i) {
+        input_bytes[i] = static_cast<uint8_t>(i * 31);
+    }
+    const auto input_span = tcb::span<const uint8_t>(input_bytes.data(), input_bytes.size());
+    auto make_input = [&]() {
+        return TypedBufferRawBytesFixedSized{input_span, num_values, 0, RawBytesFixedSizedCodec{element_size}};
+    };
+
+    std::vector<uint8_t> sequential_blob = sequential.EncryptValueList(make_input());
+    std::vector<uint8_t> parallel_blob = parallel.EncryptValueList(make_input());
+    EXPECT_EQ(sequential_blob, parallel_blob);
+
+    TypedValuesBuffer decrypted_buffer = parallel.DecryptValueList(parallel_blob);
+    auto* out = std::get_if<TypedBufferRawBytesFixedSized>(&decrypted_buffer);
+    ASSERT_NE(out, nullptr);
+    EXPECT_EQ(out->FinalizeAndTakeBuffer(), input_bytes);
+}
+
+TEST(BasicXorEncryptor, ParallelValueList_MatchesSequential_BYTE_ARRAY) {
+    WorkStealingThreadPool pool(3);
+    BasicXorEncryptor sequential("test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, 0);
+    BasicXorEncryptor parallel("test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, 1, &pool);
+
+    // Uneven element sizes, including empty elements.
+    const size_t num_values = 517;
+    std::vector<uint8_t> input_bytes;
+    for (size_t i = 0; i < num_values; ++i) {
+        const size_t element_size = (i * 13) % 97;
+        append_u32_le(input_bytes, static_cast<uint32_t>(element_size));
+        for (size_t j = 0; j < element_size; ++j) {
+            input_bytes.push_back(static_cast<uint8_t>(i + j));
+        }
+    }
+    const auto input_span = tcb::span<const uint8_t>(input_bytes.data(), input_bytes.size());
+
+    std::vector<uint8_t> sequential_blob =
+        sequential.EncryptValueList(TypedBufferRawBytesVariableSized{input_span, num_values});
+    std::vector<uint8_t> parallel_blob =
+        parallel.EncryptValueList(TypedBufferRawBytesVariableSized{input_span, num_values});
+    EXPECT_EQ(sequential_blob, parallel_blob);
+
+    TypedValuesBuffer decrypted_buffer = parallel.DecryptValueList(parallel_blob);
+    auto* out = std::get_if<TypedBufferRawBytesVariableSized>(&decrypted_buffer);
+    ASSERT_NE(out, nullptr);
+    ASSERT_EQ(out->GetNumElements(), num_values);
+    EXPECT_EQ(out->FinalizeAndTakeBuffer(), input_bytes);
+}
+
+TEST(BasicXorEncryptor, ParallelValueList_MalformedInput_Throws) {
+    WorkStealingThreadPool pool(2);
+    BasicXorEncryptor parallel("test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, 1, &pool);
+
+    // Header claims 3 elements, payload holds 2.
+    std::vector<uint8_t> encrypted(kVariableHeaderLength);
+    WriteHeader(encrypted, {false, 3, 0});
+    append_u32_le(encrypted, 1u);
+    encrypted.push_back(0xAA);
+    append_u32_le(encrypted, 1u);
+    encrypted.push_back(0xBB);
+
+    EXPECT_THROW(parallel.DecryptValueList(encrypted), InvalidInputException);
+}
+
+TEST(BasicXorEncryptor, DecryptTrustedValueListInto_MatchesDecryptValueList) {
+    WorkStealingThreadPool pool(3);
+    const size_t num_values = 517;
+    std::vector<uint8_t> variable_bytes;
+    std::vector<uint8_t> fixed_bytes;
+    for (size_t i = 0; i < num_values; ++i) {
+        const size_t element_size = (i * 13) % 97;
+        append_u32_le(variable_bytes, static_cast<uint32_t>(element_size));
+        for (size_t j = 0; j < element_size; ++j) {
+            variable_bytes.push_back(static_cast<uint8_t>(i + j));
+        }
+        append_i64_le(fixed_bytes, static_cast<int64_t>(i * 1000003));
+    }
+
+    // Sequentially, then split into parallel ranges.
+    for (size_t parallel_threshold_bytes : {size_t{0}, size_t{1}}) {
+        BasicXorEncryptor byte_array_encryptor(
+            "test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, parallel_threshold_bytes, &pool);
+        BasicXorEncryptor int64_encryptor(
+            "test_key", "i64_column", "test_user", "test_context", Type::INT64, parallel_threshold_bytes, &pool);
+        const std::vector<std::pair<BasicXorEncryptor*, std::vector<uint8_t>>> cases = {
+            {&byte_array_encryptor, byte_array_encryptor.EncryptValueList(TypedBufferRawBytesVariableSized{
+                tcb::span<const uint8_t>(variable_bytes), num_values})},
+            {&int64_encryptor, int64_encryptor.EncryptValueList(TypedBufferI64{
+                tcb::span<const uint8_t>(fixed_bytes), num_values})}};
+
+        for (const auto& [encryptor, encrypted] : cases) {
+            auto decrypted = encryptor->DecryptValueList(encrypted);
+            auto expected = std::visit([](auto& buffer) { return buffer.FinalizeAndTakeBuffer(); }, decrypted);
+            auto max_size = encryptor->MaxValueListPlaintextSize(encrypted.size());
+            ASSERT_TRUE(max_size.has_value());
+            std::vector<uint8_t> out(max_size.value(), 0xEE);
+            const size_t written = encryptor->DecryptTrustedValueListInto(encrypted, out);
+            out.resize(written);
+            EXPECT_EQ(out, expected);
+
+            // Truncated ciphertexts still fail safely.
+            std::vector<uint8_t> truncated(encrypted.begin(), encrypted.end() - 1);
+            std::vector<uint8_t> truncated_out(max_size.value());
+            EXPECT_THROW(encryptor->DecryptTrustedValueListInto(truncated, truncated_out), InvalidInputException);
+
+            std::vector<uint8_t> short_out(expected.size() - 1);
+            EXPECT_THROW(encryptor->DecryptTrustedValueListInto(encrypted, short_out), InvalidInputException);
+        }
+    }
+
+    // A length prefix that points past the end of the input is rejected.
+    BasicXorEncryptor encryptor("test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY);
+    std::vector<uint8_t> overrun(kVariableHeaderLength);
+    WriteHeader(overrun, {false, 1, 0});
+    append_u32_le(overrun, 1000u);
+    overrun.push_back(0xAA);
+    std::vector<uint8_t> overrun_out(overrun.size());
+    EXPECT_THROW(encryptor.DecryptTrustedValueListInto(overrun, overrun_out), InvalidInputException);
+}
+
+TEST(BasicXorEncryptor, EncryptDeduplicatedValueListInto_MatchesExpandedList) {
+    const std::vector<uint32_t> indices = {0, 1, 1, 2, 0, 2, 2, 1, 0};
+    std::vector<std::vector<uint8_t>> distinct_strings = {{'o', 'k'}, {}, {'n', 'o', 't', '_', 'f', 'o', 'u', 'n', 'd'}};
+    std::vector<int32_t> distinct_ints = {200, -1, 404};
+
+    std::vector<uint8_t> distinct_variable_bytes;
+    std::vector<uint8_t> expanded_variable_bytes;
+    for (const auto& value : distinct_strings) {
+        append_u32_le(distinct_variable_bytes, static_cast<uint32_t>(value.size()));
+        distinct_variable_bytes.insert(distinct_variable_bytes.end(), value.begin(), value.end());
+    }
+    std::vector<uint8_t> distinct_fixed_bytes;
+    std::vector<uint8_t> expanded_fixed_bytes;
+    for (int32_t value : distinct_ints) {
+        append_i32_le(distinct_fixed_bytes, value);
+    }
+    for (uint32_t index : indices) {
+        append_u32_le(expanded_variable_bytes, static_cast<uint32_t>(distinct_strings[index].size()));
+        expanded_variable_bytes.insert(
+            expanded_variable_bytes.end(), distinct_strings[index].begin(), distinct_strings[index].end());
+        append_i32_le(expanded_fixed_bytes, distinct_ints[index]);
+    }
+
+    BasicXorEncryptor byte_array_encryptor("test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY);
+    BasicXorEncryptor int32_encryptor("test_key", "i32_column", "test_user", "test_context", Type::INT32);
+    EXPECT_TRUE(byte_array_encryptor.IsValueEncryptionDeterministic());
+
+    const std::vector<std::tuple<BasicXorEncryptor*, TypedValuesBuffer, TypedValuesBuffer>> cases = {
+        {&byte_array_encryptor,
+         TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(distinct_variable_bytes), distinct_strings.size()},
+         TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(expanded_variable_bytes), indices.size()}},
+        {&int32_encryptor,
+         TypedBufferI32{tcb::span<const uint8_t>(distinct_fixed_bytes), distinct_ints.size()},
+         TypedBufferI32{tcb::span<const uint8_t>(expanded_fixed_bytes), indices.size()}}};
+    for (const auto& [encryptor, distinct_values, expanded_values] : cases) {
+        const auto expected = encryptor->EncryptValueList(expanded_values);
+        std::vector<uint8_t> out(expected.size() + 8, 0xEE);
+        const size_t written = encryptor->EncryptDeduplicatedValueListInto(distinct_values, indices, out);
+        out.resize(written);
+        EXPECT_EQ(out, expected);
+
+        std::vector<uint8_t> short_out(expected.size() - 1);
+        EXPECT_THROW(encryptor->EncryptDeduplicatedValueListInto(distinct_values, indices, short_out),
+                     InvalidInputException);
+        const std::vector<uint32_t> out_of_range = {0, 3};
+        std::vector<uint8_t> range_out(expected.size());
+        EXPECT_THROW(encryptor->EncryptDeduplicatedValueListInto(distinct_values, out_of_range, range_out),
+                     InvalidInputException);
+    }
+}
+
+TEST(BasicXorEncryptor, EncryptColumnarValueListInto_RoundTrip) {
+    WorkStealingThreadPool pool(3);
+    const size_t num_values = 517;
+    std::vector<uint8_t> variable_bytes;
+    for (size_t i = 0; i < num_values; ++i) {
+        const size_t element_size = (i * 13) % 97;
+        append_u32_le(variable_bytes, static_cast<uint32_t>(element_size));
+        for (size_t j = 0; j < element_size; ++j) {
+            variable_bytes.push_back(static_cast<uint8_t>(i + j));
+        }
+    }
+
+    // Sequentially, then split into parallel ranges.
+    for (size_t parallel_threshold_bytes : {size_t{0}, size_t{1}}) {
+        BasicXorEncryptor encryptor(
+            "test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, parallel_threshold_bytes, &pool);
+        ASSERT_TRUE(encryptor.SupportsColumnarValueList());
+        TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{
+            tcb::span<const uint8_t>(variable_bytes), num_values};
+
+        const size_t max_size = encryptor.MaxValueListCiphertextSize(variable_bytes.size()).value();
+        std::vector<uint8_t> encrypted(max_size);
+        encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, encrypted));
+
+        // Every size fits in one byte, so the columnar layout saves three bytes per value.
+        auto header = ReadHeader(encrypted);
+        EXPECT_TRUE(header.is_columnar);
+        EXPECT_EQ(header.size_width, 1);
+        EXPECT_EQ(encrypted.size(), kColumnarHeaderLength + variable_bytes.size() - 3 * num_values);
+
+        auto decrypted = encryptor.DecryptValueList(encrypted);
+        EXPECT_EQ(std::get<TypedBufferRawBytesVariableSized>(decrypted).FinalizeAndTakeBuffer(), variable_bytes);
+
+        std::vector<uint8_t> out(encryptor.MaxValueListPlaintextSize(encrypted.size()).value() +
+                                 GetColumnarSizeExpansion(header), 0xEE);
+        out.resize(encryptor.DecryptTrustedValueListInto(encrypted, out));
+        EXPECT_EQ(out, variable_bytes);
+
+        std::vector<uint8_t> short_out(variable_bytes.size() - 1);
+        EXPECT_THROW(encryptor.DecryptTrustedValueListInto(encrypted, short_out), InvalidInputException);
+        std::vector<uint8_t> truncated(encrypted.begin(), encrypted.end() - 1);
+        EXPECT_THROW(encryptor.DecryptValueList(truncated), InvalidInputException);
+        std::vector<uint8_t> too_small(encrypted.size() - 1);
+        EXPECT_THROW(encryptor.EncryptColumnarValueListInto(typed_buffer, too_small), InvalidInputException);
+    }
+}
+
+TEST(BasicXorEncryptor, EncryptColumnarValuesInto_PayloadRegionIsOneKeyStreamRange) {
+    WorkStealingThreadPool pool(3);
+    std::vector<uint8_t> variable_bytes;
+    for (size_t i = 0; i < 300; ++i) {
+        const size_t element_size = (i * 7) % 23;
+        append_u32_le(variable_bytes, static_cast<uint32_t>(element_size));
+        for (size_t j = 0; j < element_size; ++j) {
+            variable_bytes.push_back(static_cast<uint8_t>(i * 3 + j));
+        }
+    }
+    auto values = ByteArrayOffsetsBuffer::FromPlainValueBytes(variable_bytes, 300);
+
+    // The key stream runs over the whole data region instead of restarting on every value, sequentially and
+    // split into parallel byte ranges.
+    for (size_t parallel_threshold_bytes : {size_t{0}, size_t{1}}) {
+        BasicXorEncryptor encryptor(
+            "test_key", "ba_column", "test_user", "test_context", Type::BYTE_ARRAY, parallel_threshold_bytes, &pool);
+        std::vector<uint8_t> encrypted(encryptor.MaxValueListCiphertextSize(variable_bytes.size()).value());
+        encrypted.resize(encryptor.EncryptColumnarValuesInto(values, encrypted));
+
+        const auto expected_payloads = encryptor.EncryptBlock(values.GetData());
+        ASSERT_GE(encrypted.size(), expected_payloads.size());
+        EXPECT_EQ(std::vector<uint8_t>(encrypted.end() - expected_payloads.size(), encrypted.end()),
+                  expected_payloads);
+
+        TypedValuesBuffer typed_buffer = TypedBufferRawBytesVariableSized{
+            tcb::span<const uint8_t>(variable_bytes), 300};
+        std::vector<uint8_t> typed_encrypted(encrypted.size());
+        typed_encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, typed_encrypted));
+        EXPECT_EQ(typed_encrypted, encrypted);
+
+        std::vector<uint8_t> out(variable_bytes.size());
+        out.resize(encryptor.DecryptTrustedValueListInto(encrypted, out));
+        EXPECT_EQ(out, variable_bytes);
+    }
+}
+
+TEST(BasicXorEncryptor, EncryptColumnarValueListInto_FixedSizeMatchesValueList) {
+    BasicXorEncryptor encryptor("test_key", "i64_column", "test_user", "test_context", Type::INT64);
+    std::vector<uint8_t> fixed_bytes;
+    for (int64_t i = 0; i < 50; ++i) {
+        append_i64_le(fixed_bytes, i * 1000003);
+    }
+    TypedValuesBuffer typed_buffer = TypedBufferI64{tcb::span<const uint8_t>(fixed_bytes), 50};
+
+    const auto expected = encryptor.EncryptValueList(typed_buffer);
+    std::vector<uint8_t> encrypted(encryptor.MaxValueListCiphertextSize(fixed_bytes.size()).value());
+    encrypted.resize(encryptor.EncryptColumnarValueListInto(typed_buffer, encrypted));
+    EXPECT_EQ(encrypted, expected);
+}
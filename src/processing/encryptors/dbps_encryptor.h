@@ -18,11 +18,18 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <tcb/span.hpp>
 #include <vector>
+#include "../byte_array_offsets_buffer.h"
 #include "../typed_buffer_values.h"
 #include "../../common/enums.h"
+#include "../../common/exceptions.h"
 
 #ifndef DBPS_EXPORT
 #define DBPS_EXPORT
@@ -38,6 +45,10 @@ using namespace dbps::processing;
  * 
  * Context parameters (key_id, column_name, user_id, application_context) are provided
  * via the constructor and stored by implementations for use in encryption/decryption operations.
+ *
+ * Thread safety: an instance is shared by all pages of a column, and may be shared across requests (see
+ * EncryptorCache). Implementations that support concurrent calls on one instance, i.e. keep no per-call
+ * state in members, return true from IsThreadSafe().
  */
 class DBPS_EXPORT DBPSEncryptor {
 public:
@@ -83,6 +94,112 @@ public:
      */
     virtual std::vector<uint8_t> DecryptBlock(tcb::span<const uint8_t> data) = 0;
 
+    /**
+     * Encrypts a block of data into a caller-provided buffer.
+     * The default implementation calls EncryptBlock and copies the result into out. Encryptors that can
+     * bound their output (see MaxBlockCiphertextSize) should override it to write into out directly.
+     *
+     * @param data The plaintext data to encrypt
+     * @param out The output buffer
+     * @return The number of bytes written to out
+     * @throws InvalidInputException if out is too small for the ciphertext
+     */
+    virtual size_t EncryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+        return CopyIntoOutput(EncryptBlock(data), out);
+    }
+
+    /**
+     * Encrypts a block of data held in several segments, as if the segments were concatenated.
+     * The default implementation passes contiguous input to EncryptBlockInto, and gathers segmented input into
+     * one pooled buffer first. Encryptors that can carry their state across segments should override it to
+     * encrypt the segments in place.
+     *
+     * @param data The plaintext data to encrypt
+     * @param out The output buffer
+     * @return The number of bytes written to out
+     * @throws InvalidInputException if out is too small for the ciphertext
+     */
+    virtual size_t EncryptSegmentedBlockInto(const SegmentedBytes& data, tcb::span<uint8_t> out) {
+        if (data.IsContiguous()) {
+            return EncryptBlockInto(data.AsContiguous(), out);
+        }
+        std::vector<uint8_t> gathered = AcquireUninitializedBuffer(data.size());
+        data.CopyTo(0, gathered);
+        const size_t written = EncryptBlockInto(gathered, out);
+        ReleaseBuffer(std::move(gathered));
+        return written;
+    }
+
+    /**
+     * Decrypts a block of data into a caller-provided buffer. Counterpart of EncryptBlockInto.
+     *
+     * @param data The ciphertext data to decrypt
+     * @param out The output buffer
+     * @return The number of bytes written to out
+     * @throws InvalidInputException if out is too small for the plaintext
+     */
+    virtual size_t DecryptBlockInto(tcb::span<const uint8_t> data, tcb::span<uint8_t> out) {
+        return CopyIntoOutput(DecryptBlock(data), out);
+    }
+
+    /**
+     * Upper bounds of the output sizes, used to size caller-provided output buffers upfront.
+     * std::nullopt (the default) means the encryptor cannot bound the output without running the operation.
+     *
+     * - MaxBlockCiphertextSize: EncryptBlock output size for a plaintext of plaintext_size bytes.
+     * - MaxBlockPlaintextSize: DecryptBlock output size for a ciphertext of ciphertext_size bytes.
+     * - MaxValueListCiphertextSize: EncryptValueList output size for values taking value_bytes_size bytes
+     *   when PLAIN encoded (BYTE_ARRAY values include their 4-byte length prefixes).
+     * - MaxValueListPlaintextSize: size of the PLAIN encoded values decrypted from a value-list ciphertext of
+     *   ciphertext_size bytes (see DecryptTrustedValueListInto). Columnar ciphertexts pack their value sizes
+     *   below 4 bytes, so GetColumnarSizeExpansion of their header is added on top (see encryptor_utils.h).
+     *
+     * MaxValueListCiphertextSize bounds both value-list layouts (see EncryptColumnarValueListInto).
+     */
+    virtual std::optional<size_t> MaxBlockCiphertextSize(size_t plaintext_size) const {
+        (void) plaintext_size;
+        return std::nullopt;
+    }
+
+    virtual std::optional<size_t> MaxBlockPlaintextSize(size_t ciphertext_size) const {
+        (void) ciphertext_size;
+        return std::nullopt;
+    }
+
+    virtual std::optional<size_t> MaxValueListCiphertextSize(size_t value_bytes_size) const {
+        (void) value_bytes_size;
+        return std::nullopt;
+    }
+
+    virtual std::optional<size_t> MaxValueListPlaintextSize(size_t ciphertext_size) const {
+        (void) ciphertext_size;
+        return std::nullopt;
+    }
+
+    /**
+     * Length of the tags written by ComputeBlockTag, or 0 (the default) if the encryptor cannot authenticate
+     * data it does not encrypt.
+     */
+    virtual size_t GetBlockTagLength() const {
+        return 0;
+    }
+
+    /**
+     * Computes a keyed tag (MAC) of data that is stored unencrypted. The tag is derived from the key material
+     * and bound to the column, so modified data cannot get a matching tag without the key. Only called on
+     * encryptors with a non-zero GetBlockTagLength; the default implementation throws.
+     *
+     * @param data The bytes to authenticate
+     * @param tag The output, exactly GetBlockTagLength() bytes
+     * @throws DBPSUnsupportedException if the encryptor has no block tags
+     * @throws InvalidInputException if tag does not hold exactly GetBlockTagLength() bytes
+     */
+    virtual void ComputeBlockTag(tcb::span<const uint8_t> data, tcb::span<uint8_t> tag) {
+        (void) data;
+        (void) tag;
+        throw DBPSUnsupportedException("ComputeBlockTag: block tags are not supported");
+    }
+
     /**
      * Integration point: Encryption function based on list of values that will be implemented by Protegrity.
      * 
@@ -97,6 +214,109 @@ public:
      */
     virtual std::vector<uint8_t> EncryptValueList(const TypedValuesBuffer& typed_buffer) = 0;
 
+    /**
+     * Encrypts a typed values buffer into a caller-provided buffer. Counterpart of EncryptBlockInto.
+     * The default implementation calls EncryptValueList and copies the result into out.
+     *
+     * @param typed_buffer The typed values buffer to encrypt
+     * @param out The output buffer, sized with MaxValueListCiphertextSize
+     * @return The number of bytes written to out
+     * @throws InvalidInputException if out is too small for the ciphertext
+     */
+    virtual size_t EncryptValueListInto(const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) {
+        return CopyIntoOutput(EncryptValueList(typed_buffer), out);
+    }
+
+    /**
+     * Whether every value ciphertext has the size of its plaintext, so that EncryptValueList output keeps the
+     * layout of the PLAIN encoded values behind its header. Callers use this to write value-list ciphertexts
+     * straight into their own buffers instead of going through an intermediate vector.
+     */
+    virtual bool IsLengthPreserving() const {
+        return false;
+    }
+
+    /**
+     * Whether every method may be called concurrently on this instance. Only thread-safe encryptors are shared
+     * across requests by EncryptorCache. The default is false.
+     */
+    virtual bool IsThreadSafe() const {
+        return false;
+    }
+
+    /**
+     * Whether the ciphertext record of a value in a value list depends on the value alone, not on its position
+     * or on the other values. Such encryptors can encrypt the distinct values of a page once and copy their
+     * ciphertexts to every occurrence (see EncryptDeduplicatedValueListInto). The default is false.
+     */
+    virtual bool IsValueEncryptionDeterministic() const {
+        return false;
+    }
+
+    /**
+     * Encrypts a value list given as its distinct values and the index of the value of every element, into the
+     * same ciphertext EncryptValueListInto writes for the expanded list. Each distinct value is encrypted once.
+     * Only called on encryptors whose value encryption is deterministic; the default implementation throws.
+     *
+     * @param distinct_values The distinct values
+     * @param indices Index of the value of every element in distinct_values
+     * @param out The output buffer, sized with MaxValueListCiphertextSize of the expanded value bytes
+     * @return The number of bytes written to out
+     * @throws DBPSUnsupportedException if the encryptor is not deterministic
+     * @throws InvalidInputException if an index is out of range or out is too small
+     */
+    virtual size_t EncryptDeduplicatedValueListInto(
+        const TypedValuesBuffer& distinct_values, tcb::span<const uint32_t> indices, tcb::span<uint8_t> out) {
+        (void) distinct_values;
+        (void) indices;
+        (void) out;
+        throw DBPSUnsupportedException("EncryptDeduplicatedValueListInto: value encryption is not deterministic");
+    }
+
+    /**
+     * Whether the encryptor writes the columnar value-list layout (see EncryptColumnarValuesInto) and decrypts
+     * it. The default is false: value lists only use the records layout.
+     */
+    virtual bool SupportsColumnarValueList() const {
+        return false;
+    }
+
+    /**
+     * Encrypts BYTE_ARRAY values into the columnar value-list layout of ciphertext format v0.02 (see
+     * encryptor_utils.h): a block of packed value sizes followed by one contiguous payload region, instead of
+     * [u32 size][value] records. The payload region is the data region of values, transformed as a single range.
+     * DecryptValueList and DecryptTrustedValueListInto read both layouts.
+     * Only called on encryptors that support the columnar layout; the default implementation throws.
+     *
+     * @param values The values to encrypt, in the offsets+data layout
+     * @param out The output buffer, sized with MaxValueListCiphertextSize of the PLAIN values
+     * @return The number of bytes written to out
+     * @throws DBPSUnsupportedException if the encryptor does not support the columnar layout
+     * @throws InvalidInputException if out is too small for the ciphertext
+     */
+    virtual size_t EncryptColumnarValuesInto(const ByteArrayOffsetsBuffer& values, tcb::span<uint8_t> out) {
+        (void) values;
+        (void) out;
+        throw DBPSUnsupportedException("EncryptColumnarValuesInto: columnar value lists are not supported");
+    }
+
+    /**
+     * EncryptColumnarValuesInto for a typed values buffer. Variable-size values are converted to the offsets+data
+     * layout first; fixed-size values have no per-value framing and are encrypted as with EncryptValueListInto.
+     */
+    size_t EncryptColumnarValueListInto(const TypedValuesBuffer& typed_buffer, tcb::span<uint8_t> out) {
+        return std::visit([&](const auto& input_buffer) -> size_t {
+            if constexpr (std::decay_t<decltype(input_buffer)>::is_fixed_sized) {
+                return EncryptValueListInto(typed_buffer, out);
+            } else {
+                auto values = ByteArrayOffsetsBuffer::FromTypedBuffer(input_buffer);
+                const size_t ciphertext_size = EncryptColumnarValuesInto(values, out);
+                values.Release();
+                return ciphertext_size;
+            }
+        }, typed_buffer);
+    }
+
     /**
      * Integration point: Decryption function based on encrypted bytes that will be implemented by Protegrity.
      * 
@@ -108,7 +328,41 @@ public:
      */
     virtual TypedValuesBuffer DecryptValueList(tcb::span<const uint8_t> encrypted_bytes) = 0;
 
+    /**
+     * Decrypts a value-list ciphertext produced by this deployment straight into PLAIN encoded value bytes
+     * (the layout of GetTypedValuesBufferAsValueBytes).
+     *
+     * The input is trusted: implementations may decode it in a single pass, without the structural validation
+     * DecryptValueList does for untrusted input (e.g. checking the element count against the payload). They
+     * must still bounds-check every length they read, and throw instead of reading or writing out of bounds.
+     * The default implementation calls DecryptValueList and copies the value bytes into out.
+     *
+     * @param encrypted_bytes The value-list ciphertext, as returned by EncryptValueList
+     * @param out The output buffer, sized with MaxValueListPlaintextSize
+     * @return The number of bytes written to out
+     * @throws InvalidInputException if a length overruns the input or out is too small
+     */
+    virtual size_t DecryptTrustedValueListInto(tcb::span<const uint8_t> encrypted_bytes, tcb::span<uint8_t> out) {
+        auto typed_buffer = DecryptValueList(encrypted_bytes);
+        return std::visit([&](auto& buffer) {
+            return CopyIntoOutput(buffer.FinalizeAndTakeBuffer(), out);
+        }, typed_buffer);
+    }
+
 protected:
+    // Copies an operation result into a caller-provided buffer. Returns the number of bytes copied.
+    static size_t CopyIntoOutput(const std::vector<uint8_t>& result, tcb::span<uint8_t> out) {
+        if (out.size() < result.size()) {
+            throw InvalidInputException(
+                "Output buffer too small: " + std::to_string(result.size()) + " bytes required, " +
+                std::to_string(out.size()) + " bytes provided");
+        }
+        if (!result.empty()) {
+            std::memcpy(out.data(), result.data(), result.size());
+        }
+        return result.size();
+    }
+
     // Context parameters stored from constructor
     std::string key_id_;
     std::string column_name_;
@@ -17,10 +17,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <string>
 #include <vector>
 #include <tcb/span.hpp>
+#include "../byte_array_offsets_buffer.h"
+#include "../typed_buffer_values.h"
 #include "../../common/bytes_utils.h"
 #include "../../common/exceptions.h"
 
@@ -29,34 +34,57 @@ namespace dbps::processing {
 // Wire-format prefix tags.
 inline constexpr uint8_t kFixedSizeTag = 0x01;
 inline constexpr uint8_t kVariableSizeTag = 0x00;
+inline constexpr uint8_t kColumnarVariableSizeTag = 0x02;
 inline constexpr size_t kTagLength = 1;
 inline constexpr size_t kSizeTLength = 4;
+inline constexpr size_t kSizeWidthLength = 1;
 
 // Header sizes in bytes.
 //   Fixed:    [1-byte tag] [uint32 element_count] [uint32 element_size]
 //   Variable: [1-byte tag] [uint32 element_count]
+//   Columnar: [1-byte tag] [uint32 element_count] [uint8 size_width]
 inline constexpr size_t kFixedHeaderLength = kTagLength + kSizeTLength + kSizeTLength;
 inline constexpr size_t kVariableHeaderLength = kTagLength + kSizeTLength;
+inline constexpr size_t kColumnarHeaderLength = kTagLength + kSizeTLength + kSizeWidthLength;
 
 struct EncryptedValueHeader {
     bool is_fixed;
     uint32_t num_elements;
-    uint32_t element_size;   // only meaningful when is_fixed == true
+    uint32_t element_size;      // only meaningful when is_fixed == true
+    bool is_columnar = false;   // variable-size values in the columnar layout (see below)
+    uint8_t size_width = 0;     // only meaningful when is_columnar == true
 };
 
+inline size_t GetHeaderLength(const EncryptedValueHeader& header) {
+    if (header.is_fixed) {
+        return kFixedHeaderLength;
+    }
+    return header.is_columnar ? kColumnarHeaderLength : kVariableHeaderLength;
+}
+
+inline bool IsValidSizeWidth(uint8_t size_width) {
+    return size_width == 1 || size_width == 2 || size_width == 4;
+}
+
 // Stamp the header into the first bytes of buf.
-inline void WriteHeader(std::vector<uint8_t>& buf, const EncryptedValueHeader& header) {
-    const size_t required = header.is_fixed ? kFixedHeaderLength : kVariableHeaderLength;
-    if (buf.size() < required) {
+inline void WriteHeader(tcb::span<uint8_t> buf, const EncryptedValueHeader& header) {
+    if (buf.size() < GetHeaderLength(header)) {
         throw InvalidInputException("WriteHeader: buffer too small");
     }
     if (header.is_fixed) {
         buf[0] = kFixedSizeTag;
-        write_u32_le_at(buf, kTagLength, header.num_elements);
-        write_u32_le_at(buf, kTagLength + kSizeTLength, header.element_size);
+        write_u32_le(buf.data() + kTagLength, header.num_elements);
+        write_u32_le(buf.data() + kTagLength + kSizeTLength, header.element_size);
+    } else if (header.is_columnar) {
+        if (!IsValidSizeWidth(header.size_width)) {
+            throw InvalidInputException("WriteHeader: invalid size width");
+        }
+        buf[0] = kColumnarVariableSizeTag;
+        write_u32_le(buf.data() + kTagLength, header.num_elements);
+        buf[kTagLength + kSizeTLength] = header.size_width;
     } else {
         buf[0] = kVariableSizeTag;
-        write_u32_le_at(buf, kTagLength, header.num_elements);
+        write_u32_le(buf.data() + kTagLength, header.num_elements);
     }
 }
 
@@ -68,6 +96,7 @@ inline EncryptedValueHeader ReadHeader(tcb::span<const uint8_t> bytes) {
 
     EncryptedValueHeader header{};
     header.is_fixed = (bytes[0] == kFixedSizeTag);
+    header.is_columnar = (bytes[0] == kColumnarVariableSizeTag);
 
     if (header.is_fixed) {
         if (bytes.size() < kFixedHeaderLength) {
@@ -75,14 +104,159 @@ inline EncryptedValueHeader ReadHeader(tcb::span<const uint8_t> bytes) {
         }
         header.num_elements = read_u32_le(bytes, kTagLength);
         header.element_size = read_u32_le(bytes, kTagLength + kSizeTLength);
-    } else {
+    } else if (header.is_columnar) {
+        if (bytes.size() < kColumnarHeaderLength) {
+            throw InvalidInputException("ReadHeader: truncated columnar header");
+        }
+        header.num_elements = read_u32_le(bytes, kTagLength);
+        header.element_size = 0;
+        header.size_width = bytes[kTagLength + kSizeTLength];
+        if (!IsValidSizeWidth(header.size_width)) {
+            throw InvalidInputException("ReadHeader: invalid size width " + std::to_string(header.size_width));
+        }
+    } else if (bytes[0] == kVariableSizeTag) {
         if (bytes.size() < kVariableHeaderLength) {
             throw InvalidInputException("ReadHeader: truncated variable-size header");
         }
         header.num_elements = read_u32_le(bytes, kTagLength);
         header.element_size = 0;
+    } else {
+        throw InvalidInputException("ReadHeader: unknown tag " + std::to_string(bytes[0]));
     }
     return header;
 }
 
+// ---------------------------------------------------------------------------
+// Columnar layout of variable-size values (ciphertext format v0.02)
+//
+//   [0x02][uint32 count][uint8 size_width] <count value sizes> <value payloads back to back>
+//
+// The records layout frames every value with a 4-byte size, and decoding it walks the records one by one.
+// The columnar layout stores the sizes little-endian on the smallest width of 1, 2 or 4 bytes that holds the
+// largest one, so short strings take 1 byte of framing. Decoders unpack all the sizes in one loop, then copy
+// or decrypt the payloads as one region.
+// ---------------------------------------------------------------------------
+
+// Size width of a columnar list of values with the given payload sizes.
+inline uint8_t GetSizeWidth(tcb::span<const uint32_t> value_sizes) {
+    const uint32_t max_value_size =
+        value_sizes.empty() ? 0 : *std::max_element(value_sizes.begin(), value_sizes.end());
+    if (max_value_size <= UINT8_MAX) {
+        return 1;
+    }
+    return max_value_size <= UINT16_MAX ? 2 : 4;
+}
+
+// Bytes that the PLAIN values of a columnar list take beyond its packed sizes: the size prefixes are
+// kSizePrefixBytes wide. Added to MaxValueListPlaintextSize to bound the plaintext of a columnar ciphertext.
+inline size_t GetColumnarSizeExpansion(const EncryptedValueHeader& header) {
+    if (!header.is_columnar) {
+        return 0;
+    }
+    return static_cast<size_t>(header.num_elements) * (::kSizePrefixBytes - header.size_width);
+}
+
+// Payload sizes of the elements of an offsets+data buffer, in element order.
+inline std::vector<uint32_t> GetValueSizes(const ByteArrayOffsetsBuffer& values) {
+    const auto offsets = values.GetOffsets();
+    std::vector<uint32_t> value_sizes(values.GetNumElements());
+    for (size_t i = 0; i < value_sizes.size(); ++i) {
+        value_sizes[i] = offsets[i + 1] - offsets[i];
+    }
+    return value_sizes;
+}
+
+// Writes the packed value sizes at the start of out, which holds value_sizes.size() * size_width bytes.
+inline void WritePackedValueSizes(
+    tcb::span<uint8_t> out, tcb::span<const uint32_t> value_sizes, uint8_t size_width) {
+    if (!IsValidSizeWidth(size_width) || out.size() / size_width < value_sizes.size()) {
+        throw InvalidInputException("WritePackedValueSizes: buffer too small");
+    }
+    uint8_t* sizes_out = out.data();
+    switch (size_width) {
+        case 1:
+            for (size_t i = 0; i < value_sizes.size(); ++i) {
+                sizes_out[i] = static_cast<uint8_t>(value_sizes[i]);
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < value_sizes.size(); ++i) {
+                sizes_out[2 * i] = static_cast<uint8_t>(value_sizes[i] & 0xFF);
+                sizes_out[2 * i + 1] = static_cast<uint8_t>(value_sizes[i] >> 8);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < value_sizes.size(); ++i) {
+                write_u32_le(sizes_out + 4 * i, value_sizes[i]);
+            }
+            break;
+    }
+}
+
+struct ColumnarValueList {
+    std::vector<uint32_t> value_sizes;
+    tcb::span<const uint8_t> payloads;
+
+    // Size of the values when PLAIN encoded, with their size prefixes.
+    size_t GetPlainSize() const { return value_sizes.size() * ::kSizePrefixBytes + payloads.size(); }
+};
+
+// Unpacks the sizes of a columnar value list from `body`, the bytes that follow its header (and the
+// encryptor's own fields, such as a nonce). The payloads must fill the rest of the body exactly.
+inline ColumnarValueList ReadColumnarValueList(const EncryptedValueHeader& header, tcb::span<const uint8_t> body) {
+    const size_t num_elements = header.num_elements;
+    const size_t size_width = header.size_width;
+    if (!header.is_columnar || body.size() / size_width < num_elements) {
+        throw InvalidInputException("ReadColumnarValueList: truncated value sizes");
+    }
+    ColumnarValueList value_list;
+    value_list.value_sizes.resize(num_elements);
+    uint32_t* value_sizes = value_list.value_sizes.data();
+    const uint8_t* sizes_in = body.data();
+    switch (size_width) {
+        case 1:
+            for (size_t i = 0; i < num_elements; ++i) {
+                value_sizes[i] = sizes_in[i];
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < num_elements; ++i) {
+                value_sizes[i] = static_cast<uint32_t>(sizes_in[2 * i]) |
+                                 (static_cast<uint32_t>(sizes_in[2 * i + 1]) << 8);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < num_elements; ++i) {
+                value_sizes[i] = read_u32_le(sizes_in + 4 * i);
+            }
+            break;
+    }
+
+    uint64_t payloads_size = 0;
+    for (size_t i = 0; i < num_elements; ++i) {
+        payloads_size += value_sizes[i];
+    }
+    const size_t sizes_length = num_elements * size_width;
+    if (payloads_size != body.size() - sizes_length) {
+        throw InvalidInputException("ReadColumnarValueList: value sizes do not match the payloads");
+    }
+    value_list.payloads = body.subspan(sizes_length);
+    return value_list;
+}
+
+// Turns decrypted payloads into PLAIN records in place. out holds value_list.GetPlainSize() bytes, with the
+// payloads back to back in its tail (after value_sizes.size() * kSizePrefixBytes bytes). The payloads are moved
+// forward to their records in element order: the record of element i ends at or before the first payload not
+// moved yet, so no payload is overwritten before it is moved.
+inline void ExpandColumnarPayloadsIntoRecords(tcb::span<const uint32_t> value_sizes, tcb::span<uint8_t> out) {
+    uint8_t* record_out = out.data();
+    const uint8_t* payload_in = out.data() + value_sizes.size() * ::kSizePrefixBytes;
+    for (uint32_t value_size : value_sizes) {
+        std::memmove(record_out + ::kSizePrefixBytes, payload_in, value_size);
+        write_u32_le(record_out, value_size);
+        record_out += ::kSizePrefixBytes + value_size;
+        payload_in += value_size;
+    }
+}
+
 } // namespace dbps::processing
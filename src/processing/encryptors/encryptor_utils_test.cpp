@@ -106,3 +106,72 @@ TEST(EncryptorUtils, ReadHeader_TruncatedVariable) {
     std::vector<uint8_t> buf = {kVariableSizeTag, 0};
     EXPECT_THROW(ReadHeader(tcb::span<const uint8_t>(buf)), InvalidInputException);
 }
+
+TEST(EncryptorUtils, ReadHeader_UnknownTag) {
+    std::vector<uint8_t> buf = {0x07, 0, 0, 0, 0, 0, 0, 0, 0};
+    EXPECT_THROW(ReadHeader(tcb::span<const uint8_t>(buf)), InvalidInputException);
+}
+
+// --- Columnar layout ---
+
+TEST(EncryptorUtils, ColumnarHeader_WireFormatAndRoundTrip) {
+    std::vector<uint8_t> buf(kColumnarHeaderLength, 0);
+    WriteHeader(buf, {false, 0x01020304, 0, true, 2});
+    const std::vector<uint8_t> expected = {kColumnarVariableSizeTag, 0x04, 0x03, 0x02, 0x01, 0x02};
+    EXPECT_EQ(buf, expected);
+
+    auto header = ReadHeader(tcb::span<const uint8_t>(buf));
+    EXPECT_FALSE(header.is_fixed);
+    EXPECT_TRUE(header.is_columnar);
+    EXPECT_EQ(header.num_elements, 0x01020304u);
+    EXPECT_EQ(header.size_width, 2);
+    EXPECT_EQ(GetHeaderLength(header), kColumnarHeaderLength);
+}
+
+TEST(EncryptorUtils, ColumnarHeader_InvalidSizeWidth) {
+    std::vector<uint8_t> buf(kColumnarHeaderLength, 0);
+    EXPECT_THROW(WriteHeader(buf, {false, 1, 0, true, 3}), InvalidInputException);
+
+    buf = {kColumnarVariableSizeTag, 1, 0, 0, 0, 3};
+    EXPECT_THROW(ReadHeader(tcb::span<const uint8_t>(buf)), InvalidInputException);
+    buf.pop_back();
+    EXPECT_THROW(ReadHeader(tcb::span<const uint8_t>(buf)), InvalidInputException);
+}
+
+TEST(EncryptorUtils, GetSizeWidth) {
+    EXPECT_EQ(GetSizeWidth({}), 1);
+    EXPECT_EQ(GetSizeWidth(std::vector<uint32_t>{0, 255}), 1);
+    EXPECT_EQ(GetSizeWidth(std::vector<uint32_t>{256, 3}), 2);
+    EXPECT_EQ(GetSizeWidth(std::vector<uint32_t>{65535}), 2);
+    EXPECT_EQ(GetSizeWidth(std::vector<uint32_t>{1, 65536}), 4);
+}
+
+TEST(EncryptorUtils, ColumnarValueList_RoundTrip) {
+    for (uint32_t max_value_size : {200u, 1000u, 70000u}) {
+        const std::vector<uint32_t> value_sizes = {0, 1, max_value_size, 7};
+        const uint8_t size_width = GetSizeWidth(value_sizes);
+        const EncryptedValueHeader header{false, static_cast<uint32_t>(value_sizes.size()), 0, true, size_width};
+        const size_t payloads_size = max_value_size + 8;
+
+        std::vector<uint8_t> body(value_sizes.size() * size_width + payloads_size, 0xAB);
+        WritePackedValueSizes(body, value_sizes, size_width);
+        auto value_list = ReadColumnarValueList(header, body);
+        EXPECT_EQ(value_list.value_sizes, value_sizes);
+        EXPECT_EQ(value_list.payloads.size(), payloads_size);
+        EXPECT_EQ(value_list.GetPlainSize(), ::kSizePrefixBytes * value_sizes.size() + payloads_size);
+        EXPECT_EQ(GetColumnarSizeExpansion(header), value_sizes.size() * (::kSizePrefixBytes - size_width));
+
+        // The sizes must account for the payload region exactly.
+        std::vector<uint8_t> longer(body);
+        longer.push_back(0);
+        EXPECT_THROW(ReadColumnarValueList(header, longer), InvalidInputException);
+        std::vector<uint8_t> shorter(body.begin(), body.end() - 1);
+        EXPECT_THROW(ReadColumnarValueList(header, shorter), InvalidInputException);
+        std::vector<uint8_t> truncated_sizes(body.begin(), body.begin() + size_width);
+        EXPECT_THROW(ReadColumnarValueList(header, truncated_sizes), InvalidInputException);
+
+        std::vector<uint8_t> too_small(value_sizes.size() * size_width - 1);
+        EXPECT_THROW(WritePackedValueSizes(too_small, value_sizes, size_width), InvalidInputException);
+    }
+    EXPECT_EQ(GetColumnarSizeExpansion({false, 10, 0}), 0u);
+}
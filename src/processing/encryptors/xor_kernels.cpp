@@ -0,0 +1,304 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "xor_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DBPS_XOR_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace dbps::processing {
+
+// ---------------------------------------------------------------------------
+// XOR kernels
+//
+// Every kernel computes dst = src ^ key over n bytes with unaligned loads and stores. The x86 kernels are
+// compiled for their instruction set with target attributes, so the library itself keeps the baseline
+// compiler flags, and the fastest one the CPU supports is selected once at runtime.
+// ---------------------------------------------------------------------------
+
+namespace {
+    using XorKernel = void (*)(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n);
+
+    void XorScalar(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+            uint64_t a;
+            uint64_t b;
+            std::memcpy(&a, src + i, sizeof(a));
+            std::memcpy(&b, key + i, sizeof(b));
+            a ^= b;
+            std::memcpy(dst + i, &a, sizeof(a));
+        }
+        for (; i < n; ++i) {
+            dst[i] = src[i] ^ key[i];
+        }
+    }
+
+#ifdef DBPS_XOR_X86_KERNELS
+    __attribute__((target("sse2")))
+    void XorSse2(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64) {
+            for (size_t j = 0; j < 64; j += 16) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + j));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + i + j));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + j), _mm_xor_si128(a, b));
+            }
+        }
+        for (; i + 16 <= n; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(a, b));
+        }
+        XorScalar(src + i, key + i, dst + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    void XorAvx2(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 128 <= n; i += 128) {
+            for (size_t j = 0; j < 128; j += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + j));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + i + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + j), _mm256_xor_si256(a, b));
+            }
+        }
+        for (; i + 32 <= n; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+        }
+        XorScalar(src + i, key + i, dst + i, n - i);
+    }
+
+    __attribute__((target("avx512f")))
+    void XorAvx512(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+        size_t i = 0;
+        for (; i + 256 <= n; i += 256) {
+            for (size_t j = 0; j < 256; j += 64) {
+                __m512i a = _mm512_loadu_si512(src + i + j);
+                __m512i b = _mm512_loadu_si512(key + i + j);
+                _mm512_storeu_si512(dst + i + j, _mm512_xor_si512(a, b));
+            }
+        }
+        for (; i + 64 <= n; i += 64) {
+            __m512i a = _mm512_loadu_si512(src + i);
+            __m512i b = _mm512_loadu_si512(key + i);
+            _mm512_storeu_si512(dst + i, _mm512_xor_si512(a, b));
+        }
+        XorScalar(src + i, key + i, dst + i, n - i);
+    }
+#endif
+
+    XorKernel GetKernel(XorKernelLevel level) {
+        switch (level) {
+#ifdef DBPS_XOR_X86_KERNELS
+            case XorKernelLevel::kSse2:
+                return XorSse2;
+            case XorKernelLevel::kAvx2:
+                return XorAvx2;
+            case XorKernelLevel::kAvx512:
+                return XorAvx512;
+#endif
+            default:
+                return XorScalar;
+        }
+    }
+
+    XorKernel GetActiveKernel() {
+        static const XorKernel kernel = GetKernel(GetActiveXorKernelLevel());
+        return kernel;
+    }
+}
+
+const char* XorKernelLevelName(XorKernelLevel level) {
+    switch (level) {
+        case XorKernelLevel::kScalar:
+            return "scalar";
+        case XorKernelLevel::kSse2:
+            return "sse2";
+        case XorKernelLevel::kAvx2:
+            return "avx2";
+        case XorKernelLevel::kAvx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+bool IsXorKernelLevelSupported(XorKernelLevel level) {
+    switch (level) {
+        case XorKernelLevel::kScalar:
+            return true;
+#ifdef DBPS_XOR_X86_KERNELS
+        case XorKernelLevel::kSse2:
+            return __builtin_cpu_supports("sse2");
+        case XorKernelLevel::kAvx2:
+            return __builtin_cpu_supports("avx2");
+        case XorKernelLevel::kAvx512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+XorKernelLevel GetActiveXorKernelLevel() {
+    static const XorKernelLevel active_level = []() {
+        for (auto level : {XorKernelLevel::kAvx512, XorKernelLevel::kAvx2, XorKernelLevel::kSse2}) {
+            if (IsXorKernelLevelSupported(level)) {
+                return level;
+            }
+        }
+        return XorKernelLevel::kScalar;
+    }();
+    return active_level;
+}
+
+void XorBytes(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+    GetActiveKernel()(src, key, dst, n);
+}
+
+void XorBytes(XorKernelLevel level, const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n) {
+    GetKernel(level)(src, key, dst, n);
+}
+
+// ---------------------------------------------------------------------------
+// Key stream
+// ---------------------------------------------------------------------------
+
+namespace {
+    // Bound on the states visited while looking for the cycle of a key stream.
+    constexpr size_t kMaxCycleSearchStates = 1 << 16;
+
+    // Bytes of repeated cycle in the table, so long runs are XORed in a few large kernel calls.
+    constexpr size_t kTableCycleBytes = 4096;
+
+    // Bytes of repeated element key stream that ApplyPerElement XORs per kernel call.
+    constexpr size_t kElementTileBytes = 4096;
+}
+
+XorKeyStream::XorKeyStream(size_t key_hash) : key_hash_(key_hash) {
+    // Brent's cycle detection: find the period, then the length of the prefix before the cycle.
+    size_t power = 1;
+    size_t period = 1;
+    size_t tortoise = key_hash;
+    size_t hare = NextState(key_hash);
+    size_t steps = 0;
+    while (tortoise != hare) {
+        if (++steps > kMaxCycleSearchStates) {
+            return;
+        }
+        if (power == period) {
+            tortoise = hare;
+            power *= 2;
+            period = 0;
+        }
+        hare = NextState(hare);
+        ++period;
+    }
+    size_t prefix_length = 0;
+    tortoise = key_hash;
+    hare = key_hash;
+    for (size_t i = 0; i < period; ++i) {
+        hare = NextState(hare);
+    }
+    while (tortoise != hare) {
+        tortoise = NextState(tortoise);
+        hare = NextState(hare);
+        ++prefix_length;
+    }
+
+    const size_t cycle_bytes = (kTableCycleBytes + period - 1) / period * period;
+    table_.resize(prefix_length + cycle_bytes);
+    size_t state = key_hash;
+    for (size_t i = 0; i < prefix_length + period; ++i) {
+        table_[i] = static_cast<uint8_t>(state & 0xFF);
+        state = NextState(state);
+    }
+    for (size_t i = prefix_length + period; i < table_.size(); ++i) {
+        table_[i] = table_[i - period];
+    }
+    prefix_length_ = prefix_length;
+    period_ = period;
+}
+
+size_t XorKeyStream::GetTableIndex(size_t position) const {
+    return position < prefix_length_ ? position : prefix_length_ + (position - prefix_length_) % period_;
+}
+
+size_t XorKeyStream::Apply(const uint8_t* src, uint8_t* dst, size_t n, size_t position) const {
+    if (!IsPrecomputed()) {
+        size_t state = key_hash_;
+        for (size_t i = 0; i < position; ++i) {
+            state = NextState(state);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i] ^ (state & 0xFF);
+            state = NextState(state);
+        }
+        return position + n;
+    }
+
+    const XorKernel kernel = GetActiveKernel();
+    size_t index = GetTableIndex(position);
+    size_t done = 0;
+    while (done < n) {
+        const size_t chunk = std::min(n - done, table_.size() - index);
+        kernel(src + done, table_.data() + index, dst + done, chunk);
+        done += chunk;
+        index = GetTableIndex(index + chunk);
+    }
+    return position + n;
+}
+
+void XorKeyStream::ApplyPerElement(
+    const uint8_t* src, uint8_t* dst, size_t num_elements, size_t element_size) const {
+    if (num_elements == 0 || element_size == 0) {
+        return;
+    }
+    // Without a table, or when a tile would hold fewer than two elements, each element is its own run.
+    if (!IsPrecomputed() || element_size > kElementTileBytes / 2) {
+        for (size_t i = 0; i < num_elements; ++i) {
+            Apply(src + i * element_size, dst + i * element_size, element_size);
+        }
+        return;
+    }
+
+    // A tile repeats the first element_size bytes of the stream, so each kernel call covers whole elements.
+    // The table starts at stream position 0 and is longer than a tile, so those bytes are contiguous in it.
+    const size_t elements_per_tile = kElementTileBytes / element_size;
+    const size_t tile_size = elements_per_tile * element_size;
+    uint8_t tile[kElementTileBytes];
+    std::memcpy(tile, table_.data(), element_size);
+    for (size_t filled = element_size; filled < tile_size; filled *= 2) {
+        std::memcpy(tile + filled, tile, std::min(filled, tile_size - filled));
+    }
+
+    const XorKernel kernel = GetActiveKernel();
+    const size_t total_size = num_elements * element_size;
+    for (size_t offset = 0; offset < total_size; offset += tile_size) {
+        kernel(src + offset, tile, dst + offset, std::min(tile_size, total_size - offset));
+    }
+}
+
+} // namespace dbps::processing
@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef DBPS_EXPORT
+#define DBPS_EXPORT
+#endif
+
+namespace dbps::processing {
+
+// Instruction set levels of the XOR kernels, from slowest to fastest.
+enum class XorKernelLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+    kAvx512
+};
+
+DBPS_EXPORT const char* XorKernelLevelName(XorKernelLevel level);
+
+// Whether the CPU running the process (and the build) supports the kernel of this level.
+DBPS_EXPORT bool IsXorKernelLevelSupported(XorKernelLevel level);
+
+// Fastest supported level, detected once from the CPU features. This is the level used by XorBytes.
+DBPS_EXPORT XorKernelLevel GetActiveXorKernelLevel();
+
+// dst[i] = src[i] ^ key[i] for i in [0, n). dst may alias src.
+DBPS_EXPORT void XorBytes(const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n);
+
+// Same as above with the kernel of an explicit level, which must be supported. For tests and benchmarks.
+DBPS_EXPORT void XorBytes(XorKernelLevel level, const uint8_t* src, const uint8_t* key, uint8_t* dst, size_t n);
+
+/**
+ * Precomputed key stream of BasicXorEncryptor.
+ *
+ * The key stream emits the low byte of a state that is rotated after every byte. The state sequence is
+ * eventually periodic (a short prefix followed by a cycle of at most a few dozen states), so the stream is
+ * materialized once per key as its prefix followed by the cycle repeated over a few KB. XORing with the
+ * stream is then a run of XorBytes calls over that table instead of a byte-at-a-time loop.
+ *
+ * Positions index the stream from its start, so a block processed in segments passes the position reached
+ * by the previous segment. If no cycle is found within a bounded number of states, the byte loop is used.
+ */
+class DBPS_EXPORT XorKeyStream {
+public:
+    explicit XorKeyStream(size_t key_hash);
+
+    // State after `state` in the key stream.
+    static size_t NextState(size_t state) {
+        return (state << 1) | (state >> 31);
+    }
+
+    // XORs n bytes with the key stream starting at `position`. Returns the position after them.
+    size_t Apply(const uint8_t* src, uint8_t* dst, size_t n, size_t position = 0) const;
+
+    // XORs num_elements contiguous elements of element_size bytes, restarting the key stream on every element.
+    void ApplyPerElement(const uint8_t* src, uint8_t* dst, size_t num_elements, size_t element_size) const;
+
+private:
+    const size_t key_hash_;
+    // Stream bytes: prefix_length_ bytes, then the period_-byte cycle repeated up to the table size.
+    std::vector<uint8_t> table_;
+    size_t prefix_length_ = 0;
+    size_t period_ = 0;
+
+    bool IsPrecomputed() const { return period_ != 0; }
+
+    // Index in table_ of a stream position.
+    size_t GetTableIndex(size_t position) const;
+};
+
+} // namespace dbps::processing
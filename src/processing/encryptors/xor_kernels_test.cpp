@@ -0,0 +1,162 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "xor_kernels.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace dbps::processing;
+
+namespace {
+    std::vector<uint8_t> RandomBytes(size_t n, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> bytes(n);
+        for (auto& b : bytes) {
+            b = static_cast<uint8_t>(rng());
+        }
+        return bytes;
+    }
+
+    // Byte-at-a-time key stream, as BasicXorEncryptor computed it before the precomputed stream.
+    std::vector<uint8_t> ReferenceXor(const std::vector<uint8_t>& data, size_t key_hash, size_t position = 0) {
+        for (size_t i = 0; i < position; ++i) {
+            key_hash = (key_hash << 1) | (key_hash >> 31);
+        }
+        std::vector<uint8_t> out(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            out[i] = data[i] ^ (key_hash & 0xFF);
+            key_hash = (key_hash << 1) | (key_hash >> 31);
+        }
+        return out;
+    }
+
+    const std::vector<XorKernelLevel> kAllLevels = {
+        XorKernelLevel::kScalar, XorKernelLevel::kSse2, XorKernelLevel::kAvx2, XorKernelLevel::kAvx512};
+
+    const std::vector<size_t> kKeyHashes = {
+        0, 1, 0xFF, size_t{1} << 31, std::hash<std::string>{}("test_key"), std::hash<std::string>{}("other_key")};
+}
+
+// --- Kernels ---
+
+TEST(XorKernels, ScalarIsAlwaysSupported) {
+    EXPECT_TRUE(IsXorKernelLevelSupported(XorKernelLevel::kScalar));
+    EXPECT_TRUE(IsXorKernelLevelSupported(GetActiveXorKernelLevel()));
+    EXPECT_STREQ(XorKernelLevelName(XorKernelLevel::kScalar), "scalar");
+}
+
+TEST(XorKernels, SupportedLevelsMatchScalar_AllSizesAndOffsets) {
+    const auto src = RandomBytes(1100, 1);
+    const auto key = RandomBytes(1100, 2);
+    for (auto level : kAllLevels) {
+        if (!IsXorKernelLevelSupported(level)) {
+            continue;
+        }
+        SCOPED_TRACE(XorKernelLevelName(level));
+        // Unaligned starts and every tail length around the vector widths.
+        for (size_t offset : {0, 1, 3, 7}) {
+            for (size_t n = 0; n <= 300; ++n) {
+                std::vector<uint8_t> expected(n);
+                std::vector<uint8_t> actual(n + 1, 0xAB);
+                for (size_t i = 0; i < n; ++i) {
+                    expected[i] = src[offset + i] ^ key[offset + i];
+                }
+                XorBytes(level, src.data() + offset, key.data() + offset, actual.data(), n);
+                EXPECT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin())) << "n=" << n;
+                EXPECT_EQ(actual[n], 0xAB) << "wrote past the end, n=" << n;
+            }
+        }
+    }
+}
+
+TEST(XorKernels, InPlace) {
+    const auto key = RandomBytes(1000, 3);
+    for (auto level : kAllLevels) {
+        if (!IsXorKernelLevelSupported(level)) {
+            continue;
+        }
+        auto data = RandomBytes(1000, 4);
+        const auto original = data;
+        XorBytes(level, data.data(), key.data(), data.data(), data.size());
+        XorBytes(level, data.data(), key.data(), data.data(), data.size());
+        EXPECT_EQ(data, original) << XorKernelLevelName(level);
+    }
+}
+
+// --- Key stream ---
+
+TEST(XorKeyStream, Apply_MatchesReferenceKeyStream) {
+    const auto data = RandomBytes(20000, 5);
+    for (size_t key_hash : kKeyHashes) {
+        XorKeyStream key_stream(key_hash);
+        std::vector<uint8_t> out(data.size());
+        EXPECT_EQ(key_stream.Apply(data.data(), out.data(), data.size()), data.size());
+        EXPECT_EQ(out, ReferenceXor(data, key_hash)) << "key_hash=" << key_hash;
+    }
+}
+
+TEST(XorKeyStream, Apply_FromPosition_ContinuesTheStream) {
+    const auto data = RandomBytes(9000, 6);
+    const size_t key_hash = std::hash<std::string>{}("test_key");
+    XorKeyStream key_stream(key_hash);
+    for (size_t position : {1, 31, 32, 33, 4095, 4096, 4200, 100000}) {
+        std::vector<uint8_t> out(data.size());
+        EXPECT_EQ(key_stream.Apply(data.data(), out.data(), data.size(), position), position + data.size());
+        EXPECT_EQ(out, ReferenceXor(data, key_hash, position)) << "position=" << position;
+    }
+
+    // Segments of uneven sizes, each continuing at the position the previous one reached.
+    std::vector<uint8_t> out(data.size());
+    size_t position = 0;
+    for (size_t segment_size : {7, 1, 4500, 0, 333, 4159}) {
+        position = key_stream.Apply(data.data() + position, out.data() + position, segment_size, position);
+    }
+    ASSERT_EQ(position, data.size());
+    EXPECT_EQ(out, ReferenceXor(data, key_hash));
+}
+
+TEST(XorKeyStream, ApplyPerElement_RestartsOnEveryElement) {
+    for (size_t key_hash : kKeyHashes) {
+        XorKeyStream key_stream(key_hash);
+        for (size_t element_size : {1, 4, 8, 12, 16, 33, 1000, 3000, 5000}) {
+            const size_t num_elements = 20000 / element_size + 3;
+            const auto data = RandomBytes(num_elements * element_size, static_cast<uint32_t>(element_size));
+            std::vector<uint8_t> expected;
+            for (size_t i = 0; i < num_elements; ++i) {
+                std::vector<uint8_t> element(data.begin() + i * element_size, data.begin() + (i + 1) * element_size);
+                auto encrypted = ReferenceXor(element, key_hash);
+                expected.insert(expected.end(), encrypted.begin(), encrypted.end());
+            }
+            std::vector<uint8_t> out(data.size());
+            key_stream.ApplyPerElement(data.data(), out.data(), num_elements, element_size);
+            EXPECT_EQ(out, expected) << "key_hash=" << key_hash << " element_size=" << element_size;
+        }
+    }
+}
+
+TEST(XorKeyStream, ApplyPerElement_InPlace) {
+    XorKeyStream key_stream(std::hash<std::string>{}("test_key"));
+    auto data = RandomBytes(8 * 1000, 7);
+    const auto original = data;
+    key_stream.ApplyPerElement(data.data(), data.data(), 1000, 8);
+    EXPECT_NE(data, original);
+    key_stream.ApplyPerElement(data.data(), data.data(), 1000, 8);
+    EXPECT_EQ(data, original);
+}
@@ -17,8 +17,10 @@
 
 #include "parquet_utils.h"
 #include "enum_utils.h"
+#include "buffer_pool.h"
 #include "compression_utils.h"
 #include "typed_buffer_values.h"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -221,14 +223,38 @@ tcb::span<const uint8_t> ReadDefinitionLevelBytesV1(tcb::span<const uint8_t> lev
     return def_payload;
 }
 
+// Function to skip a length-prefixed block of the level bytes. The page may be segmented, so the length prefix
+// is read across segment boundaries and the payload is not touched.
+void SkipV1LengthPrefixedBlock(const SegmentedBytes& bytes, size_t& offset) {
+    if (offset + 4 > bytes.size()) {
+        throw InvalidInputException(
+            "Invalid Parquet DATA_PAGE_V1 level bytes: missing 4-byte length prefix");
+    }
+    uint32_t len = bytes.ReadU32LE(offset);
+    const size_t payload_offset = offset + 4;
+    if (len > bytes.size() - payload_offset) {
+        throw InvalidInputException(
+            "Invalid Parquet DATA_PAGE_V1 level bytes: length-prefixed block exceeds bounds");
+    }
+    offset = payload_offset + static_cast<size_t>(len);
+}
+
 // -----------------------------------------------------------------------------
 // Helper function to calculate level bytes length
 // -----------------------------------------------------------------------------
 
 // Calculates the total length of level bytes based on encoding attributes.
 // Assumes the input encoding attributes are already validated with the required keys and expected value types.
+int CalculateLevelBytesLength(const SegmentedBytes& raw,
+    const AttributesMap& encoding_attribs);
+
 int CalculateLevelBytesLength(tcb::span<const uint8_t> raw,
     const AttributesMap& encoding_attribs) {
+    return CalculateLevelBytesLength(SegmentedBytes(raw), encoding_attribs);
+}
+
+int CalculateLevelBytesLength(const SegmentedBytes& raw,
+    const AttributesMap& encoding_attribs) {
 
     // Get page_type from the converted attributes
     const std::string& page_type = std::get<std::string>(encoding_attribs.at("page_type"));
@@ -258,12 +284,12 @@ int CalculateLevelBytesLength(tcb::span<const uint8_t> raw,
         size_t offset = 0;
         if (max_rep_level > 0) {
             size_t start_offset = offset;
-            (void) ReadV1LengthPrefixedPayload(raw, offset);
+            SkipV1LengthPrefixedBlock(raw, offset);
             total_level_bytes += static_cast<int>(offset - start_offset);
         }
         if (max_def_level > 0) {
             size_t start_offset = offset;
-            (void) ReadV1LengthPrefixedPayload(raw, offset);
+            SkipV1LengthPrefixedBlock(raw, offset);
             total_level_bytes += static_cast<int>(offset - start_offset);
         }
 
@@ -289,6 +315,49 @@ int CalculateLevelBytesLength(tcb::span<const uint8_t> raw,
     return total_level_bytes;
 }
 
+// -----------------------------------------------------------------------------
+// Helper function to count the values encoded in the value bytes of a page
+// -----------------------------------------------------------------------------
+
+size_t CountPageValueElements(
+    const std::string& page_type, tcb::span<const uint8_t> level_bytes, const AttributesMap& encoding_attributes) {
+    if (page_type == "DATA_PAGE_V1") {
+        // For DATA_PAGE_V1, data_page_num_values is the count of logical rows (includes nulls).
+        // The V1 header does not carry num_nulls, so we cannot derive present values as in V2.
+        // To get the number of encoded physical values in value_bytes, we must parse definition levels.
+        const int32_t num_values = std::get<int32_t>(encoding_attributes.at("data_page_num_values"));
+        int32_t max_def_level = std::get<int32_t>(encoding_attributes.at("data_page_max_definition_level"));
+        int32_t max_rep_level = std::get<int32_t>(encoding_attributes.at("data_page_max_repetition_level"));
+        if (max_def_level == 0) {
+            // All values are present in the value bytes section.
+            return static_cast<size_t>(num_values);
+        }
+        // If max_def_level > 0, there are definition levels bytes. So parse it and count the present values.
+        auto def_bytes_payload = ReadDefinitionLevelBytesV1(level_bytes, max_rep_level);
+        return CountPresentValuesFromDefinitionLevelsV1(def_bytes_payload, num_values, max_def_level);
+    }
+
+    if (page_type == "DATA_PAGE_V2") {
+        // For DATA_PAGE_V2, data_page_num_values is the count of logical rows, not present values. data_page_num_values includes nulls. 
+        // num_nulls is the count of nulls in the page.
+        // So num_elements (the present values) is num_values - num_nulls.
+        int32_t num_values = std::get<int32_t>(encoding_attributes.at("data_page_num_values"));
+        int32_t num_nulls = std::get<int32_t>(encoding_attributes.at("page_v2_num_nulls"));
+        if (num_nulls > num_values) {
+            throw InvalidInputException(
+                "Invalid num_nulls: " + std::to_string(num_nulls) + " > num_values: " +
+                std::to_string(num_values) + " in DATA_PAGE_V2 encoding attributes");
+        }
+        return static_cast<size_t>(num_values - num_nulls);
+    }
+
+    if (page_type == "DICTIONARY_PAGE") {
+        return static_cast<size_t>(std::get<int32_t>(encoding_attributes.at("dict_page_num_values")));
+    }
+
+    throw InvalidInputException("Unexpected page type: " + page_type);
+}
+
 // -----------------------------------------------------------------------------
 // Public functions to process Parquet formatted Dictionary and Data pages
 // -----------------------------------------------------------------------------
@@ -305,29 +374,17 @@ LevelAndValueBytes DecompressAndSplit(
     // So the split of level and value byte requires to:
     // (1) decompress the whole payload, (2) calculate length of level bytes, (3) split into level and value bytes.
     if (page_type == "DATA_PAGE_V1") {
-        auto decompressed_bytes = Decompress(plaintext, compression);
-        int leading_bytes_to_strip = CalculateLevelBytesLength(
-            decompressed_bytes, encoding_attributes);
-        auto [level_bytes, value_bytes] = Split(decompressed_bytes, leading_bytes_to_strip);
-
-        // For DATA_PAGE_V1, data_page_num_values is the count of logical rows (includes nulls).
-        // The V1 header does not carry num_nulls, so we cannot derive present values as in V2.
-        // To get the number of encoded physical values in value_bytes, we must parse definition levels.
-        size_t num_elements = 0;
-        const int32_t num_values = std::get<int32_t>(encoding_attributes.at("data_page_num_values"));
-        int32_t max_def_level = std::get<int32_t>(encoding_attributes.at("data_page_max_definition_level"));
-        int32_t max_rep_level = std::get<int32_t>(encoding_attributes.at("data_page_max_repetition_level"));
-        if (max_def_level == 0) {
-            // All values are present in the value bytes section.
-            num_elements = static_cast<size_t>(num_values);
+        std::vector<uint8_t> decompressed_bytes;
+        tcb::span<const uint8_t> page_bytes = plaintext;
+        if (compression != CompressionCodec::UNCOMPRESSED) {
+            decompressed_bytes = Decompress(plaintext, compression);
+            page_bytes = decompressed_bytes;
         }
-        // If max_def_level > 0, there are definition levels bytes. So parse it and count the present values.
-        else {
-            auto def_bytes_payload = ReadDefinitionLevelBytesV1(level_bytes, max_rep_level);
-            num_elements = CountPresentValuesFromDefinitionLevelsV1(def_bytes_payload, num_values, max_def_level);
-        }
-
-        return LevelAndValueBytes{std::move(level_bytes), std::move(value_bytes), num_elements};
+        int leading_bytes_to_strip = CalculateLevelBytesLength(
+            page_bytes, encoding_attributes);
+        auto [level_bytes, value_bytes] = Split(page_bytes, leading_bytes_to_strip);
+        size_t num_elements = CountPageValueElements(page_type, level_bytes, encoding_attributes);
+        return LevelAndValueBytes(level_bytes, value_bytes, num_elements, std::move(decompressed_bytes));
     }
 
     // On DATA_PAGE_V2, only the value bytes are compressed.
@@ -336,83 +393,182 @@ LevelAndValueBytes DecompressAndSplit(
     if (page_type == "DATA_PAGE_V2") {
         int leading_bytes_to_strip = CalculateLevelBytesLength(
             plaintext, encoding_attributes);
-        auto [level_bytes_span, compressed_value_bytes_span] = Split(plaintext, leading_bytes_to_strip);
-        std::vector<uint8_t> level_bytes(level_bytes_span.begin(), level_bytes_span.end());
+        auto [level_bytes, value_bytes] = Split(plaintext, leading_bytes_to_strip);
 
+        // Level bytes are never compressed, so they always point into plaintext.
         bool page_v2_is_compressed = std::get<bool>(
             encoding_attributes.at("page_v2_is_compressed"));
-        std::vector<uint8_t> value_bytes;
-        if (page_v2_is_compressed) {
-            value_bytes = Decompress(compressed_value_bytes_span, compression);
-        } else {
-            value_bytes = std::vector<uint8_t>(compressed_value_bytes_span.begin(), compressed_value_bytes_span.end());
+        std::vector<uint8_t> decompressed_bytes;
+        if (page_v2_is_compressed && compression != CompressionCodec::UNCOMPRESSED) {
+            decompressed_bytes = Decompress(value_bytes, compression);
+            value_bytes = decompressed_bytes;
         }
+        size_t num_elements = CountPageValueElements(page_type, level_bytes, encoding_attributes);
+        return LevelAndValueBytes(level_bytes, value_bytes, num_elements, std::move(decompressed_bytes));
+    }
 
-        // For DATA_PAGE_V2, data_page_num_values is the count of logical rows, not present values. data_page_num_values includes nulls. 
-        // num_nulls is the count of nulls in the page.
-        // So num_elements (the present values) is num_values - num_nulls.
-        int32_t num_values = std::get<int32_t>(encoding_attributes.at("data_page_num_values"));
-        int32_t num_nulls = std::get<int32_t>(encoding_attributes.at("page_v2_num_nulls"));
-        if (num_nulls > num_values) {
-            throw InvalidInputException(
-                "Invalid num_nulls: " + std::to_string(num_nulls) + " > num_values: " +
-                std::to_string(num_values) + " in DATA_PAGE_V2 encoding attributes");
+    // DICTIONARY_PAGE has no level bytes.
+    if (page_type == "DICTIONARY_PAGE") {
+        std::vector<uint8_t> decompressed_bytes;
+        tcb::span<const uint8_t> value_bytes = plaintext;
+        if (compression != CompressionCodec::UNCOMPRESSED) {
+            decompressed_bytes = Decompress(plaintext, compression);
+            value_bytes = decompressed_bytes;
         }
-        size_t num_elements = static_cast<size_t>(num_values - num_nulls);
+        size_t num_elements = CountPageValueElements(page_type, {}, encoding_attributes);
+        return LevelAndValueBytes(
+            tcb::span<const uint8_t>(), value_bytes, num_elements, std::move(decompressed_bytes));
+    }
 
-        return LevelAndValueBytes{std::move(level_bytes), std::move(value_bytes), num_elements};
+    throw InvalidInputException("Unexpected page type: " + page_type);
+}
+
+LevelAndValueBytes DecompressAndSplit(
+    const SegmentedBytes& plaintext,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes) {
+    if (plaintext.IsContiguous()) {
+        return DecompressAndSplit(plaintext.AsContiguous(), compression, encoding_attributes);
+    }
+
+    // Codecs need one contiguous input. DATA_PAGE_V1 and DICTIONARY_PAGE payloads are compressed as a whole, so
+    // their segments are gathered into a pooled buffer, released once decompressed: the result only points into
+    // the decompressed bytes.
+    auto page_type = std::get<std::string>(encoding_attributes.at("page_type"));
+    const bool is_page_v2 = (page_type == "DATA_PAGE_V2");
+    if (!is_page_v2 && compression != CompressionCodec::UNCOMPRESSED) {
+        std::vector<uint8_t> gathered = AcquireUninitializedBuffer(plaintext.size());
+        plaintext.CopyTo(0, gathered);
+        auto split_page = DecompressAndSplit(gathered, compression, encoding_attributes);
+        ReleaseBuffer(std::move(gathered));
+        return split_page;
+    }
+
+    // Otherwise the level and value bytes are viewed in place when each lies within one segment (e.g. DATA_PAGE_V2
+    // levels and values held in separate buffers). Only a range that straddles segments is gathered, into the
+    // buffer owned by the result.
+    const size_t level_size = static_cast<size_t>(CalculateLevelBytesLength(plaintext, encoding_attributes));
+    const size_t value_size = plaintext.size() - level_size;
+    const bool gather_levels = !plaintext.IsWithinOneSegment(0, level_size);
+    std::vector<uint8_t> scratch;
+    tcb::span<const uint8_t> level_bytes = gather_levels ? tcb::span<const uint8_t>()
+                                                         : plaintext.GetContiguous(0, level_size, scratch);
+    tcb::span<const uint8_t> value_bytes;
+    std::vector<uint8_t> owned_bytes;
+
+    const bool page_v2_is_compressed = is_page_v2 && std::get<bool>(encoding_attributes.at("page_v2_is_compressed"));
+    if (page_v2_is_compressed && compression != CompressionCodec::UNCOMPRESSED) {
+        // Only the value bytes are compressed. Straddling levels go after the decompressed values.
+        auto compressed_values = plaintext.GetContiguous(level_size, value_size, scratch);
+        owned_bytes = Decompress(compressed_values, compression);
+        ReleaseBuffer(std::move(scratch));
+        const size_t decompressed_size = owned_bytes.size();
+        if (gather_levels) {
+            owned_bytes.resize(decompressed_size + level_size);
+            plaintext.CopyTo(0, tcb::span<uint8_t>(owned_bytes.data() + decompressed_size, level_size));
+            level_bytes = tcb::span<const uint8_t>(owned_bytes.data() + decompressed_size, level_size);
+        }
+        value_bytes = tcb::span<const uint8_t>(owned_bytes.data(), decompressed_size);
+    } else {
+        const bool gather_values = !plaintext.IsWithinOneSegment(level_size, value_size);
+        owned_bytes = AcquireUninitializedBuffer((gather_levels ? level_size : 0) + (gather_values ? value_size : 0));
+        size_t owned_offset = 0;
+        if (gather_levels) {
+            plaintext.CopyTo(0, tcb::span<uint8_t>(owned_bytes.data(), level_size));
+            level_bytes = tcb::span<const uint8_t>(owned_bytes.data(), level_size);
+            owned_offset = level_size;
+        }
+        if (gather_values) {
+            plaintext.CopyTo(level_size, tcb::span<uint8_t>(owned_bytes.data() + owned_offset, value_size));
+            value_bytes = tcb::span<const uint8_t>(owned_bytes.data() + owned_offset, value_size);
+        } else {
+            value_bytes = plaintext.GetContiguous(level_size, value_size, scratch);
+        }
+    }
+
+    size_t num_elements = CountPageValueElements(page_type, level_bytes, encoding_attributes);
+    return LevelAndValueBytes(level_bytes, value_bytes, num_elements, std::move(owned_bytes));
+}
+
+size_t MaxCompressAndJoinSize(
+    size_t level_bytes_size,
+    size_t value_bytes_size,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes) {
+
+    // Get the page type from the encoding attributes.
+    const auto& page_type = std::get<std::string>(encoding_attributes.at("page_type"));
+
+    if (page_type == "DATA_PAGE_V1") {
+        return MaxCompressedSize(level_bytes_size + value_bytes_size, compression);
+    }
+
+    if (page_type == "DATA_PAGE_V2") {
+        bool page_v2_is_compressed =
+            std::get<bool>(encoding_attributes.at("page_v2_is_compressed"));
+        return level_bytes_size + MaxCompressedSize(
+            value_bytes_size, page_v2_is_compressed ? compression : CompressionCodec::UNCOMPRESSED);
     }
 
-    // DICTIONARY_PAGE has no level bytes.
     if (page_type == "DICTIONARY_PAGE") {
-        auto level_bytes = std::vector<uint8_t>();
-        auto value_bytes = Decompress(plaintext, compression);
-        size_t num_elements = static_cast<size_t>( std::get<int32_t>(encoding_attributes.at("dict_page_num_values")));
-        return LevelAndValueBytes{std::move(level_bytes), std::move(value_bytes), num_elements};
+        return MaxCompressedSize(value_bytes_size, compression);
     }
 
     throw InvalidInputException("Unexpected page type: " + page_type);
 }
 
-std::vector<uint8_t> CompressAndJoin(
-    const std::vector<uint8_t>& level_bytes,
-    const std::vector<uint8_t>& value_bytes,
+size_t CompressAndJoinInto(
+    tcb::span<const uint8_t> level_bytes,
+    tcb::span<const uint8_t> value_bytes,
     CompressionCodec::type compression,
-    const AttributesMap& encoding_attributes) {
+    const AttributesMap& encoding_attributes,
+    tcb::span<uint8_t> out,
+    bool verify_level_bytes) {
 
     // Get the page type from the encoding attributes.
     const auto& page_type = std::get<std::string>(encoding_attributes.at("page_type"));
     
     // Check that the calculated level bytes size == the size of the actual level bytes.
-    int expected_level_bytes = CalculateLevelBytesLength(level_bytes, encoding_attributes);
-    if (static_cast<size_t>(expected_level_bytes) != level_bytes.size()) {
-        throw InvalidInputException("Level bytes size does not match encoding attributes");
+    if (verify_level_bytes) {
+        int expected_level_bytes = CalculateLevelBytesLength(level_bytes, encoding_attributes);
+        if (static_cast<size_t>(expected_level_bytes) != level_bytes.size()) {
+            throw InvalidInputException("Level bytes size does not match encoding attributes");
+        }
     }
 
+    // On DATA_PAGE_V1, the whole payload is compressed: compress levels and values as one stream.
     if (page_type == "DATA_PAGE_V1") {
-        auto joined = Join(level_bytes, value_bytes);
-        return Compress(joined, compression);
+        return CompressConcatenatedInto(level_bytes, value_bytes, compression, out);
     }
 
+    // On DATA_PAGE_V2, only the value bytes are compressed: levels are copied as-is ahead of them.
     if (page_type == "DATA_PAGE_V2") {
         bool page_v2_is_compressed =
             std::get<bool>(encoding_attributes.at("page_v2_is_compressed"));
-        if (page_v2_is_compressed) {
-            auto compressed_values = Compress(value_bytes, compression);
-            return Join(level_bytes, compressed_values);
-        } else {
-            return Join(level_bytes, value_bytes);
-        }
+        return CompressWithRawPrefixInto(
+            level_bytes, value_bytes, page_v2_is_compressed ? compression : CompressionCodec::UNCOMPRESSED, out);
     }
 
     // DICTIONARY_PAGE has no level bytes.
     if (page_type == "DICTIONARY_PAGE") {
-        return Compress(value_bytes, compression);
+        return CompressConcatenatedInto(value_bytes, {}, compression, out);
     }
 
     throw InvalidInputException("Unexpected page type: " + page_type);
 }
 
+std::vector<uint8_t> CompressAndJoin(
+    tcb::span<const uint8_t> level_bytes,
+    tcb::span<const uint8_t> value_bytes,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes) {
+    // Only the bytes written by CompressAndJoinInto are kept, so the page is taken uninitialized from the pool.
+    auto page = AcquireUninitializedBuffer(
+        MaxCompressAndJoinSize(level_bytes.size(), value_bytes.size(), compression, encoding_attributes));
+    page.resize(CompressAndJoinInto(level_bytes, value_bytes, compression, encoding_attributes, page));
+    return page;
+}
+
 // -----------------------------------------------------------------------------
 // Public functions to build Parquet formatted value bytes into TypedValuesBuffer
 // -----------------------------------------------------------------------------
@@ -475,4 +631,87 @@ std::vector<uint8_t> GetTypedValuesBufferAsValueBytes(TypedValuesBuffer&& buffer
     }, buffer);
 }
 
+std::vector<ValueBytesChunk> SplitValueBytesIntoChunks(
+    tcb::span<const uint8_t> value_bytes,
+    size_t num_elements,
+    Type::type datatype,
+    const std::optional<int>& datatype_length,
+    size_t max_chunk_bytes) {
+
+    if (max_chunk_bytes == 0) {
+        throw InvalidInputException("SplitValueBytesIntoChunks requires max_chunk_bytes > 0");
+    }
+
+    std::vector<ValueBytesChunk> chunks;
+
+    // BYTE_ARRAY values are length-prefixed, so chunk boundaries are found by walking the prefixes.
+    if (datatype == Type::BYTE_ARRAY) {
+        size_t chunk_start = 0;
+        size_t chunk_num_elements = 0;
+        size_t cursor = 0;
+        for (size_t i = 0; i < num_elements; ++i) {
+            if (value_bytes.size() - cursor < ::kSizePrefixBytes) {
+                throw InvalidInputException("Malformed BYTE_ARRAY value bytes: truncated length prefix");
+            }
+            const size_t value_size = ::kSizePrefixBytes + read_u32_le(value_bytes.data() + cursor);
+            if (value_bytes.size() - cursor < value_size) {
+                throw InvalidInputException("Malformed BYTE_ARRAY value bytes: truncated value");
+            }
+            // Close the current chunk if the value does not fit in it.
+            if (chunk_num_elements > 0 && cursor + value_size - chunk_start > max_chunk_bytes) {
+                chunks.push_back({value_bytes.subspan(chunk_start, cursor - chunk_start), chunk_num_elements});
+                chunk_start = cursor;
+                chunk_num_elements = 0;
+            }
+            cursor += value_size;
+            ++chunk_num_elements;
+        }
+        if (cursor != value_bytes.size()) {
+            throw InvalidInputException("Malformed BYTE_ARRAY value bytes: trailing bytes after the last value");
+        }
+        if (chunk_num_elements > 0) {
+            chunks.push_back({value_bytes.subspan(chunk_start, cursor - chunk_start), chunk_num_elements});
+        }
+        return chunks;
+    }
+
+    // Fixed-size values: every chunk holds the same number of values, except the last one.
+    size_t element_size = 0;
+    switch (datatype) {
+        case Type::INT32:
+        case Type::FLOAT:
+            element_size = 4;
+            break;
+        case Type::INT64:
+        case Type::DOUBLE:
+            element_size = 8;
+            break;
+        case Type::INT96:
+            element_size = 12;
+            break;
+        case Type::FIXED_LEN_BYTE_ARRAY:
+            if (!datatype_length.has_value() || datatype_length.value() <= 0) {
+                throw InvalidInputException("FIXED_LEN_BYTE_ARRAY requires a positive datatype_length");
+            }
+            element_size = static_cast<size_t>(datatype_length.value());
+            break;
+        case Type::BOOLEAN:
+            throw DBPSUnsupportedException("On SplitValueBytesIntoChunks, BOOLEAN datatype "
+                "values are bit-encoded and not expanded as bytes, so BOOLEAN is not supported.");
+        default:
+            throw InvalidInputException("Invalid datatype: " + std::string(to_string(datatype)));
+    }
+    if (value_bytes.size() != num_elements * element_size) {
+        throw InvalidInputException("Malformed fixed-size value bytes: size does not match num_elements");
+    }
+    const size_t elements_per_chunk = std::max<size_t>(1, max_chunk_bytes / element_size);
+    chunks.reserve((num_elements + elements_per_chunk - 1) / elements_per_chunk);
+    for (size_t first = 0; first < num_elements; first += elements_per_chunk) {
+        const size_t chunk_num_elements = std::min(elements_per_chunk, num_elements - first);
+        chunks.push_back({value_bytes.subspan(first * element_size, chunk_num_elements * element_size),
+                          chunk_num_elements});
+    }
+    return chunks;
+}
+
 // -----------------------------------------------------------------------------
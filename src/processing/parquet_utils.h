@@ -23,6 +23,7 @@
 #include <map>
 #include <variant>
 #include <cstdint>
+#include <utility>
 #include <tcb/span.hpp>
 #include "enums.h"
 #include "../common/exceptions.h"
@@ -30,10 +31,35 @@
 #include "typed_buffer_values.h"
 #include "../common/bytes_utils.h"
 
+/**
+ * Level and value bytes of a Parquet page, as non-owning views.
+ *
+ * The spans point either into the caller's input (uncompressed payloads, no copies) or into
+ * decompressed_bytes, the single buffer owned by this struct when the page had to be decompressed.
+ * The caller's input must outlive the struct. Move-only, since a copy would alias decompressed_bytes
+ * of the original.
+ */
 struct LevelAndValueBytes {
-    std::vector<uint8_t> level_bytes;
-    std::vector<uint8_t> value_bytes;
-    size_t num_elements;
+    tcb::span<const uint8_t> level_bytes;
+    tcb::span<const uint8_t> value_bytes;
+    size_t num_elements = 0;
+    std::vector<uint8_t> decompressed_bytes;
+
+    LevelAndValueBytes(
+        tcb::span<const uint8_t> level_bytes,
+        tcb::span<const uint8_t> value_bytes,
+        size_t num_elements,
+        std::vector<uint8_t> decompressed_bytes = {})
+        : level_bytes(level_bytes),
+          value_bytes(value_bytes),
+          num_elements(num_elements),
+          decompressed_bytes(std::move(decompressed_bytes)) {}
+
+    // Moving a std::vector keeps its heap storage, so the spans remain valid after a move.
+    LevelAndValueBytes(LevelAndValueBytes&&) = default;
+    LevelAndValueBytes& operator=(LevelAndValueBytes&&) = default;
+    LevelAndValueBytes(const LevelAndValueBytes&) = delete;
+    LevelAndValueBytes& operator=(const LevelAndValueBytes&) = delete;
 };
 
 using namespace dbps::external;
@@ -46,22 +72,73 @@ using namespace dbps::external;
  * Decompresses and splits a Parquet page into level and value bytes.
  * Handles DATA_PAGE_V1, DATA_PAGE_V2 (including optional compression on value bytes),
  * and DICTIONARY_PAGE.
+ *
+ * Zero-copy for uncompressed payloads: the returned spans point into plaintext, which must outlive
+ * the result. Compressed payloads are decompressed once into the buffer owned by the result.
  */
  LevelAndValueBytes DecompressAndSplit(
     tcb::span<const uint8_t> plaintext,
     CompressionCodec::type compression,
     const AttributesMap& encoding_attributes);
 
+/**
+ * Same as DecompressAndSplit, for a page payload held in several segments (e.g. received in network chunks, or
+ * DATA_PAGE_V2 levels and values in separate caller buffers), without concatenating the segments first.
+ *
+ * Uncompressed level and value bytes are viewed in place when each lies within one segment. Only a range that
+ * straddles segments is gathered, into the buffer owned by the result. Compressed payloads are gathered for
+ * decompression, since the codecs need one contiguous input.
+ */
+LevelAndValueBytes DecompressAndSplit(
+    const SegmentedBytes& plaintext,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes);
+
+/**
+ * Number of values encoded in the value bytes of a page (the present values, nulls excluded), from the encoding
+ * attributes and, for DATA_PAGE_V1 pages with definition levels, the level bytes.
+ * @throws InvalidInputException on an unexpected page type or malformed level bytes
+ */
+size_t CountPageValueElements(
+    const std::string& page_type, tcb::span<const uint8_t> level_bytes, const AttributesMap& encoding_attributes);
+
 /**
  * Reverse of DecompressAndSplit: joins level/value bytes and applies compression
  * based on page type and encoding attributes.
+ *
+ * The level and value bytes are written (or compressed) straight into the returned page, without
+ * an intermediate joined buffer.
  */
 std::vector<uint8_t> CompressAndJoin(
-    const std::vector<uint8_t>& level_bytes,
-    const std::vector<uint8_t>& value_bytes,
+    tcb::span<const uint8_t> level_bytes,
+    tcb::span<const uint8_t> value_bytes,
     CompressionCodec::type compression,
     const AttributesMap& encoding_attributes);
 
+/**
+ * Upper bound of the CompressAndJoin output size for level and value bytes of the given sizes.
+ */
+size_t MaxCompressAndJoinSize(
+    size_t level_bytes_size,
+    size_t value_bytes_size,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes);
+
+/**
+ * Same as CompressAndJoin, writing the page into a caller-provided buffer of at least
+ * MaxCompressAndJoinSize bytes. Returns the number of bytes written.
+ * With verify_level_bytes false, the level bytes are trusted to match the encoding attributes and are not
+ * parsed again (e.g. level bytes decrypted from a trusted ciphertext).
+ * @throws InvalidInputException if out is smaller than the bound
+ */
+size_t CompressAndJoinInto(
+    tcb::span<const uint8_t> level_bytes,
+    tcb::span<const uint8_t> value_bytes,
+    CompressionCodec::type compression,
+    const AttributesMap& encoding_attributes,
+    tcb::span<uint8_t> out,
+    bool verify_level_bytes = true);
+
 
 // -----------------------------------------------------------------------------
 // Functions for zero-copy reinterpretation of raw value bytes into a typed buffer.
@@ -89,6 +166,30 @@ dbps::processing::TypedValuesBuffer ReinterpretValueBytesAsTypedValuesBuffer(
     const std::optional<int>& datatype_length,
     Encoding::type encoding);
 
+/**
+ * A run of consecutive whole values within the value bytes of a page, as a non-owning view.
+ */
+struct ValueBytesChunk {
+    tcb::span<const uint8_t> value_bytes;
+    size_t num_elements = 0;
+};
+
+/**
+ * Splits PLAIN value bytes into consecutive chunks of whole values of at most max_chunk_bytes each.
+ * A single value larger than max_chunk_bytes gets a chunk of its own. Each chunk can be passed to
+ * ReinterpretValueBytesAsTypedValuesBuffer on its own.
+ *
+ * The chunks point into value_bytes, which must outlive them.
+ * @throws DBPSUnsupportedException for BOOLEAN values (bit-packed)
+ * @throws InvalidInputException if max_chunk_bytes is 0, or the value bytes do not hold num_elements values
+ */
+std::vector<ValueBytesChunk> SplitValueBytesIntoChunks(
+    tcb::span<const uint8_t> value_bytes,
+    size_t num_elements,
+    Type::type datatype,
+    const std::optional<int>& datatype_length,
+    size_t max_chunk_bytes);
+
 /**
  * Finalize a typed buffer and return the raw value bytes.
  * Consumes the buffer via rvalue-reference; caller must pass std::move(buffer).
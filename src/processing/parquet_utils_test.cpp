@@ -49,6 +49,16 @@ int CalculateLevelBytesLength(tcb::span<const uint8_t> raw,
 
 namespace {
 
+// Copies the bytes viewed by a span, to compare the split results against the expected vectors.
+std::vector<uint8_t> ToBytes(tcb::span<const uint8_t> bytes) {
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+// Returns true if the view lies within the given buffer.
+bool IsViewInto(tcb::span<const uint8_t> view, const std::vector<uint8_t>& buffer) {
+    return view.data() >= buffer.data() && view.data() + view.size() <= buffer.data() + buffer.size();
+}
+
 // Encodes an unsigned integer as ULEB128 bytes (base-128 varint) for test payload construction.
 // Each output byte stores 7 data bits; the MSB is a continuation flag.
 // - Example: 6   -> {0x06}        (single byte, continuation flag not set)
@@ -457,8 +467,8 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV2_Uncompressed) {
     auto result = DecompressAndSplit(
         plaintext, CompressionCodec::UNCOMPRESSED, attribs_conv);
 
-    EXPECT_EQ(level_bytes, result.level_bytes);
-    EXPECT_EQ(value_bytes, result.value_bytes);
+    EXPECT_EQ(level_bytes, ToBytes(result.level_bytes));
+    EXPECT_EQ(value_bytes, ToBytes(result.value_bytes));
 }
 
 TEST(ParquetUtils, DecompressAndSplit_DataPageV2_Compressed) {
@@ -484,8 +494,8 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV2_Compressed) {
     auto result = DecompressAndSplit(
         plaintext, CompressionCodec::SNAPPY, attribs_conv);
 
-    EXPECT_EQ(level_bytes, result.level_bytes);
-    EXPECT_EQ(value_bytes, result.value_bytes);
+    EXPECT_EQ(level_bytes, ToBytes(result.level_bytes));
+    EXPECT_EQ(value_bytes, ToBytes(result.value_bytes));
 }
 
 TEST(ParquetUtils, DecompressAndSplit_DataPageV2_UnsupportedCompression) {
@@ -520,7 +530,7 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV1_Required_NoLevels) {
     auto result = DecompressAndSplit(value_bytes, CompressionCodec::UNCOMPRESSED, attribs);
 
     EXPECT_TRUE(result.level_bytes.empty());
-    EXPECT_EQ(value_bytes, result.value_bytes);
+    EXPECT_EQ(value_bytes, ToBytes(result.value_bytes));
     EXPECT_EQ(4u, result.num_elements);
 }
 
@@ -540,8 +550,8 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV1_Nullable_RleAllPresent) {
     std::vector<uint8_t> plaintext = Join(level_bytes, value_bytes);
 
     auto result = DecompressAndSplit(plaintext, CompressionCodec::UNCOMPRESSED, attribs);
-    EXPECT_EQ(level_bytes, result.level_bytes);
-    EXPECT_EQ(value_bytes, result.value_bytes);
+    EXPECT_EQ(level_bytes, ToBytes(result.level_bytes));
+    EXPECT_EQ(value_bytes, ToBytes(result.value_bytes));
     EXPECT_EQ(5u, result.num_elements);
 }
 
@@ -566,8 +576,8 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV1_Nullable_BitPackedWithRepLevels
     std::vector<uint8_t> plaintext = Join(level_bytes, value_bytes);
 
     auto result = DecompressAndSplit(plaintext, CompressionCodec::UNCOMPRESSED, attribs);
-    EXPECT_EQ(level_bytes, result.level_bytes);
-    EXPECT_EQ(value_bytes, result.value_bytes);
+    EXPECT_EQ(level_bytes, ToBytes(result.level_bytes));
+    EXPECT_EQ(value_bytes, ToBytes(result.value_bytes));
     EXPECT_EQ(3u, result.num_elements);
 }
 
@@ -591,6 +601,140 @@ TEST(ParquetUtils, DecompressAndSplit_DataPageV1_InvalidDefinitionPayload) {
         InvalidInputException);
 }
 
+TEST(ParquetUtils, DecompressAndSplit_Uncompressed_IsZeroCopy) {
+    AttributesMap attribs_v1 = {
+        {"page_type", std::string("DATA_PAGE_V1")},
+        {"data_page_num_values", int32_t(5)},
+        {"data_page_max_repetition_level", int32_t(0)},
+        {"data_page_max_definition_level", int32_t(1)},
+        {"page_v1_repetition_level_encoding", std::string("RLE")},
+        {"page_v1_definition_level_encoding", std::string("RLE")}
+    };
+    std::vector<uint8_t> level_bytes = WrapLengthPrefixed(MakeRleDefPayload(5, 1, 1));
+    std::vector<uint8_t> plaintext_v1 = Join(level_bytes, {0x10, 0x20, 0x30, 0x40, 0x50});
+
+    auto result_v1 = DecompressAndSplit(plaintext_v1, CompressionCodec::UNCOMPRESSED, attribs_v1);
+    EXPECT_TRUE(result_v1.decompressed_bytes.empty());
+    EXPECT_EQ(result_v1.level_bytes.data(), plaintext_v1.data());
+    EXPECT_EQ(result_v1.value_bytes.data(), plaintext_v1.data() + level_bytes.size());
+
+    AttributesMap attribs_v2 = {
+        {"page_type", std::string("DATA_PAGE_V2")},
+        {"data_page_num_values", int32_t(2)},
+        {"data_page_max_definition_level", int32_t(1)},
+        {"data_page_max_repetition_level", int32_t(0)},
+        {"page_v2_definition_levels_byte_length", int32_t(1)},
+        {"page_v2_repetition_levels_byte_length", int32_t(0)},
+        {"page_v2_num_nulls", int32_t(0)},
+        {"page_v2_is_compressed", false}
+    };
+    std::vector<uint8_t> plaintext_v2 = {0x01, 0x21, 0x22};
+
+    // An uncompressed V2 page of a SNAPPY column is not decompressed either.
+    auto result_v2 = DecompressAndSplit(plaintext_v2, CompressionCodec::SNAPPY, attribs_v2);
+    EXPECT_TRUE(result_v2.decompressed_bytes.empty());
+    EXPECT_EQ(result_v2.level_bytes.data(), plaintext_v2.data());
+    EXPECT_EQ(result_v2.value_bytes.data(), plaintext_v2.data() + 1);
+
+    AttributesMap attribs_dict = {
+        {"page_type", std::string("DICTIONARY_PAGE")},
+        {"dict_page_num_values", int32_t(1)}
+    };
+    std::vector<uint8_t> plaintext_dict = {0x01, 0x02, 0x03, 0x04};
+
+    auto result_dict = DecompressAndSplit(plaintext_dict, CompressionCodec::UNCOMPRESSED, attribs_dict);
+    EXPECT_TRUE(result_dict.level_bytes.empty());
+    EXPECT_EQ(result_dict.value_bytes.data(), plaintext_dict.data());
+    EXPECT_EQ(result_dict.value_bytes.size(), plaintext_dict.size());
+}
+
+TEST(ParquetUtils, DecompressAndSplit_Compressed_ViewsOwnedBuffer) {
+    AttributesMap attribs = {
+        {"page_type", std::string("DATA_PAGE_V1")},
+        {"data_page_num_values", int32_t(4)},
+        {"data_page_max_repetition_level", int32_t(0)},
+        {"data_page_max_definition_level", int32_t(0)},
+        {"page_v1_repetition_level_encoding", std::string("RLE")},
+        {"page_v1_definition_level_encoding", std::string("RLE")}
+    };
+    std::vector<uint8_t> value_bytes = {0x11, 0x22, 0x33, 0x44};
+    auto compressed = Compress(value_bytes, CompressionCodec::SNAPPY);
+
+    auto result = DecompressAndSplit(compressed, CompressionCodec::SNAPPY, attribs);
+    EXPECT_TRUE(IsViewInto(result.value_bytes, result.decompressed_bytes));
+
+    // The views must stay valid when the result is moved.
+    LevelAndValueBytes moved = std::move(result);
+    EXPECT_TRUE(IsViewInto(moved.value_bytes, moved.decompressed_bytes));
+    EXPECT_EQ(ToBytes(moved.value_bytes), value_bytes);
+}
+
+TEST(ParquetUtils, DecompressAndSplit_Segmented_MatchesContiguous) {
+    AttributesMap attribs_v1 = {
+        {"page_type", std::string("DATA_PAGE_V1")},
+        {"data_page_num_values", int32_t(5)},
+        {"data_page_max_repetition_level", int32_t(0)},
+        {"data_page_max_definition_level", int32_t(1)},
+        {"page_v1_repetition_level_encoding", std::string("RLE")},
+        {"page_v1_definition_level_encoding", std::string("RLE")}
+    };
+    std::vector<uint8_t> plaintext_v1 =
+        Join(WrapLengthPrefixed(MakeRleDefPayload(5, 1, 1)), {0x10, 0x20, 0x30, 0x40, 0x50});
+
+    AttributesMap attribs_v2 = {
+        {"page_type", std::string("DATA_PAGE_V2")},
+        {"data_page_num_values", int32_t(4)},
+        {"data_page_max_definition_level", int32_t(1)},
+        {"data_page_max_repetition_level", int32_t(1)},
+        {"page_v2_definition_levels_byte_length", int32_t(2)},
+        {"page_v2_repetition_levels_byte_length", int32_t(1)},
+        {"page_v2_num_nulls", int32_t(0)},
+        {"page_v2_is_compressed", true}
+    };
+    const std::vector<uint8_t> v2_values = {0x21, 0x22, 0x23, 0x24};
+    std::vector<uint8_t> plaintext_v2_uncompressed = Join({0x01, 0x02, 0x03}, v2_values);
+    std::vector<uint8_t> plaintext_v2_compressed = Join({0x01, 0x02, 0x03}, Compress(v2_values, CompressionCodec::SNAPPY));
+
+    AttributesMap attribs_dict = {
+        {"page_type", std::string("DICTIONARY_PAGE")},
+        {"dict_page_num_values", int32_t(1)}
+    };
+    std::vector<uint8_t> plaintext_dict = {0x01, 0x02, 0x03, 0x04};
+
+    struct Case {
+        const std::vector<uint8_t>& plaintext;
+        CompressionCodec::type compression;
+        const AttributesMap& attribs;
+    };
+    const std::vector<Case> cases = {
+        {plaintext_v1, CompressionCodec::UNCOMPRESSED, attribs_v1},
+        {plaintext_v2_uncompressed, CompressionCodec::UNCOMPRESSED, attribs_v2},
+        {plaintext_v2_compressed, CompressionCodec::SNAPPY, attribs_v2},
+        {plaintext_dict, CompressionCodec::UNCOMPRESSED, attribs_dict},
+    };
+
+    // Split every page at every position, so boundaries fall inside the levels, the values and between them.
+    for (const auto& test_case : cases) {
+        const auto expected = DecompressAndSplit(test_case.plaintext, test_case.compression, test_case.attribs);
+        const tcb::span<const uint8_t> all(test_case.plaintext);
+        for (size_t split = 0; split <= all.size(); ++split) {
+            const std::vector<tcb::span<const uint8_t>> segments = {all.first(split), all.subspan(split)};
+            const auto result = DecompressAndSplit(SegmentedBytes(segments), test_case.compression, test_case.attribs);
+            EXPECT_EQ(ToBytes(result.level_bytes), ToBytes(expected.level_bytes)) << "split=" << split;
+            EXPECT_EQ(ToBytes(result.value_bytes), ToBytes(expected.value_bytes)) << "split=" << split;
+        }
+    }
+
+    // Levels and values that each lie within one segment are viewed in place.
+    const tcb::span<const uint8_t> v1_all(plaintext_v1);
+    const size_t v1_level_size = plaintext_v1.size() - 5;
+    const std::vector<tcb::span<const uint8_t>> v1_segments = {v1_all.first(v1_level_size), v1_all.subspan(v1_level_size)};
+    const auto in_place = DecompressAndSplit(SegmentedBytes(v1_segments), CompressionCodec::UNCOMPRESSED, attribs_v1);
+    EXPECT_TRUE(in_place.decompressed_bytes.empty());
+    EXPECT_EQ(in_place.level_bytes.data(), plaintext_v1.data());
+    EXPECT_EQ(in_place.value_bytes.data(), plaintext_v1.data() + v1_level_size);
+}
+
 // -----------------------------------------------------------------------------
 // Tests for CompressAndJoin function.
 // -----------------------------------------------------------------------------
@@ -615,8 +759,8 @@ TEST(ParquetUtils, CompressAndJoin_DataPageV1_Compressed) {
     EXPECT_EQ(joined, expected);
 
     auto decomposed = DecompressAndSplit(joined, CompressionCodec::SNAPPY, attribs);
-    EXPECT_EQ(decomposed.level_bytes, level_bytes);
-    EXPECT_EQ(decomposed.value_bytes, value_bytes);
+    EXPECT_EQ(ToBytes(decomposed.level_bytes), level_bytes);
+    EXPECT_EQ(ToBytes(decomposed.value_bytes), value_bytes);
 }
 
 TEST(ParquetUtils, CompressAndJoin_DataPageV2_Uncompressed) {
@@ -639,8 +783,8 @@ TEST(ParquetUtils, CompressAndJoin_DataPageV2_Uncompressed) {
     EXPECT_EQ(joined, expected);
 
     auto decomposed = DecompressAndSplit(joined, CompressionCodec::UNCOMPRESSED, attribs);
-    EXPECT_EQ(decomposed.level_bytes, level_bytes);
-    EXPECT_EQ(decomposed.value_bytes, value_bytes);
+    EXPECT_EQ(ToBytes(decomposed.level_bytes), level_bytes);
+    EXPECT_EQ(ToBytes(decomposed.value_bytes), value_bytes);
 }
 
 TEST(ParquetUtils, CompressAndJoin_DataPageV2_Compressed_RoundTrip) {
@@ -665,8 +809,37 @@ TEST(ParquetUtils, CompressAndJoin_DataPageV2_Compressed_RoundTrip) {
 
     auto decomposed = DecompressAndSplit(joined, CompressionCodec::SNAPPY, attribs);
 
-    EXPECT_EQ(decomposed.level_bytes, level_bytes);
-    EXPECT_EQ(decomposed.value_bytes, value_bytes);
+    EXPECT_EQ(ToBytes(decomposed.level_bytes), level_bytes);
+    EXPECT_EQ(ToBytes(decomposed.value_bytes), value_bytes);
+}
+
+TEST(ParquetUtils, CompressAndJoinInto_MatchesCompressAndJoin) {
+    AttributesMap attribs = {
+        {"page_type", std::string("DATA_PAGE_V2")},
+        {"data_page_num_values", int32_t(4)},
+        {"data_page_max_definition_level", int32_t(1)},
+        {"data_page_max_repetition_level", int32_t(0)},
+        {"page_v2_definition_levels_byte_length", int32_t(2)},
+        {"page_v2_repetition_levels_byte_length", int32_t(1)},
+        {"page_v2_num_nulls", int32_t(0)},
+        {"page_v2_is_compressed", true}
+    };
+
+    std::vector<uint8_t> level_bytes = {0x10, 0x11, 0x12};
+    std::vector<uint8_t> value_bytes(200, 0x42);
+
+    auto expected = CompressAndJoin(level_bytes, value_bytes, CompressionCodec::SNAPPY, attribs);
+    size_t max_size = MaxCompressAndJoinSize(level_bytes.size(), value_bytes.size(), CompressionCodec::SNAPPY, attribs);
+    ASSERT_GE(max_size, expected.size());
+
+    std::vector<uint8_t> out(max_size);
+    size_t written = CompressAndJoinInto(level_bytes, value_bytes, CompressionCodec::SNAPPY, attribs, out);
+    EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + written), expected);
+
+    std::vector<uint8_t> too_small(level_bytes.size());
+    EXPECT_THROW(
+        CompressAndJoinInto(level_bytes, value_bytes, CompressionCodec::SNAPPY, attribs, too_small),
+        InvalidInputException);
 }
 
 TEST(ParquetUtils, CompressAndJoin_DataPageV2_LevelLengthMismatch) {
@@ -687,6 +860,13 @@ TEST(ParquetUtils, CompressAndJoin_DataPageV2_LevelLengthMismatch) {
     EXPECT_THROW(
         CompressAndJoin(level_bytes, value_bytes, CompressionCodec::SNAPPY, attribs),
         InvalidInputException);
+
+    // Trusted level bytes are not checked against the attributes.
+    std::vector<uint8_t> out(MaxCompressAndJoinSize(
+        level_bytes.size(), value_bytes.size(), CompressionCodec::SNAPPY, attribs));
+    const size_t written = CompressAndJoinInto(level_bytes, value_bytes, CompressionCodec::SNAPPY, attribs, out, false);
+    EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + 2), level_bytes);
+    EXPECT_EQ(Decompress(tcb::span<const uint8_t>(out).subspan(2, written - 2), CompressionCodec::SNAPPY), value_bytes);
 }
 
 TEST(ParquetUtils, CompressAndJoin_DictionaryPage) {
@@ -1071,3 +1251,67 @@ TEST(ParquetUtils, GetAsValueBytes_WrittenBuffer) {
     std::vector<uint8_t> output_bytes = GetTypedValuesBufferAsValueBytes(std::move(variant_buf));
     EXPECT_EQ(expected, output_bytes);
 }
+
+// =============================================================================
+// SplitValueBytesIntoChunks tests
+// =============================================================================
+
+TEST(ParquetUtils, SplitValueBytesIntoChunks_FixedSize) {
+    std::vector<int32_t> values = {1, 2, 3, 4, 5, 6, 7};
+    std::vector<uint8_t> value_bytes(
+        reinterpret_cast<const uint8_t*>(values.data()),
+        reinterpret_cast<const uint8_t*>(values.data()) + values.size() * sizeof(int32_t));
+
+    // 10 bytes per chunk hold 2 INT32 values.
+    auto chunks = SplitValueBytesIntoChunks(value_bytes, values.size(), Type::INT32, std::nullopt, 10);
+    ASSERT_EQ(chunks.size(), 4u);
+    size_t offset = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i].num_elements, i < 3 ? 2u : 1u);
+        EXPECT_EQ(chunks[i].value_bytes.data(), value_bytes.data() + offset);
+        offset += chunks[i].value_bytes.size();
+    }
+    EXPECT_EQ(offset, value_bytes.size());
+
+    // Chunks smaller than a value hold one value each.
+    EXPECT_EQ(SplitValueBytesIntoChunks(value_bytes, values.size(), Type::INT32, std::nullopt, 1).size(), values.size());
+    EXPECT_THROW(SplitValueBytesIntoChunks(value_bytes, values.size() + 1, Type::INT32, std::nullopt, 10),
+                 InvalidInputException);
+    EXPECT_THROW(SplitValueBytesIntoChunks(value_bytes, values.size(), Type::INT32, std::nullopt, 0),
+                 InvalidInputException);
+    EXPECT_THROW(SplitValueBytesIntoChunks(value_bytes, values.size(), Type::BOOLEAN, std::nullopt, 10),
+                 DBPSUnsupportedException);
+}
+
+TEST(ParquetUtils, SplitValueBytesIntoChunks_VariableSize) {
+    std::vector<std::string> values = {"ab", "c", "", "defghijklm", "n"};
+    std::vector<uint8_t> value_bytes;
+    for (const auto& value : values) {
+        append_u32_le(value_bytes, static_cast<uint32_t>(value.size()));
+        value_bytes.insert(value_bytes.end(), value.begin(), value.end());
+    }
+
+    // Each value takes 4 prefix bytes: [ab][c] fit in 11 bytes, then [], then the oversized value alone, then [n].
+    auto chunks = SplitValueBytesIntoChunks(value_bytes, values.size(), Type::BYTE_ARRAY, std::nullopt, 11);
+    ASSERT_EQ(chunks.size(), 4u);
+    EXPECT_EQ(chunks[0].num_elements, 2u);
+    EXPECT_EQ(chunks[0].value_bytes.size(), 11u);
+    EXPECT_EQ(chunks[1].num_elements, 1u);
+    EXPECT_EQ(chunks[2].num_elements, 1u);
+    EXPECT_EQ(chunks[2].value_bytes.size(), 14u);
+    EXPECT_EQ(chunks[3].num_elements, 1u);
+
+    // Every chunk is a valid value buffer on its own.
+    size_t num_elements = 0;
+    for (const auto& chunk : chunks) {
+        auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
+            chunk.value_bytes, chunk.num_elements, Type::BYTE_ARRAY, std::nullopt, Encoding::PLAIN);
+        num_elements += std::get<TypedBufferRawBytesVariableSized>(typed_buffer).GetNumElements();
+    }
+    EXPECT_EQ(num_elements, values.size());
+
+    EXPECT_THROW(SplitValueBytesIntoChunks(value_bytes, values.size() + 1, Type::BYTE_ARRAY, std::nullopt, 11),
+                 InvalidInputException);
+    EXPECT_THROW(SplitValueBytesIntoChunks(value_bytes, values.size() - 1, Type::BYTE_ARRAY, std::nullopt, 11),
+                 InvalidInputException);
+}
@@ -18,14 +18,18 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include <tcb/span.hpp>
 
+#include "buffer_pool.h"
 #include "bytes_utils.h"
 #include "exceptions.h"
 
@@ -35,6 +39,9 @@ namespace dbps::processing {
 // ByteBuffer class forward declaration
 // -----------------------------------------------------------------------------
 
+template <class Codec>
+class ByteBufferView;
+
 template <class Codec>
 class ByteBuffer {
 public:
@@ -64,6 +71,16 @@ public:
         size_t prefix_size = 0,
         Codec codec = Codec{});
 
+    // Creates a write buffer for variable-size elements that takes ownership of already serialized
+    // [u32 size][element] records, as if all elements were written in order.
+    // Used to hand over records assembled outside the buffer (e.g. stitched from per-range buffers)
+    // without copying them element by element. The records are validated against num_elements.
+    static ByteBuffer FromSerializedBuffer(
+        std::vector<uint8_t> serialized_buffer,
+        size_t num_elements,
+        size_t prefix_size = 0,
+        Codec codec = Codec{});
+
     // Getters for immediately available properties.
     size_t GetNumElements() const { return num_elements_; }
     size_t GetElementSize() const { return element_size_; }
@@ -76,9 +93,71 @@ public:
     void SetElement(size_t position, const value_type& element);
     void SetRawElement(size_t position, tcb::span<const uint8_t> raw);
 
+    // Two-phase writes of a variable-size write buffer, for out-of-order or concurrent writers:
+    // 1. ReserveElementSizes declares the payload size of every element before any write. The records and
+    //    their size prefixes are laid out in element order, and the buffer is allocated once.
+    // 2. SetElement/SetRawElement/GetWritableRawElement fill the reserved slots in place, in any order, and
+    //    concurrently for distinct positions. Each write must have the declared payload size.
+    // Nothing is appended or moved afterwards, so FinalizeAndTakeBuffer hands over the buffer as-is once every
+    // slot has been written.
+    void ReserveElementSizes(tcb::span<const size_t> element_sizes);
+
     // Iterator for read-only elements returning raw bytes.
     bool ElementsIteratorNext(tcb::span<const uint8_t>& raw_bytes) const;
 
+    // Bulk visitation of read-only buffers. The buffer is validated once upfront, then the kernel runs
+    // without per-element state or bounds checks.
+    // - Fixed-size elements: kernel(size_t first_position, tcb::span<const uint8_t> run) is called once with
+    //   all elements as a single contiguous run of num_elements * element_size bytes.
+    // - Variable-size elements: kernel(size_t first_position, tcb::span<const tcb::span<const uint8_t>> batch)
+    //   is called with consecutive batches of up to kBulkBatchSize element spans.
+    template <class Kernel>
+    void ForEachBatch(Kernel&& kernel) const;
+
+    // Length-preserving bulk transform of this read-only buffer into `output`, an empty write buffer with the
+    // same number of elements (and the same element size for fixed-size elements). Both buffers are checked
+    // once upfront, and the kernel(tcb::span<const uint8_t> in, tcb::span<uint8_t> out) writes out in place:
+    // - Fixed-size elements: called once, with all elements as contiguous runs of equal size.
+    // - Variable-size elements: called once per element. Output records are laid out in order, so
+    //   output.FinalizeAndTakeBuffer() takes its fast path.
+    template <class OutputCodec, class Kernel>
+    void TransformInto(ByteBuffer<OutputCodec>& output, Kernel&& kernel) const;
+
+    // Record-level form of TransformInto for length-preserving transforms into caller memory. The records are
+    // the buffer bytes after its prefix: the elements, with their [u32 size] prefixes for variable-size elements.
+    // `records_out` must hold exactly GetRecordsSize() bytes.
+    // - CopyRecordsInto copies the records with a single memcpy, size prefixes included.
+    // - TransformPayloadsInto runs kernel(tcb::span<const uint8_t> in, tcb::span<uint8_t> out) for the elements in
+    //   [begin, end), with out at the same offset in records_out as in within the records: once over the whole
+    //   run for fixed-size elements, once per element for variable-size elements.
+    // Fixed-size records are only payloads, so the copy can be skipped when all elements are transformed.
+    // After a first GetRecordsSize call, disjoint ranges can be transformed concurrently.
+    size_t GetRecordsSize() const;
+    void CopyRecordsInto(tcb::span<uint8_t> records_out) const;
+    template <class Kernel>
+    void TransformPayloadsInto(tcb::span<uint8_t> records_out, size_t begin, size_t end, Kernel&& kernel) const;
+
+    // Whole-buffer typed access for fixed-size elements, for consumers that process native arrays at once
+    // (e.g. typed encryptors over INT32/INT64/FLOAT/DOUBLE values). The element size must be a multiple of
+    // sizeof(T), so INT96 elements can be accessed as three int32_t values each.
+    // - GetElementsAs returns a view of a read-only buffer's payload when it already has the native layout
+    //   (little-endian host and T-aligned payload). Otherwise the values are decoded into `scratch` in bulk and
+    //   the returned view points into it.
+    // - SetElementsFrom encodes all elements of a write buffer from a native array in bulk.
+    template <class T>
+    tcb::span<const T> GetElementsAs(std::vector<T>& scratch) const;
+    template <class T>
+    void SetElementsFrom(tcb::span<const T> values);
+
+    // Maximum number of element spans per ForEachBatch batch for variable-size elements.
+    static constexpr size_t kBulkBatchSize = 256;
+
+    // Builds the element index ahead of time, so GetElement/GetRawElement can be called concurrently
+    // from multiple threads. Otherwise the index is built lazily on first access, which is not thread-safe.
+    // The elements iterator keeps its own state and must not be shared across threads: use a ByteBufferView
+    // (byte_buffer_view.h) with one cursor per thread instead.
+    void PrepareForConcurrentReads() const { EnsureInitializedFromSpan(); }
+
     // Finalizes the write path and transfers the resulting buffer ownership.
     std::vector<uint8_t> FinalizeAndTakeBuffer();
 
@@ -119,6 +198,16 @@ protected:
     size_t next_expected_write_position_ = 0;
 
 private:
+    // TransformInto writes into buffers of other codecs.
+    template <class OtherCodec>
+    friend class ByteBuffer;
+
+    // Views reuse the element index of the buffer they are created from.
+    friend class ByteBufferView<Codec>;
+
+    // Validates a read-only buffer for the bulk methods and builds the variable-size index.
+    void PrepareForBulkReads(const char* caller) const;
+
     // Initialization methods and flags for read-only buffer
     void InitializeFromSpan() const;
     void EnsureInitializedFromSpan() const;
@@ -128,8 +217,13 @@ private:
     // Initialization methods and flags for write buffer
     void InitializeForWriteBuffer(size_t variable_size_reserved_bytes_hint);
     void RebindSpanToWriteBuffer();
+    void ResizeWriteBufferUninitialized(size_t new_size);
     bool is_write_buffer_enabled_ = false;
     bool is_write_buffer_finalized_ = false;    
+
+    // Two-phase writes: slot layout is fixed by ReserveElementSizes, and each slot is flagged once written.
+    bool is_write_buffer_reserved_ = false;
+    std::vector<uint8_t> reserved_slot_written_;
 };
 
 // Constant to mark a size_t value as unset.
@@ -142,6 +236,55 @@ inline size_t ReadSizeAt(tcb::span<const uint8_t> bytes, size_t offset) {
     return static_cast<size_t>(read_u32_le(bytes, offset));
 }
 
+// Indexes the [u32 size][element] records stored back-to-back in bytes from `start` to the end, writing the
+// offset of each record's size prefix into `offsets`. Bounds and the element count are validated in the same
+// pass: the walk throws as soon as a record is truncated or a record beyond `expected_count` is found, so the
+// index is never larger than expected. The main loop is unrolled four records at a time, which keeps the
+// walk cheap for short elements where framing dominates.
+inline void IndexLengthPrefixedRecords(
+    tcb::span<const uint8_t> bytes, size_t start, size_t expected_count, std::vector<size_t>& offsets) {
+    const uint8_t* data = bytes.data();
+    const size_t end = bytes.size();
+    offsets.resize(expected_count);
+    size_t* out = offsets.data();
+    size_t cursor = start;
+    size_t count = 0;
+
+    // Indexes the record at cursor and moves past it. One comparison per bound.
+    auto index_record = [&]() {
+        if (end - cursor < kSizePrefixBytes) {
+            throw InvalidInputException(cursor == end
+                ? "Malformed variable-size buffer: num_elements on payload != num_elements_ expected."
+                : "Malformed variable-size buffer: truncated length prefix");
+        }
+        const size_t element_size = read_u32_le(data + cursor);
+        if (end - cursor - kSizePrefixBytes < element_size) {
+            throw InvalidInputException("Malformed variable-size buffer: truncated element payload");
+        }
+        out[count++] = cursor;
+        cursor += kSizePrefixBytes + element_size;
+    };
+
+    // Unrolled walk while at least four more records are expected and their prefixes may fit.
+    while (expected_count - count >= 4 && end - cursor >= 4 * kSizePrefixBytes) {
+        index_record();
+        index_record();
+        index_record();
+        index_record();
+    }
+    while (cursor < end) {
+        if (count == expected_count) {
+            throw InvalidInputException(
+                "Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+        }
+        index_record();
+    }
+    if (count != expected_count) {
+        throw InvalidInputException(
+            "Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Constructors and initializers for read-only buffer
 // -----------------------------------------------------------------------------
@@ -223,29 +366,9 @@ inline void ByteBuffer<Codec>::InitializeFromSpan() const {
     }
 
     // Variable-size layout stores [u32 size][element value] back-to-back.
-    // Single pass validates shape and captures per-element prefix offsets.
-    offsets_.clear();
-    offsets_.reserve(num_elements_);
-    size_t cursor = prefix_size_;
-    while (cursor < elements_span_size_) {
-        if (elements_span_size_ - cursor < kSizePrefixBytes) {
-            throw InvalidInputException("Malformed variable-size buffer: truncated length prefix");
-        }
-        offsets_.push_back(cursor);
-        const size_t current_element_size = ReadSizeAt(elements_span_, cursor);
-        cursor += kSizePrefixBytes;
-        if (elements_span_size_ - cursor < current_element_size) {
-            throw InvalidInputException("Malformed variable-size buffer: truncated element payload");
-        }
-        cursor += current_element_size;
-    }
-
-    // Check if the num_elements passed at contruction time coincides with the calculated from the payload size.
-    const size_t num_elements_on_payload = offsets_.size();
-    if (num_elements_on_payload != num_elements_) {
-        throw InvalidInputException("Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
-    }
-
+    // Single pass validates shape and element count and captures per-element prefix offsets.
+    // The elements iterator reuses this index once it is built.
+    IndexLengthPrefixedRecords(elements_span_, prefix_size_, num_elements_, offsets_);
     is_initialized_from_span_ = true;
 }
 
@@ -392,6 +515,16 @@ inline bool ByteBuffer<Codec>::ElementsIteratorNext(tcb::span<const uint8_t>& ra
     }
 
     // Variable-sized elements
+    // Once the index is built (e.g. by GetElement), it was validated already: walk it without checks.
+    if (is_initialized_from_span_) {
+        const size_t offset = offsets_[element_iterator_count_];
+        const size_t current_element_size = ReadSizeAt(elements_span_, offset);
+        raw_bytes = elements_span_.subspan(offset + kSizePrefixBytes, current_element_size);
+        element_iterator_current_ptr_ = raw_bytes.data() + current_element_size;
+        element_iterator_count_++;
+        return true;
+    }
+
     if (bytes_remaining < kSizePrefixBytes) {
         throw InvalidInputException("Malformed variable-size buffer: truncated length prefix in iterator");
     }
@@ -410,6 +543,178 @@ inline bool ByteBuffer<Codec>::ElementsIteratorNext(tcb::span<const uint8_t>& ra
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// Bulk visitation
+// -----------------------------------------------------------------------------
+
+template <class Codec>
+inline void ByteBuffer<Codec>::PrepareForBulkReads(const char* caller) const {
+    if (is_write_buffer_enabled_) {
+        throw InvalidInputException(std::string(caller) + " is only defined for read-only buffers");
+    }
+    EnsureInitializedFromSpan();
+
+    // An empty payload is accepted by the index with any element count, so the count is checked here.
+    if constexpr (is_fixed_sized) {
+        if (elements_span_size_ - prefix_size_ != num_elements_ * element_size_) {
+            throw InvalidInputException(
+                "Malformed fixed-size buffer: num_elements on payload != num_elements_ expected.");
+        }
+    } else {
+        if (offsets_.size() != num_elements_) {
+            throw InvalidInputException(
+                "Malformed variable-size buffer: num_elements on payload != num_elements_ expected.");
+        }
+    }
+}
+
+template <class Codec>
+template <class Kernel>
+inline void ByteBuffer<Codec>::ForEachBatch(Kernel&& kernel) const {
+    PrepareForBulkReads("ForEachBatch");
+    if (num_elements_ == 0) {
+        return;
+    }
+
+    if constexpr (is_fixed_sized) {
+        kernel(size_t{0}, elements_span_.subspan(prefix_size_, num_elements_ * element_size_));
+    } else {
+        std::array<tcb::span<const uint8_t>, kBulkBatchSize> batch;
+        const uint8_t* data = elements_span_.data();
+        for (size_t first = 0; first < num_elements_; first += kBulkBatchSize) {
+            const size_t batch_size = std::min(kBulkBatchSize, num_elements_ - first);
+            for (size_t i = 0; i < batch_size; ++i) {
+                const size_t offset = offsets_[first + i];
+                batch[i] = tcb::span<const uint8_t>(data + offset + kSizePrefixBytes, read_u32_le(data + offset));
+            }
+            kernel(first, tcb::span<const tcb::span<const uint8_t>>(batch.data(), batch_size));
+        }
+    }
+}
+
+template <class Codec>
+template <class OutputCodec, class Kernel>
+inline void ByteBuffer<Codec>::TransformInto(ByteBuffer<OutputCodec>& output, Kernel&& kernel) const {
+    static_assert(is_fixed_sized == ByteBuffer<OutputCodec>::is_fixed_sized,
+                  "TransformInto requires input and output buffers of the same size class.");
+    PrepareForBulkReads("TransformInto");
+    if (!output.is_write_buffer_enabled_ || output.is_write_buffer_finalized_) {
+        throw InvalidInputException("TransformInto: output is not an open write buffer");
+    }
+    if (output.num_elements_ != num_elements_) {
+        throw InvalidInputException("TransformInto: output num_elements does not match the input");
+    }
+
+    if constexpr (is_fixed_sized) {
+        if (output.element_size_ != element_size_) {
+            throw InvalidInputException("TransformInto: output element_size does not match the input");
+        }
+        if (num_elements_ == 0) {
+            return;
+        }
+        const size_t run_size = num_elements_ * element_size_;
+        kernel(elements_span_.subspan(prefix_size_, run_size),
+               tcb::span<uint8_t>(output.write_buffer_.data() + output.prefix_size_, run_size));
+    } else {
+        if (output.next_expected_write_position_ != 0 || output.write_buffer_.size() != output.prefix_size_) {
+            throw InvalidInputException("TransformInto: output write buffer is not empty");
+        }
+
+        // Records keep their sizes, so the input layout is copied as-is and only the payloads are transformed.
+        const size_t records_size = elements_span_size_ - prefix_size_;
+        output.ResizeWriteBufferUninitialized(output.prefix_size_ + records_size);
+        tcb::span<uint8_t> records_out(output.write_buffer_.data() + output.prefix_size_, records_size);
+        CopyRecordsInto(records_out);
+        TransformPayloadsInto(records_out, 0, num_elements_, kernel);
+        for (size_t i = 0; i < num_elements_; ++i) {
+            output.offsets_[i] = output.prefix_size_ + (offsets_[i] - prefix_size_);
+        }
+        output.next_expected_write_position_ = num_elements_;
+        output.RebindSpanToWriteBuffer();
+    }
+}
+
+template <class Codec>
+template <class T>
+inline tcb::span<const T> ByteBuffer<Codec>::GetElementsAs(std::vector<T>& scratch) const {
+    static_assert(is_fixed_sized, "GetElementsAs is only defined for fixed-size elements");
+    if (element_size_ % sizeof(T) != 0) {
+        throw InvalidInputException("GetElementsAs: element size is not a multiple of the value size");
+    }
+    PrepareForBulkReads("GetElementsAs");
+    auto payload = elements_span_.subspan(prefix_size_);
+    const size_t num_values = payload.size() / sizeof(T);
+    if constexpr (kHostIsLittleEndian) {
+        if (reinterpret_cast<uintptr_t>(payload.data()) % alignof(T) == 0) {
+            return tcb::span<const T>(reinterpret_cast<const T*>(payload.data()), num_values);
+        }
+    }
+    scratch.resize(num_values);
+    read_le_array<T>(payload, scratch);
+    return scratch;
+}
+
+template <class Codec>
+template <class T>
+inline void ByteBuffer<Codec>::SetElementsFrom(tcb::span<const T> values) {
+    static_assert(is_fixed_sized, "SetElementsFrom is only defined for fixed-size elements");
+    if (!is_write_buffer_enabled_ || is_write_buffer_finalized_) {
+        throw InvalidInputException("SetElementsFrom: buffer is not an open write buffer");
+    }
+    const size_t payload_size = num_elements_ * element_size_;
+    if (element_size_ % sizeof(T) != 0 || values.size() * sizeof(T) != payload_size) {
+        throw InvalidInputException("SetElementsFrom: values do not match the buffer elements");
+    }
+    write_le_array<T>(values, tcb::span<uint8_t>(write_buffer_.data() + prefix_size_, payload_size));
+}
+
+template <class Codec>
+inline size_t ByteBuffer<Codec>::GetRecordsSize() const {
+    PrepareForBulkReads("GetRecordsSize");
+    return elements_span_size_ - prefix_size_;
+}
+
+template <class Codec>
+inline void ByteBuffer<Codec>::CopyRecordsInto(tcb::span<uint8_t> records_out) const {
+    const size_t records_size = GetRecordsSize();
+    if (records_out.size() != records_size) {
+        throw InvalidInputException("CopyRecordsInto: output size does not match the records size");
+    }
+    if (records_size > 0) {
+        std::memcpy(records_out.data(), elements_span_.data() + prefix_size_, records_size);
+    }
+}
+
+template <class Codec>
+template <class Kernel>
+inline void ByteBuffer<Codec>::TransformPayloadsInto(
+    tcb::span<uint8_t> records_out, size_t begin, size_t end, Kernel&& kernel) const {
+    const size_t records_size = GetRecordsSize();
+    if (records_out.size() != records_size) {
+        throw InvalidInputException("TransformPayloadsInto: output size does not match the records size");
+    }
+    if (begin > end || end > num_elements_) {
+        throw InvalidInputException("TransformPayloadsInto: invalid element range");
+    }
+    if (begin == end) {
+        return;
+    }
+
+    const uint8_t* in = elements_span_.data() + prefix_size_;
+    if constexpr (is_fixed_sized) {
+        const size_t run_offset = begin * element_size_;
+        const size_t run_size = (end - begin) * element_size_;
+        kernel(tcb::span<const uint8_t>(in + run_offset, run_size), records_out.subspan(run_offset, run_size));
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            const size_t payload_offset = offsets_[i] - prefix_size_ + kSizePrefixBytes;
+            const uint32_t element_size = read_u32_le(in + payload_offset - kSizePrefixBytes);
+            kernel(tcb::span<const uint8_t>(in + payload_offset, element_size),
+                   tcb::span<uint8_t>(records_out.data() + payload_offset, element_size));
+        }
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Constructors and initializers for write buffer
 // -----------------------------------------------------------------------------
@@ -446,16 +751,40 @@ ByteBuffer<Codec>::ByteBuffer(
     InitializeForWriteBuffer(use_reserve_hint ? reserved_bytes_hint : 0);
 }
 
+// Creates a write buffer for variable-size elements from already serialized records.
+template <class Codec>
+inline ByteBuffer<Codec> ByteBuffer<Codec>::FromSerializedBuffer(
+    std::vector<uint8_t> serialized_buffer,
+    size_t num_elements,
+    size_t prefix_size,
+    Codec codec) {
+    static_assert(!is_fixed_sized, "FromSerializedBuffer is for variable-size elements only.");
+    ByteBuffer buffer(num_elements, 0, false, prefix_size, std::move(codec));
+    buffer.write_buffer_ = std::move(serialized_buffer);
+    buffer.RebindSpanToWriteBuffer();
+
+    // Index and validate the records the same way as a read-only buffer over the same bytes.
+    buffer.InitializeFromSpan();
+    if (buffer.offsets_.size() != num_elements) {
+        throw InvalidInputException("FromSerializedBuffer: num_elements on payload != num_elements expected.");
+    }
+
+    // All elements are in place and in order, so FinalizeAndTakeBuffer takes the fast path.
+    buffer.next_expected_write_position_ = num_elements;
+    return buffer;
+}
+
 // Initializes `write_buffer_`, `offsets_` and `elements_span_`
 template <class Codec>
 inline void ByteBuffer<Codec>::InitializeForWriteBuffer(size_t variable_size_reserved_bytes_hint) {
     // Fixed-size elements
     if constexpr (is_fixed_sized) {
         // write_buffer can be allocated to precise size since the element size and number of elements are known.
-        // We initialize it to 0s to have random-ish access during writes.
+        // Every slot is written before the buffer is taken, so only the prefix is zeroed; recycled memory from
+        // the default BufferPool of the thread, if any (see buffer_pool.h), is not cleared again.
         const size_t fixed_size_total_bytes = prefix_size_ + (num_elements_ * element_size_);
-        write_buffer_.clear();
-        write_buffer_.resize(fixed_size_total_bytes, static_cast<uint8_t>(0));
+        write_buffer_ = AcquireUninitializedBuffer(fixed_size_total_bytes);
+        std::fill_n(write_buffer_.begin(), prefix_size_, static_cast<uint8_t>(0));
 
         // offsets_ are not used for fixed-size elements.
         offsets_.clear();
@@ -473,9 +802,8 @@ inline void ByteBuffer<Codec>::InitializeForWriteBuffer(size_t variable_size_res
     const size_t min_required_record_bytes = num_elements_ * kSizePrefixBytes;
     const size_t variable_size_reserved_bytes =
         prefix_size_ + std::max(variable_size_reserved_bytes_hint, min_required_record_bytes);
-    write_buffer_.clear();
+    write_buffer_ = AcquireBuffer(variable_size_reserved_bytes);
     write_buffer_.resize(prefix_size_, static_cast<uint8_t>(0));
-    write_buffer_.reserve(variable_size_reserved_bytes);
 
     // offsets_ is initialized so the vector is fully allocated and have random-ish access during writes.
     offsets_.clear();
@@ -521,6 +849,19 @@ inline tcb::span<uint8_t> ByteBuffer<Codec>::GetWritableSpanForElement(size_t po
     
     // Variable-sized elements - `else` is needed because it's a compile-time check.
     else {
+        // Reserved slots are written in place. Only the slot flag is updated, so distinct positions can be
+        // written concurrently.
+        if (is_write_buffer_reserved_) {
+            const size_t offset = offsets_[position];
+            if (payload_size != ReadSizeAt(elements_span_, offset)) {
+                throw InvalidInputException(
+                    "GetWriteSpanForElement: payload does not match the reserved size of element " +
+                    std::to_string(position));
+            }
+            reserved_slot_written_[position] = 1;
+            return tcb::span<uint8_t>(write_buffer_.data() + offset + kSizePrefixBytes, payload_size);
+        }
+
         // Defensive check for unlikely extremely large element size that exceeds uint32.
         if (payload_size > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) [[unlikely]] {
             throw InvalidInputException("Variable-size element payload exceeds uint32 capacity.. Woohhh!!");
@@ -577,6 +918,43 @@ inline void ByteBuffer<Codec>::SetRawElement(size_t position, tcb::span<const ui
     std::memcpy(write_span.data(), raw.data(), raw.size());
 }
 
+template <class Codec>
+inline void ByteBuffer<Codec>::ReserveElementSizes(tcb::span<const size_t> element_sizes) {
+    static_assert(!is_fixed_sized, "ReserveElementSizes is for variable-size elements only.");
+    if (!is_write_buffer_enabled_ || is_write_buffer_finalized_) {
+        throw InvalidInputException("ReserveElementSizes: buffer is not an open write buffer");
+    }
+    if (is_write_buffer_reserved_ || write_buffer_.size() != prefix_size_) {
+        throw InvalidInputException("ReserveElementSizes: element sizes must be reserved before any write");
+    }
+    if (element_sizes.size() != num_elements_) {
+        throw InvalidInputException(
+            "ReserveElementSizes: got " + std::to_string(element_sizes.size()) + " element sizes for " +
+            std::to_string(num_elements_) + " elements");
+    }
+
+    // Prefix sums of the record sizes give the slot offsets, and the buffer is sized once.
+    size_t total_size = prefix_size_;
+    for (const size_t element_size : element_sizes) {
+        if (element_size > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) [[unlikely]] {
+            throw InvalidInputException("Variable-size element payload exceeds uint32 capacity.. Woohhh!!");
+        }
+        total_size += kSizePrefixBytes + element_size;
+    }
+    // Each slot is flagged once written and FinalizeAndTakeBuffer requires all flags, so no slot is zeroed.
+    ResizeWriteBufferUninitialized(total_size);
+
+    size_t offset = prefix_size_;
+    for (size_t i = 0; i < num_elements_; ++i) {
+        offsets_[i] = offset;
+        write_u32_le(write_buffer_.data() + offset, static_cast<uint32_t>(element_sizes[i]));
+        offset += kSizePrefixBytes + element_sizes[i];
+    }
+    reserved_slot_written_.assign(num_elements_, 0);
+    is_write_buffer_reserved_ = true;
+    RebindSpanToWriteBuffer();
+}
+
 template <class Codec>
 inline std::vector<uint8_t> ByteBuffer<Codec>::FinalizeAndTakeBuffer() {
     if (is_write_buffer_finalized_) {
@@ -593,6 +971,15 @@ inline std::vector<uint8_t> ByteBuffer<Codec>::FinalizeAndTakeBuffer() {
         return std::move(write_buffer_);
     }
 
+    // Reserved slots are already in element order.
+    if (is_write_buffer_reserved_) {
+        if (std::find(reserved_slot_written_.begin(), reserved_slot_written_.end(), 0) != reserved_slot_written_.end()) {
+            throw InvalidInputException("Cannot finalize variable-size buffer: not all elements were written");
+        }
+        is_write_buffer_finalized_ = true;
+        return std::move(write_buffer_);
+    }
+
     // For variable-size when all elements were written exactly once and in sequential order,
     // we can skip out-of-order or fragmentation checks.  This is the fast path.
     // This is the most common behavior when writing elements in single threaded mode.
@@ -611,8 +998,7 @@ inline std::vector<uint8_t> ByteBuffer<Codec>::FinalizeAndTakeBuffer() {
 
     // For variable-size, when elements are written out of order, assume the buffer is fragmented and potentially with orphaned bytes
     // The buffer is validated and rebuilt into an ordered compact buffer in one pass.
-    std::vector<uint8_t> result;
-    result.reserve(write_buffer_.size());
+    std::vector<uint8_t> result = AcquireBuffer(write_buffer_.size());
     // Copy the prefix bytes at the beginning of the result.
     result.insert(
         result.end(),
@@ -640,14 +1026,28 @@ inline std::vector<uint8_t> ByteBuffer<Codec>::FinalizeAndTakeBuffer() {
     }
 
     // Defrag path returns a new buffer; release the original fragmented write buffer.
-    write_buffer_.clear();
-    write_buffer_.shrink_to_fit();
+    ReleaseBuffer(std::move(write_buffer_));
+    write_buffer_ = std::vector<uint8_t>();
     is_write_buffer_enabled_ = false;
     is_write_buffer_finalized_ = true;
     
     return result;
 }
 
+// Grows write_buffer_ with memory that is not zero-filled, keeping the bytes already written (e.g. the prefix).
+// Callers write every byte past the current size before the buffer is read or taken.
+template <class Codec>
+inline void ByteBuffer<Codec>::ResizeWriteBufferUninitialized(size_t new_size) {
+    if (new_size <= write_buffer_.size()) {
+        write_buffer_.resize(new_size);
+        return;
+    }
+    std::vector<uint8_t> resized = AcquireUninitializedBuffer(new_size);
+    std::copy(write_buffer_.begin(), write_buffer_.end(), resized.begin());
+    ReleaseBuffer(std::move(write_buffer_));
+    write_buffer_ = std::move(resized);
+}
+
 template <class Codec>
 inline void ByteBuffer<Codec>::RebindSpanToWriteBuffer() {
     auto write_buffer_size = write_buffer_.size();
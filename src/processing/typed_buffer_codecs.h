@@ -67,6 +67,8 @@ struct PlainValueCodec {
     }
 };
 
+static_assert(sizeof(Int96) == 3 * sizeof(int32_t), "Int96 must be three packed int32 values");
+
 struct Int96Codec {
     using value_type = Int96;
     static constexpr bool is_fixed_sized = true;
@@ -84,21 +86,32 @@ struct Int96Codec {
         if (read_span.size() != sizeof(Int96)) {
             throw InvalidInputException("Decode: read_span size does not match Int96 element size");
         }
-        const uint8_t* p = read_span.data();
-        return Int96{
-            read_le<int32_t>(p + 0 * kI32Size),
-            read_le<int32_t>(p + 1 * kI32Size),
-            read_le<int32_t>(p + 2 * kI32Size)};
+        // On little-endian hosts the three packed int32 values are the struct layout, so they are copied at once.
+        if constexpr (kHostIsLittleEndian) {
+            Int96 value;
+            std::memcpy(&value, read_span.data(), sizeof(Int96));
+            return value;
+        } else {
+            const uint8_t* p = read_span.data();
+            return Int96{
+                read_le<int32_t>(p + 0 * kI32Size),
+                read_le<int32_t>(p + 1 * kI32Size),
+                read_le<int32_t>(p + 2 * kI32Size)};
+        }
     }
 
     inline void Encode(const value_type& value, tcb::span<uint8_t> write_span) const {
         if (write_span.size() != sizeof(Int96)) {
             throw InvalidInputException("Encode: write_span size does not match Int96 element size");
         }
-        uint8_t* p = write_span.data();
-        write_le<int32_t>(value.lo, p + 0 * kI32Size);
-        write_le<int32_t>(value.mid, p + 1 * kI32Size);
-        write_le<int32_t>(value.hi, p + 2 * kI32Size);
+        if constexpr (kHostIsLittleEndian) {
+            std::memcpy(write_span.data(), &value, sizeof(Int96));
+        } else {
+            uint8_t* p = write_span.data();
+            write_le<int32_t>(value.lo, p + 0 * kI32Size);
+            write_le<int32_t>(value.mid, p + 1 * kI32Size);
+            write_le<int32_t>(value.hi, p + 2 * kI32Size);
+        }
     }
 };
 
@@ -20,9 +20,11 @@
 #include "typed_buffer_testing_codecs.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "bytes_utils.h"
@@ -32,6 +34,7 @@ using dbps::processing::ByteBuffer;
 using dbps::processing::RawBytesFixedSizedCodec;
 using dbps::processing::RawBytesVariableSizedCodec;
 using dbps::processing::kUnsetSize;
+using dbps::processing::IndexLengthPrefixedRecords;
 using dbps::processing::testing::StringFixedSizedCodec;
 using dbps::processing::testing::StringVariableSizedCodec;
 
@@ -1221,3 +1224,316 @@ TEST(TypedBufferTest, SetRawElement_VariableSize_WriteAndReadBack) {
     EXPECT_EQ(std::vector<uint8_t>(r0.begin(), r0.end()), e0);
     EXPECT_EQ(std::vector<uint8_t>(r1.begin(), r1.end()), e1);
 }
+
+TEST(TypedBufferTest, FromSerializedBuffer_VariableSize_ReadAndFinalize) {
+    std::vector<uint8_t> serialized = {0x00, 0x00};  // 2-byte prefix
+    append_u32_le(serialized, 2u);
+    serialized.insert(serialized.end(), {0xAA, 0xBB});
+    append_u32_le(serialized, 0u);
+    append_u32_le(serialized, 3u);
+    serialized.insert(serialized.end(), {0xCC, 0xDD, 0xEE});
+    const std::vector<uint8_t> expected = serialized;
+
+    auto buffer = RawBytesVariableSizedBuffer::FromSerializedBuffer(serialized, 3u, 2u);
+    EXPECT_EQ(buffer.GetNumElements(), 3u);
+    auto r0 = buffer.GetRawElement(0);
+    auto r2 = buffer.GetRawElement(2);
+    EXPECT_EQ(std::vector<uint8_t>(r0.begin(), r0.end()), (std::vector<uint8_t>{0xAA, 0xBB}));
+    EXPECT_TRUE(buffer.GetRawElement(1).empty());
+    EXPECT_EQ(std::vector<uint8_t>(r2.begin(), r2.end()), (std::vector<uint8_t>{0xCC, 0xDD, 0xEE}));
+
+    EXPECT_EQ(buffer.FinalizeAndTakeBuffer(), expected);
+}
+
+TEST(TypedBufferTest, FromSerializedBuffer_VariableSize_CountMismatch_Throws) {
+    std::vector<uint8_t> serialized;
+    append_u32_le(serialized, 1u);
+    serialized.push_back(0xAA);
+
+    EXPECT_THROW(RawBytesVariableSizedBuffer::FromSerializedBuffer(serialized, 2u), InvalidInputException);
+    EXPECT_THROW(RawBytesVariableSizedBuffer::FromSerializedBuffer({}, 1u), InvalidInputException);
+}
+
+TEST(TypedBufferTest, PrepareForConcurrentReads_ValidatesVariableSizePayload) {
+    std::vector<uint8_t> serialized;
+    append_u32_le(serialized, 4u);
+    serialized.push_back(0xAA);  // truncated payload
+
+    RawBytesVariableSizedBuffer buffer(tcb::span<const uint8_t>(serialized), 1u);
+    EXPECT_THROW(buffer.PrepareForConcurrentReads(), InvalidInputException);
+}
+
+TEST(TypedBufferTest, IndexLengthPrefixedRecords_ShortElements) {
+    // 11 records (unrolled walk plus tail) of 0 to 3 bytes, after a 2-byte prefix.
+    std::vector<uint8_t> serialized = {0xFF, 0xFF};
+    std::vector<size_t> expected_offsets;
+    for (size_t i = 0; i < 11; ++i) {
+        expected_offsets.push_back(serialized.size());
+        append_u32_le(serialized, static_cast<uint32_t>(i % 4));
+        serialized.insert(serialized.end(), i % 4, static_cast<uint8_t>(i));
+    }
+
+    std::vector<size_t> offsets;
+    IndexLengthPrefixedRecords(serialized, 2, 11, offsets);
+    EXPECT_EQ(offsets, expected_offsets);
+
+    // Count mismatches are detected in both directions, and truncations anywhere in the walk.
+    EXPECT_THROW(IndexLengthPrefixedRecords(serialized, 2, 10, offsets), InvalidInputException);
+    EXPECT_THROW(IndexLengthPrefixedRecords(serialized, 2, 12, offsets), InvalidInputException);
+    auto truncated_payload = serialized;
+    truncated_payload.pop_back();
+    EXPECT_THROW(IndexLengthPrefixedRecords(truncated_payload, 2, 11, offsets), InvalidInputException);
+    std::vector<uint8_t> oversized_first(serialized.begin(), serialized.begin() + 2);
+    append_u32_le(oversized_first, 1000u);
+    oversized_first.insert(oversized_first.end(), 20, 0x00);
+    EXPECT_THROW(IndexLengthPrefixedRecords(oversized_first, 2, 4, offsets), InvalidInputException);
+}
+
+TEST(TypedBufferTest, ElementsIteratorNext_ReusesIndex) {
+    std::vector<uint8_t> serialized;
+    for (uint8_t i = 0; i < 6; ++i) {
+        append_u32_le(serialized, i);
+        serialized.insert(serialized.end(), i, i);
+    }
+
+    RawBytesVariableSizedBuffer indexed_buffer(tcb::span<const uint8_t>(serialized), 6u);
+    RawBytesVariableSizedBuffer plain_buffer(tcb::span<const uint8_t>(serialized), 6u);
+    indexed_buffer.PrepareForConcurrentReads();
+
+    // Iterating an indexed buffer, including after a partial iteration, matches the validating walk.
+    tcb::span<const uint8_t> indexed_element;
+    tcb::span<const uint8_t> plain_element;
+    size_t count = 0;
+    while (plain_buffer.ElementsIteratorNext(plain_element)) {
+        ASSERT_TRUE(indexed_buffer.ElementsIteratorNext(indexed_element));
+        EXPECT_EQ(indexed_element.data(), plain_element.data());
+        EXPECT_EQ(indexed_element.size(), plain_element.size());
+        if (++count == 3) {
+            (void)plain_buffer.GetRawElement(5);  // Builds the index mid-iteration
+        }
+    }
+    EXPECT_EQ(count, 6u);
+    EXPECT_FALSE(indexed_buffer.ElementsIteratorNext(indexed_element));
+}
+
+TEST(TypedBufferTest, ForEachBatch_FixedSize_SingleContiguousRun) {
+    std::vector<uint8_t> serialized = {0xFF, 'a', 'b', 'c', 'd', 'e', 'f'};
+    RawBytesFixedSizedBuffer buffer(tcb::span<const uint8_t>(serialized), 3u, 1u, RawBytesFixedSizedCodec{2});
+
+    size_t num_calls = 0;
+    buffer.ForEachBatch([&](size_t first_position, tcb::span<const uint8_t> run) {
+        EXPECT_EQ(first_position, 0u);
+        EXPECT_EQ(run.data(), serialized.data() + 1);
+        EXPECT_EQ(run.size(), 6u);
+        ++num_calls;
+    });
+    EXPECT_EQ(num_calls, 1u);
+
+    // Count mismatches are rejected before the kernel runs, including for empty payloads.
+    std::vector<uint8_t> empty_payload;
+    RawBytesFixedSizedBuffer empty_buffer(tcb::span<const uint8_t>(empty_payload), 2u, 0u, RawBytesFixedSizedCodec{2});
+    EXPECT_THROW(empty_buffer.ForEachBatch([](size_t, tcb::span<const uint8_t>) {}), InvalidInputException);
+}
+
+TEST(TypedBufferTest, ForEachBatch_VariableSize_Batches) {
+    const size_t num_elements = RawBytesVariableSizedBuffer::kBulkBatchSize + 3;
+    std::vector<uint8_t> serialized;
+    for (size_t i = 0; i < num_elements; ++i) {
+        append_u32_le(serialized, static_cast<uint32_t>(i % 3));
+        serialized.insert(serialized.end(), i % 3, static_cast<uint8_t>(i));
+    }
+    RawBytesVariableSizedBuffer buffer(tcb::span<const uint8_t>(serialized), num_elements);
+
+    std::vector<size_t> batch_starts;
+    size_t visited = 0;
+    buffer.ForEachBatch([&](size_t first_position, tcb::span<const tcb::span<const uint8_t>> batch) {
+        batch_starts.push_back(first_position);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const size_t position = first_position + i;
+            EXPECT_EQ(batch[i].size(), position % 3);
+            for (uint8_t byte : batch[i]) {
+                EXPECT_EQ(byte, static_cast<uint8_t>(position));
+            }
+        }
+        visited += batch.size();
+    });
+    EXPECT_EQ(visited, num_elements);
+    EXPECT_EQ(batch_starts, (std::vector<size_t>{0, RawBytesVariableSizedBuffer::kBulkBatchSize}));
+}
+
+TEST(TypedBufferTest, TransformInto_FixedAndVariableSize) {
+    auto invert = [](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        ASSERT_EQ(in.size(), out.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            out[i] = static_cast<uint8_t>(~in[i]);
+        }
+    };
+
+    std::vector<uint8_t> fixed_serialized = {1, 2, 3, 4};
+    RawBytesFixedSizedBuffer fixed_input(
+        tcb::span<const uint8_t>(fixed_serialized), 2u, 0u, RawBytesFixedSizedCodec{2});
+    RawBytesFixedSizedBuffer fixed_output(2u, 1u, RawBytesFixedSizedCodec{2});
+    fixed_input.TransformInto(fixed_output, invert);
+    EXPECT_EQ(fixed_output.FinalizeAndTakeBuffer(), (std::vector<uint8_t>{0, 0xFE, 0xFD, 0xFC, 0xFB}));
+
+    std::vector<uint8_t> variable_serialized;
+    append_u32_le(variable_serialized, 2u);
+    variable_serialized.insert(variable_serialized.end(), {0x10, 0x20});
+    append_u32_le(variable_serialized, 0u);
+    append_u32_le(variable_serialized, 1u);
+    variable_serialized.push_back(0x30);
+    RawBytesVariableSizedBuffer variable_input(tcb::span<const uint8_t>(variable_serialized), 3u);
+    RawBytesVariableSizedBuffer variable_output(3u, 0u, false);
+    variable_input.TransformInto(variable_output, invert);
+    std::vector<uint8_t> expected;
+    append_u32_le(expected, 2u);
+    expected.insert(expected.end(), {0xEF, 0xDF});
+    append_u32_le(expected, 0u);
+    append_u32_le(expected, 1u);
+    expected.push_back(0xCF);
+    EXPECT_EQ(variable_output.FinalizeAndTakeBuffer(), expected);
+
+    // Mismatched or already written outputs are rejected.
+    RawBytesVariableSizedBuffer wrong_count_output(2u, 0u, false);
+    EXPECT_THROW(variable_input.TransformInto(wrong_count_output, invert), InvalidInputException);
+    RawBytesVariableSizedBuffer written_output(3u, 0u, false);
+    written_output.SetRawElement(0, variable_input.GetRawElement(0));
+    EXPECT_THROW(variable_input.TransformInto(written_output, invert), InvalidInputException);
+    RawBytesFixedSizedBuffer wrong_size_output(2u, 0u, RawBytesFixedSizedCodec{1});
+    EXPECT_THROW(fixed_input.TransformInto(wrong_size_output, invert), InvalidInputException);
+}
+
+TEST(TypedBufferTest, CopyRecordsInto_TransformPayloadsInto_KeepLayout) {
+    auto invert = [](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        ASSERT_EQ(in.size(), out.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            out[i] = static_cast<uint8_t>(~in[i]);
+        }
+    };
+
+    // Fixed-size: a range of elements is one kernel call over its run, at the same offset in the output.
+    std::vector<uint8_t> fixed_serialized = {0xFF, 1, 2, 3, 4, 5, 6};
+    RawBytesFixedSizedBuffer fixed_input(
+        tcb::span<const uint8_t>(fixed_serialized), 3u, 1u, RawBytesFixedSizedCodec{2});
+    ASSERT_EQ(fixed_input.GetRecordsSize(), 6u);
+    std::vector<uint8_t> fixed_records(6, 0);
+    size_t num_calls = 0;
+    fixed_input.TransformPayloadsInto(fixed_records, 1, 3, [&](tcb::span<const uint8_t> in, tcb::span<uint8_t> out) {
+        invert(in, out);
+        ++num_calls;
+    });
+    EXPECT_EQ(num_calls, 1u);
+    EXPECT_EQ(fixed_records, (std::vector<uint8_t>{0, 0, 0xFC, 0xFB, 0xFA, 0xF9}));
+
+    // Variable-size: the records are copied with their size prefixes, then payloads are transformed in place.
+    std::vector<uint8_t> variable_serialized = {0xAA};
+    append_u32_le(variable_serialized, 2u);
+    variable_serialized.insert(variable_serialized.end(), {0x10, 0x20});
+    append_u32_le(variable_serialized, 0u);
+    append_u32_le(variable_serialized, 1u);
+    variable_serialized.push_back(0x30);
+    RawBytesVariableSizedBuffer variable_input(tcb::span<const uint8_t>(variable_serialized), 3u, 1u);
+    ASSERT_EQ(variable_input.GetRecordsSize(), variable_serialized.size() - 1);
+    std::vector<uint8_t> variable_records(variable_input.GetRecordsSize());
+    variable_input.CopyRecordsInto(variable_records);
+    EXPECT_EQ(variable_records, std::vector<uint8_t>(variable_serialized.begin() + 1, variable_serialized.end()));
+    variable_input.TransformPayloadsInto(variable_records, 0, 1, invert);
+    variable_input.TransformPayloadsInto(variable_records, 1, 3, invert);
+    std::vector<uint8_t> expected;
+    append_u32_le(expected, 2u);
+    expected.insert(expected.end(), {0xEF, 0xDF});
+    append_u32_le(expected, 0u);
+    append_u32_le(expected, 1u);
+    expected.push_back(0xCF);
+    EXPECT_EQ(variable_records, expected);
+
+    // Output sizes must match the records size, and ranges must be within the buffer.
+    std::vector<uint8_t> short_records(variable_records.size() - 1);
+    EXPECT_THROW(variable_input.CopyRecordsInto(short_records), InvalidInputException);
+    EXPECT_THROW(variable_input.TransformPayloadsInto(short_records, 0, 3, invert), InvalidInputException);
+    EXPECT_THROW(variable_input.TransformPayloadsInto(variable_records, 2, 4, invert), InvalidInputException);
+    EXPECT_THROW(fixed_input.TransformPayloadsInto(fixed_records, 2, 1, invert), InvalidInputException);
+}
+
+TEST(TypedBufferTest, ReserveElementSizes_OutOfOrderWrites_FinalizeInPlace) {
+    RawBytesVariableSizedBuffer buffer(3u, 0u, false, 2u);
+    const std::vector<size_t> element_sizes = {2, 0, 3};
+    buffer.ReserveElementSizes(element_sizes);
+    const auto* reserved_data = buffer.GetRawElement(0).data();
+
+    std::vector<uint8_t> e0 = {0xAA, 0xBB};
+    std::vector<uint8_t> e2 = {0xCC, 0xDD, 0xEE};
+    buffer.SetRawElement(2, tcb::span<const uint8_t>(e2));
+    buffer.SetRawElement(1, tcb::span<const uint8_t>());
+    buffer.SetRawElement(0, tcb::span<const uint8_t>(e0));
+    EXPECT_EQ(buffer.GetRawElement(0).data(), reserved_data);
+    auto r2 = buffer.GetRawElement(2);
+    EXPECT_EQ(std::vector<uint8_t>(r2.begin(), r2.end()), e2);
+
+    std::vector<uint8_t> expected = {0x00, 0x00};
+    append_u32_le(expected, 2u);
+    expected.insert(expected.end(), e0.begin(), e0.end());
+    append_u32_le(expected, 0u);
+    append_u32_le(expected, 3u);
+    expected.insert(expected.end(), e2.begin(), e2.end());
+    auto finalized = buffer.FinalizeAndTakeBuffer();
+    EXPECT_EQ(finalized, expected);
+    EXPECT_EQ(finalized.data() + 2 + 4, reserved_data);
+}
+
+TEST(TypedBufferTest, ReserveElementSizes_ConcurrentWriters) {
+    constexpr size_t kNumElements = 1000;
+    constexpr size_t kNumThreads = 4;
+    std::vector<size_t> element_sizes(kNumElements);
+    for (size_t i = 0; i < kNumElements; ++i) {
+        element_sizes[i] = i % 7;
+    }
+    RawBytesVariableSizedBuffer buffer(kNumElements, 0u, false);
+    buffer.ReserveElementSizes(element_sizes);
+
+    // Each thread writes an interleaved set of positions.
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        writers.emplace_back([&buffer, &element_sizes, t] {
+            for (size_t i = t; i < kNumElements; i += kNumThreads) {
+                auto slot = buffer.GetWritableRawElement(i, element_sizes[i]);
+                std::fill(slot.begin(), slot.end(), static_cast<uint8_t>(i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::vector<uint8_t> expected;
+    for (size_t i = 0; i < kNumElements; ++i) {
+        append_u32_le(expected, static_cast<uint32_t>(element_sizes[i]));
+        expected.insert(expected.end(), element_sizes[i], static_cast<uint8_t>(i));
+    }
+    EXPECT_EQ(buffer.FinalizeAndTakeBuffer(), expected);
+}
+
+TEST(TypedBufferTest, ReserveElementSizes_InvalidUse_Throws) {
+    const std::vector<size_t> element_sizes = {1, 2};
+
+    // The number of sizes must match, and sizes are reserved once, before any write.
+    RawBytesVariableSizedBuffer wrong_count(3u, 0u, false);
+    EXPECT_THROW(wrong_count.ReserveElementSizes(element_sizes), InvalidInputException);
+    RawBytesVariableSizedBuffer written(2u, 0u, false);
+    written.SetRawElement(0, std::vector<uint8_t>{0x01});
+    EXPECT_THROW(written.ReserveElementSizes(element_sizes), InvalidInputException);
+    RawBytesVariableSizedBuffer reserved(2u, 0u, false);
+    reserved.ReserveElementSizes(element_sizes);
+    EXPECT_THROW(reserved.ReserveElementSizes(element_sizes), InvalidInputException);
+
+    // Writes must match the reserved sizes, and every slot must be written before finalizing.
+    EXPECT_THROW(reserved.SetRawElement(1, std::vector<uint8_t>{0x01}), InvalidInputException);
+    reserved.SetRawElement(1, std::vector<uint8_t>{0x01, 0x02});
+    EXPECT_THROW(reserved.FinalizeAndTakeBuffer(), InvalidInputException);
+
+    // Read-only buffers cannot be reserved.
+    std::vector<uint8_t> serialized;
+    append_u32_le(serialized, 0u);
+    RawBytesVariableSizedBuffer read_only(tcb::span<const uint8_t>(serialized), 1u);
+    EXPECT_THROW(read_only.ReserveElementSizes(std::vector<size_t>{0}), InvalidInputException);
+}
@@ -49,6 +49,14 @@ using TypedValuesBuffer = std::variant<
     TypedBufferRawBytesVariableSized
 >;
 
+// Bulk visitation of a TypedValuesBuffer: the variant is visited once and the kernel is forwarded to
+// ByteBuffer::ForEachBatch. The kernel is called with contiguous runs for fixed-size buffers and with batches of
+// element spans for variable-size buffers, so it must accept both (e.g. a generic lambda with `if constexpr`).
+template <class Kernel>
+inline void ForEachBatch(const TypedValuesBuffer& buffer, Kernel&& kernel) {
+    std::visit([&](const auto& typed_buffer) { typed_buffer.ForEachBatch(kernel); }, buffer);
+}
+
 // Printable string representation of the typed buffer
 inline std::string PrintableTypedValuesBuffer(const TypedValuesBuffer& buffer) {
     return std::visit([](const auto& typed_buffer) -> std::string {
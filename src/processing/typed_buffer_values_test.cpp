@@ -617,3 +617,85 @@ TEST(TypedBufferValuesTest, TypedValuesBufferToString_BasicUsage) {
     EXPECT_NE(raw_str.find("2 bytes"), std::string::npos);
     EXPECT_NE(raw_str.find("4 bytes"), std::string::npos);
 }
+
+TEST(TypedBufferValuesTest, ForEachBatch_VisitsVariantOnce) {
+    std::vector<uint8_t> int_bytes;
+    append_i32_le(int_bytes, 1);
+    append_i32_le(int_bytes, 2);
+    TypedValuesBuffer int_buffer = TypedBufferI32{tcb::span<const uint8_t>(int_bytes), 2u};
+
+    std::vector<uint8_t> string_bytes;
+    append_u32_le(string_bytes, 2u);
+    string_bytes.insert(string_bytes.end(), {'h', 'i'});
+    TypedValuesBuffer string_buffer = TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(string_bytes), 1u};
+
+    size_t total_bytes = 0;
+    auto kernel = [&](size_t, auto batch) {
+        if constexpr (std::is_same_v<decltype(batch), tcb::span<const uint8_t>>) {
+            total_bytes += batch.size();
+        } else {
+            for (const auto& element : batch) {
+                total_bytes += element.size();
+            }
+        }
+    };
+    ForEachBatch(int_buffer, kernel);
+    EXPECT_EQ(total_bytes, 8u);
+    ForEachBatch(string_buffer, kernel);
+    EXPECT_EQ(total_bytes, 10u);
+}
+
+TEST(TypedBufferValuesTest, GetElementsAs_AlignedAndUnalignedPayloads) {
+    const std::vector<int64_t> values = {7, -1, 9223372036854775807LL};
+
+    // Aligned payload: on little-endian hosts the view points straight into the payload.
+    std::vector<uint8_t> aligned_bytes(values.size() * sizeof(int64_t));
+    write_le_array<int64_t>(values, aligned_bytes);
+    TypedBufferI64 aligned_buffer{tcb::span<const uint8_t>(aligned_bytes), values.size()};
+    std::vector<int64_t> scratch;
+    auto aligned_view = aligned_buffer.GetElementsAs<int64_t>(scratch);
+    EXPECT_EQ(std::vector<int64_t>(aligned_view.begin(), aligned_view.end()), values);
+    if (kHostIsLittleEndian) {
+        EXPECT_EQ(reinterpret_cast<const uint8_t*>(aligned_view.data()), aligned_bytes.data());
+        EXPECT_TRUE(scratch.empty());
+    }
+
+    // Payload after a 1-byte prefix: decoded into the scratch vector.
+    std::vector<uint8_t> prefixed_bytes = {0xAB};
+    prefixed_bytes.insert(prefixed_bytes.end(), aligned_bytes.begin(), aligned_bytes.end());
+    TypedBufferI64 prefixed_buffer{tcb::span<const uint8_t>(prefixed_bytes), values.size(), 1u};
+    auto prefixed_view = prefixed_buffer.GetElementsAs<int64_t>(scratch);
+    EXPECT_EQ(prefixed_view.data(), scratch.data());
+    EXPECT_EQ(scratch, values);
+}
+
+TEST(TypedBufferValuesTest, GetElementsAs_Int96AsInt32Triples) {
+    std::vector<uint8_t> bytes;
+    AppendInt96LE(bytes, Int96{1, 2, 3});
+    AppendInt96LE(bytes, Int96{-1, 0, 2147483647});
+    TypedBufferInt96 buffer{tcb::span<const uint8_t>(bytes), 2u};
+
+    std::vector<int32_t> scratch;
+    auto view = buffer.GetElementsAs<int32_t>(scratch);
+    EXPECT_EQ(std::vector<int32_t>(view.begin(), view.end()), (std::vector<int32_t>{1, 2, 3, -1, 0, 2147483647}));
+
+    std::vector<int64_t> wrong_scratch;
+    EXPECT_THROW(buffer.GetElementsAs<int64_t>(wrong_scratch), InvalidInputException);
+}
+
+TEST(TypedBufferValuesTest, SetElementsFrom_WritesAllElements) {
+    const std::vector<double> values = {1.5, -2.25, 0.0};
+    TypedBufferDouble writer(values.size(), 2u);
+    writer.SetElementsFrom<double>(values);
+    std::vector<uint8_t> finalized = writer.FinalizeAndTakeBuffer();
+    ASSERT_EQ(finalized.size(), 2u + values.size() * sizeof(double));
+
+    TypedBufferDouble reader{tcb::span<const uint8_t>(finalized), values.size(), 2u};
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_DOUBLE_EQ(reader.GetElement(i), values[i]);
+    }
+
+    TypedBufferDouble short_writer(values.size() + 1);
+    EXPECT_THROW(short_writer.SetElementsFrom<double>(values), InvalidInputException);
+    EXPECT_THROW(reader.SetElementsFrom<double>(values), InvalidInputException);
+}
@@ -0,0 +1,258 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "value_dedup.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "buffer_pool.h"
+#include "../common/bytes_utils.h"
+#include "../common/exceptions.h"
+
+namespace dbps::processing {
+
+namespace {
+    constexpr size_t kIndexBlockHeaderBytes = ::kSizePrefixBytes + 1;
+
+    uint8_t GetIndexWidth(size_t num_distinct) {
+        if (num_distinct <= (size_t{1} << 8)) {
+            return 1;
+        }
+        if (num_distinct <= (size_t{1} << 16)) {
+            return 2;
+        }
+        return 4;
+    }
+
+    std::string_view AsStringView(tcb::span<const uint8_t> bytes) {
+        return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    // Collects the distinct values of a page, with a cardinality check after the sample and on every new value.
+    class DistinctValuesCollector {
+    public:
+        DistinctValuesCollector(size_t num_elements, bool is_fixed, const ValueDedupOptions& options)
+            : is_fixed_(is_fixed),
+              sample_size_(options.sample_size),
+              max_sample_distinct_(static_cast<size_t>(options.max_distinct_ratio * options.sample_size)),
+              max_distinct_(static_cast<size_t>(options.max_distinct_ratio * num_elements)) {
+            result_.indices.reserve(num_elements);
+            index_.reserve(std::min(max_distinct_, options.sample_size) + 1);
+        }
+
+        // Adds the next value. Returns false once deduplication is dropped.
+        bool Add(tcb::span<const uint8_t> value) {
+            auto [it, inserted] = index_.try_emplace(AsStringView(value), static_cast<uint32_t>(index_.size()));
+            if (inserted) {
+                if (index_.size() > max_distinct_) {
+                    return false;
+                }
+                if (!is_fixed_) {
+                    const size_t offset = result_.distinct_value_bytes.size();
+                    result_.distinct_value_bytes.resize(offset + ::kSizePrefixBytes);
+                    write_u32_le(result_.distinct_value_bytes.data() + offset, static_cast<uint32_t>(value.size()));
+                }
+                result_.distinct_value_bytes.insert(result_.distinct_value_bytes.end(), value.begin(), value.end());
+            }
+            result_.indices.push_back(it->second);
+            return result_.indices.size() != sample_size_ || index_.size() <= max_sample_distinct_;
+        }
+
+        DeduplicatedValues TakeResult() {
+            result_.num_distinct = index_.size();
+            return std::move(result_);
+        }
+
+    private:
+        const bool is_fixed_;
+        const size_t sample_size_;
+        const size_t max_sample_distinct_;
+        const size_t max_distinct_;
+        // Keys view the values in the input buffer.
+        std::unordered_map<std::string_view, uint32_t> index_;
+        DeduplicatedValues result_;
+    };
+}
+
+std::optional<ValueDedupMode> ValueDedupModeFromString(const std::string& name) {
+    if (name == "off") {
+        return ValueDedupMode::OFF;
+    }
+    if (name == "scatter") {
+        return ValueDedupMode::SCATTER;
+    }
+    if (name == "dictionary") {
+        return ValueDedupMode::DICTIONARY;
+    }
+    return std::nullopt;
+}
+
+std::optional<DeduplicatedValues> DeduplicateValues(const TypedValuesBuffer& values, const ValueDedupOptions& options) {
+    return std::visit([&](const auto& buffer) -> std::optional<DeduplicatedValues> {
+        constexpr bool is_fixed = std::decay_t<decltype(buffer)>::is_fixed_sized;
+        const size_t num_elements = buffer.GetNumElements();
+        if (num_elements == 0 || num_elements < options.min_num_elements) {
+            return std::nullopt;
+        }
+
+        DistinctValuesCollector collector(num_elements, is_fixed, options);
+        bool dropped = false;
+        buffer.ForEachBatch([&](size_t, auto batch) {
+            if constexpr (is_fixed) {
+                const size_t element_size = buffer.GetElementSize();
+                for (size_t offset = 0; offset < batch.size() && !dropped; offset += element_size) {
+                    dropped = !collector.Add(batch.subspan(offset, element_size));
+                }
+            } else {
+                for (size_t i = 0; i < batch.size() && !dropped; ++i) {
+                    dropped = !collector.Add(batch[i]);
+                }
+            }
+        });
+        if (dropped) {
+            return std::nullopt;
+        }
+        return collector.TakeResult();
+    }, values);
+}
+
+size_t GetIndexBlockSize(size_t num_elements, size_t num_distinct) {
+    return kIndexBlockHeaderBytes + num_elements * GetIndexWidth(num_distinct);
+}
+
+std::vector<uint8_t> EncodeIndexBlock(tcb::span<const uint32_t> indices, size_t num_distinct) {
+    const uint8_t width = GetIndexWidth(num_distinct);
+    std::vector<uint8_t> block = AcquireUninitializedBuffer(GetIndexBlockSize(indices.size(), num_distinct));
+    write_u32_le(block.data(), static_cast<uint32_t>(indices.size()));
+    block[::kSizePrefixBytes] = width;
+    uint8_t* out = block.data() + kIndexBlockHeaderBytes;
+    switch (width) {
+        case 1:
+            for (uint32_t index : indices) {
+                *out++ = static_cast<uint8_t>(index);
+            }
+            break;
+        case 2:
+            for (uint32_t index : indices) {
+                out[0] = static_cast<uint8_t>(index & 0xFF);
+                out[1] = static_cast<uint8_t>((index >> 8) & 0xFF);
+                out += 2;
+            }
+            break;
+        default:
+            for (uint32_t index : indices) {
+                write_u32_le(out, index);
+                out += 4;
+            }
+            break;
+    }
+    return block;
+}
+
+std::vector<uint32_t> DecodeIndexBlock(tcb::span<const uint8_t> index_block, size_t num_distinct) {
+    if (index_block.size() < kIndexBlockHeaderBytes) {
+        throw InvalidInputException("Index block too short: " + std::to_string(index_block.size()) + " bytes");
+    }
+    const size_t num_elements = read_u32_le(index_block, 0);
+    const uint8_t width = index_block[::kSizePrefixBytes];
+    if (width != GetIndexWidth(num_distinct)) {
+        throw InvalidInputException("Invalid index width " + std::to_string(width) + " for " +
+                                    std::to_string(num_distinct) + " distinct values");
+    }
+    if (index_block.size() != GetIndexBlockSize(num_elements, num_distinct)) {
+        throw InvalidInputException("Index block size " + std::to_string(index_block.size()) +
+                                    " does not match its " + std::to_string(num_elements) + " elements");
+    }
+
+    std::vector<uint32_t> indices(num_elements);
+    const uint8_t* in = index_block.data() + kIndexBlockHeaderBytes;
+    for (size_t i = 0; i < num_elements; ++i, in += width) {
+        const uint32_t index = (width == 1) ? *in
+                             : (width == 2) ? static_cast<uint32_t>(in[0] | (in[1] << 8))
+                                            : read_u32_le(in);
+        if (index >= num_distinct) {
+            throw InvalidInputException("Index " + std::to_string(index) + " out of range of " +
+                                        std::to_string(num_distinct) + " distinct values");
+        }
+        indices[i] = index;
+    }
+    return indices;
+}
+
+std::vector<uint8_t> ExpandDistinctValues(TypedValuesBuffer&& distinct_values, tcb::span<const uint32_t> indices) {
+    return std::visit([&](auto& buffer) -> std::vector<uint8_t> {
+        constexpr bool is_fixed = std::decay_t<decltype(buffer)>::is_fixed_sized;
+        const size_t num_distinct = buffer.GetNumElements();
+        const size_t element_size = buffer.GetElementSize();
+        std::vector<uint8_t> distinct_bytes = buffer.FinalizeAndTakeBuffer();
+        for (uint32_t index : indices) {
+            if (index >= num_distinct) {
+                throw InvalidInputException("Index " + std::to_string(index) + " out of range of " +
+                                            std::to_string(num_distinct) + " distinct values");
+            }
+        }
+
+        std::vector<uint8_t> value_bytes;
+        if constexpr (is_fixed) {
+            if (distinct_bytes.size() != num_distinct * element_size) {
+                throw InvalidInputException("Distinct values do not match their element size");
+            }
+            value_bytes = AcquireUninitializedBuffer(indices.size() * element_size);
+            uint8_t* out = value_bytes.data();
+            for (uint32_t index : indices) {
+                std::memcpy(out, distinct_bytes.data() + static_cast<size_t>(index) * element_size, element_size);
+                out += element_size;
+            }
+        } else {
+            // Records of the distinct values, [u32 size][payload] each, are copied as-is.
+            std::vector<size_t> record_offsets(num_distinct + 1);
+            size_t offset = 0;
+            for (size_t i = 0; i < num_distinct; ++i) {
+                if (distinct_bytes.size() - offset < ::kSizePrefixBytes) {
+                    throw InvalidInputException("Distinct values truncated");
+                }
+                const size_t record_size = ::kSizePrefixBytes + read_u32_le(distinct_bytes.data() + offset);
+                if (distinct_bytes.size() - offset < record_size) {
+                    throw InvalidInputException("Distinct values truncated");
+                }
+                record_offsets[i] = offset;
+                offset += record_size;
+            }
+            record_offsets[num_distinct] = offset;
+
+            size_t value_bytes_size = 0;
+            for (uint32_t index : indices) {
+                value_bytes_size += record_offsets[index + 1] - record_offsets[index];
+            }
+            value_bytes = AcquireUninitializedBuffer(value_bytes_size);
+            uint8_t* out = value_bytes.data();
+            for (uint32_t index : indices) {
+                const size_t record_size = record_offsets[index + 1] - record_offsets[index];
+                std::memcpy(out, distinct_bytes.data() + record_offsets[index], record_size);
+                out += record_size;
+            }
+        }
+        ReleaseBuffer(std::move(distinct_bytes));
+        return value_bytes;
+    }, distinct_values);
+}
+
+} // namespace dbps::processing
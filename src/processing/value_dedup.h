@@ -0,0 +1,109 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <tcb/span.hpp>
+#include "typed_buffer_values.h"
+
+namespace dbps::processing {
+
+/**
+ * Value deduplication of per-value encrypted pages.
+ *
+ * Low-cardinality PLAIN pages (status codes, country codes, booleans as strings) repeat a handful of values
+ * many times. Deduplication hashes the values of a page and encrypts each distinct value once:
+ * - SCATTER: the ciphertext of each distinct value is copied to all its occurrences. The page ciphertext is the
+ *   same as without deduplication, so it only applies to encryptors whose value ciphertexts depend on the value
+ *   alone (see DBPSEncryptor::IsValueEncryptionDeterministic). Other encryptors encrypt every value.
+ * - DICTIONARY: the page ciphertext holds the encrypted distinct values and the encrypted index block mapping
+ *   every element to its value, which shrinks the ciphertext. Like SCATTER, it reveals which elements of a page
+ *   hold equal values to whoever can decrypt the index block, and it reveals the number of distinct values.
+ *
+ * Deduplication turns itself off for pages whose values are mostly distinct: the first values are sampled and
+ * the page is dropped as soon as its distinct values exceed max_distinct_ratio.
+ */
+enum class ValueDedupMode {
+    OFF = 0,
+    SCATTER = 1,
+    DICTIONARY = 2
+};
+
+// Parses "off", "scatter" or "dictionary". std::nullopt for any other name.
+std::optional<ValueDedupMode> ValueDedupModeFromString(const std::string& name);
+
+struct ValueDedupOptions {
+    ValueDedupMode mode = ValueDedupMode::OFF;
+
+    // Pages with fewer values are not deduplicated.
+    size_t min_num_elements = 64;
+
+    // Number of leading values whose cardinality is checked before hashing the rest of the page.
+    size_t sample_size = 1024;
+
+    // Deduplication is dropped when the distinct values exceed this fraction of the sampled values, or of all
+    // the values of the page.
+    double max_distinct_ratio = 0.25;
+};
+
+struct DeduplicatedValues {
+    // PLAIN encoded distinct values, in order of first occurrence.
+    std::vector<uint8_t> distinct_value_bytes;
+    size_t num_distinct = 0;
+
+    // Index of the value of every element in the distinct values.
+    std::vector<uint32_t> indices;
+};
+
+/**
+ * Hashes the values of a read-only typed values buffer and collects its distinct values.
+ *
+ * @return The distinct values and the element indices, or std::nullopt when deduplication does not pay off:
+ *    the page has fewer than min_num_elements values, or too many distinct values (see ValueDedupOptions).
+ */
+std::optional<DeduplicatedValues> DeduplicateValues(const TypedValuesBuffer& values, const ValueDedupOptions& options);
+
+/**
+ * Index block of the dictionary form: [u32 num_elements][u8 index width][indices].
+ * Indices are little-endian, on the smallest width of 1, 2 or 4 bytes that holds num_distinct - 1.
+ */
+size_t GetIndexBlockSize(size_t num_elements, size_t num_distinct);
+std::vector<uint8_t> EncodeIndexBlock(tcb::span<const uint32_t> indices, size_t num_distinct);
+
+/**
+ * Parses an index block.
+ *
+ * @throws InvalidInputException if the block is malformed or an index is not below num_distinct
+ */
+std::vector<uint32_t> DecodeIndexBlock(tcb::span<const uint8_t> index_block, size_t num_distinct);
+
+/**
+ * Expands distinct values into the PLAIN encoded value bytes of every element, in element order.
+ *
+ * @param distinct_values The distinct values as a write buffer, e.g. as decrypted from the dictionary form
+ * @param indices Index of the value of every element, each below the number of distinct values
+ * @throws InvalidInputException if an index is out of range
+ */
+std::vector<uint8_t> ExpandDistinctValues(TypedValuesBuffer&& distinct_values, tcb::span<const uint32_t> indices);
+
+} // namespace dbps::processing
@@ -0,0 +1,171 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "value_dedup.h"
+#include "../common/bytes_utils.h"
+#include "../common/exceptions.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace dbps::processing;
+
+namespace {
+    std::vector<uint8_t> PlainStrings(const std::vector<std::string>& values) {
+        std::vector<uint8_t> bytes;
+        for (const auto& value : values) {
+            append_u32_le(bytes, static_cast<uint32_t>(value.size()));
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+        return bytes;
+    }
+
+    std::vector<uint8_t> PlainInts(const std::vector<int32_t>& values) {
+        std::vector<uint8_t> bytes;
+        for (int32_t value : values) {
+            append_i32_le(bytes, value);
+        }
+        return bytes;
+    }
+
+    ValueDedupOptions SmallPageOptions() {
+        ValueDedupOptions options;
+        options.mode = ValueDedupMode::DICTIONARY;
+        options.min_num_elements = 4;
+        options.sample_size = 8;
+        options.max_distinct_ratio = 0.5;
+        return options;
+    }
+} // namespace
+
+TEST(ValueDedup, ModeFromString) {
+    EXPECT_EQ(ValueDedupModeFromString("off"), ValueDedupMode::OFF);
+    EXPECT_EQ(ValueDedupModeFromString("scatter"), ValueDedupMode::SCATTER);
+    EXPECT_EQ(ValueDedupModeFromString("dictionary"), ValueDedupMode::DICTIONARY);
+    EXPECT_FALSE(ValueDedupModeFromString("DICT").has_value());
+    EXPECT_FALSE(ValueDedupModeFromString("").has_value());
+}
+
+TEST(ValueDedup, DeduplicateFixedSizedValues) {
+    const std::vector<int32_t> values = {200, 404, 200, 200, 500, 404, 200, 200, 200, 404};
+    const auto bytes = PlainInts(values);
+    const TypedValuesBuffer buffer = TypedBufferI32{tcb::span<const uint8_t>(bytes), values.size()};
+
+    const auto deduplicated = DeduplicateValues(buffer, SmallPageOptions());
+    ASSERT_TRUE(deduplicated.has_value());
+    EXPECT_EQ(deduplicated->num_distinct, 3u);
+    EXPECT_EQ(deduplicated->distinct_value_bytes, PlainInts({200, 404, 500}));
+    EXPECT_EQ(deduplicated->indices, (std::vector<uint32_t>{0, 1, 0, 0, 2, 1, 0, 0, 0, 1}));
+}
+
+TEST(ValueDedup, DeduplicateVariableSizedValues) {
+    const std::vector<std::string> values = {"US", "", "DE", "US", "US", "", "DE", "US"};
+    const auto bytes = PlainStrings(values);
+    const TypedValuesBuffer buffer =
+        TypedBufferRawBytesVariableSized{tcb::span<const uint8_t>(bytes), values.size()};
+
+    const auto deduplicated = DeduplicateValues(buffer, SmallPageOptions());
+    ASSERT_TRUE(deduplicated.has_value());
+    EXPECT_EQ(deduplicated->num_distinct, 3u);
+    EXPECT_EQ(deduplicated->distinct_value_bytes, PlainStrings({"US", "", "DE"}));
+    EXPECT_EQ(deduplicated->indices, (std::vector<uint32_t>{0, 1, 2, 0, 0, 1, 2, 0}));
+}
+
+TEST(ValueDedup, TurnsOffForSmallOrHighCardinalityPages) {
+    const auto options = SmallPageOptions();
+
+    const auto small_bytes = PlainInts({1, 1, 1});
+    const TypedValuesBuffer small_page = TypedBufferI32{tcb::span<const uint8_t>(small_bytes), 3};
+    EXPECT_FALSE(DeduplicateValues(small_page, options).has_value());
+
+    // The first sample_size values are all distinct.
+    std::vector<int32_t> distinct_prefix;
+    for (int32_t i = 0; i < 8; ++i) {
+        distinct_prefix.push_back(i);
+    }
+    distinct_prefix.insert(distinct_prefix.end(), 100, 0);
+    const auto prefix_bytes = PlainInts(distinct_prefix);
+    const TypedValuesBuffer prefix_page =
+        TypedBufferI32{tcb::span<const uint8_t>(prefix_bytes), distinct_prefix.size()};
+    EXPECT_FALSE(DeduplicateValues(prefix_page, options).has_value());
+
+    // The sample repeats, the rest of the page does not.
+    std::vector<int32_t> distinct_suffix(8, 7);
+    for (int32_t i = 0; i < 20; ++i) {
+        distinct_suffix.push_back(1000 + i);
+    }
+    const auto suffix_bytes = PlainInts(distinct_suffix);
+    const TypedValuesBuffer suffix_page =
+        TypedBufferI32{tcb::span<const uint8_t>(suffix_bytes), distinct_suffix.size()};
+    EXPECT_FALSE(DeduplicateValues(suffix_page, options).has_value());
+}
+
+TEST(ValueDedup, IndexBlockRoundTrip) {
+    for (size_t num_distinct : {size_t{2}, size_t{256}, size_t{257}, size_t{65536}, size_t{65537}}) {
+        std::vector<uint32_t> indices;
+        for (size_t i = 0; i < 50; ++i) {
+            indices.push_back(static_cast<uint32_t>((i * 7919) % num_distinct));
+        }
+        indices.push_back(static_cast<uint32_t>(num_distinct - 1));
+
+        const auto block = EncodeIndexBlock(indices, num_distinct);
+        EXPECT_EQ(block.size(), GetIndexBlockSize(indices.size(), num_distinct));
+        EXPECT_EQ(DecodeIndexBlock(block, num_distinct), indices);
+    }
+    EXPECT_EQ(GetIndexBlockSize(10, 256), 5u + 10u);
+    EXPECT_EQ(GetIndexBlockSize(10, 257), 5u + 20u);
+    EXPECT_EQ(GetIndexBlockSize(10, 65537), 5u + 40u);
+}
+
+TEST(ValueDedup, DecodeIndexBlockRejectsMalformedBlocks) {
+    const std::vector<uint32_t> indices = {0, 1, 2, 1};
+    const auto block = EncodeIndexBlock(indices, 3);
+
+    EXPECT_THROW(DecodeIndexBlock(tcb::span<const uint8_t>(block.data(), 3), 3), InvalidInputException);
+
+    auto truncated = block;
+    truncated.pop_back();
+    EXPECT_THROW(DecodeIndexBlock(truncated, 3), InvalidInputException);
+
+    auto bad_width = block;
+    bad_width[4] = 3;
+    EXPECT_THROW(DecodeIndexBlock(bad_width, 3), InvalidInputException);
+
+    // Index 2 is out of range of 2 distinct values.
+    EXPECT_THROW(DecodeIndexBlock(block, 2), InvalidInputException);
+}
+
+TEST(ValueDedup, ExpandDistinctValues) {
+    const std::vector<uint32_t> indices = {1, 0, 1, 2};
+
+    auto make_ints = []() {
+        TypedBufferI32 ints(3);
+        ints.SetElement(0, 7);
+        ints.SetElement(1, -7);
+        ints.SetElement(2, 0);
+        return ints;
+    };
+    EXPECT_EQ(ExpandDistinctValues(make_ints(), indices), PlainInts({-7, 7, -7, 0}));
+
+    auto strings = TypedBufferRawBytesVariableSized::FromSerializedBuffer(PlainStrings({"a", "bcd", ""}), 3);
+    EXPECT_EQ(ExpandDistinctValues(std::move(strings), indices), PlainStrings({"bcd", "a", "bcd", ""}));
+
+    const std::vector<uint32_t> out_of_range = {0, 3};
+    EXPECT_THROW(ExpandDistinctValues(make_ints(), out_of_range), InvalidInputException);
+}
@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace dbps::processing {
+
+namespace {
+    // Completion state shared by the tasks of a single ParallelFor call.
+    struct ParallelForJob {
+        std::atomic<size_t> remaining_tasks;
+        std::atomic<bool> failed{false};
+        std::exception_ptr first_exception;
+        std::mutex mutex;
+        std::condition_variable done_condition;
+
+        explicit ParallelForJob(size_t num_tasks) : remaining_tasks(num_tasks) {}
+    };
+
+    // Queue index that matches no queue, used when the caller thread steals.
+    constexpr size_t kNoQueueIndex = static_cast<size_t>(-1);
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads) {
+    queues_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_condition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::GetSharedPool() {
+    static WorkStealingThreadPool shared_pool(
+        std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1);
+    return shared_pool;
+}
+
+void WorkStealingThreadPool::ParallelFor(size_t num_tasks, const std::function<void(size_t)>& task) {
+    if (num_tasks == 0) {
+        return;
+    }
+
+    // Without workers, or with a single task, there is nothing to parallelize.
+    if (workers_.empty() || num_tasks == 1) {
+        for (size_t i = 0; i < num_tasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<ParallelForJob>(num_tasks);
+
+    // `task` is captured by reference. This is safe because ParallelFor does not return
+    // until every task of the job has finished.
+    auto run_task = [job, &task](size_t task_index) {
+        if (!job->failed.load(std::memory_order_relaxed)) {
+            try {
+                task(task_index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (!job->failed.exchange(true)) {
+                    job->first_exception = std::current_exception();
+                }
+            }
+        }
+        if (job->remaining_tasks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->done_condition.notify_all();
+        }
+    };
+
+    // pending_tasks_ is raised before the tasks are visible, so it never underflows when a task is taken.
+    pending_tasks_.fetch_add(num_tasks);
+    const size_t first_queue_index = next_queue_index_.fetch_add(1);
+    for (size_t i = 0; i < num_tasks; ++i) {
+        auto& queue = *queues_[(first_queue_index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.emplace_back([run_task, i]() { run_task(i); });
+    }
+    {
+        // Taking the mutex orders the push against workers that are about to sleep.
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_condition_.notify_all();
+
+    // The calling thread helps until no task is left to take, then waits for the running ones.
+    Task stolen_task;
+    while (job->remaining_tasks.load() > 0) {
+        if (TryStealTask(kNoQueueIndex, stolen_task)) {
+            stolen_task();
+            stolen_task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done_condition.wait(lock, [&job]() { return job->remaining_tasks.load() == 0; });
+    }
+
+    if (job->first_exception) {
+        std::rethrow_exception(job->first_exception);
+    }
+}
+
+void WorkStealingThreadPool::WorkerLoop(size_t worker_index) {
+    Task task;
+    while (true) {
+        if (TryPopTask(worker_index, task) || TryStealTask(worker_index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_condition_.wait(lock, [this]() { return stop_ || pending_tasks_.load() > 0; });
+        if (stop_ && pending_tasks_.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingThreadPool::TryPopTask(size_t queue_index, Task& task) {
+    auto& queue = *queues_[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    pending_tasks_.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingThreadPool::TryStealTask(size_t skip_queue_index, Task& task) {
+    const size_t num_queues = queues_.size();
+    // Start from a different queue on each call so thieves spread across victims.
+    const size_t start_index = (skip_queue_index == kNoQueueIndex)
+        ? next_queue_index_.load(std::memory_order_relaxed)
+        : skip_queue_index + 1;
+    for (size_t offset = 0; offset < num_queues; ++offset) {
+        const size_t queue_index = (start_index + offset) % num_queues;
+        if (queue_index == skip_queue_index) {
+            continue;
+        }
+        auto& queue = *queues_[queue_index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        pending_tasks_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+} // namespace dbps::processing
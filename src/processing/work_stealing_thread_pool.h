@@ -0,0 +1,99 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef DBPS_EXPORT
+#define DBPS_EXPORT
+#endif
+
+namespace dbps::processing {
+
+/**
+ * Fixed-size thread pool with per-worker task queues and work stealing.
+ *
+ * Tasks submitted by ParallelFor are spread round-robin across the worker queues. Each worker pops
+ * tasks from the back of its own queue and, when it runs dry, steals from the front of the other
+ * queues. This keeps all workers busy when tasks have uneven costs (e.g. ranges of variable-size
+ * elements).
+ *
+ * The thread calling ParallelFor also runs tasks while it waits, so a pool with N worker threads
+ * runs tasks on up to N + 1 threads, and nested or concurrent ParallelFor calls cannot deadlock.
+ * A pool with zero worker threads runs all tasks on the calling thread.
+ */
+class DBPS_EXPORT WorkStealingThreadPool {
+public:
+    explicit WorkStealingThreadPool(size_t num_threads);
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    // Number of worker threads, not counting the threads calling ParallelFor.
+    size_t GetNumThreads() const { return workers_.size(); }
+
+    /**
+     * Runs task(i) for every i in [0, num_tasks) and blocks until all of them have finished.
+     *
+     * Tasks may run concurrently and in any order. If any task throws, the remaining tasks of the call
+     * are skipped and the first exception is rethrown on the calling thread once no task is running.
+     */
+    void ParallelFor(size_t num_tasks, const std::function<void(size_t)>& task);
+
+    // Process-wide pool sized to the hardware concurrency (one thread is left for the caller).
+    static WorkStealingThreadPool& GetSharedPool();
+
+private:
+    using Task = std::function<void()>;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // Number of tasks pushed to the queues and not yet taken by any thread.
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<size_t> next_queue_index_{0};
+
+    // Sleeping workers wait on wake_condition_ until tasks are pushed or the pool stops.
+    std::mutex wake_mutex_;
+    std::condition_variable wake_condition_;
+    bool stop_ = false;
+
+    void WorkerLoop(size_t worker_index);
+
+    // Pops from the back of the given queue (the most recently pushed task).
+    bool TryPopTask(size_t queue_index, Task& task);
+
+    // Steals from the front of any queue other than skip_queue_index.
+    bool TryStealTask(size_t skip_queue_index, Task& task);
+};
+
+} // namespace dbps::processing
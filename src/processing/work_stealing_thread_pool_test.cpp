@@ -0,0 +1,118 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "work_stealing_thread_pool.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using dbps::processing::WorkStealingThreadPool;
+
+TEST(WorkStealingThreadPool, ParallelFor_RunsEveryTaskOnce) {
+    WorkStealingThreadPool pool(3);
+    EXPECT_EQ(pool.GetNumThreads(), 3u);
+
+    constexpr size_t kNumTasks = 1000;
+    std::vector<std::atomic<int>> run_counts(kNumTasks);
+    pool.ParallelFor(kNumTasks, [&](size_t i) { run_counts[i].fetch_add(1); });
+
+    for (size_t i = 0; i < kNumTasks; ++i) {
+        EXPECT_EQ(run_counts[i].load(), 1) << "task " << i;
+    }
+}
+
+TEST(WorkStealingThreadPool, ParallelFor_ZeroTasks) {
+    WorkStealingThreadPool pool(2);
+    bool called = false;
+    pool.ParallelFor(0, [&](size_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(WorkStealingThreadPool, ParallelFor_NoWorkersRunsOnCallingThread) {
+    WorkStealingThreadPool pool(0);
+    const auto caller_id = std::this_thread::get_id();
+    std::vector<size_t> order;
+    pool.ParallelFor(5, [&](size_t i) {
+        EXPECT_EQ(std::this_thread::get_id(), caller_id);
+        order.push_back(i);
+    });
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(WorkStealingThreadPool, ParallelFor_UnevenTasksAreStolen) {
+    WorkStealingThreadPool pool(4);
+    std::atomic<size_t> sum{0};
+    // A few slow tasks land on some queues; idle workers must steal the rest.
+    pool.ParallelFor(64, [&](size_t i) {
+        if (i % 16 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        sum.fetch_add(i);
+    });
+    EXPECT_EQ(sum.load(), 64u * 63u / 2u);
+}
+
+TEST(WorkStealingThreadPool, ParallelFor_RethrowsFirstException) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<size_t> completed{0};
+    EXPECT_THROW(
+        pool.ParallelFor(100, [&](size_t i) {
+            if (i == 7) {
+                throw std::runtime_error("task failed");
+            }
+            completed.fetch_add(1);
+        }),
+        std::runtime_error);
+    EXPECT_LT(completed.load(), 100u);
+
+    // The pool is still usable after a failed call.
+    std::atomic<size_t> count{0};
+    pool.ParallelFor(10, [&](size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 10u);
+}
+
+TEST(WorkStealingThreadPool, ParallelFor_NestedAndConcurrentCallers) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<size_t> count{0};
+
+    auto run_nested = [&]() {
+        pool.ParallelFor(8, [&](size_t) {
+            pool.ParallelFor(8, [&](size_t) { count.fetch_add(1); });
+        });
+    };
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 3; ++i) {
+        callers.emplace_back(run_nested);
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(count.load(), 3u * 8u * 8u);
+}
+
+TEST(WorkStealingThreadPool, GetSharedPool_IsSingleton) {
+    auto& pool = WorkStealingThreadPool::GetSharedPool();
+    EXPECT_EQ(&pool, &WorkStealingThreadPool::GetSharedPool());
+
+    std::atomic<size_t> count{0};
+    pool.ParallelFor(16, [&](size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 16u);
+}
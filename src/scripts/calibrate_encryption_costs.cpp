@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <cxxopts.hpp>
+
+#include "../common/enums.h"
+#include "../common/enum_utils.h"
+#include "../processing/encryption_mode_policy.h"
+
+using namespace dbps::external;
+using namespace dbps::enum_utils;
+
+// Measures the per-block and per-value encryption costs of this host and writes them as an
+// EncryptionCostModel file, for the "cost" encryption mode policy (see encryption_mode_cost_model_file).
+int main(int argc, char* argv[]) {
+    cxxopts::Options options("calibrate_encryption_costs", "Encryption cost model calibration");
+
+    EncryptionCostCalibrationOptions defaults;
+    options.add_options()
+        ("output", "Path of the cost model JSON file to write.",
+            cxxopts::value<std::string>())
+        ("small_page_bytes", "Size of the small synthetic pages.",
+            cxxopts::value<size_t>()->default_value(std::to_string(defaults.small_page_bytes)))
+        ("large_page_bytes", "Size of the large synthetic pages.",
+            cxxopts::value<size_t>()->default_value(std::to_string(defaults.large_page_bytes)))
+        ("iterations", "Runs per measurement, the fastest one is kept.",
+            cxxopts::value<size_t>()->default_value(std::to_string(defaults.iterations)))
+        ("h,help", "Display this help message");
+
+    try {
+        auto parsed_options = options.parse(argc, argv);
+        if (parsed_options.count("help")) {
+            std::cout << options.help() << std::endl;
+            return 0;
+        }
+        if (!parsed_options.count("output")) {
+            std::cout << "Error: --output is required." << std::endl;
+            std::cout << options.help() << std::endl;
+            return 1;
+        }
+
+        EncryptionCostCalibrationOptions calibration_options;
+        calibration_options.small_page_bytes = parsed_options["small_page_bytes"].as<size_t>();
+        calibration_options.large_page_bytes = parsed_options["large_page_bytes"].as<size_t>();
+        calibration_options.iterations = parsed_options["iterations"].as<size_t>();
+        const std::string output_path = parsed_options["output"].as<std::string>();
+
+        const auto cost_model = CalibrateEncryptionCostModel(calibration_options);
+
+        // Estimated page costs at the calibrated sizes, in microseconds.
+        std::cout << std::left << std::setw(22) << "datatype"
+                  << std::setw(18) << "per_block_small" << std::setw(18) << "per_value_small"
+                  << std::setw(18) << "per_block_large" << std::setw(18) << "per_value_large" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (auto datatype : {Type::BOOLEAN, Type::INT32, Type::INT64, Type::INT96, Type::FLOAT, Type::DOUBLE,
+                              Type::BYTE_ARRAY, Type::FIXED_LEN_BYTE_ARRAY}) {
+            std::cout << std::setw(22) << std::string(to_string(datatype));
+            for (size_t page_bytes : {calibration_options.small_page_bytes, calibration_options.large_page_bytes}) {
+                for (auto mode : {EncryptionMode::PER_BLOCK, EncryptionMode::PER_VALUE}) {
+                    std::cout << std::setw(18) << cost_model.EstimatePageCostNanos(datatype, mode, page_bytes) / 1000.0;
+                }
+            }
+            std::cout << std::endl;
+        }
+
+        cost_model.SaveToFile(output_path);
+        std::cout << "Cost model written to: " << output_path << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
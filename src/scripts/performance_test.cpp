@@ -27,6 +27,7 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cxxopts.hpp>
 
@@ -37,11 +38,18 @@
 #include "../processing/compression_utils.h"
 #include "../processing/parquet_utils.h"
 #include "../processing/parquet_testing_utils.h"
+#include "../processing/work_stealing_thread_pool.h"
+#include "../processing/encryptors/aes_encryptor.h"
+#include "../processing/encryptors/basic_xor_encryptor.h"
+#include "../processing/encryptors/xor_kernels.h"
 #include "tcb/span.hpp"
 
 using namespace dbps::external;
 using namespace dbps::enum_utils;
 using namespace dbps::compression;
+using dbps::processing::WorkStealingThreadPool;
+using dbps::processing::XorKernelLevel;
+using dbps::processing::XorKeyStream;
 
 template <typename T>
 using span = tcb::span<T>;
@@ -228,13 +236,14 @@ namespace {
         CompressionCodec::type compression_type,
         Type::type datatype,
         std::optional<int> datatype_length,
-        std::optional<std::map<std::string, std::string>> column_encryption_metadata = std::nullopt) {
+        std::optional<std::map<std::string, std::string>> column_encryption_metadata = std::nullopt,
+        std::map<std::string, std::string> configuration_map = {}) {
         std::string app_context = R"({"user_id": "demo_user_123"})";
         auto agent = std::make_unique<LocalDataBatchProtectionAgent>();
 
         agent->init(
             "local_demo_column",             // column_name
-            {},                              // configuration_map
+            configuration_map,               // configuration_map
             app_context,                     // app_context
             "local_demo_key_001",            // column_key_id
             datatype,                        // datatype
@@ -261,6 +270,20 @@ namespace {
         {"data_page_v2, compression=SNAPPY, encoding=PLAIN", "DATA_PAGE_V2", CompressionCodec::SNAPPY, "PLAIN"},
         {"data_page_v1, compression=None, encoding=RLE_DICTIONARY", "DATA_PAGE_V1", CompressionCodec::UNCOMPRESSED, "RLE_DICTIONARY"}
     };
+
+    std::optional<DataPageBuildResult> BuildScenarioPage(
+        const Scenario& scenario, const std::vector<uint8_t>& value_bytes, size_t num_values) {
+        if (scenario.page_type == "DATA_PAGE_V1") {
+            return BuildDataPageV1Payload(value_bytes, num_values, scenario.compression, scenario.page_encoding);
+        }
+        if (scenario.page_type == "DATA_PAGE_V2") {
+            return BuildDataPageV2Payload(value_bytes, num_values, scenario.compression, scenario.page_encoding);
+        }
+        if (scenario.page_type == "DICTIONARY_PAGE") {
+            return BuildDictionaryPagePayload(value_bytes, num_values, scenario.compression, scenario.page_encoding);
+        }
+        return std::nullopt;
+    }
 }
 
 class DBPALocalTestApp {
@@ -289,29 +312,12 @@ public:
         std::cout << "\nScenario: " << scenario.name
                   << " | datatype=" << to_string(datatype) << std::endl;
 
-        DataPageBuildResult page;
-        if (scenario.page_type == "DATA_PAGE_V1") {
-            page = BuildDataPageV1Payload(
-                value_bytes,
-                num_values,
-                scenario.compression,
-                scenario.page_encoding);
-        } else if (scenario.page_type == "DATA_PAGE_V2") {
-            page = BuildDataPageV2Payload(
-                value_bytes,
-                num_values,
-                scenario.compression,
-                scenario.page_encoding);
-        } else if (scenario.page_type == "DICTIONARY_PAGE") {
-            page = BuildDictionaryPagePayload(
-                value_bytes,
-                num_values,
-                scenario.compression,
-                scenario.page_encoding);
-        } else {
+        auto built_page = BuildScenarioPage(scenario, value_bytes, num_values);
+        if (!built_page.has_value()) {
             std::cout << "  ERROR: Unknown page type: " << scenario.page_type << std::endl;
             return false;
         }
+        const DataPageBuildResult& page = built_page.value();
 
         auto encrypt_agent = BuildLocalDbpaAgent(
             scenario.compression,
@@ -373,6 +379,297 @@ public:
         return true;
     }
 
+    // Measures EncryptValueList/DecryptValueList on one values buffer with thread pools of increasing size.
+    // 1 thread runs sequentially (parallelism disabled). N threads use a pool of N - 1 workers plus the caller.
+    // The threshold is forced to 1 byte, so this shows the scaling curve of the parallel path itself.
+    bool RunParallelScaling(
+        Type::type datatype,
+        const std::vector<uint8_t>& value_bytes,
+        size_t num_values,
+        size_t iterations,
+        size_t warmup_rounds,
+        size_t max_threads) {
+        std::cout << "\n=== Intra-page Parallel Value Encryption Scaling ===" << std::endl;
+        std::cout << "Datatype: " << to_string(datatype)
+                  << " | values: " << num_values
+                  << " | value bytes: " << value_bytes.size() << std::endl;
+        std::cout << "Default parallel threshold (bytes): "
+                  << BasicXorEncryptor::kDefaultParallelThresholdBytes << std::endl;
+
+        std::vector<size_t> thread_counts;
+        for (size_t threads = 1; threads < max_threads; threads *= 2) {
+            thread_counts.push_back(threads);
+        }
+        thread_counts.push_back(max_threads);
+
+        double baseline_encrypt_ms = 0.0;
+        double baseline_decrypt_ms = 0.0;
+        for (size_t threads : thread_counts) {
+            WorkStealingThreadPool pool(threads - 1);
+            BasicXorEncryptor encryptor(
+                "local_demo_key_001", "local_demo_column", "demo_user_123", "{}", datatype,
+                threads == 1 ? 0 : 1, &pool);
+
+            double encrypt_sum_ms = 0.0;
+            double decrypt_sum_ms = 0.0;
+            double encrypt_min_ms = 0.0;
+            double decrypt_min_ms = 0.0;
+            for (size_t i = 0; i < warmup_rounds + iterations; ++i) {
+                auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
+                    value_bytes, num_values, datatype, std::nullopt, Encoding::PLAIN);
+
+                auto start = std::chrono::steady_clock::now();
+                auto encrypted = encryptor.EncryptValueList(typed_buffer);
+                auto middle = std::chrono::steady_clock::now();
+                auto decrypted = encryptor.DecryptValueList(encrypted);
+                auto end = std::chrono::steady_clock::now();
+
+                if (i == 0 && GetTypedValuesBufferAsValueBytes(std::move(decrypted)) != value_bytes) {
+                    std::cout << "  ERROR: Round-trip mismatch with threads=" << threads << std::endl;
+                    return false;
+                }
+                if (i < warmup_rounds) {
+                    continue;
+                }
+                double encrypt_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+                double decrypt_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+                encrypt_sum_ms += encrypt_ms;
+                decrypt_sum_ms += decrypt_ms;
+                encrypt_min_ms = (i == warmup_rounds) ? encrypt_ms : std::min(encrypt_min_ms, encrypt_ms);
+                decrypt_min_ms = (i == warmup_rounds) ? decrypt_ms : std::min(decrypt_min_ms, decrypt_ms);
+            }
+
+            double encrypt_avg_ms = encrypt_sum_ms / static_cast<double>(iterations);
+            double decrypt_avg_ms = decrypt_sum_ms / static_cast<double>(iterations);
+            if (threads == 1) {
+                baseline_encrypt_ms = encrypt_avg_ms;
+                baseline_decrypt_ms = decrypt_avg_ms;
+            }
+            std::cout << "  threads=" << threads
+                      << " | encrypt avg=" << encrypt_avg_ms << " ms min=" << encrypt_min_ms << " ms"
+                      << " speedup=" << (baseline_encrypt_ms / encrypt_avg_ms)
+                      << " | decrypt avg=" << decrypt_avg_ms << " ms min=" << decrypt_min_ms << " ms"
+                      << " speedup=" << (baseline_decrypt_ms / decrypt_avg_ms) << std::endl;
+        }
+        return true;
+    }
+
+    // Measures page decryption of one scenario with the default checked decoders and with trusted_ciphertext,
+    // which decodes the value lists in a single pass without the structural validation for untrusted input.
+    // Both agents decrypt the same ciphertext, encrypted once upfront.
+    bool RunTrustedDecryptComparison(
+        int scenario_number,
+        Type::type datatype,
+        const std::vector<uint8_t>& value_bytes,
+        size_t num_values,
+        size_t iterations,
+        size_t warmup_rounds) {
+        std::cout << "\n=== Checked vs Trusted Decryption ===" << std::endl;
+        if (scenario_number <= 0 || scenario_number > static_cast<int>(kScenarios.size())) {
+            std::cout << "ERROR: Invalid scenario number: " << scenario_number << std::endl;
+            return false;
+        }
+        const auto& scenario = kScenarios[static_cast<size_t>(scenario_number - 1)];
+        std::cout << "Scenario: " << scenario.name
+                  << " | datatype=" << to_string(datatype)
+                  << " | values: " << num_values << std::endl;
+
+        auto page = BuildScenarioPage(scenario, value_bytes, num_values);
+        if (!page.has_value()) {
+            std::cout << "  ERROR: Unknown page type: " << scenario.page_type << std::endl;
+            return false;
+        }
+        auto encrypt_agent = BuildLocalDbpaAgent(scenario.compression, datatype, std::nullopt);
+        auto encrypt_result = encrypt_agent->Encrypt(span<const uint8_t>(page->payload), page->attrs);
+        if (!encrypt_result || !encrypt_result->success() || !encrypt_result->encryption_metadata()) {
+            std::cout << "  ERROR: Encryption failed" << std::endl;
+            return false;
+        }
+        const auto ciphertext = encrypt_result->ciphertext();
+        const auto encryption_metadata = encrypt_result->encryption_metadata();
+
+        double checked_avg_ms = 0.0;
+        for (bool trusted : {false, true}) {
+            std::map<std::string, std::string> configuration;
+            if (trusted) {
+                configuration["trusted_ciphertext"] = "true";
+            }
+            auto decrypt_agent = BuildLocalDbpaAgent(
+                scenario.compression, datatype, std::nullopt, encryption_metadata, configuration);
+
+            double sum_ms = 0.0;
+            double min_ms = 0.0;
+            for (size_t i = 0; i < warmup_rounds + iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                auto decrypt_result = decrypt_agent->Decrypt(ciphertext, page->attrs);
+                auto end = std::chrono::steady_clock::now();
+                if (!decrypt_result || !decrypt_result->success()) {
+                    std::cout << "  ERROR: Decryption failed (trusted=" << trusted << ")" << std::endl;
+                    return false;
+                }
+                if (i == 0) {
+                    auto plaintext = decrypt_result->plaintext();
+                    if (!std::equal(plaintext.begin(), plaintext.end(), page->payload.begin(), page->payload.end())) {
+                        std::cout << "  ERROR: Round-trip payload mismatch (trusted=" << trusted << ")" << std::endl;
+                        return false;
+                    }
+                }
+                if (i < warmup_rounds) {
+                    continue;
+                }
+                double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+                sum_ms += elapsed_ms;
+                min_ms = (i == warmup_rounds) ? elapsed_ms : std::min(min_ms, elapsed_ms);
+            }
+
+            double avg_ms = sum_ms / static_cast<double>(iterations);
+            if (!trusted) {
+                checked_avg_ms = avg_ms;
+            }
+            std::cout << "  " << (trusted ? "trusted" : "checked")
+                      << " | decrypt avg=" << avg_ms << " ms min=" << min_ms << " ms"
+                      << " speedup=" << (checked_avg_ms / avg_ms) << std::endl;
+        }
+        return true;
+    }
+
+    // Measures the real crypto cost per page, single-threaded: value-list and block encryption/decryption of the
+    // values buffer with BasicXorEncryptor and with AesEncryptor (AES-256: CTR per value, GCM per block).
+    bool RunEncryptorComparison(
+        Type::type datatype,
+        const std::vector<uint8_t>& value_bytes,
+        size_t num_values,
+        size_t iterations,
+        size_t warmup_rounds) {
+        std::cout << "\n=== Encryptor Comparison (single thread) ===" << std::endl;
+        std::cout << "Datatype: " << to_string(datatype)
+                  << " | values: " << num_values
+                  << " | value bytes: " << value_bytes.size() << std::endl;
+
+        const std::vector<uint8_t> aes_key(32, 0x5A);
+        std::vector<std::pair<std::string, std::unique_ptr<DBPSEncryptor>>> encryptors;
+        encryptors.emplace_back("basic_xor", std::make_unique<BasicXorEncryptor>(
+            "local_demo_key_001", "local_demo_column", "demo_user_123", "{}", datatype, 0));
+        encryptors.emplace_back("aes_256", std::make_unique<AesEncryptor>(
+            "local_demo_key_001", "local_demo_column", "demo_user_123", "{}", datatype, aes_key));
+
+        auto mb_per_s = [&](double ms) {
+            return ms > 0.0 ? static_cast<double>(value_bytes.size()) / (ms * 1e3) : 0.0;
+        };
+        for (auto& [name, encryptor] : encryptors) {
+            // Sums and minimums of: value-list encrypt, value-list decrypt, block encrypt, block decrypt.
+            double sum_ms[4] = {};
+            double min_ms[4] = {};
+            for (size_t i = 0; i < warmup_rounds + iterations; ++i) {
+                auto typed_buffer = ReinterpretValueBytesAsTypedValuesBuffer(
+                    value_bytes, num_values, datatype, std::nullopt, Encoding::PLAIN);
+
+                auto t0 = std::chrono::steady_clock::now();
+                auto encrypted_values = encryptor->EncryptValueList(typed_buffer);
+                auto t1 = std::chrono::steady_clock::now();
+                auto decrypted_values = encryptor->DecryptValueList(encrypted_values);
+                auto t2 = std::chrono::steady_clock::now();
+                auto encrypted_block = encryptor->EncryptBlock(value_bytes);
+                auto t3 = std::chrono::steady_clock::now();
+                auto decrypted_block = encryptor->DecryptBlock(encrypted_block);
+                auto t4 = std::chrono::steady_clock::now();
+
+                if (i == 0 && (GetTypedValuesBufferAsValueBytes(std::move(decrypted_values)) != value_bytes ||
+                               decrypted_block != value_bytes)) {
+                    std::cout << "  ERROR: Round-trip mismatch with " << name << std::endl;
+                    return false;
+                }
+                if (i < warmup_rounds) {
+                    continue;
+                }
+                const std::chrono::steady_clock::time_point points[5] = {t0, t1, t2, t3, t4};
+                for (size_t op = 0; op < 4; ++op) {
+                    double elapsed_ms = std::chrono::duration<double, std::milli>(points[op + 1] - points[op]).count();
+                    sum_ms[op] += elapsed_ms;
+                    min_ms[op] = (i == warmup_rounds) ? elapsed_ms : std::min(min_ms[op], elapsed_ms);
+                }
+            }
+
+            const char* op_names[4] = {"value encrypt", "value decrypt", "block encrypt", "block decrypt"};
+            std::cout << "  " << name << std::endl;
+            for (size_t op = 0; op < 4; ++op) {
+                std::cout << "    " << op_names[op]
+                          << " | avg=" << (sum_ms[op] / static_cast<double>(iterations)) << " ms"
+                          << " min=" << min_ms[op] << " ms"
+                          << " | " << mb_per_s(min_ms[op]) << " MB/s" << std::endl;
+            }
+        }
+        return true;
+    }
+
+    // Measures single-threaded XOR throughput in GB/s per core: each kernel level the CPU supports, then the
+    // BasicXorEncryptor key stream over one block and per element of fixed-size types (INT32 to 16-byte FLBA),
+    // against the byte-at-a-time key stream loop.
+    bool RunXorKernelBenchmark(size_t buffer_bytes, size_t iterations, size_t warmup_rounds) {
+        std::cout << "\n=== XOR Kernel Throughput (single thread) ===" << std::endl;
+        std::cout << "Buffer bytes: " << buffer_bytes
+                  << " | active kernel: " << XorKernelLevelName(dbps::processing::GetActiveXorKernelLevel())
+                  << std::endl;
+
+        std::vector<uint8_t> src(buffer_bytes);
+        std::vector<uint8_t> key(buffer_bytes);
+        std::vector<uint8_t> dst(buffer_bytes);
+        for (size_t i = 0; i < buffer_bytes; ++i) {
+            src[i] = static_cast<uint8_t>(i * 131 + 7);
+            key[i] = static_cast<uint8_t>(i * 29 + 3);
+        }
+
+        auto report = [&](const std::string& label, auto&& run) {
+            double sum_ms = 0.0;
+            double min_ms = 0.0;
+            for (size_t i = 0; i < warmup_rounds + iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                run();
+                auto end = std::chrono::steady_clock::now();
+                if (i < warmup_rounds) {
+                    continue;
+                }
+                double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+                sum_ms += elapsed_ms;
+                min_ms = (i == warmup_rounds) ? elapsed_ms : std::min(min_ms, elapsed_ms);
+            }
+            double avg_ms = sum_ms / static_cast<double>(iterations);
+            double gb_per_s = min_ms > 0.0 ? static_cast<double>(buffer_bytes) / (min_ms * 1e6) : 0.0;
+            std::cout << "  " << label << " | avg=" << avg_ms << " ms min=" << min_ms << " ms"
+                      << " | " << gb_per_s << " GB/s" << std::endl;
+        };
+
+        for (auto level : {XorKernelLevel::kScalar, XorKernelLevel::kSse2,
+                           XorKernelLevel::kAvx2, XorKernelLevel::kAvx512}) {
+            if (!dbps::processing::IsXorKernelLevelSupported(level)) {
+                std::cout << "  kernel " << XorKernelLevelName(level) << " | not supported" << std::endl;
+                continue;
+            }
+            report(std::string("kernel ") + XorKernelLevelName(level), [&]() {
+                dbps::processing::XorBytes(level, src.data(), key.data(), dst.data(), buffer_bytes);
+            });
+        }
+
+        const size_t key_hash = std::hash<std::string>{}("demo_key_001");
+        report("byte loop key stream", [&]() {
+            size_t state = key_hash;
+            for (size_t i = 0; i < buffer_bytes; ++i) {
+                dst[i] = src[i] ^ (state & 0xFF);
+                state = XorKeyStream::NextState(state);
+            }
+        });
+        const XorKeyStream key_stream(key_hash);
+        report("key stream block", [&]() {
+            key_stream.Apply(src.data(), dst.data(), buffer_bytes);
+        });
+        for (size_t element_size : {4, 8, 12, 16}) {
+            report("key stream per element (" + std::to_string(element_size) + " bytes)", [&]() {
+                key_stream.ApplyPerElement(src.data(), dst.data(), buffer_bytes / element_size, element_size);
+            });
+        }
+        return true;
+    }
+
     void RunDemo(
         int scenario_number,
         Type::type datatype,
@@ -380,7 +677,13 @@ public:
         std::optional<size_t> max_rows,
         size_t iterations,
         size_t warmup_rounds,
-        bool skip_decrypt) {
+        bool skip_decrypt,
+        size_t repeat_values,
+        bool parallel_scaling,
+        size_t max_threads,
+        bool trusted_decrypt,
+        size_t xor_kernel_bytes,
+        bool encryptor_comparison) {
         std::cout << "Starting DBPA Local Performance Test..." << std::endl;
         std::cout << std::endl;
         std::cout << "\n--- Local DBPA Scenario ---" << std::endl;
@@ -391,6 +694,13 @@ public:
             std::cout << "Local DBPA Scenarios: FAIL" << std::endl;
             return;
         }
+        if (repeat_values > 1) {
+            const size_t original_size = lines.size();
+            lines.reserve(original_size * repeat_values);
+            for (size_t r = 1; r < repeat_values; ++r) {
+                lines.insert(lines.end(), lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(original_size));
+            }
+        }
 
         std::vector<uint8_t> value_bytes;
         size_t num_values = 0;
@@ -413,6 +723,36 @@ public:
             return;
         }
 
+        if (parallel_scaling) {
+            bool scaling_ok = RunParallelScaling(
+                datatype, value_bytes, num_values, iterations, warmup_rounds, max_threads);
+            std::cout << "\n=== Demo Summary ===" << std::endl;
+            std::cout << "Parallel Scaling: " << (scaling_ok ? "PASS" : "FAIL") << std::endl;
+            return;
+        }
+
+        if (encryptor_comparison) {
+            bool comparison_ok = RunEncryptorComparison(datatype, value_bytes, num_values, iterations, warmup_rounds);
+            std::cout << "\n=== Demo Summary ===" << std::endl;
+            std::cout << "Encryptor Comparison: " << (comparison_ok ? "PASS" : "FAIL") << std::endl;
+            return;
+        }
+
+        if (xor_kernel_bytes > 0) {
+            bool kernels_ok = RunXorKernelBenchmark(xor_kernel_bytes, iterations, warmup_rounds);
+            std::cout << "\n=== Demo Summary ===" << std::endl;
+            std::cout << "XOR Kernels: " << (kernels_ok ? "PASS" : "FAIL") << std::endl;
+            return;
+        }
+
+        if (trusted_decrypt) {
+            bool comparison_ok = RunTrustedDecryptComparison(
+                scenario_number, datatype, value_bytes, num_values, iterations, warmup_rounds);
+            std::cout << "\n=== Demo Summary ===" << std::endl;
+            std::cout << "Trusted Decryption: " << (comparison_ok ? "PASS" : "FAIL") << std::endl;
+            return;
+        }
+
         bool local_dbpa_ok = true;
         std::vector<double> timings_ms;
         size_t total_loops = warmup_rounds + iterations;
@@ -509,6 +849,19 @@ int main(int argc, char* argv[]) {
             cxxopts::value<size_t>()->default_value("3"))
         ("skip_decrypt", "Skip decryption step.",
             cxxopts::value<bool>()->default_value("true"))
+        ("repeat_values", "Repeat the values read from values_file this many times (to build larger pages).",
+            cxxopts::value<size_t>()->default_value("1"))
+        ("parallel_scaling", "Run the intra-page parallel value encryption scaling benchmark instead of a scenario.",
+            cxxopts::value<bool>()->default_value("false"))
+        ("max_threads", "Maximum number of threads for parallel_scaling (0 = hardware concurrency).",
+            cxxopts::value<size_t>()->default_value("0"))
+        ("trusted_decrypt", "Compare checked and trusted_ciphertext decryption of the scenario page instead.",
+            cxxopts::value<bool>()->default_value("false"))
+        ("xor_kernel_bytes", "Benchmark the XOR kernels and key stream on a buffer of this many bytes instead "
+            "(0 = off).",
+            cxxopts::value<size_t>()->default_value("0"))
+        ("encryptor_comparison", "Compare BasicXorEncryptor and AesEncryptor on the values buffer instead.",
+            cxxopts::value<bool>()->default_value("false"))
         ("h,help", "Display this help message");
 
     try {
@@ -525,6 +878,15 @@ int main(int argc, char* argv[]) {
         size_t iterations = parsed_options["iterations"].as<size_t>();
         size_t warmup = parsed_options["warmup"].as<size_t>();
         bool skip_decrypt = parsed_options["skip_decrypt"].as<bool>();
+        size_t repeat_values = parsed_options["repeat_values"].as<size_t>();
+        bool parallel_scaling = parsed_options["parallel_scaling"].as<bool>();
+        size_t max_threads = parsed_options["max_threads"].as<size_t>();
+        bool trusted_decrypt = parsed_options["trusted_decrypt"].as<bool>();
+        size_t xor_kernel_bytes = parsed_options["xor_kernel_bytes"].as<size_t>();
+        bool encryptor_comparison = parsed_options["encryptor_comparison"].as<bool>();
+        if (max_threads == 0) {
+            max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
 
         if (values_file_path.empty()) {
             std::cout << "Error: --values_file is required." << std::endl;
@@ -550,7 +912,9 @@ int main(int argc, char* argv[]) {
         }
 
         DBPALocalTestApp demo;
-        demo.RunDemo(scenario_number, datatype_opt.value(), values_file_path, max_rows, iterations, warmup, skip_decrypt);
+        demo.RunDemo(scenario_number, datatype_opt.value(), values_file_path, max_rows, iterations, warmup, skip_decrypt,
+                     repeat_values, parallel_scaling, max_threads, trusted_decrypt,
+                     xor_kernel_bytes, encryptor_comparison);
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
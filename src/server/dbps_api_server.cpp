@@ -16,14 +16,38 @@
 // under the License.
 
 #include <crow/app.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <map>
 #include <string>
+#include <memory>
 #include <optional>
+#include <thread>
+#include <vector>
 #include <cxxopts.hpp>
 #include "json_request.h"
 #include "encryption_sequencer.h"
+#include "encryption_mode_policy.h"
+#include "buffer_pool.h"
+#include "encryptor_cache.h"
 #include "auth_utils.h"
 
+// Counts a request as in flight for the lifetime of the guard.
+class InFlightRequestGuard {
+public:
+    explicit InFlightRequestGuard(std::atomic<size_t>& counter) : counter_(counter) {
+        counter_.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~InFlightRequestGuard() { counter_.fetch_sub(1, std::memory_order_relaxed); }
+    InFlightRequestGuard(const InFlightRequestGuard&) = delete;
+    InFlightRequestGuard& operator=(const InFlightRequestGuard&) = delete;
+
+private:
+    std::atomic<size_t>& counter_;
+};
+
 // Helper function to create error response
 crow::response CreateErrorResponse(const std::string& error_msg, int status_code = 400) {
     std::cout << "CreateErrorResponse: Status=" << status_code << ", Message=\"" << error_msg << "\"" << std::endl;
@@ -51,6 +75,19 @@ int main(int argc, char* argv[]) {
     static constexpr const char* kJwtSecretParamShort = "j,jwt_secret";
     static constexpr const char* kAllowMissingCredentialsParam = "allow_missing_credentials";
     static constexpr const char* kAllowMissingCredentialsParamShort = "m,allow_missing_credentials";
+    static constexpr const char* kStreamingChunkSizeParam = "streaming_chunk_size";
+    static constexpr const char* kStreamingChunkSizeParamShort = "s,streaming_chunk_size";
+    static constexpr const char* kEncryptionModePolicyParam = "encryption_mode_policy";
+    static constexpr const char* kEncryptionModeMaxPageLatencyParam = "encryption_mode_max_page_latency_us";
+    static constexpr const char* kEncryptionModeCostModelFileParam = "encryption_mode_cost_model_file";
+    static constexpr const char* kLoadAwareModePolicyParam = "load_aware_mode_policy";
+    static constexpr const char* kDictionaryIndexPassthroughParam = "dictionary_index_passthrough";
+    static constexpr const char* kInsecureDictionaryIndexChecksumParam = "insecure_dictionary_index_checksum";
+    static constexpr const char* kValueDedupParam = "value_dedup";
+    static constexpr const char* kColumnarValueListsParam = "columnar_value_lists";
+    static constexpr const char* kBufferPoolMaxCachedBytesParam = "buffer_pool_max_cached_bytes";
+    static constexpr const char* kEncryptorCacheCapacityParam = "encryptor_cache_capacity";
+    static constexpr const char* kEncryptorCacheTtlSecondsParam = "encryptor_cache_ttl_seconds";
     
     // Initialize credentials file path and JWT secret key with parsed command line options
     std::optional<std::string> credentials_file_path = std::nullopt;
@@ -60,12 +97,59 @@ int main(int argc, char* argv[]) {
     // This is useful for development and testing purposes, but should be set to false in production.
     bool allow_missing_credentials = true;
 
+    // `streaming_chunk_size` enables the bounded-memory streaming mode for encryption, processing pages in chunks
+    // of at most this many bytes. 0 (the default) disables it. Decryption follows the encryption_metadata.
+    size_t streaming_chunk_size = 0;
+
+    // Per-block vs per-value selection policy settings, in EncryptionModePolicy::FromConfiguration keys.
+    // With `load_aware_mode_policy`, the "cost" policy scales its estimates by the number of in-flight
+    // encryption requests per hardware thread.
+    std::map<std::string, std::string> mode_policy_configuration;
+    bool load_aware_mode_policy = false;
+
+    // `dictionary_index_passthrough` leaves the data pages of dictionary-encoded chunks unencrypted behind a tag.
+    // The XOR encryptor of the server has no block tags, so it also requires `insecure_dictionary_index_checksum`,
+    // for staging only: the checksum used instead detects accidental corruption but not tampering. It applies
+    // to /decrypt as well, which otherwise rejects checksum-tagged pages.
+    bool dictionary_index_passthrough = false;
+    bool insecure_dictionary_index_checksum = false;
+
+    // `value_dedup` encrypts each distinct value of low-cardinality per-value pages once: "scatter" keeps the
+    // ciphertext unchanged, "dictionary" also stores it as distinct values plus indices. "off" by default.
+    dbps::processing::ValueDedupOptions value_dedup;
+
+    // `columnar_value_lists` encrypts the values of variable-size types with packed value sizes and one payload
+    // region (ciphertext format v0.02). Clients of format v0.01 cannot decrypt it.
+    bool columnar_value_lists = false;
+
+    // `buffer_pool_max_cached_bytes` recycles the page buffers of /encrypt and /decrypt, keeping up to this many
+    // bytes per thread for reuse. 0 (the default) disables it.
+    size_t buffer_pool_max_cached_bytes = 0;
+
+    // `encryptor_cache_capacity` shares the encryptors (and their key schedules) of /encrypt and /decrypt across
+    // requests for the same column, key and context. 0 disables it. Entries older than
+    // `encryptor_cache_ttl_seconds` are rebuilt, so rotated keys are picked up (0 keeps them until evicted).
+    size_t encryptor_cache_capacity = 1024;
+    size_t encryptor_cache_ttl_seconds = 0;
+
     try {
         cxxopts::Options options("dbps_api_server", "Data Batch Protection Service API Server");
         options.add_options()
             (kCredentialsFileParamShort, "Path to credentials JSON file", cxxopts::value<std::string>())
             (kJwtSecretParamShort, "JWT secret key for signing and verifying tokens", cxxopts::value<std::string>())
-            (kAllowMissingCredentialsParamShort, "Allow credentials checking to be skipped if the credentials file is not provided", cxxopts::value<bool>());
+            (kAllowMissingCredentialsParamShort, "Allow credentials checking to be skipped if the credentials file is not provided", cxxopts::value<bool>())
+            (kStreamingChunkSizeParamShort, "Chunk size in bytes of the streaming encryption mode (0 disables it)", cxxopts::value<size_t>())
+            (kEncryptionModePolicyParam, "Per-block vs per-value policy: per_value_when_supported, per_block or cost", cxxopts::value<std::string>())
+            (kEncryptionModeMaxPageLatencyParam, "Per-page latency budget in microseconds of the cost policy", cxxopts::value<std::string>())
+            (kEncryptionModeCostModelFileParam, "Cost model file of the cost policy, from calibrate_encryption_costs", cxxopts::value<std::string>())
+            (kLoadAwareModePolicyParam, "Scale the cost policy estimates by the server load", cxxopts::value<bool>())
+            (kDictionaryIndexPassthroughParam, "Leave the data pages of dictionary-encoded chunks unencrypted, behind a tag", cxxopts::value<bool>())
+            (kInsecureDictionaryIndexChecksumParam, "Staging only: tag passthrough pages with a checksum (no tamper protection)", cxxopts::value<bool>())
+            (kValueDedupParam, "Value deduplication of per-value pages: off, scatter or dictionary", cxxopts::value<std::string>())
+            (kColumnarValueListsParam, "Encrypt variable-size values in the columnar layout of ciphertext format v0.02", cxxopts::value<bool>())
+            (kBufferPoolMaxCachedBytesParam, "Bytes per thread kept for reuse by the page buffer pool (0 disables it)", cxxopts::value<size_t>())
+            (kEncryptorCacheCapacityParam, "Number of encryptors kept for reuse across requests (0 disables the cache)", cxxopts::value<size_t>())
+            (kEncryptorCacheTtlSecondsParam, "Seconds after which a cached encryptor is rebuilt (0 disables expiry)", cxxopts::value<size_t>());
         auto result = options.parse(argc, argv);
         if (result.count(kCredentialsFileParam)) {
             credentials_file_path = result[kCredentialsFileParam].as<std::string>();
@@ -76,6 +160,45 @@ int main(int argc, char* argv[]) {
         if (result.count(kAllowMissingCredentialsParam)) {
             allow_missing_credentials = result[kAllowMissingCredentialsParam].as<bool>();
         }
+        if (result.count(kStreamingChunkSizeParam)) {
+            streaming_chunk_size = result[kStreamingChunkSizeParam].as<size_t>();
+        }
+        for (const char* param : {kEncryptionModePolicyParam, kEncryptionModeMaxPageLatencyParam,
+                                  kEncryptionModeCostModelFileParam}) {
+            if (result.count(param)) {
+                mode_policy_configuration[param] = result[param].as<std::string>();
+            }
+        }
+        if (result.count(kLoadAwareModePolicyParam)) {
+            load_aware_mode_policy = result[kLoadAwareModePolicyParam].as<bool>();
+        }
+        if (result.count(kDictionaryIndexPassthroughParam)) {
+            dictionary_index_passthrough = result[kDictionaryIndexPassthroughParam].as<bool>();
+        }
+        if (result.count(kInsecureDictionaryIndexChecksumParam)) {
+            insecure_dictionary_index_checksum = result[kInsecureDictionaryIndexChecksumParam].as<bool>();
+        }
+        if (result.count(kValueDedupParam)) {
+            auto dedup_mode = dbps::processing::ValueDedupModeFromString(result[kValueDedupParam].as<std::string>());
+            if (!dedup_mode.has_value()) {
+                std::cerr << "Error: Invalid " << kValueDedupParam << ": "
+                          << result[kValueDedupParam].as<std::string>() << std::endl;
+                return 1;
+            }
+            value_dedup.mode = dedup_mode.value();
+        }
+        if (result.count(kColumnarValueListsParam)) {
+            columnar_value_lists = result[kColumnarValueListsParam].as<bool>();
+        }
+        if (result.count(kBufferPoolMaxCachedBytesParam)) {
+            buffer_pool_max_cached_bytes = result[kBufferPoolMaxCachedBytesParam].as<size_t>();
+        }
+        if (result.count(kEncryptorCacheCapacityParam)) {
+            encryptor_cache_capacity = result[kEncryptorCacheCapacityParam].as<size_t>();
+        }
+        if (result.count(kEncryptorCacheTtlSecondsParam)) {
+            encryptor_cache_ttl_seconds = result[kEncryptorCacheTtlSecondsParam].as<size_t>();
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error parsing command line options: " << e.what() << std::endl;
         return 1;
@@ -104,6 +227,42 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Build the encryption mode policy once, shared by every /encrypt request.
+    // The number of in-flight /encrypt requests is tracked for the load-aware policy.
+    auto in_flight_encryptions = std::make_shared<std::atomic<size_t>>(0);
+    std::shared_ptr<const EncryptionModePolicy> mode_policy;
+    try {
+        EncryptionModePolicy::LoadProvider load_provider = nullptr;
+        if (load_aware_mode_policy) {
+            const double hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+            load_provider = [in_flight_encryptions, hardware_threads]() {
+                return static_cast<double>(in_flight_encryptions->load(std::memory_order_relaxed)) / hardware_threads;
+            };
+        }
+        mode_policy = EncryptionModePolicy::FromConfiguration(mode_policy_configuration, load_provider);
+    } catch (const InvalidInputException& e) {
+        std::cerr << "Error: Invalid encryption mode policy: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Page buffer pool shared by every request. Crow runs each request on one thread, so the pool recycles the
+    // buffers of a request into the pool of its thread.
+    std::shared_ptr<dbps::processing::BufferPool> buffer_pool;
+    if (buffer_pool_max_cached_bytes > 0) {
+        dbps::processing::BufferPoolOptions pool_options;
+        pool_options.max_cached_bytes_per_shard = buffer_pool_max_cached_bytes;
+        buffer_pool = std::make_shared<dbps::processing::BufferPool>(pool_options);
+    }
+
+    // Encryptor cache shared by every request, so repeated requests for a column skip the key setup.
+    std::shared_ptr<EncryptorCache> encryptor_cache;
+    if (encryptor_cache_capacity > 0) {
+        EncryptorCacheOptions cache_options;
+        cache_options.capacity = encryptor_cache_capacity;
+        cache_options.ttl = std::chrono::seconds(encryptor_cache_ttl_seconds);
+        encryptor_cache = std::make_shared<EncryptorCache>(cache_options);
+    }
+
     // Initialize API server
     crow::SimpleApp app;
 
@@ -111,7 +270,7 @@ int main(int argc, char* argv[]) {
         return crow::response(200, "OK");
     });
 
-    CROW_ROUTE(app, "/statusz")([&credential_store](const crow::request& req){
+    CROW_ROUTE(app, "/statusz")([&credential_store, encryptor_cache](const crow::request& req){
         // Verify JWT token
         auto auth_error = VerifyJWTFromRequest(req, credential_store);
         if (auth_error.has_value()) {
@@ -120,6 +279,15 @@ int main(int argc, char* argv[]) {
 
         crow::json::wvalue response;
         response["enable_credential_check"] = credential_store.GetEnableCredentialCheck();
+        if (encryptor_cache) {
+            const EncryptorCacheStats stats = encryptor_cache->GetStats();
+            response["encryptor_cache"]["size"] = stats.size;
+            response["encryptor_cache"]["hits"] = stats.hits;
+            response["encryptor_cache"]["misses"] = stats.misses;
+            response["encryptor_cache"]["evictions"] = stats.evictions;
+            response["encryptor_cache"]["expirations"] = stats.expirations;
+            response["encryptor_cache"]["invalidations"] = stats.invalidations;
+        }
         return crow::response(200, response);
     });
 
@@ -139,7 +307,7 @@ int main(int argc, char* argv[]) {
     });
 
     // Encryption endpoint - POST /encrypt
-    CROW_ROUTE(app, "/encrypt").methods("POST"_method)([&credential_store](const crow::request& req) {
+    CROW_ROUTE(app, "/encrypt").methods("POST"_method)([&credential_store, streaming_chunk_size, mode_policy, dictionary_index_passthrough, insecure_dictionary_index_checksum, value_dedup, columnar_value_lists, in_flight_encryptions, buffer_pool, encryptor_cache](const crow::request& req) {
         // Verify JWT token
         auto auth_error = VerifyJWTFromRequest(req, credential_store);
         if (auth_error.has_value()) {
@@ -166,19 +334,33 @@ int main(int argc, char* argv[]) {
         // Create response using our JsonResponse class
         EncryptJsonResponse response;
         
-        // Use DataBatchEncryptionSequencer for actual encryption
+        // Count this request as in flight until it returns.
+        InFlightRequestGuard in_flight_guard(*in_flight_encryptions);
+
+        // Use DataBatchEncryptionSequencer for actual encryption, with the server column encryption settings.
         // It is safe to use value() because the request is validated above.
+        ColumnEncryptionOptions column_options;
+        column_options.streaming_chunk_size = streaming_chunk_size;
+        column_options.mode_policy = mode_policy;
+        column_options.dictionary_index_passthrough = dictionary_index_passthrough;
+        column_options.insecure_dictionary_index_checksum = insecure_dictionary_index_checksum;
+        column_options.buffer_pool = buffer_pool;
+        column_options.encryptor_cache = encryptor_cache;
+        column_options.value_dedup = value_dedup;
+        column_options.columnar_value_lists = columnar_value_lists;
         DataBatchEncryptionSequencer sequencer(
-            request.column_name_,
-            request.datatype_.value(),
-            request.datatype_length_,
-            request.compression_.value(),
+            std::make_shared<const ColumnEncryptionContext>(
+                request.column_name_,
+                request.datatype_.value(),
+                request.datatype_length_,
+                request.compression_.value(),
+                request.encrypted_compression_.value(),
+                request.key_id_,
+                request.user_id_,
+                request.application_context_,
+                std::move(column_options)),
             request.encoding_.value(),
             request.encoding_attributes_,
-            request.encrypted_compression_.value(),
-            request.key_id_,
-            request.user_id_,
-            request.application_context_,
             {} // encryption_metadata does not exist in the Encryption request.
         );
         
@@ -190,9 +372,12 @@ int main(int argc, char* argv[]) {
         } catch (const InvalidInputException& e) {
             return CreateErrorResponse("Invalid input for encryption: " + std::string(e.what()));
         }
+
+        // The decoded plaintext is no longer needed, release it before building the response.
+        std::vector<uint8_t>().swap(request.value_);
         
         // Set encrypted value and encryption_metadata
-        response.encrypted_value_ = sequencer.encrypted_result_;
+        response.encrypted_value_ = std::move(sequencer.encrypted_result_);
         response.encryption_metadata_ = sequencer.encryption_metadata_;
         
         // Set common fields of response
@@ -203,13 +388,16 @@ int main(int argc, char* argv[]) {
         response.reference_id_ = request.reference_id_;
         response.encrypted_compression_ = request.encrypted_compression_;
         
-        // Generate JSON response using our class
+        // Generate JSON response using our class, then hand the ciphertext buffer back to the pool.
         std::string response_json = response.ToJson();
+        if (buffer_pool) {
+            buffer_pool->Release(std::move(response.encrypted_value_));
+        }
         return crow::response(200, response_json);
     });
 
     // Decryption endpoint - POST /decrypt
-    CROW_ROUTE(app, "/decrypt").methods("POST"_method)([&credential_store](const crow::request& req) {
+    CROW_ROUTE(app, "/decrypt").methods("POST"_method)([&credential_store, insecure_dictionary_index_checksum, buffer_pool, encryptor_cache](const crow::request& req) {
         // Verify JWT token
         auto auth_error = VerifyJWTFromRequest(req, credential_store);
         if (auth_error.has_value()) {
@@ -249,19 +437,25 @@ int main(int argc, char* argv[]) {
         response.compression_ = request.compression_;
         response.encoding_ = request.encoding_;
         
-        // Use DataBatchEncryptionSequencer for actual decryption
+        // Use DataBatchEncryptionSequencer for actual decryption, taking the encryptor from the cache.
         // It is safe to use value() because the request is validated above.
+        ColumnEncryptionOptions column_options;
+        column_options.insecure_dictionary_index_checksum = insecure_dictionary_index_checksum;
+        column_options.buffer_pool = buffer_pool;
+        column_options.encryptor_cache = encryptor_cache;
         DataBatchEncryptionSequencer sequencer(
-            request.column_name_,
-            request.datatype_.value(),
-            request.datatype_length_,
-            request.compression_.value(),
+            std::make_shared<const ColumnEncryptionContext>(
+                request.column_name_,
+                request.datatype_.value(),
+                request.datatype_length_,
+                request.compression_.value(),
+                request.encrypted_compression_.value(),
+                request.key_id_,
+                request.user_id_,
+                request.application_context_,
+                std::move(column_options)),
             request.encoding_.value(),
             request.encoding_attributes_,
-            request.encrypted_compression_.value(),
-            request.key_id_,
-            request.user_id_,
-            request.application_context_,
             request.encryption_metadata_
         );
         
@@ -274,10 +468,16 @@ int main(int argc, char* argv[]) {
             return CreateErrorResponse("Decryption failed: " + std::string(e.what()));
         }
         
-        response.decrypted_value_ = sequencer.decrypted_result_;
+        // The decoded ciphertext is no longer needed, release it before building the response.
+        std::vector<uint8_t>().swap(request.encrypted_value_);
+
+        response.decrypted_value_ = std::move(sequencer.decrypted_result_);
         
-        // Generate JSON response using our class
+        // Generate JSON response using our class, then hand the plaintext buffer back to the pool.
         std::string response_json = response.ToJson();
+        if (buffer_pool) {
+            buffer_pool->Release(std::move(response.decrypted_value_));
+        }
         return crow::response(200, response_json);
     });
 